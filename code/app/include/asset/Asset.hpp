@@ -12,8 +12,35 @@
 #include "TextureItem.hpp"
 #include "LightItem.hpp"
 
+#include "scene/StagedScene.hpp"
+
 namespace NRenderer
 {
+    // һεʲռݵ±귶Χ
+    // ϲʱֻ׷ݣΧʲ֮ǰЧ
+    struct ImportRange
+    {
+        // ʲҲһκϲʼ±
+        struct Offsets
+        {
+            unsigned int model = 0;
+            unsigned int node = 0;
+            unsigned int material = 0;
+            unsigned int texture = 0;
+            unsigned int sphere = 0;
+            unsigned int triangle = 0;
+            unsigned int plane = 0;
+            unsigned int mesh = 0;
+            unsigned int light = 0;
+            unsigned int pointLight = 0;
+            unsigned int areaLight = 0;
+            unsigned int directionalLight = 0;
+            unsigned int spotLight = 0;
+        };
+        Offsets begin;  // ϲǰ
+        Offsets end;    // ϲ
+    };
+
     // ʲṹ
     // ˳еģ͡ʡ͹Դ
     struct Asset
@@ -37,6 +64,9 @@ namespace NRenderer
         vector<SharedDirectionalLight> directionalLights;  // ƽйб
         vector<SharedSpotLight> spotLights;           // ۹б
 
+        // ϴȾ¼޸ĵļ壬ʱȾԤ
+        SceneChanges changes;
+
         // ģ
         // ɾģصOpenGLģб
         void clearModel() {
@@ -72,6 +102,7 @@ namespace NRenderer
             triangles.clear();
             planes.clear();
             meshes.clear();
+            changes.markAll();
         }
 
         // Դ
@@ -83,6 +114,7 @@ namespace NRenderer
             areaLights.clear();
             directionalLights.clear();
             spotLights.clear();
+            changes.markAll();
         }
 
         // 
@@ -97,6 +129,20 @@ namespace NRenderer
             textureItems.clear();
         }
 
+        // ϲݴ
+        // ݴе±ʲƫƣԤֻڽ̵߳
+        // ϲstagedеݱߣʹ
+        // : ϲʲеķΧ
+        ImportRange merge(StagedScene& staged);
+
+        // ǰʲ
+        ImportRange::Offsets offsets() const;
+
+        // ½ݴ֮ǰϲ
+        // ֻ滻б仯޸ĵļ¼changesУֻڽ̵߳
+        // ݴrangeĽṹڵԴ͡ģͰĽڵ㣩һʱκ޸Ĳfalse
+        bool reload(StagedScene& staged, const ImportRange& range);
+
         // ΪڵԤõOpenGL
         void genPreviewGlBuffersPerNode(NodeItem& node);
         // ΪԴԤõOpenGL
@@ -7,6 +7,7 @@
 
 #include <string>
 #include "asset/Asset.hpp"
+#include "scene/StagedScene.hpp"
 
 namespace NRenderer
 {
@@ -14,16 +15,31 @@ namespace NRenderer
 
     // 
     // Ϊͬ͵ʲṩͳһĽӿ
+    // Ϊstageں̨߳нļӴOpenGL
+    // ϲ(Asset::merge)ڽ߳нУͬʱOpenGL
     class Importer
     {
     protected:
         string lastErrorInfo;   // һδϢ
     public:
-        // ʲ
+        // ʲļݴ
+        // staged: ݴ
+        // path: ʲļ·
+        // progress: ȡ
+        // : Ƿɹȡʱfalse
+        virtual bool stage(StagedScene& staged, const string& path, ImportProgress& progress) = 0;
+
+        // ͬʲ
         // asset: Ŀʲ
         // path: ʲļ·
         // : Ƿɹ
-        virtual bool import(Asset& asset, const string& path) = 0;
+        bool import(Asset& asset, const string& path) {
+            StagedScene staged{};
+            ImportProgress progress{};
+            if (!stage(staged, path, progress)) return false;
+            asset.merge(staged);
+            return true;
+        }
 
         // ȡϢ
         // : һδϢ
@@ -43,4 +59,4 @@ namespace NRenderer
     SHARE(Importer);
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -6,9 +6,6 @@
 // ˵OBJʽ3DģļĹ
 
 #include "Importer.hpp"
-#include <map>
-
-#include <unordered_map>
 
 namespace NRenderer
 {
@@ -16,23 +13,17 @@ namespace NRenderer
 
     // OBJļ
     // ͵OBJʽ3Dģļ
+    // ɷ˵ObjParserõں̨߳н
     class ObjImporter: public Importer
     {
-    private:
-        // MTLļ
-        // asset: Ŀʲ
-        // path: MTLļ·
-        // file: MTLļ
-        // mtlMap: Ƶӳ
-        // : Ƿɹ
-        bool parseMtl(Asset& asset, const string& path, ifstream& file, unordered_map<string, size_t>& mtlMap);
     public:
-        // OBJļ
-        // asset: Ŀʲ
+        // OBJļõ
+        // staged: ݴ
         // path: OBJļ·
-        // : Ƿɹ
-        virtual bool import(Asset& asset, const string& path) override;
+        // progress: ȡ
+        // : Ƿɹ
+        virtual bool stage(StagedScene& staged, const string& path, ImportProgress& progress) override;
     };
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -6,43 +6,23 @@
 // ˵SCNʽļĹ
 
 #include "Importer.hpp"
-#include <map>
 
 namespace NRenderer
 {
     using namespace std;
 
     // SCNļ
-    // ͵SCNʽĳļ
+    // ͵SCNʽĳļɷ˵ScnParser
     class ScnImporter: public Importer
     {
-    private:
-        // ʲ
-        // asset: Ŀʲ
-        // file: ļ
-        // mtlMap: Ƶӳ
-        // : Ƿɹ
-        bool parseMtl(Asset& asset, ifstream& file, map<string, size_t>& mtlMap);
-
-        // ģͲ
-        // asset: Ŀʲ
-        // file: ļ
-        // mtlMap: Ƶӳ
-        // : Ƿɹ
-        bool parseMdl(Asset& asset, ifstream& file, map<string, size_t>& mtlMap);
-
-        // Դ
-        // asset: Ŀʲ
-        // file: ļ
-        // : Ƿɹ
-        bool parseLgt(Asset& asset, ifstream& file);
     public:
-        // SCNļ
-        // asset: Ŀʲ
+        // SCNļ
+        // staged: ݴ
         // path: SCNļ·
-        // : Ƿɹ
-        virtual bool import(Asset& asset, const string& path) override;
+        // progress: ȡ
+        // : Ƿɹ
+        virtual bool stage(StagedScene& staged, const string& path, ImportProgress& progress) override;
     };
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -19,12 +19,19 @@ namespace NRenderer
         // Ĭ
         ~TextureImporter() = default;
 
-        // ļ
-        // asset: Ŀʲ
+        // ͼļӴOpenGL
+        // texture: Ŀ
+        // path: ͼļ·
+        // : Ƿɹ
+        static bool decode(Texture& texture, const string& path);
+
+        // ļ
+        // staged: ݴ
         // path: ļ·
-        // : Ƿɹ
-        virtual bool import(Asset& asset, const string& path) override;
+        // progress: ȡ
+        // : Ƿɹ
+        virtual bool stage(StagedScene& staged, const string& path, ImportProgress& progress) override;
     };
 }
 
-#endif
\ No newline at end of file
+#endif
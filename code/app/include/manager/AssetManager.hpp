@@ -5,49 +5,124 @@
 // ʲͷļ
 // ˹ʲĹ
 
+#include <thread>
+#include <atomic>
+
 #include "asset/Asset.hpp"
 #include "importer/TextureImporter.hpp"
 #include "utilities/FileFetcher.hpp"
 #include "importer/SceneImporterFactory.hpp"
 #include "utilities/File.hpp"
+#include "utilities/FileWatcher.hpp"
 #include "server/Server.hpp"
 
 namespace NRenderer
 {
     // ʲṹ
     // Ͳеʲ
+    // ں̨߳нļɺɽ̵߳finishImportϲʲ
+    // ļⲿ޸ʱԶ½ֻб仯ʲ
     struct AssetManager
     {
+        // ״̬ö
+        enum class ImportState
+        {
+            IDLING,     // ״̬
+            RUNNING,    // ̨
+            FINISH      // ȴϲ
+        };
+
         Asset asset;  // ʲʵ
 
+    private:
+        // ¼
+        struct ImportRecord
+        {
+            string path;            // ļ·
+            bool scene;             // ǷΪļ
+            ImportRange range;      // ϲʲеķΧ
+            vector<string> files;   // ʱȡļһ޸ʱ¼
+        };
+        vector<ImportRecord> records;       // ʲ֮ǰгɹ
+        FileWatcher watcher;                // recordsеļ
+        vector<size_t> pendingReloads;      // ļ޸ġȴ¼صļ¼±
+        int reloading;                      // ¼صļ¼±꣬-1ʾͨ
+
+        atomic<ImportState> importState;    // ǰ״̬
+        ImportProgress importProgress;      // ȡ
+        SharedImporter importer;            // ǰʹõĵ
+        string importPath;                  // ǰļ·
+        StagedScene staged;                 // ̨ݴ
+        bool importSuccess;                 // ̨Ƿɹ
+        thread importThread;                // ̨߳
+        bool importingScene;                // ǰǷΪļ
+        string scenePath;                   // һγɹĳļ·決Ա
+
+        // ļӦĺ決նļ·
+        static string bakePath(const string& scenePath) {
+            return scenePath + ".nrbake";
+        }
+
+        // ں̨߳пʼ
+        // importer: ʹõĵ
+        // path: ļ·
+        void startImport(SharedImporter importer, const string& path);
+
+        // ¼ȡļʼ
+        void watchFiles(ImportRecord& record);
+        // Ӧ¼صݴ
+        void finishReload();
+        // ʲ֮ǰĵ뷶ΧʧЧټ
+        void clearRecords() {
+            records.clear();
+            watcher.clear();
+            pendingReloads.clear();
+        }
+    public:
+        AssetManager();
+        // ʱȡȴδɵĵ
+        ~AssetManager();
+
         // 볡ļ
         // ֵ֧ .scn  .obj ʽĳļ
-        void importScene() {
-            FileFetcher ff;
-            auto optPath = ff.fetch("All\0*.scn;*.obj\0");
-            if (optPath) {
-                auto importer = SceneImporterFactory::instance().importer(File::getFileExtension(*optPath));
-                bool success = importer->import(asset, *optPath);
-                if (!success) {
-                    getServer().logger.error(importer->getErrorInfo());
-                }
-                else {
-                    getServer().logger.success("ɹ:" + *optPath);
-                }
-            }
-        }
+        void importScene();
 
         // ļ
         // ֵ֧ .png  .jpg ʽͼƬļ
-        void importTexture() {
-            TextureImporter tImp{};
-            FileFetcher ff;
-            auto optPath = ff.fetch("image\0*.png;*.jpg\0");
-            if (optPath) {
-                tImp.import(asset, *optPath);
-            }
+        void importTexture();
+
+        // ȡǰ״̬
+        ImportState getImportState() const {
+            return importState;
+        }
+
+        // ȡǰȣ0-1
+        float getImportProgress() const {
+            return importProgress.get();
+        }
+
+        // ȡǰļ·
+        string getImportPath() const {
+            return importPath;
         }
 
+        // ȡǰ
+        void cancelImport() {
+            importProgress.cancel();
+        }
+
+        // 
+        // ɹʱݴϲʲڽ̵߳
+        void finishImport();
+
+        // 鵼ļǷ޸ģ޸ʱں̨½
+        // ڽ̵߳ãʱ
+        void pollChanges();
+
+        // µĺ決ն
+        // 決δĽʱдĳļԱߣڽ̵߳
+        void saveBakedIrradiance();
+
         // ʲ
         // ģ͡Դʺ
         void clearAll() {
@@ -55,16 +130,19 @@ namespace NRenderer
             asset.clearLight();
             asset.clearMaterial();
             asset.clearTexture();
+            clearRecords();
         }
 
         // ģʲ
         void clearModel() {
             asset.clearModel();
+            clearRecords();
         }
 
         // Դʲ
         void clearLight() {
             asset.clearLight();
+            clearRecords();
         }
     };
 }
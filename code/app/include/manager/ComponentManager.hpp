@@ -11,6 +11,7 @@
 #include <thread>
 
 #include "component/RenderComponent.hpp"
+#include "component/ComponentLoader.hpp"
 #include "server/Server.hpp"
 
 namespace NRenderer
@@ -32,7 +33,7 @@ namespace NRenderer
         };
     private:
         State state;                    // ǰ״̬
-        vector<HMODULE> loadedDlls;     // ѼصDLLģб
+        ComponentLoader loader;         // 嵥ӳټDLL
         ComponentInfo activeComponent;   // ǰϢ
         chrono::system_clock::time_point lastStartTime;  // ϴοʼʱ
         chrono::system_clock::time_point lastEndTime;    // ϴνʱ
@@ -45,8 +46,8 @@ namespace NRenderer
         ~ComponentManager();
 
         // ʼ
-        // dllPath: DLLļ·
-        void init(const string& dllPath);
+        // directory: DLLĿ¼
+        void init(const string& directory);
         
         // ȡǰϢ
         // : Ϣ
@@ -3,6 +3,7 @@
 #define __NR_RENDER_SETTINGS_MANAGER_HPP__
 
 #include "scene/Camera.hpp"
+#include "scene/Scene.hpp"
 
 namespace NRenderer
 {
@@ -12,11 +13,25 @@ namespace NRenderer
         unsigned int height;
         unsigned int depth;
         unsigned int samplesPerPixel;
+        unsigned int threads;
+        RenderOption::Heatmap heatmap;
+        string heatmapOutput;
+        RenderOption::SamplerMode sampler;
+        bool visibilityCache;
+        bool temporal;
+        RenderOption::Accelerator accelerator;
         RenderSettings()
             : width             (500)
             , height            (500)
             , depth             (4)
             , samplesPerPixel   (16)
+            , threads           (8)
+            , heatmap           (RenderOption::Heatmap::NONE)
+            , heatmapOutput     ("heatmap")
+            , sampler           (RenderOption::SamplerMode::RANDOM)
+            , visibilityCache   (false)
+            , temporal          (false)
+            , accelerator       (RenderOption::Accelerator::AUTO)
         {}
     };
     struct AmbientSettings
@@ -17,6 +17,7 @@ namespace NRenderer
         enum class State
         {
             HOVER_COMPONENT_PROGRESS,  // ͣ
+            HOVER_IMPORT_PROGRESS,     // ͣڵ
             NORMAL                     // ״̬
         };
         State state;                   // ǰUI״̬
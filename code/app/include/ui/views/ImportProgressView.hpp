@@ -0,0 +1,29 @@
+#pragma once
+#ifndef __NR_IMPORT_PROGRESS_VIEW_HPP__
+#define __NR_IMPORT_PROGRESS_VIEW_HPP__
+
+// ͼͷļ
+// ʾʲȵĽ
+
+#include "View.hpp"
+
+namespace NRenderer
+{
+   // ͼ
+   // ʾ̨Ľȣṩȡťڵϲʲ
+   class ImportProgressView: public View
+   {
+    private:
+        // д麯
+        virtual void drawSetup();         // ǰ
+        virtual void drawFinish();        // ƺ
+        virtual void drawPosAndSize();    // λúʹС
+        virtual void drawBeginWindow();   // ʼƴ
+        virtual void drawEndWindow();     // ƴ
+        virtual void draw();              // 
+    public:
+        using View::View;                 // ʹûĹ캯
+   };
+}
+
+#endif
@@ -0,0 +1,55 @@
+#pragma once
+#ifndef __NR_FILE_WATCHER_HPP__
+#define __NR_FILE_WATCHER_HPP__
+
+// ļͷļ
+// ṩ˼ļⲿ޸ĵĹ
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <filesystem>
+
+namespace NRenderer
+{
+    using namespace std;
+
+    // ļ
+    // ¼ļ޸ʱ䣬ɽ̶߳ѯ߳
+    // ༭ļʱȽضд룬޸ʱȶһѯںű޸
+    class FileWatcher
+    {
+    private:
+        struct Entry
+        {
+            string path;                            // ļ·
+            filesystem::file_time_type time;        // ѱ޸ʱ
+            filesystem::file_time_type pending;     // ⵽δ޸ʱ
+        };
+        vector<Entry> entries;
+        chrono::steady_clock::time_point lastPoll;
+        chrono::milliseconds interval;              // ѯ
+
+        // ȡļ޸ʱ䣬ļڣڱ滻ʱfalse
+        static bool modifiedTime(const string& path, filesystem::file_time_type& time);
+    public:
+        FileWatcher(chrono::milliseconds interval = chrono::milliseconds{500})
+            : entries           ()
+            , lastPoll          ()
+            , interval          (interval)
+        {}
+        ~FileWatcher() = default;
+
+        // ʼļڼӵļ޸ʱ
+        void watch(const string& path);
+        // ֹͣļ
+        void clear();
+
+        // ļǷ޸
+        // ϴμ鲻ѯʱֱӷ
+        // : ϴα޸ĵļ·
+        vector<string> poll();
+    };
+} // namespace NRenderer
+
+#endif
@@ -297,4 +297,363 @@ namespace NRenderer
             // ʵ
         }
     }
+
+    // ϲݴ
+    // ݴе±0ʼϲʱʲݵ
+    ImportRange Asset::merge(StagedScene& staged) {
+        auto& scene = staged.scene;
+        using PW = Property::Wrapper;
+        ImportRange range{};
+        range.begin = offsets();
+
+        // ¼ϲǰʲ״̬
+        const unsigned int beginModel = (unsigned int)modelItems.size();
+        const unsigned int beginNode = (unsigned int)nodeItems.size();
+        const unsigned int beginMaterial = (unsigned int)materialItems.size();
+        const unsigned int beginTexture = (unsigned int)textureItems.size();
+
+        const unsigned int beginSph = (unsigned int)spheres.size();
+        const unsigned int beginTri = (unsigned int)triangles.size();
+        const unsigned int beginPln = (unsigned int)planes.size();
+        const unsigned int beginMsh = (unsigned int)meshes.size();
+
+        const size_t beginLight = lightItems.size();
+        const unsigned int beginPnt = (unsigned int)pointLights.size();
+        const unsigned int beginArea = (unsigned int)areaLights.size();
+        const unsigned int beginDir = (unsigned int)directionalLights.size();
+        const unsigned int beginSpt = (unsigned int)spotLights.size();
+
+        // ƫƲʾ
+        auto offsetMaterial = [beginMaterial](Handle& h) {
+            if (h.valid()) h.setIndex((unsigned int)h.index() + beginMaterial);
+        };
+
+        // OpenGL󣬽ʧܵΪ
+        for (size_t i = 0; i < scene.textures.size(); i++) {
+            TextureItem ti{};
+            ti.name = staged.textureNames[i];
+            ti.texture = make_shared<Texture>(move(scene.textures[i]));
+            ti.glId = 0;
+            if (ti.texture->rgba != nullptr) {
+                ti.glId = GlImage::loadImage(ti.texture->rgba, {float(ti.texture->width), float(ti.texture->height)});
+            }
+            textureItems.push_back(move(ti));
+        }
+
+        // ʣƫе
+        for (size_t i = 0; i < scene.materials.size(); i++) {
+            MaterialItem mi{};
+            mi.name = staged.materialNames[i];
+            mi.material = make_shared<Material>(move(scene.materials[i]));
+            for (auto& p : mi.material->properties) {
+                if (p.type != Property::Type::TEXTURE_ID) continue;
+                auto& h = get<PW::TextureIdType>(p.valueWrapper).value;
+                if (h.valid()) h.setIndex((unsigned int)h.index() + beginTexture);
+            }
+            materialItems.push_back(move(mi));
+        }
+
+        // ʵ
+        for (auto& s : scene.sphereBuffer) {
+            spheres.push_back(make_shared<Sphere>(s));
+            offsetMaterial(spheres.back()->material);
+        }
+        for (auto& t : scene.triangleBuffer) {
+            triangles.push_back(make_shared<Triangle>(t));
+            offsetMaterial(triangles.back()->material);
+        }
+        for (auto& p : scene.planeBuffer) {
+            planes.push_back(make_shared<Plane>(p));
+            offsetMaterial(planes.back()->material);
+        }
+        for (auto& m : scene.meshBuffer) {
+            meshes.push_back(make_shared<Mesh>(move(m)));
+            offsetMaterial(meshes.back()->material);
+        }
+
+        // ģڵ
+        for (size_t i = 0; i < scene.models.size(); i++) {
+            ModelItem mi{};
+            mi.name = staged.modelNames[i];
+            mi.model = make_shared<Model>(move(scene.models[i]));
+            for (auto& n : mi.model->nodes) n += beginNode;
+            modelItems.push_back(move(mi));
+        }
+        for (size_t i = 0; i < scene.nodes.size(); i++) {
+            NodeItem ni{};
+            ni.name = staged.nodeNames[i];
+            ni.node = make_shared<Node>(scene.nodes[i]);
+            ni.node->model += beginModel;
+            using T = Node::Type;
+            switch (ni.node->type) {
+                case T::SPHERE: ni.node->entity += beginSph; break;
+                case T::TRIANGLE: ni.node->entity += beginTri; break;
+                case T::PLANE: ni.node->entity += beginPln; break;
+                case T::MESH: ni.node->entity += beginMsh; break;
+            }
+            nodeItems.push_back(move(ni));
+        }
+
+        // Դ
+        for (auto& p : scene.pointLightBuffer) pointLights.push_back(make_shared<PointLight>(p));
+        for (auto& a : scene.areaLightBuffer) areaLights.push_back(make_shared<AreaLight>(a));
+        for (auto& d : scene.directionalLightBuffer) directionalLights.push_back(make_shared<DirectionalLight>(d));
+        for (auto& s : scene.spotLightBuffer) spotLights.push_back(make_shared<SpotLight>(s));
+        for (size_t i = 0; i < scene.lights.size(); i++) {
+            LightItem li{};
+            li.name = staged.lightNames[i];
+            li.light = make_shared<Light>(scene.lights[i]);
+            using T = Light::Type;
+            switch (li.light->type) {
+                case T::POINT: li.light->entity += beginPnt; break;
+                case T::SPOT: li.light->entity += beginSpt; break;
+                case T::DIRECTIONAL: li.light->entity += beginDir; break;
+                case T::AREA: li.light->entity += beginArea; break;
+            }
+            lightItems.push_back(move(li));
+        }
+
+        // ΪӵĽڵ͹ԴOpenGLԤ
+        for (auto i = beginNode; i < nodeItems.size(); i++) {
+            genPreviewGlBuffersPerNode(nodeItems[i]);
+        }
+        for (auto i = beginLight; i < lightItems.size(); i++) {
+            genPreviewGlBuffersPerLight(lightItems[i]);
+        }
+
+        changes.markAll();
+        range.end = offsets();
+        return range;
+    }
+
+    // ǰʲ
+    ImportRange::Offsets Asset::offsets() const {
+        ImportRange::Offsets o{};
+        o.model = (unsigned int)modelItems.size();
+        o.node = (unsigned int)nodeItems.size();
+        o.material = (unsigned int)materialItems.size();
+        o.texture = (unsigned int)textureItems.size();
+        o.sphere = (unsigned int)spheres.size();
+        o.triangle = (unsigned int)triangles.size();
+        o.plane = (unsigned int)planes.size();
+        o.mesh = (unsigned int)meshes.size();
+        o.light = (unsigned int)lightItems.size();
+        o.pointLight = (unsigned int)pointLights.size();
+        o.areaLight = (unsigned int)areaLights.size();
+        o.directionalLight = (unsigned int)directionalLights.size();
+        o.spotLight = (unsigned int)spotLights.size();
+        return o;
+    }
+
+    namespace
+    {
+        // ֶαȽϣʲеĽṹûжȽ
+        bool same(const Handle& a, const Handle& b) {
+            return a.getValue() == b.getValue();
+        }
+        bool same(const Sphere& a, const Sphere& b) {
+            return same(a.material, b.material) && a.direction == b.direction && a.position == b.position && a.radius == b.radius;
+        }
+        bool same(const Triangle& a, const Triangle& b) {
+            return same(a.material, b.material) && a.v[0] == b.v[0] && a.v[1] == b.v[1] && a.v[2] == b.v[2] && a.normal == b.normal;
+        }
+        bool same(const Plane& a, const Plane& b) {
+            return same(a.material, b.material) && a.normal == b.normal && a.position == b.position && a.u == b.u && a.v == b.v;
+        }
+        bool same(const Mesh& a, const Mesh& b) {
+            return same(a.material, b.material) && a.positions == b.positions && a.normals == b.normals && a.uvs == b.uvs
+                && a.positionIndices == b.positionIndices && a.normalIndices == b.normalIndices && a.uvIndices == b.uvIndices;
+        }
+        bool same(const Model& a, const Model& b) {
+            return a.nodes == b.nodes && a.translation == b.translation && a.scale == b.scale;
+        }
+        bool same(const PointLight& a, const PointLight& b) {
+            return a.intensity == b.intensity && a.position == b.position;
+        }
+        bool same(const AreaLight& a, const AreaLight& b) {
+            return a.radiance == b.radiance && a.position == b.position && a.u == b.u && a.v == b.v;
+        }
+        bool same(const DirectionalLight& a, const DirectionalLight& b) {
+            return a.irradiance == b.irradiance && a.direction == b.direction;
+        }
+        bool same(const SpotLight& a, const SpotLight& b) {
+            return a.intensity == b.intensity && a.position == b.position && a.direction == b.direction
+                && a.hotSpot == b.hotSpot && a.fallout == b.fallout;
+        }
+        bool same(const Texture& a, const Texture& b) {
+            if (a.width != b.width || a.height != b.height) return false;
+            if (a.rgba == nullptr || b.rgba == nullptr) return a.rgba == b.rgba;
+            return equal(a.rgba, a.rgba + size_t(a.width)*a.height, b.rgba);
+        }
+        bool same(const Material& a, const Material& b) {
+            if (a.type != b.type || a.properties.size() != b.properties.size()) return false;
+            for (size_t i = 0; i < a.properties.size(); i++) {
+                auto& pa = a.properties[i];
+                auto& pb = b.properties[i];
+                if (pa.key != pb.key || pa.valueWrapper.index() != pb.valueWrapper.index()) return false;
+                bool equalValue = visit([&pb](const auto& wa) {
+                    const auto& wb = get<decay_t<decltype(wa)>>(pb.valueWrapper);
+                    if constexpr (is_same_v<decay_t<decltype(wa)>, Property::Wrapper::TextureIdType>) return same(wa.value, wb.value);
+                    else return wa.value == wb.value;
+                }, pa.valueWrapper);
+                if (!equalValue) return false;
+            }
+            return true;
+        }
+
+        // ȽݴʲͬһΧݣб仯滻Ϊݴ
+        // changed: ÿ滻ʲе±꣩
+        template<typename T, typename Changed>
+        void replaceChanged(vector<shared_ptr<T>>& items, unsigned int begin, vector<T>& staged, Changed&& changed) {
+            for (size_t i = 0; i < staged.size(); i++) {
+                auto& current = *items[begin + i];
+                if (same(current, staged[i])) continue;
+                current = move(staged[i]);
+                changed(Index(begin + i));
+            }
+        }
+    }
+
+    // ½ݴ֮ǰϲ
+    bool Asset::reload(StagedScene& staged, const ImportRange& range) {
+        auto& scene = staged.scene;
+        using PW = Property::Wrapper;
+        const auto& b = range.begin;
+        const auto& e = range.end;
+
+        // ṹǷһ£һʱҪµ
+        auto now = offsets();
+        if (e.model > now.model || e.node > now.node || e.material > now.material || e.texture > now.texture
+            || e.sphere > now.sphere || e.triangle > now.triangle || e.plane > now.plane || e.mesh > now.mesh
+            || e.light > now.light || e.pointLight > now.pointLight || e.areaLight > now.areaLight
+            || e.directionalLight > now.directionalLight || e.spotLight > now.spotLight) return false;
+        if (scene.models.size() != e.model - b.model || scene.nodes.size() != e.node - b.node
+            || scene.materials.size() != e.material - b.material || scene.textures.size() != e.texture - b.texture
+            || scene.sphereBuffer.size() != e.sphere - b.sphere || scene.triangleBuffer.size() != e.triangle - b.triangle
+            || scene.planeBuffer.size() != e.plane - b.plane || scene.meshBuffer.size() != e.mesh - b.mesh
+            || scene.lights.size() != e.light - b.light || scene.pointLightBuffer.size() != e.pointLight - b.pointLight
+            || scene.areaLightBuffer.size() != e.areaLight - b.areaLight
+            || scene.directionalLightBuffer.size() != e.directionalLight - b.directionalLight
+            || scene.spotLightBuffer.size() != e.spotLight - b.spotLight) return false;
+        for (size_t i = 0; i < scene.nodes.size(); i++) {
+            auto& n = scene.nodes[i];
+            auto& current = *nodeItems[b.node + i].node;
+            using T = Node::Type;
+            unsigned int beginEntity = n.type == T::SPHERE ? b.sphere : n.type == T::TRIANGLE ? b.triangle
+                : n.type == T::PLANE ? b.plane : b.mesh;
+            if (n.type != current.type || n.entity + beginEntity != current.entity || n.model + b.model != current.model) return false;
+        }
+        for (size_t i = 0; i < scene.models.size(); i++) {
+            auto& nodes = scene.models[i].nodes;
+            auto& current = modelItems[b.model + i].model->nodes;
+            if (nodes.size() != current.size()) return false;
+            for (size_t k = 0; k < nodes.size(); k++) {
+                if (nodes[k] + b.node != current[k]) return false;
+            }
+        }
+        for (size_t i = 0; i < scene.lights.size(); i++) {
+            auto& l = scene.lights[i];
+            auto& current = *lightItems[b.light + i].light;
+            using T = Light::Type;
+            unsigned int beginEntity = l.type == T::POINT ? b.pointLight : l.type == T::SPOT ? b.spotLight
+                : l.type == T::DIRECTIONAL ? b.directionalLight : b.areaLight;
+            if (l.type != current.type || l.entity + beginEntity != current.entity) return false;
+        }
+
+        // ֻ´б仯
+        for (size_t i = 0; i < scene.textures.size(); i++) {
+            auto& ti = textureItems[b.texture + i];
+            ti.name = staged.textureNames[i];
+            if (same(*ti.texture, scene.textures[i])) continue;
+            if (ti.glId != 0) GlImage::deleteImage(ti.glId);
+            ti.texture = make_shared<Texture>(move(scene.textures[i]));
+            ti.glId = 0;
+            if (ti.texture->rgba != nullptr) {
+                ti.glId = GlImage::loadImage(ti.texture->rgba, {float(ti.texture->width), float(ti.texture->height)});
+            }
+        }
+
+        // ʣϲʱһƫȽ
+        for (size_t i = 0; i < scene.materials.size(); i++) {
+            auto& mi = materialItems[b.material + i];
+            mi.name = staged.materialNames[i];
+            auto& m = scene.materials[i];
+            for (auto& p : m.properties) {
+                if (p.type != Property::Type::TEXTURE_ID) continue;
+                auto& h = get<PW::TextureIdType>(p.valueWrapper).value;
+                if (h.valid()) h.setIndex((unsigned int)h.index() + b.texture);
+            }
+            if (!same(*mi.material, m)) *mi.material = move(m);
+        }
+
+        // ʵ壺¼޸ĵ±֮꣬ɶӦڵԤ
+        auto offsetMaterial = [&b](Handle& h) {
+            if (h.valid()) h.setIndex((unsigned int)h.index() + b.material);
+        };
+        for (auto& s : scene.sphereBuffer) offsetMaterial(s.material);
+        for (auto& t : scene.triangleBuffer) offsetMaterial(t.material);
+        for (auto& p : scene.planeBuffer) offsetMaterial(p.material);
+        for (auto& m : scene.meshBuffer) offsetMaterial(m.material);
+        vector<Index> changedSpheres{}, changedTriangles{}, changedPlanes{}, changedMeshes{};
+        replaceChanged(spheres, b.sphere, scene.sphereBuffer, [&](Index i) { changedSpheres.push_back(i); });
+        replaceChanged(triangles, b.triangle, scene.triangleBuffer, [&](Index i) { changedTriangles.push_back(i); });
+        replaceChanged(planes, b.plane, scene.planeBuffer, [&](Index i) { changedPlanes.push_back(i); });
+        replaceChanged(meshes, b.mesh, scene.meshBuffer, [&](Index i) { changedMeshes.push_back(i); });
+
+        // ģͣƽƻű仯ʱģ͵м嶼Ϊ޸
+        for (size_t i = 0; i < scene.models.size(); i++) {
+            auto& mi = modelItems[b.model + i];
+            mi.name = staged.modelNames[i];
+            auto& m = scene.models[i];
+            for (auto& n : m.nodes) n += b.node;
+            if (same(*mi.model, m)) continue;
+            *mi.model = move(m);
+            for (auto n : mi.model->nodes) {
+                auto& node = *nodeItems[n].node;
+                using T = Node::Type;
+                switch (node.type) {
+                    case T::SPHERE: changedSpheres.push_back(node.entity); break;
+                    case T::TRIANGLE: changedTriangles.push_back(node.entity); break;
+                    case T::PLANE: changedPlanes.push_back(node.entity); break;
+                    case T::MESH: changedMeshes.push_back(node.entity); break;
+                }
+            }
+        }
+
+        for (size_t i = 0; i < scene.nodes.size(); i++) {
+            auto& ni = nodeItems[b.node + i];
+            ni.name = staged.nodeNames[i];
+            auto& n = *ni.node;
+            using T = Node::Type;
+            auto& changed = n.type == T::SPHERE ? changedSpheres : n.type == T::TRIANGLE ? changedTriangles
+                : n.type == T::PLANE ? changedPlanes : changedMeshes;
+            if (find(changed.begin(), changed.end(), n.entity) != changed.end()) {
+                genPreviewGlBuffersPerNode(ni);
+            }
+        }
+        if (!changes.all) {
+            changes.spheres.insert(changes.spheres.end(), changedSpheres.begin(), changedSpheres.end());
+            changes.triangles.insert(changes.triangles.end(), changedTriangles.begin(), changedTriangles.end());
+            changes.planes.insert(changes.planes.end(), changedPlanes.begin(), changedPlanes.end());
+        }
+
+        // Դ
+        vector<bool> changedLights(scene.lights.size(), false);
+        auto markLight = [&](Light::Type type, Index entity) {
+            for (size_t i = 0; i < scene.lights.size(); i++) {
+                auto& l = *lightItems[b.light + i].light;
+                if (l.type == type && l.entity == entity) changedLights[i] = true;
+            }
+        };
+        replaceChanged(pointLights, b.pointLight, scene.pointLightBuffer, [&](Index i) { markLight(Light::Type::POINT, i); });
+        replaceChanged(areaLights, b.areaLight, scene.areaLightBuffer, [&](Index i) { markLight(Light::Type::AREA, i); });
+        replaceChanged(directionalLights, b.directionalLight, scene.directionalLightBuffer, [&](Index i) { markLight(Light::Type::DIRECTIONAL, i); });
+        replaceChanged(spotLights, b.spotLight, scene.spotLightBuffer, [&](Index i) { markLight(Light::Type::SPOT, i); });
+        for (size_t i = 0; i < scene.lights.size(); i++) {
+            auto& li = lightItems[b.light + i];
+            li.name = staged.lightNames[i];
+            if (changedLights[i]) genPreviewGlBuffersPerLight(li);
+        }
+        return true;
+    }
 }
\ No newline at end of file
@@ -13,6 +13,13 @@ namespace NRenderer
         ro.samplesPerPixel = renderSettings.samplesPerPixel;  // ÿز
         ro.width = renderSettings.width;                    // Ⱦ
         ro.height = renderSettings.height;                  // Ⱦ߶
+        ro.threads = renderSettings.threads;                // Ⱦ߳
+        ro.heatmap = renderSettings.heatmap;                // شͼ
+        ro.heatmapOutput = renderSettings.heatmapOutput;    // ͼ·
+        ro.sampler = renderSettings.sampler;                // ģʽ
+        ro.visibilityCache = renderSettings.visibilityCache;    // ԴɼԻ
+        ro.temporal = renderSettings.temporal;              // ͶӰһ֡
+        ro.accelerator = renderSettings.accelerator;        // ٽṹ
         this->scene->renderOption = ro;
     }
 
@@ -95,6 +102,9 @@ namespace NRenderer
         for (auto& s : asset.spotLights) {
             this->scene->spotLightBuffer.push_back(*s);
         }
+
+        // ¼޸ĵļ壬Ԥʱݴ˸һεļٽṹ
+        this->scene->changes = asset.changes;
     }
 
     // 
@@ -1,37 +1,50 @@
 #include "importer/TextureImporter.hpp"
 #include "utilities/ImageLoader.hpp"
-#include "utilities/GlImage.hpp"
-#include "asset/TextureItem.hpp"
 
 // ʵļ
-// ļеOpenGL
+// ļнOpenGLںϲʲʱ
 
 namespace NRenderer
 {
-    // ļ
-    // asset: ʲ
-    // path: ļ·
-    // ֵ: Ƿɹ
-    bool TextureImporter::import(Asset& asset, const string& path) {
+    // ͼļ
+    // texture: Ŀ
+    // path: ͼļ·
+    // ֵ: Ƿɹ
+    bool TextureImporter::decode(Texture& texture, const string& path) {
         ImageLoader imgLoader;
-        auto img = imgLoader.load(path);                // ͼļ
-
-        // 
-        SharedTexture spTexture{new Texture()};
-        spTexture->width = img->width;                 // 
-        spTexture->height = img->height;               // ߶
-        spTexture->rgba = (RGBA*)img->data;           // 
-
-        // OpenGL
-        auto id = GlImage::loadImage(spTexture->rgba, {spTexture->width, spTexture->height});
+        auto img = imgLoader.load(path, 4);             // RGBAʽͼ
+        if (img == nullptr) return false;
 
-        // 
-        TextureItem ti;
-        ti.glId = id;                                 // OpenGLID
-        ti.name = path;                               // ƣļ·
-        ti.texture = spTexture;                       // 
-        asset.textureItems.push_back(move(ti));       // ӵʲ
+        // ͼݵ
+        delete[] texture.rgba;
+        texture.width = img->width;                     // 
+        texture.height = img->height;                   // ߶
+        texture.rgba = new RGBA[img->width*img->height];
+        for (int i = 0; i < img->width*img->height; i++) {
+            texture.rgba[i].r = img->data[i*4];
+            texture.rgba[i].g = img->data[i*4 + 1];
+            texture.rgba[i].b = img->data[i*4 + 2];
+            texture.rgba[i].a = img->data[i*4 + 3];
+        }
+        delete img;
+        return true;
+    }
 
+    // ļ
+    // staged: ݴ
+    // path: ļ·
+    // progress: ȡ
+    // ֵ: Ƿɹ
+    bool TextureImporter::stage(StagedScene& staged, const string& path, ImportProgress& progress) {
+        staged.scene.textures.emplace_back();
+        if (!decode(staged.scene.textures.back(), path)) {
+            staged.scene.textures.pop_back();
+            lastErrorInfo = "Cannot load image: " + path;
+            return false;
+        }
+        staged.textureNames.push_back(path);           // ƣļ·
+        staged.texturePaths.push_back(path);
+        progress.report(1.f);
         return true;
     }
-}
\ No newline at end of file
+}
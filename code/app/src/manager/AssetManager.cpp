@@ -0,0 +1,190 @@
+#include "manager/AssetManager.hpp"
+
+// ʲʵļ
+// ʲĺ̨ϲ
+
+namespace NRenderer
+{
+    // 캯
+    AssetManager::AssetManager()
+        : asset             ()
+        , importState       (ImportState::IDLING)   // ʼ״̬Ϊ
+        , importProgress    ()
+        , importer          (nullptr)
+        , importPath        ()
+        , staged            ()
+        , importSuccess     (false)
+        , importThread      ()
+        , importingScene    (false)
+        , scenePath         ()
+        , records           ()
+        , watcher           ()
+        , pendingReloads    ()
+        , reloading         (-1)
+    {}
+
+    // 
+    // ̨߳˹ĳԱȴ
+    AssetManager::~AssetManager() {
+        importProgress.cancel();
+        if (importThread.joinable()) importThread.join();
+    }
+
+    // ں̨߳пʼ
+    // ͬһʱֻһ
+    void AssetManager::startImport(SharedImporter importer, const string& path) {
+        if (importState != ImportState::IDLING) {
+            getServer().logger.warning("ڵ:" + importPath);
+            return;
+        }
+        if (importThread.joinable()) importThread.join();
+
+        this->importer = importer;
+        importPath = path;
+        staged = StagedScene{};
+        importProgress.reset();
+        importSuccess = false;
+        importState = ImportState::RUNNING;
+        importThread = thread([this]() {
+            importSuccess = this->importer->stage(staged, importPath, importProgress);
+            importState = ImportState::FINISH;
+        });
+    }
+
+    // 볡ļ
+    void AssetManager::importScene() {
+        FileFetcher ff;
+        auto optPath = ff.fetch("All\0*.scn;*.obj\0");
+        if (optPath) {
+            auto importer = SceneImporterFactory::instance().importer(File::getFileExtension(*optPath));
+            if (importer == nullptr) {
+                getServer().logger.error("Unsupported file: " + *optPath);
+                return;
+            }
+            importingScene = true;
+            reloading = -1;
+            startImport(importer, *optPath);
+        }
+    }
+
+    // ļ
+    void AssetManager::importTexture() {
+        FileFetcher ff;
+        auto optPath = ff.fetch("image\0*.png;*.jpg\0");
+        if (optPath) {
+            importingScene = false;
+            reloading = -1;
+            startImport(make_shared<TextureImporter>(), *optPath);
+        }
+    }
+
+    // 
+    // ̨߳Ѿϲݴͷڴ
+    void AssetManager::finishImport() {
+        if (importState != ImportState::FINISH) return;
+        if (importThread.joinable()) importThread.join();
+
+        if (reloading >= 0) {
+            finishReload();
+        }
+        else if (importSuccess) {
+            ImportRecord record{ importPath, importingScene, asset.merge(staged), {} };
+            watchFiles(record);
+            records.push_back(move(record));
+            getServer().logger.success("ɹ:" + importPath);
+            if (importingScene) {
+                // 泡ĺ決βһʱʹõ
+                scenePath = importPath;
+                auto baked = make_shared<BakedIrradiance>();
+                if (baked->read(bakePath(scenePath))) {
+                    getServer().irradiance.restore(baked);
+                    getServer().logger.log("Ѷȡ決ն:" + bakePath(scenePath));
+                }
+            }
+        }
+        else {
+            getServer().logger.error(importer->getErrorInfo());
+        }
+        staged = StagedScene{};
+        importer = nullptr;
+        importState = ImportState::IDLING;
+    }
+
+    // ¼ȡļʼ
+    // ·.mtlļںϲԱݴ
+    void AssetManager::watchFiles(ImportRecord& record) {
+        record.files.clear();
+        record.files.push_back(record.path);
+        for (auto& path : staged.texturePaths) record.files.push_back(path);
+        for (auto& path : staged.sourceFiles) record.files.push_back(path);
+        for (auto& path : record.files) watcher.watch(path);
+    }
+
+    // Ӧ¼صݴ
+    // ṹûб仯ʱֻ滻޸Ĺṹ仯ʱֻһ¼ºϲҪûµ
+    void AssetManager::finishReload() {
+        auto& record = records[reloading];
+        reloading = -1;
+        if (!importSuccess) {
+            getServer().logger.error(importer->getErrorInfo());
+            return;
+        }
+        if (asset.reload(staged, record.range)) {
+            getServer().logger.success("¼:" + record.path);
+        }
+        else if (records.size() == 1) {
+            asset.clearModel();
+            asset.clearLight();
+            asset.clearMaterial();
+            asset.clearTexture();
+            record.range = asset.merge(staged);
+            getServer().logger.success("ṹѸı䣬µ:" + record.path);
+        }
+        else {
+            getServer().logger.warning("ṹѸı䣬ʲµ:" + record.path);
+            return;
+        }
+        watchFiles(record);
+    }
+
+    // 鵼ļǷ޸
+    void AssetManager::pollChanges() {
+        if (importState != ImportState::IDLING || records.empty()) return;
+        for (auto& path : watcher.poll()) {
+            for (size_t i = 0; i < records.size(); i++) {
+                auto& files = records[i].files;
+                if (find(files.begin(), files.end(), path) == files.end()) continue;
+                if (find(pendingReloads.begin(), pendingReloads.end(), i) == pendingReloads.end()) pendingReloads.push_back(i);
+            }
+        }
+        // һֻ¼һ¼֮֡д
+        while (!pendingReloads.empty()) {
+            size_t i = pendingReloads.front();
+            pendingReloads.erase(pendingReloads.begin());
+            SharedImporter reloadImporter = records[i].scene
+                ? SceneImporterFactory::instance().importer(File::getFileExtension(records[i].path))
+                : make_shared<TextureImporter>();
+            if (reloadImporter == nullptr) continue;
+            reloading = int(i);
+            importingScene = records[i].scene;
+            startImport(reloadImporter, records[i].path);
+            return;
+        }
+    }
+
+    // µĺ決ն
+    void AssetManager::saveBakedIrradiance() {
+        auto baked = getServer().irradiance.takeUnsaved();
+        if (baked == nullptr) return;
+        if (scenePath.empty()) {
+            getServer().logger.warning("Ǵļģ決նδ");
+            return;
+        }
+        if (baked->write(bakePath(scenePath))) {
+            getServer().logger.success("決նѱ:" + bakePath(scenePath));
+        }
+        else {
+            getServer().logger.error("޷決ն:" + bakePath(scenePath));
+        }
+    }
+} // namespace NRenderer
@@ -1,5 +1,4 @@
 #include "manager/ComponentManager.hpp"
-#include "io.h"
 
 // ʵļ
 // Ⱦļءִк״̬
@@ -10,7 +9,7 @@ namespace NRenderer
     // ʼ״̬ͳԱ
     ComponentManager::ComponentManager()
         : state             (State::IDLING)         // ʼ״̬Ϊ
-        , loadedDlls        ()                      // ѼصDLLб
+        , loader            ()                      // 
         , activeComponent   ()                      // ǰ
         , lastStartTime     ()                      // ϴִпʼʱ
         , lastEndTime       ()                      // ϴִнʱ
@@ -18,25 +17,11 @@ namespace NRenderer
     {}
 
     // ʼ
-    // path: DLLļ·
-    void ComponentManager::init(const string& path) {
-        auto& f = getServer().componentFactory;
-        _finddata_t findData;
-        
-        // DLLļ
-        auto handle = _findfirst(path.c_str(), &findData);
-        if (handle == -1) return;
-        do {
-            string name{findData.name};
-            string filePath = (path.substr(0 ,path.size() - 6) + "\\" + name);
-            
-            // DLLļ
-            auto h = ::LoadLibrary((LPCSTR)filePath.c_str());
-            if (h != NULL) {
-                loadedDlls.push_back(h);  // DLL
-            }
-        } while (_findnext(handle, &findData) == 0);
-        _findclose(handle);
+    // ֻȡ嵥ǼϢDLL״ִʱż
+    // directory: DLLĿ¼
+    void ComponentManager::init(const string& directory) {
+        auto nums = loader.init(directory);
+        getServer().logger.log(to_string(nums) + " components registered from " + directory);
     }
 
     // ִ
@@ -64,12 +49,9 @@ namespace NRenderer
     }
 
     // 
-    // ͷмصDLL
+    // ʱͷмصDLL
     ComponentManager::~ComponentManager()
     {
-        for (auto& h : loadedDlls) {
-            ::FreeLibrary(h);  // ͷDLL
-        }
     }
 
 } // namespace NRenderer
@@ -13,6 +13,6 @@ namespace NRenderer
         , assetManager                      ()  // ʲ
         , componentManager                  ()  // 
     {
-        componentManager.init(".\\components\\*.dll");  // ʼDLL
+        componentManager.init(".\\components");  // ʼ嵥ǼDLL
    }
 }
\ No newline at end of file
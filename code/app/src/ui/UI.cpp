@@ -12,6 +12,7 @@
 #include "ui/views/SceneView.hpp"
 #include "ui/views/ScreenView.hpp"
 #include "ui/views/ComponentProgressView.hpp"
+#include "ui/views/ImportProgressView.hpp"
 
 namespace NRenderer
 {
@@ -62,6 +63,7 @@ namespace NRenderer
         views.push_back(new ScreenView({0, 0}, {600, 600}, uiContext, manager));
         views.push_back(new SceneView({600, 0}, {300, 600}, uiContext, manager));
         views.push_back(new ComponentProgressView({}, {240, 100}, uiContext, manager));
+        views.push_back(new ImportProgressView({}, {360, 120}, uiContext, manager));
     #pragma endregion _INIT_
     }
     void UI::run() {
@@ -51,6 +51,8 @@ namespace NRenderer
                 string logInfo{};
                 logInfo = activeComponentInfo.id + "ִ. Time: " + to_string(execTime.count()) + "s";
                 getServer().logger.success(logInfo);
+                // 決Ľ泡ʲ
+                manager.assetManager.saveBakedIrradiance();
 
                 uiContext.state = UIContext::State::NORMAL;  // ָ״̬
                 ImGui::CloseCurrentPopup();  // رյ
@@ -0,0 +1,55 @@
+#include "ui/views/ImportProgressView.hpp"
+
+// ͼʵļ
+// ʵʲȵʾȡ
+
+namespace NRenderer
+{
+    // ʵֵĴڻƺ
+    void ImportProgressView::drawBeginWindow() {}
+    void ImportProgressView::drawEndWindow() {}
+    void ImportProgressView::drawSetup() {}
+    void ImportProgressView::drawFinish() {}
+
+    // ýȴڵλúʹС
+    void ImportProgressView::drawPosAndSize() {
+        // Ļλ
+        ImVec2 center(ImGui::GetIO().DisplaySize.x * 0.5f, ImGui::GetIO().DisplaySize.y * 0.5f);
+        // ôλΪĻ
+        ImGui::SetNextWindowPos(center, ImGuiCond_Appearing, ImVec2(0.5f, 0.5f));
+        // ôڳʼС
+        ImGui::SetNextWindowSize({size.x, size.y}, ImGuiCond_FirstUseEver);
+    }
+
+    // ƽȴ
+    void ImportProgressView::draw() {
+        auto& assetManager = manager.assetManager;
+        using S = AssetManager::ImportState;
+        // ûеʱ鵼ļǷ޸ģ޸ʱʼ¼
+        if (assetManager.getImportState() == S::IDLING) assetManager.pollChanges();
+        // ûеʱʾȴ
+        if (assetManager.getImportState() == S::IDLING) return;
+
+        ImGui::OpenPopup("Importing Asset");  // 򿪵
+
+        // ʼƵ
+        if (ImGui::BeginPopupModal("Importing Asset", nullptr, 0)) {
+            if (assetManager.getImportState() == S::RUNNING) {
+                // ̨
+                uiContext.state = UIContext::State::HOVER_IMPORT_PROGRESS;
+                ImGui::TextUnformatted(("ڵ: " + assetManager.getImportPath()).c_str());
+                ImGui::ProgressBar(assetManager.getImportProgress());
+                if (ImGui::Button("Cancel")) {
+                    assetManager.cancelImport();
+                }
+            }
+            else if (assetManager.getImportState() == S::FINISH) {
+                // ڽ߳кϲʲ
+                assetManager.finishImport();
+                uiContext.state = UIContext::State::NORMAL;  // ָ״̬
+                ImGui::CloseCurrentPopup();  // رյ
+            }
+            ImGui::EndPopup();
+        }
+    }
+}
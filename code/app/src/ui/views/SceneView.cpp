@@ -57,6 +57,62 @@ namespace NRenderer
         ImGui::InputScalar("Height", ImGuiDataType_U32, &rs.height, &intStep, NULL, "%u");          // Ⱦ߶
         ImGui::InputScalar("Depth", ImGuiDataType_U32, &rs.depth, &intStep, NULL, "%u");            // ׷
         ImGui::InputScalar("Sample Nums", ImGuiDataType_U32, &rs.samplesPerPixel, &intStep, NULL, "%u");  // 
+        ImGui::InputScalar("Threads", ImGuiDataType_U32, &rs.threads, &intStep, NULL, "%u");        // Ⱦ߳0ΪӲ߳
+
+        // شͼѡ
+        const string heatmapStr[5] = {"None", "Cycles", "Rays", "BVH Nodes", "Shader Calls"};
+        int currHeatmap = int(rs.heatmap);
+        if (ImGui::BeginCombo("Heatmap##RenderSettings", heatmapStr[currHeatmap].c_str())) {
+            for (int i=0; i<5; i++) {
+                bool selected = currHeatmap == i;
+                if (ImGui::Selectable((heatmapStr[i]+"##HeatmapItem").c_str(), &selected)) {
+                    rs.heatmap = RenderOption::Heatmap(i);
+                    currHeatmap = i;
+                }
+            }
+            ImGui::EndCombo();
+        }
+        // ͼ·չȾд.pfm.ppm
+        if (rs.heatmap != RenderOption::Heatmap::NONE) {
+            char buf[256];
+            strcpy_s<256>(buf, rs.heatmapOutput.c_str());
+            if (ImGui::InputText("Heatmap File##RenderSettings", buf, 256))
+                rs.heatmapOutput = string(buf);
+        }
+
+        // ѡʺϵͲԤ
+        const string samplerStr[2] = {"Random", "Blue Noise"};
+        int currSampler = int(rs.sampler);
+        if (ImGui::BeginCombo("Sampler##RenderSettings", samplerStr[currSampler].c_str())) {
+            for (int i=0; i<2; i++) {
+                bool selected = currSampler == i;
+                if (ImGui::Selectable((samplerStr[i]+"##SamplerItem").c_str(), &selected)) {
+                    rs.sampler = RenderOption::SamplerMode(i);
+                    currSampler = i;
+                }
+            }
+            ImGui::EndCombo();
+        }
+
+        // ٽṹѡԶʱͼԪֲBVH֮ѡ
+        const string acceleratorStr[3] = {"Auto", "BVH", "Grid"};
+        int currAccelerator = int(rs.accelerator);
+        if (ImGui::BeginCombo("Accelerator##RenderSettings", acceleratorStr[currAccelerator].c_str())) {
+            for (int i=0; i<3; i++) {
+                bool selected = currAccelerator == i;
+                if (ImGui::Selectable((acceleratorStr[i]+"##AcceleratorItem").c_str(), &selected)) {
+                    rs.accelerator = RenderOption::Accelerator(i);
+                    currAccelerator = i;
+                }
+            }
+            ImGui::EndCombo();
+        }
+
+        // ԴɼԻ棬пʡȥ󲿷Ӱ
+        ImGui::Checkbox("Visibility Cache##RenderSettings", &rs.visibilityCache);
+
+        // ƶһ֡ĽͶӰӽǣԤ
+        ImGui::Checkbox("Temporal Reprojection##RenderSettings", &rs.temporal);
     }
 
     // ý
@@ -132,6 +188,8 @@ namespace NRenderer
                 auto& rs = manager.renderSettingsManager;
                 SceneBuilder sceneBuilder{manager.assetManager.asset, rs.renderSettings, rs.ambientSettings, rs.camera};
                 componentManager.exec<RenderComponent>(components[currComponentSelected], sceneBuilder.build());
+                // ֮޸Ⱦĳ¼
+                manager.assetManager.asset.changes.clear();
             }
             else {
                 getServer().logger.error("No render component is selected!");  // δѡȾʱʾ
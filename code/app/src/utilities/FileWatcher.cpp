@@ -0,0 +1,54 @@
+#include "utilities/FileWatcher.hpp"
+
+// ļʵļ
+// ͨѯļ޸ʱ޸
+
+namespace NRenderer
+{
+    using namespace std;
+
+    bool FileWatcher::modifiedTime(const string& path, filesystem::file_time_type& time) {
+        error_code ec;
+        time = filesystem::last_write_time(filesystem::path(path), ec);
+        return !ec;
+    }
+
+    // ʼļ
+    void FileWatcher::watch(const string& path) {
+        filesystem::file_time_type time{};
+        modifiedTime(path, time);
+        for (auto& e : entries) {
+            if (e.path == path) {
+                e.time = time;
+                e.pending = time;
+                return;
+            }
+        }
+        entries.push_back({ path, time, time });
+    }
+
+    // ֹͣļ
+    void FileWatcher::clear() {
+        entries.clear();
+    }
+
+    // ļǷ޸
+    vector<string> FileWatcher::poll() {
+        vector<string> changed{};
+        auto now = chrono::steady_clock::now();
+        if (now - lastPoll < interval) return changed;
+        lastPoll = now;
+        for (auto& e : entries) {
+            filesystem::file_time_type time{};
+            if (!modifiedTime(e.path, time) || time == e.time) continue;
+            // ޸ʱѯ֮䲻ٱ仯ʱΪд
+            if (time != e.pending) {
+                e.pending = time;
+                continue;
+            }
+            e.time = time;
+            changed.push_back(e.path);
+        }
+        return changed;
+    }
+} // namespace NRenderer
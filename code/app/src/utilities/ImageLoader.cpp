@@ -21,6 +21,10 @@ namespace NRenderer
 
 		// ʹstb_imageͼ
 		auto data = stbi_load(file.c_str(), &(image->width), &(image->height), &(image->channel), channel);
+		if (data == nullptr) {
+			delete image;
+			return nullptr;
+		}
 		image->channel = channel;
 
 		// ͼתΪʽ0-1Χ
@@ -0,0 +1,74 @@
+// йߵ
+// ÿȥ֮Ĳ
+#pragma once
+#ifndef __NR_CLI_COMMANDS_HPP__
+#define __NR_CLI_COMMANDS_HPP__
+
+#include <string>
+#include <vector>
+#include <type_traits>
+
+#include "scene/SceneGenerator.hpp"
+
+namespace NRenderer
+{
+    using namespace std;
+    using Arguments = vector<string>;
+
+    // ѹԳ
+    int generateCommand(const Arguments& args);
+    // ߳չԲ
+    int benchCommand(const Arguments& args);
+    // г嵥е
+    int listCommand(const Arguments& args);
+    // ޽Ⱦɳ
+    int renderCommand(const Arguments& args);
+    // ӹڴ֡
+    int watchCommand(const Arguments& args);
+    // ڱ׽ṩȾ
+    int serveCommand(const Arguments& args);
+    // Ⱦύ
+    int submitCommand(const Arguments& args);
+    // ϲζȾĲۻļ
+    int mergeCommand(const Arguments& args);
+
+    // ȡ --key value Ĳ
+    // : Ƿҵò
+    bool findOption(const Arguments& args, const string& key, string& value);
+    // ȡظֵ --key value ȫȡֵ
+    vector<string> findOptions(const Arguments& args, const string& key);
+    // Ƿ --flag Ŀ
+    bool hasFlag(const Arguments& args, const string& flag);
+    // ȡֵδҵʱԭֵ
+    template<typename T>
+    void readOption(const Arguments& args, const string& key, T& value) {
+        string s;
+        if (findOption(args, key, s)) {
+            if constexpr (is_floating_point_v<T>) value = T(stod(s));
+            else value = T(stoull(s, nullptr, 0));
+        }
+    }
+
+    // Զŷָĸ
+    vector<float> parseList(string s);
+
+    // ȡ --sampler random|blue-noise δҵʱԭֵ
+    // : ȡֵǷЧ
+    bool readSamplerOption(const Arguments& args, RenderOption::SamplerMode& mode);
+
+    // ȡ --accelerator auto|bvh|grid δҵʱԭֵ
+    // : ȡֵǷЧ
+    bool readAcceleratorOption(const Arguments& args, RenderOption::Accelerator& accelerator);
+
+    // ȡ --heatmap cycles|rays|nodes|shader-calls δҵʱԭֵ
+    // : ȡֵǷЧ
+    bool readHeatmapOption(const Arguments& args, RenderOption::Heatmap& heatmap);
+
+    // Ӳнɲgenbenchã
+    GeneratorOptions parseGeneratorOptions(const Arguments& args);
+    // ӡɲ˵
+    void generatorOptionsUsage();
+
+}
+
+#endif
@@ -0,0 +1,55 @@
+// ׽֣Unix domain socketļ򵥷װ
+// Windows 10 1803֧֮ͬAF_UNIX˵Ϊһ£漰κ
+#pragma once
+#ifndef __NR_CLI_LOCAL_SOCKET_HPP__
+#define __NR_CLI_LOCAL_SOCKET_HPP__
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+namespace NRenderer
+{
+    using namespace std;
+
+    class LocalSocket
+    {
+    private:
+        intptr_t handle;    // ׽־-1ʾЧ
+        string buffer;      // жȡʱ
+        string lastErrorInfo;
+
+        explicit LocalSocket(intptr_t handle);
+    public:
+        LocalSocket();
+        LocalSocket(const LocalSocket&) = delete;
+        LocalSocket(LocalSocket&& other) noexcept;
+        LocalSocket& operator=(LocalSocket&& other) noexcept;
+        ~LocalSocket();
+
+        // pathϼӣpathѴʱɾ
+        bool listen(const string& path);
+        // һӣʧʱЧ׽
+        LocalSocket accept();
+        // ӵpathϵķ
+        bool connect(const string& path);
+
+        bool valid() const { return handle != -1; }
+        void close();
+
+        // ȫ
+        bool sendAll(const void* data, size_t size);
+        // һıԶ׷ӻУ
+        bool sendLine(const string& line);
+        // ǡsizeֽ
+        bool recvAll(void* data, size_t size);
+        // һıУӹرʱfalse
+        bool recvLine(string& line);
+
+        string getErrorInfo() const {
+            return lastErrorInfo;
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,61 @@
+// ȾͨЭ
+// ıЭ飬ֻгı֡ԶƿڶӦ֮
+//
+// ͻÿһֶΣEndͬһϿύ:
+//   Job
+//   Component <name>
+//   Scene <path>              ˶ȡ.scnļ
+//   Inline <bytes>            bytesֽڵ.scnıMAX_INLINE_SCENE_BYTESʱܾ
+//   Size <width> <height>
+//   Spp <n> / Depth <n> / Threads <n>
+//   Interval <ms>             ͽ֡ļ
+//   Camera <px> <py> <pz> <lx> <ly> <lz> <fov>
+//   Ambient <r> <g> <b>
+//   End
+// ߷һShutdown÷˳
+//
+// ¼ÿ¼һУ:
+//   Accepted <parsed 0|1> <prepared 0|1> <prepareMs>   ıԤǷл棬߶ʱȫ׼
+//   Progress <0-1>
+//   Frame <seq> <changedTiles> <bytes>  bytesֽڵTileStream
+//   Done <renderMs> <frames> <frameBytes>
+//   Error <message>
+#pragma once
+#ifndef __NR_CLI_RENDER_PROTOCOL_HPP__
+#define __NR_CLI_RENDER_PROTOCOL_HPP__
+
+#include <string>
+
+#include "LocalSocket.hpp"
+#include "scene/Scene.hpp"
+
+namespace NRenderer
+{
+    using namespace std;
+
+    // Ĭϵ׽·ǰĿ¼£
+    constexpr const char* DEFAULT_SOCKET_PATH = "nrender.sock";
+    // ıޣⰴеĳֱӷڴ
+    constexpr size_t MAX_INLINE_SCENE_BYTES = size_t(256) << 20;
+
+    // Ⱦ
+    struct RenderJob
+    {
+        string component = "SimplePathTracer";
+        string scenePath;           // ļ·inlineΪtrueʱʹ
+        string sceneText;           // .scnı
+        bool inlineScene = false;
+        RenderOption option;
+        unsigned int interval = 250;    // ͽ֡ļ룩
+        Camera camera;
+        Vec3 ambient = {0, 0, 0};
+    };
+
+    // 
+    bool sendJob(LocalSocket& socket, const RenderJob& job);
+    // ȡJob֮ݣֱEnd
+    // : ǷʽʱerrorΪϢ
+    bool receiveJob(LocalSocket& socket, RenderJob& job, string& error);
+}
+
+#endif
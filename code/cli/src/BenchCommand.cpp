@@ -0,0 +1,280 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <cstdio>
+
+#include "Commands.hpp"
+#include "component/RenderComponent.hpp"
+#include "component/ComponentLoader.hpp"
+#include "server/Server.hpp"
+
+// ߳չԲ
+// Բͬ߳ȾͬһɳٱȡЧʡ߳̿ʱ
+
+namespace NRenderer
+{
+    namespace
+    {
+        // ߳µĲԽ
+        struct BenchResult
+        {
+            unsigned int threads = 0;
+            double wallSeconds = 0.0;
+            double speedup = 0.0;
+            double efficiency = 0.0;
+            double idleMean = 0.0;          // ƽ߳̿ʱ
+            double idleMax = 0.0;           // ߳̿ʱ
+            double imbalance = 0.0;         // ʱ / ƽʱ
+            uint64_t rays = 0;
+            double raysPerSecond = 0.0;
+            string flag = "ok";             // ok / breakdown / plateau
+        };
+
+        void benchUsage() {
+            cout<<"Usage: NRCli bench [options] [scene generator options]"<<endl
+                <<"  --component <name>      ȾĬSimplePathTracer"<<endl
+                <<"  --components-dir <dir>  Ŀ¼Ĭcomponents"<<endl
+                <<"  --threads <list>        ߳б1,2,4,8ĬϵӲ߳2ݣ"<<endl
+                <<"  --repeat <n>            ÿ߳ظȡһΣĬ1"<<endl
+                <<"  --width <n> --height <n> --spp <n> --depth <n>"<<endl
+                <<"                          ȾĬ256x2564spp4"<<endl
+                <<"  --visibility-cache      Դɼ"<<endl
+                <<"  --accelerator <type>    ٽṹautoĬϣbvhgrid"<<endl
+                <<"  --threshold <f>         ЧʵڸֵʱΪbreakdownĬ0.7"<<endl
+                <<"  --label <text>          иĻǩڿڵԱ"<<endl
+                <<"  --format <csv|json>     ʽĬcsv"<<endl
+                <<"  -o <file>               ļĬϱ׼"<<endl;
+            generatorOptionsUsage();
+        }
+
+        vector<unsigned int> parseThreadList(const Arguments& args) {
+            vector<unsigned int> list;
+            string s;
+            if (findOption(args, "--threads", s)) {
+                stringstream ss{s};
+                string item;
+                while (getline(ss, item, ',')) {
+                    if (!item.empty()) list.push_back(max(1u, unsigned(stoul(item))));
+                }
+            }
+            else {
+                unsigned int hw = max(1u, thread::hardware_concurrency());
+                for (unsigned int n = 1; n < hw; n *= 2) list.push_back(n);
+                list.push_back(hw);
+            }
+            sort(list.begin(), list.end());
+            list.erase(unique(list.begin(), list.end()), list.end());
+            return list;
+        }
+
+        // CSVֶΣRFC 4180š˫Żʱ˫ţڲ˫д
+        string csvField(const string& s) {
+            if (s.find_first_of(",\"\r\n") == string::npos) return s;
+            string quoted = "\"";
+            for (char c : s) {
+                if (c == '"') quoted += '"';
+                quoted += c;
+            }
+            return quoted + "\"";
+        }
+
+        // JSONַţת˫šбַ
+        string jsonString(const string& s) {
+            string escaped = "\"";
+            for (char c : s) {
+                switch (c) {
+                case '"': escaped += "\\\""; break;
+                case '\\': escaped += "\\\\"; break;
+                case '\n': escaped += "\\n"; break;
+                case '\r': escaped += "\\r"; break;
+                case '\t': escaped += "\\t"; break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20) {
+                        char buf[8];
+                        snprintf(buf, sizeof(buf), "\\u%04x", unsigned(static_cast<unsigned char>(c)));
+                        escaped += buf;
+                    }
+                    else escaped += c;
+                }
+            }
+            return escaped + "\"";
+        }
+
+        void writeCsv(ostream& os, const string& component, const string& label, const vector<BenchResult>& results) {
+            os<<"label,component,hardware_threads,threads,wall_s,speedup,efficiency,"
+                "idle_mean_s,idle_max_s,imbalance,rays,rays_per_s,flag\n";
+            for (auto& r : results) {
+                os<<csvField(label)<<","<<csvField(component)<<","<<thread::hardware_concurrency()<<","<<r.threads<<","
+                    <<r.wallSeconds<<","<<r.speedup<<","<<r.efficiency<<","
+                    <<r.idleMean<<","<<r.idleMax<<","<<r.imbalance<<","
+                    <<r.rays<<","<<r.raysPerSecond<<","<<r.flag<<"\n";
+            }
+        }
+
+        void writeJson(ostream& os, const string& component, const string& label,
+            const GeneratorOptions& gen, const RenderOption& ro, const vector<BenchResult>& results) {
+            os<<"{\n"
+                <<"  \"label\": "<<jsonString(label)<<",\n"
+                <<"  \"component\": "<<jsonString(component)<<",\n"
+                <<"  \"hardwareThreads\": "<<thread::hardware_concurrency()<<",\n"
+                <<"  \"scene\": { \"seed\": "<<gen.seed<<", \"primitives\": "<<gen.primitiveCount()
+                <<", \"areaLights\": "<<gen.areaLights<<" },\n"
+                <<"  \"render\": { \"width\": "<<ro.width<<", \"height\": "<<ro.height
+                <<", \"samplesPerPixel\": "<<ro.samplesPerPixel<<", \"depth\": "<<ro.depth<<" },\n"
+                <<"  \"results\": [\n";
+            for (size_t i = 0; i < results.size(); i++) {
+                auto& r = results[i];
+                os<<"    { \"threads\": "<<r.threads
+                    <<", \"wallSeconds\": "<<r.wallSeconds
+                    <<", \"speedup\": "<<r.speedup
+                    <<", \"efficiency\": "<<r.efficiency
+                    <<", \"idleMeanSeconds\": "<<r.idleMean
+                    <<", \"idleMaxSeconds\": "<<r.idleMax
+                    <<", \"imbalance\": "<<r.imbalance
+                    <<", \"rays\": "<<r.rays
+                    <<", \"raysPerSecond\": "<<r.raysPerSecond
+                    <<", \"flag\": \""<<r.flag<<"\" }"<<(i + 1 < results.size() ? "," : "")<<"\n";
+            }
+            os<<"  ]\n}\n";
+        }
+    }
+
+    int benchCommand(const Arguments& args) {
+        if (hasFlag(args, "-h") || hasFlag(args, "--help")) {
+            benchUsage();
+            return 1;
+        }
+        string componentName = "SimplePathTracer";
+        string componentsDir = "components";
+        string format = "csv";
+        string output;
+        string label = "local";
+        findOption(args, "--component", componentName);
+        findOption(args, "--components-dir", componentsDir);
+        findOption(args, "--format", format);
+        findOption(args, "--label", label);
+        findOption(args, "-o", output);
+        unsigned int repeat = 1;
+        double threshold = 0.7;
+        readOption(args, "--repeat", repeat);
+        readOption(args, "--threshold", threshold);
+        repeat = max(1u, repeat);
+
+        RenderOption ro;
+        ro.width = 256;
+        ro.height = 256;
+        ro.samplesPerPixel = 4;
+        ro.depth = 4;
+        ro.countRays = true;
+        readOption(args, "--width", ro.width);
+        readOption(args, "--height", ro.height);
+        readOption(args, "--spp", ro.samplesPerPixel);
+        readOption(args, "--depth", ro.depth);
+        ro.visibilityCache = hasFlag(args, "--visibility-cache");
+        if (!readAcceleratorOption(args, ro.accelerator)) {
+            cerr<<"--accelerator expects auto, bvh or grid"<<endl;
+            return 1;
+        }
+
+        auto gen = parseGeneratorOptions(args);
+        auto threadList = parseThreadList(args);
+
+        ComponentLoader loader;
+        loader.init(componentsDir);
+        auto& server = getServer();
+        auto component = server.componentFactory.createComponent<RenderComponent>("Render", componentName);
+        if (component == nullptr) {
+            cerr<<"Render component not found: "<<componentName<<" (searched in "<<componentsDir<<")"<<endl;
+            return 1;
+        }
+
+        vector<BenchResult> results;
+        server.statistics.resetLockStatistics();
+        for (auto n : threadList) {
+            BenchResult best;
+            for (unsigned int k = 0; k < repeat; k++) {
+                // ȾὫ͵ر任꣬ÿζ
+                SceneGenerator generator{gen};
+                auto spScene = generator.generate();
+                spScene->renderOption = ro;
+                spScene->renderOption.threads = n;
+                spScene->camera.aspect = float(ro.width)/float(ro.height);
+
+                auto reported = server.statistics.getRenderCount();
+                auto begin = chrono::steady_clock::now();
+                component->exec([](){}, [](){}, spScene);
+                double measured = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+
+                BenchResult r;
+                r.threads = n;
+                if (server.statistics.getRenderCount() != reported) {
+                    auto stats = server.statistics.getLastRender();
+                    r.wallSeconds = stats.wallSeconds;
+                    r.rays = stats.rays;
+                    double busySum = 0.0, busyMax = 0.0;
+                    for (size_t t = 0; t < stats.threadBusySeconds.size(); t++) {
+                        double idle = stats.idleSeconds(t);
+                        r.idleMean += idle;
+                        r.idleMax = max(r.idleMax, idle);
+                        busySum += stats.threadBusySeconds[t];
+                        busyMax = max(busyMax, stats.threadBusySeconds[t]);
+                    }
+                    if (!stats.threadBusySeconds.empty()) {
+                        r.idleMean /= double(stats.threadBusySeconds.size());
+                        double busyMean = busySum / double(stats.threadBusySeconds.size());
+                        r.imbalance = busyMean > 0.0 ? busyMax / busyMean : 0.0;
+                    }
+                }
+                else {
+                    // ûϱͳƣֻܸ׼ڵܺʱ
+                    if (k == 0) cerr<<"warning: "<<componentName<<" does not report render statistics"<<endl;
+                    r.wallSeconds = measured;
+                }
+                if (best.threads == 0 || r.wallSeconds < best.wallSeconds) best = r;
+            }
+            cerr<<"threads "<<n<<": "<<best.wallSeconds<<" s"<<endl;
+            results.push_back(best);
+        }
+
+        // С߳ĽΪ׼ٱȣչʧЧλ
+        if (!results.empty()) {
+            auto& base = results.front();
+            for (size_t i = 0; i < results.size(); i++) {
+                auto& r = results[i];
+                r.speedup = r.wallSeconds > 0.0 ? base.wallSeconds / r.wallSeconds * base.threads : 0.0;
+                r.efficiency = r.speedup / r.threads;
+                r.raysPerSecond = r.wallSeconds > 0.0 ? double(r.rays) / r.wallSeconds : 0.0;
+                if (r.efficiency < threshold) {
+                    r.flag = "breakdown";
+                }
+                else if (i > 0 && r.speedup < results[i - 1].speedup * 1.1) {
+                    r.flag = "plateau";
+                }
+            }
+        }
+
+        ofstream file;
+        if (!output.empty()) {
+            file.open(output);
+            if (!file.is_open()) {
+                cerr<<"Failed to open "<<output<<" for writing."<<endl;
+                return 1;
+            }
+        }
+        ostream& os = output.empty() ? cout : file;
+        if (format == "json") writeJson(os, componentName, label, gen, ro, results);
+        else writeCsv(os, componentName, label, results);
+
+        // ͳƣNR_LOCK_STATS룩Թ
+        if (server.statistics.lockStatsEnabled()) {
+            cerr<<"lock,acquisitions,contended,wait_s"<<endl;
+            for (auto& l : server.statistics.getLockStatistics()) {
+                cerr<<l.name<<","<<l.acquisitions<<","<<l.contended<<","<<l.waitSeconds<<endl;
+            }
+        }
+        return 0;
+    }
+}
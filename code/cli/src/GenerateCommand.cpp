@@ -0,0 +1,68 @@
+#include <iostream>
+#include <chrono>
+
+#include "Commands.hpp"
+#include "scene/SceneGenerator.hpp"
+
+namespace NRenderer
+{
+    void generatorOptionsUsage() {
+        cout<<"  --seed <n>              ӣĬ20050"<<endl
+            <<"  --extent <f>            ߳Ĭ500"<<endl
+            <<"  --spheres <n>           Ĭ1000"<<endl
+            <<"  --meshes <n>            ϸ"<<endl
+            <<"  --mesh-triangles <n>    ϸ"<<endl
+            <<"  --terrain <n>           "<<endl
+            <<"  --lights <n>            ԴĬ1"<<endl
+            <<"  --grid <x> <y> <z>      ʵߴ"<<endl
+            <<"  --instance-triangles <n> ÿʵĬ80"<<endl
+            <<"  --materials <n>         Ĭ12"<<endl
+            <<"  --lambert-only          ֻʹLambertian"<<endl;
+    }
+
+    GeneratorOptions parseGeneratorOptions(const Arguments& args) {
+        GeneratorOptions options;
+        readOption(args, "--seed", options.seed);
+        readOption(args, "--extent", options.extent);
+        readOption(args, "--spheres", options.spheres);
+        readOption(args, "--meshes", options.meshes);
+        readOption(args, "--mesh-triangles", options.meshTriangles);
+        readOption(args, "--terrain", options.terrainTriangles);
+        readOption(args, "--lights", options.areaLights);
+        readOption(args, "--instance-triangles", options.instanceTriangles);
+        readOption(args, "--materials", options.materials);
+        options.mixedMaterials = !hasFlag(args, "--lambert-only");
+        for (size_t i = 0; i + 3 < args.size(); i++) {
+            if (args[i] == "--grid") {
+                options.gridX = stoul(args[i + 1]);
+                options.gridY = stoul(args[i + 2]);
+                options.gridZ = stoul(args[i + 3]);
+            }
+        }
+        if (options.meshes > 0 && options.meshTriangles == 0) {
+            options.meshTriangles = options.meshes*2000;
+        }
+        return options;
+    }
+
+    int generateCommand(const Arguments& args) {
+        string output;
+        if (hasFlag(args, "-h") || hasFlag(args, "--help") || !findOption(args, "-o", output)) {
+            cout<<"Usage: NRCli gen -o <file.scn> [options]"<<endl;
+            generatorOptionsUsage();
+            return 1;
+        }
+        auto options = parseGeneratorOptions(args);
+
+        auto begin = chrono::steady_clock::now();
+        SceneGenerator generator{options};
+        if (!generator.writeScn(output)) {
+            cerr<<generator.getErrorInfo()<<endl;
+            return 1;
+        }
+        auto ms = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - begin).count();
+        cout<<"Generated "<<output<<": "<<options.primitiveCount()<<" primitives, "
+            <<options.areaLights<<" area lights, seed "<<options.seed<<" ("<<ms<<" ms)"<<endl;
+        return 0;
+    }
+}
@@ -0,0 +1,33 @@
+#include <iostream>
+
+#include "Commands.hpp"
+#include "component/ComponentLoader.hpp"
+
+namespace NRenderer
+{
+    int listCommand(const Arguments& args) {
+        string componentsDir = "components";
+        findOption(args, "--components-dir", componentsDir);
+
+        // 嵥Чʱֻȡ嵥κ
+        // 嵥ֻ--write-manifestʱдĿ¼
+        ComponentLoader loader;
+        loader.init(componentsDir);
+        if (hasFlag(args, "--write-manifest")) {
+            if (!loader.saveManifest()) {
+                cerr<<"Failed to write "<<ComponentLoader::MANIFEST_FILE<<" in "<<componentsDir<<endl;
+                return 1;
+            }
+        }
+        else if (loader.isManifestStale()) {
+            cerr<<"Component manifest is out of date, run 'NRCli list --write-manifest' to update it."<<endl;
+        }
+        for (auto& entry : loader.getManifest()) {
+            cout<<entry.file<<endl;
+            for (auto& ci : entry.components) {
+                cout<<"  "<<ci.type<<"\t"<<ci.name<<endl;
+            }
+        }
+        return 0;
+    }
+}
@@ -0,0 +1,197 @@
+#include "LocalSocket.hpp"
+
+#include <cstring>
+#include <cstdio>
+#include <algorithm>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <afunix.h>
+#else
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace NRenderer
+{
+    namespace
+    {
+#ifdef _WIN32
+        using NativeSocket = SOCKET;
+        // WinsockҪʹǰʼһ
+        bool startup() {
+            static bool ok = [](){
+                WSADATA data;
+                return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+            }();
+            return ok;
+        }
+        void closeNative(intptr_t h) { closesocket(NativeSocket(h)); }
+        constexpr int SEND_FLAGS = 0;
+#else
+        using NativeSocket = int;
+        bool startup() { return true; }
+        void closeNative(intptr_t h) { ::close(int(h)); }
+        // Զ˹رպд벻SIGPIPEֻش
+        constexpr int SEND_FLAGS = MSG_NOSIGNAL;
+#endif
+
+        bool makeAddress(const string& path, sockaddr_un& addr) {
+            memset(&addr, 0, sizeof(addr));
+            addr.sun_family = AF_UNIX;
+            if (path.size() >= sizeof(addr.sun_path)) return false;
+            memcpy(addr.sun_path, path.c_str(), path.size());
+            return true;
+        }
+    }
+
+    LocalSocket::LocalSocket()
+        : handle            (-1)
+        , buffer            ()
+        , lastErrorInfo     ()
+    {}
+
+    LocalSocket::LocalSocket(intptr_t handle)
+        : handle            (handle)
+        , buffer            ()
+        , lastErrorInfo     ()
+    {}
+
+    LocalSocket::LocalSocket(LocalSocket&& other) noexcept
+        : handle            (other.handle)
+        , buffer            (std::move(other.buffer))
+        , lastErrorInfo     (std::move(other.lastErrorInfo))
+    {
+        other.handle = -1;
+    }
+
+    LocalSocket& LocalSocket::operator=(LocalSocket&& other) noexcept {
+        if (this != &other) {
+            close();
+            handle = other.handle;
+            buffer = std::move(other.buffer);
+            lastErrorInfo = std::move(other.lastErrorInfo);
+            other.handle = -1;
+        }
+        return *this;
+    }
+
+    LocalSocket::~LocalSocket() {
+        close();
+    }
+
+    void LocalSocket::close() {
+        if (handle != -1) closeNative(handle);
+        handle = -1;
+        buffer.clear();
+    }
+
+    bool LocalSocket::listen(const string& path) {
+        close();
+        sockaddr_un addr;
+        if (!startup() || !makeAddress(path, addr)) {
+            lastErrorInfo = "Invalid socket path: " + path;
+            return false;
+        }
+        NativeSocket s = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (intptr_t(s) == -1) {
+            lastErrorInfo = "Failed to create socket.";
+            return false;
+        }
+        handle = intptr_t(s);
+        remove(path.c_str());
+        if (::bind(s, (sockaddr*)&addr, sizeof(addr)) != 0 || ::listen(s, 8) != 0) {
+            lastErrorInfo = "Failed to listen on " + path + ".";
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    LocalSocket LocalSocket::accept() {
+        NativeSocket s = ::accept(NativeSocket(handle), nullptr, nullptr);
+        return LocalSocket{intptr_t(s)};
+    }
+
+    bool LocalSocket::connect(const string& path) {
+        close();
+        sockaddr_un addr;
+        if (!startup() || !makeAddress(path, addr)) {
+            lastErrorInfo = "Invalid socket path: " + path;
+            return false;
+        }
+        NativeSocket s = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (intptr_t(s) == -1) {
+            lastErrorInfo = "Failed to create socket.";
+            return false;
+        }
+        handle = intptr_t(s);
+        if (::connect(s, (sockaddr*)&addr, sizeof(addr)) != 0) {
+            lastErrorInfo = "Failed to connect to " + path + ".";
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    bool LocalSocket::sendAll(const void* data, size_t size) {
+        auto p = static_cast<const char*>(data);
+        while (size > 0) {
+            int chunk = int(min<size_t>(size, 1 << 20));
+            auto n = ::send(NativeSocket(handle), p, chunk, SEND_FLAGS);
+            if (n <= 0) {
+                lastErrorInfo = "Connection closed.";
+                return false;
+            }
+            p += n;
+            size -= size_t(n);
+        }
+        return true;
+    }
+
+    bool LocalSocket::sendLine(const string& line) {
+        string s = line + "\n";
+        return sendAll(s.data(), s.size());
+    }
+
+    bool LocalSocket::recvAll(void* data, size_t size) {
+        auto p = static_cast<char*>(data);
+        // İжȡʱ
+        size_t cached = min(size, buffer.size());
+        memcpy(p, buffer.data(), cached);
+        buffer.erase(0, cached);
+        p += cached;
+        size -= cached;
+        while (size > 0) {
+            int chunk = int(min<size_t>(size, 1 << 20));
+            auto n = ::recv(NativeSocket(handle), p, chunk, 0);
+            if (n <= 0) {
+                lastErrorInfo = "Connection closed.";
+                return false;
+            }
+            p += n;
+            size -= size_t(n);
+        }
+        return true;
+    }
+
+    bool LocalSocket::recvLine(string& line) {
+        while (true) {
+            auto pos = buffer.find('\n');
+            if (pos != string::npos) {
+                line = buffer.substr(0, pos);
+                if (!line.empty() && line.back() == '\r') line.pop_back();
+                buffer.erase(0, pos + 1);
+                return true;
+            }
+            char chunk[4096];
+            auto n = ::recv(NativeSocket(handle), chunk, sizeof(chunk), 0);
+            if (n <= 0) {
+                lastErrorInfo = "Connection closed.";
+                return false;
+            }
+            buffer.append(chunk, size_t(n));
+        }
+    }
+}
@@ -0,0 +1,59 @@
+#include <iostream>
+#include <map>
+#include <functional>
+
+#include "Commands.hpp"
+
+using namespace std;
+using namespace NRenderer;
+
+namespace
+{
+    struct Command
+    {
+        function<int(const Arguments&)> entry;
+        string description;
+    };
+
+    const map<string, Command>& commands() {
+        static const map<string, Command> cmds = {
+            {"gen", {generateCommand, "ɳѹԳ(.scn)"}},
+            {"bench", {benchCommand, "Ⱦڲͬ߳µչ"}},
+            {"list", {listCommand, "г嵥е⣩--write-manifestд嵥"}},
+            {"render", {renderCommand, "޽Ⱦɳɾ񵽹ڴ"}},
+            {"watch", {watchCommand, "ӹڴ֡еȾ"}},
+            {"serve", {serveCommand, "ΪȾУ泡ͽ֡"}},
+            {"submit", {submitCommand, "򱾵ȾύȾ"}},
+            {"merge", {mergeCommand, "ϲȾõĲۻļ"}}
+        };
+        return cmds;
+    }
+
+    void usage() {
+        cout<<"Usage: NRCli <command> [options]"<<endl<<endl;
+        for (auto& [name, cmd] : commands()) {
+            cout<<"  "<<name<<"\t"<<cmd.description<<endl;
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        usage();
+        return 1;
+    }
+    auto it = commands().find(argv[1]);
+    if (it == commands().end()) {
+        cerr<<"Unknown command: "<<argv[1]<<endl;
+        usage();
+        return 1;
+    }
+    Arguments args{argv + 2, argv + argc};
+    try {
+        return it->second.entry(args);
+    }
+    catch (const exception& e) {
+        cerr<<e.what()<<endl;
+        return 1;
+    }
+}
@@ -0,0 +1,88 @@
+#include <iostream>
+#include <cstdio>
+
+#include "Commands.hpp"
+#include "server/AccumulationBuffer.hpp"
+
+namespace NRenderer
+{
+    namespace
+    {
+        void mergeUsage() {
+            cout<<"Usage: NRCli merge -o <image.ppm> [options] <a.nracc> <b.nracc> ..."<<endl
+                <<"  --acc <file>            ͬʱдϲۻļΪϲ"<<endl
+                <<"  --variance <file.pfm>   дÿطͼ"<<endl
+                <<"Ҫʹͬĳֱʡͬ--sample-seedȾ"<<endl;
+        }
+
+        bool writePpm(const string& path, const vector<RGBA>& pixels, unsigned int w, unsigned int h) {
+            FILE* file = fopen(path.c_str(), "wb");
+            if (file == nullptr) return false;
+            fprintf(file, "P6\n%u %u\n255\n", w, h);
+            for (auto& p : pixels) {
+                auto c = RGBA2RGBAi(p);
+                unsigned char rgb[3] = { (unsigned char)c.r, (unsigned char)c.g, (unsigned char)c.b };
+                fwrite(rgb, 1, 3, file);
+            }
+            bool ok = ferror(file) == 0;
+            fclose(file);
+            return ok;
+        }
+    }
+
+    int mergeCommand(const Arguments& args) {
+        string output, accOutput, varianceOutput;
+        bool hasOutput = findOption(args, "-o", output);
+        bool hasAcc = findOption(args, "--acc", accOutput);
+        bool hasVariance = findOption(args, "--variance", varianceOutput);
+
+        // ѡȡֵĲļ
+        vector<string> inputs;
+        for (size_t i = 0; i < args.size(); i++) {
+            if (args[i] == "-o" || args[i] == "--acc" || args[i] == "--variance") i++;
+            else inputs.push_back(args[i]);
+        }
+        if (hasFlag(args, "-h") || hasFlag(args, "--help") || inputs.empty() || (!hasOutput && !hasAcc)) {
+            mergeUsage();
+            return 1;
+        }
+
+        AccumulationBuffer merged{};
+        for (auto& input : inputs) {
+            AccumulationBuffer buffer{};
+            if (!buffer.read(input)) {
+                cerr<<"Failed to read "<<input<<endl;
+                return 1;
+            }
+            if (merged.empty()) {
+                merged = move(buffer);
+            }
+            else if (!merged.merge(buffer)) {
+                cerr<<"Size mismatch: "<<input<<" is "<<buffer.getWidth()<<"x"<<buffer.getHeight()
+                    <<", expected "<<merged.getWidth()<<"x"<<merged.getHeight()<<endl;
+                return 1;
+            }
+        }
+
+        unsigned int w = merged.getWidth(), h = merged.getHeight();
+        if (hasOutput && !writePpm(output, merged.resolve(), w, h)) {
+            cerr<<"Failed to write "<<output<<endl;
+            return 1;
+        }
+        if (hasAcc && !merged.write(accOutput)) {
+            cerr<<"Failed to write "<<accOutput<<endl;
+            return 1;
+        }
+        if (hasVariance && !merged.writeVariancePfm(varianceOutput)) {
+            cerr<<"Failed to write "<<varianceOutput<<endl;
+            return 1;
+        }
+        uint64_t samples = 0;
+        for (unsigned int i = 0; i < h; i++) {
+            for (unsigned int j = 0; j < w; j++) samples += merged.count(i, j);
+        }
+        cout<<"Merged "<<inputs.size()<<" files ("<<w<<"x"<<h<<", "
+            <<(w*h > 0 ? double(samples)/double(size_t(w)*h) : 0.0)<<" spp)"<<endl;
+        return 0;
+    }
+}
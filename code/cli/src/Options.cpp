@@ -0,0 +1,71 @@
+#include "Commands.hpp"
+
+#include <sstream>
+#include <algorithm>
+
+namespace NRenderer
+{
+    bool findOption(const Arguments& args, const string& key, string& value) {
+        for (size_t i = 0; i + 1 < args.size(); i++) {
+            if (args[i] == key) {
+                value = args[i + 1];
+                return true;
+            }
+        }
+        return false;
+    }
+
+    vector<string> findOptions(const Arguments& args, const string& key) {
+        vector<string> values;
+        for (size_t i = 0; i + 1 < args.size(); i++) {
+            if (args[i] == key) values.push_back(args[++i]);
+        }
+        return values;
+    }
+
+    bool hasFlag(const Arguments& args, const string& flag) {
+        for (auto& arg : args) {
+            if (arg == flag) return true;
+        }
+        return false;
+    }
+
+    vector<float> parseList(string s) {
+        replace(s.begin(), s.end(), ',', ' ');
+        istringstream ss{s};
+        vector<float> values;
+        float v;
+        while (ss>>v) values.push_back(v);
+        return values;
+    }
+
+    bool readSamplerOption(const Arguments& args, RenderOption::SamplerMode& mode) {
+        string s;
+        if (!findOption(args, "--sampler", s)) return true;
+        if (s == "random") mode = RenderOption::SamplerMode::RANDOM;
+        else if (s == "blue-noise") mode = RenderOption::SamplerMode::BLUE_NOISE;
+        else return false;
+        return true;
+    }
+
+    bool readAcceleratorOption(const Arguments& args, RenderOption::Accelerator& accelerator) {
+        string s;
+        if (!findOption(args, "--accelerator", s)) return true;
+        if (s == "auto") accelerator = RenderOption::Accelerator::AUTO;
+        else if (s == "bvh") accelerator = RenderOption::Accelerator::BVH;
+        else if (s == "grid") accelerator = RenderOption::Accelerator::GRID;
+        else return false;
+        return true;
+    }
+
+    bool readHeatmapOption(const Arguments& args, RenderOption::Heatmap& heatmap) {
+        string s;
+        if (!findOption(args, "--heatmap", s)) return true;
+        if (s == "cycles") heatmap = RenderOption::Heatmap::CYCLES;
+        else if (s == "rays") heatmap = RenderOption::Heatmap::RAYS;
+        else if (s == "nodes") heatmap = RenderOption::Heatmap::NODES;
+        else if (s == "shader-calls") heatmap = RenderOption::Heatmap::SHADER_CALLS;
+        else return false;
+        return true;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,247 @@
+#include <iostream>
+#include <cstdio>
+#include <chrono>
+
+#include "Commands.hpp"
+#include "component/RenderComponent.hpp"
+#include "component/ComponentLoader.hpp"
+#include "server/Server.hpp"
+
+namespace NRenderer
+{
+    namespace
+    {
+        void renderUsage() {
+            cout<<"Usage: NRCli render [-o <image.ppm>] [--acc <file.nracc>] [--bake <file.nrbake>] [options] [scene generator options]"<<endl
+                <<"  --component <name>      ȾĬSimplePathTracer"<<endl
+                <<"  --components-dir <dir>  Ŀ¼Ĭcomponents"<<endl
+                <<"  --width <n> --height <n> --spp <n> --depth <n> --threads <n>"<<endl
+                <<"  --mirror <name>         Ļ񵽾ڴ"<<endl
+                <<"  --preview-ms <n>        ȾˢĻļĬϿʱΪ500"<<endl
+                <<"  --sampler <mode>        randomĬϣblue-noiseʺϵͲԤ"<<endl
+                <<"  --visibility-cache      ԴɼԣȷӰ"<<endl
+                <<"  --accelerator <type>    ٽṹautoĬϣͼԪֲѡ񣩡bvhgrid"<<endl
+                <<"  --sample-seed <n>       ӣĬϰʱ䣩Ⱦʱÿʹòͬ"<<endl
+                <<"  --heatmap <type>        ¼شͼcyclesraysnodesshader-calls"<<endl
+                <<"  --heatmap-output <path> ͼ·չд.pfm.ppm"<<endl
+                <<"                          ĬΪļȥչ󸽼_heatmap_<type>"<<endl
+                <<"  --acc <file>            дÿزۻļNRCli mergeϲ"<<endl
+                <<"  --bake <file>           Ⱦǰȡ決նļʱ決½ʱд"<<endl
+                <<"                          IrradianceBake決RayCastʾȫֹ"<<endl
+                <<"ӽǣһȾӽǣóԤȾ̣߳-oļ󸽼ӽ:"<<endl
+                <<"  --view <px,py,pz,lx,ly,lz[,fov]>  ظӽΪţ--accֻ¼һӽ"<<endl
+                <<"  --stereo <separation>   ԳΪġƽƵƽԣleftright"<<endl
+                <<"  --cubemap               ڳλȾͼ棨pxnxpynypznzҪͬ"<<endl;
+            generatorOptionsUsage();
+        }
+
+        bool writePpm(const string& path, const RGBA* pixels, unsigned int w, unsigned int h) {
+            FILE* file = fopen(path.c_str(), "wb");
+            if (file == nullptr) return false;
+            fprintf(file, "P6\n%u %u\n255\n", w, h);
+            for (size_t i = 0; i < size_t(w)*h; i++) {
+                auto c = RGBA2RGBAi(pixels[i]);
+                unsigned char rgb[3] = { (unsigned char)c.r, (unsigned char)c.g, (unsigned char)c.b };
+                fwrite(rgb, 1, 3, file);
+            }
+            bool ok = ferror(file) == 0;
+            fclose(file);
+            return ok;
+        }
+
+        bool writePpm(const string& path, const Screen& screen) {
+            return writePpm(path, screen.getPixels(), screen.getWidth(), screen.getHeight());
+        }
+
+        // չ֮ǰӽout.ppmleftõout_left.ppm
+        string viewPath(const string& path, const string& name) {
+            auto dot = path.find_last_of('.');
+            auto slash = path.find_last_of("/\\");
+            if (dot == string::npos || (slash != string::npos && dot < slash)) return path + "_" + name;
+            return path.substr(0, dot) + "_" + name + path.substr(dot);
+        }
+
+        // ȥչ󸽼ͼͣout.ppmraysõout_heatmap_rays
+        string heatmapPath(const string& path, const string& type) {
+            auto dot = path.find_last_of('.');
+            auto slash = path.find_last_of("/\\");
+            string stem = dot == string::npos || (slash != string::npos && dot < slash) ? path : path.substr(0, dot);
+            return stem + "_heatmap_" + type;
+        }
+
+        // ӽǲдscene.viewsӽǵ
+        // : ǷЧЧʱӡ
+        bool parseViews(const Arguments& args, Scene& scene, vector<string>& names) {
+            const Camera& base = scene.camera;
+            for (auto& s : findOptions(args, "--view")) {
+                auto v = parseList(s);
+                if (v.size() < 6) {
+                    cerr<<"--view expects px,py,pz,lx,ly,lz[,fov]"<<endl;
+                    return false;
+                }
+                Camera view = base;
+                view.position = {v[0], v[1], v[2]};
+                view.lookAt = {v[3], v[4], v[5]};
+                if (v.size() > 6) view.fov = v[6];
+                names.push_back(to_string(scene.views.size()));
+                scene.views.push_back(view);
+            }
+            string s;
+            if (findOption(args, "--stereo", s)) {
+                auto v = parseList(s);
+                if (v.size() != 1) {
+                    cerr<<"--stereo expects the eye separation"<<endl;
+                    return false;
+                }
+                float separation = v[0];
+                // ·׷ҷһ
+                Vec3 right = glm::normalize(glm::cross(base.up, base.position - base.lookAt));
+                for (float side : { -0.5f, 0.5f }) {
+                    Camera eye = base;
+                    eye.position += right*separation*side;
+                    eye.lookAt += right*separation*side;
+                    scene.views.push_back(eye);
+                }
+                names.push_back("left");
+                names.push_back("right");
+            }
+            if (hasFlag(args, "--cubemap")) {
+                if (scene.renderOption.width != scene.renderOption.height) {
+                    cerr<<"--cubemap expects equal --width and --height"<<endl;
+                    return false;
+                }
+                // ֱzΪϷ
+                const Vec3 directions[] = { {1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1} };
+                const Vec3 ups[] = { {0, 1, 0}, {0, 1, 0}, {0, 0, -1}, {0, 0, 1}, {0, 1, 0}, {0, 1, 0} };
+                const char* faces[] = { "px", "nx", "py", "ny", "pz", "nz" };
+                for (int i = 0; i < 6; i++) {
+                    Camera face = base;
+                    face.lookAt = base.position + directions[i];
+                    face.up = ups[i];
+                    face.fov = 90.f;
+                    face.aperture = 0.f;
+                    scene.views.push_back(face);
+                    names.push_back(faces[i]);
+                }
+            }
+            for (auto& view : scene.views) view.aspect = base.aspect;
+            return true;
+        }
+    }
+
+    int renderCommand(const Arguments& args) {
+        string output, accOutput, bakePath;
+        bool hasOutput = findOption(args, "-o", output);
+        bool hasAcc = findOption(args, "--acc", accOutput);
+        bool hasBake = findOption(args, "--bake", bakePath);
+        if (hasFlag(args, "-h") || hasFlag(args, "--help") || (!hasOutput && !hasAcc && !hasBake)) {
+            renderUsage();
+            return 1;
+        }
+        string componentName = "SimplePathTracer";
+        string componentsDir = "components";
+        string mirrorName;
+        findOption(args, "--component", componentName);
+        findOption(args, "--components-dir", componentsDir);
+        bool mirror = findOption(args, "--mirror", mirrorName);
+
+        auto gen = parseGeneratorOptions(args);
+        SceneGenerator generator{gen};
+        auto spScene = generator.generate();
+        auto& ro = spScene->renderOption;
+        readOption(args, "--width", ro.width);
+        readOption(args, "--height", ro.height);
+        readOption(args, "--spp", ro.samplesPerPixel);
+        readOption(args, "--depth", ro.depth);
+        readOption(args, "--threads", ro.threads);
+        ro.previewInterval = mirror ? 500 : 0;
+        readOption(args, "--preview-ms", ro.previewInterval);
+        readOption(args, "--sample-seed", ro.sampleSeed);
+        if (!readSamplerOption(args, ro.sampler)) {
+            cerr<<"--sampler expects random or blue-noise"<<endl;
+            return 1;
+        }
+        if (!readAcceleratorOption(args, ro.accelerator)) {
+            cerr<<"--accelerator expects auto, bvh or grid"<<endl;
+            return 1;
+        }
+        if (!readHeatmapOption(args, ro.heatmap)) {
+            cerr<<"--heatmap expects cycles, rays, nodes or shader-calls"<<endl;
+            return 1;
+        }
+        if (ro.heatmap != RenderOption::Heatmap::NONE && !findOption(args, "--heatmap-output", ro.heatmapOutput)) {
+            string type;
+            findOption(args, "--heatmap", type);
+            ro.heatmapOutput = heatmapPath(hasOutput ? output : (hasAcc ? accOutput : bakePath), type);
+        }
+        ro.visibilityCache = hasFlag(args, "--visibility-cache");
+        ro.accumulate = hasAcc;
+        spScene->camera.aspect = float(ro.width)/float(ro.height);
+        vector<string> viewNames;
+        if (!parseViews(args, *spScene, viewNames)) return 1;
+
+        auto& server = getServer();
+        if (mirror && !server.screen.enableMirror(mirrorName)) {
+            cerr<<"Failed to create shared frame buffer "<<mirrorName<<endl;
+            return 1;
+        }
+
+        ComponentLoader loader;
+        loader.init(componentsDir);
+        auto component = server.componentFactory.createComponent<RenderComponent>("Render", componentName);
+        if (component == nullptr) {
+            cerr<<"Render component not found: "<<componentName<<" (searched in "<<componentsDir<<")"<<endl;
+            return 1;
+        }
+
+        if (hasBake) {
+            auto baked = make_shared<BakedIrradiance>();
+            if (baked->read(bakePath)) server.irradiance.restore(baked);
+        }
+
+        server.views.clear();
+        auto begin = chrono::steady_clock::now();
+        component->exec([](){}, [](){}, spScene);
+        auto seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+
+        if (!spScene->views.empty()) {
+            if (server.views.size() != spScene->views.size()) {
+                cerr<<componentName<<" does not support multi-view rendering"<<endl;
+                return 1;
+            }
+            // ֻһӽʱֱд-oָļ
+            for (size_t i = 0; hasOutput && i < server.views.size(); i++) {
+                string path = server.views.size() == 1 ? output : viewPath(output, viewNames[i]);
+                if (!writePpm(path, server.views[i].data(), ro.width, ro.height)) {
+                    cerr<<"Failed to write "<<path<<endl;
+                    return 1;
+                }
+            }
+        }
+        else if (hasOutput && !writePpm(output, server.screen)) {
+            cerr<<"Failed to write "<<output<<endl;
+            return 1;
+        }
+        if (hasAcc) {
+            if (server.accumulation.empty()) {
+                cerr<<componentName<<" does not support accumulation output"<<endl;
+                return 1;
+            }
+            if (!server.accumulation.write(accOutput)) {
+                cerr<<"Failed to write "<<accOutput<<endl;
+                return 1;
+            }
+        }
+        if (hasBake) {
+            auto baked = server.irradiance.takeUnsaved();
+            if (baked != nullptr && !baked->write(bakePath)) {
+                cerr<<"Failed to write "<<bakePath<<endl;
+                return 1;
+            }
+        }
+        cout<<"Rendered "<<(hasOutput ? output : (hasAcc ? accOutput : bakePath));
+        if (spScene->views.size() > 1) cout<<" ("<<spScene->views.size()<<" views)";
+        cout<<" ("<<ro.width<<"x"<<ro.height<<", "<<ro.samplesPerPixel<<" spp) in "<<seconds<<" s"<<endl;
+        return 0;
+    }
+}
@@ -0,0 +1,114 @@
+#include "RenderProtocol.hpp"
+
+#include <sstream>
+
+namespace NRenderer
+{
+    namespace
+    {
+        string vec3ToString(const Vec3& v) {
+            ostringstream ss;
+            ss.precision(9);
+            ss<<v.x<<" "<<v.y<<" "<<v.z;
+            return ss.str();
+        }
+    }
+
+    bool sendJob(LocalSocket& socket, const RenderJob& job) {
+        const auto& ro = job.option;
+        const auto& c = job.camera;
+        ostringstream ss;
+        ss.precision(9);
+        ss<<"Job\n"
+          <<"Component "<<job.component<<"\n";
+        if (job.inlineScene) ss<<"Inline "<<job.sceneText.size()<<"\n"<<job.sceneText;
+        else ss<<"Scene "<<job.scenePath<<"\n";
+        ss<<"Size "<<ro.width<<" "<<ro.height<<"\n"
+          <<"Spp "<<ro.samplesPerPixel<<"\n"
+          <<"Depth "<<ro.depth<<"\n"
+          <<"Threads "<<ro.threads<<"\n"
+          <<"Sampler "<<int(ro.sampler)<<"\n"
+          <<"VisibilityCache "<<int(ro.visibilityCache)<<"\n"
+          <<"Temporal "<<int(ro.temporal)<<"\n"
+          <<"Accelerator "<<int(ro.accelerator)<<"\n"
+          <<"Interval "<<job.interval<<"\n"
+          <<"Camera "<<vec3ToString(c.position)<<" "<<vec3ToString(c.lookAt)<<" "<<c.fov<<"\n"
+          <<"Ambient "<<vec3ToString(job.ambient)<<"\n"
+          <<"End\n";
+        auto s = ss.str();
+        return socket.sendAll(s.data(), s.size());
+    }
+
+    bool receiveJob(LocalSocket& socket, RenderJob& job, string& error) {
+        string line;
+        while (socket.recvLine(line)) {
+            istringstream ss{line};
+            string key;
+            ss>>key;
+            auto& ro = job.option;
+            if (key == "End") return true;
+            else if (key == "Component") ss>>job.component;
+            else if (key == "Scene") {
+                job.inlineScene = false;
+                getline(ss>>ws, job.scenePath);
+            }
+            else if (key == "Inline") {
+                size_t bytes = 0;
+                ss>>bytes;
+                if (ss.fail()) {
+                    error = "Invalid request line: " + line;
+                    return false;
+                }
+                if (bytes > MAX_INLINE_SCENE_BYTES) {
+                    error = "Inline scene too large: " + to_string(bytes) + " bytes (limit "
+                        + to_string(MAX_INLINE_SCENE_BYTES) + ").";
+                    return false;
+                }
+                job.inlineScene = true;
+                job.sceneText.resize(bytes);
+                if (bytes > 0 && !socket.recvAll(&job.sceneText[0], bytes)) break;
+            }
+            else if (key == "Size") ss>>ro.width>>ro.height;
+            else if (key == "Spp") ss>>ro.samplesPerPixel;
+            else if (key == "Depth") ss>>ro.depth;
+            else if (key == "Threads") ss>>ro.threads;
+            else if (key == "Sampler") {
+                int sampler = 0;
+                ss>>sampler;
+                ro.sampler = RenderOption::SamplerMode(sampler);
+            }
+            else if (key == "VisibilityCache") {
+                int enabled = 0;
+                ss>>enabled;
+                ro.visibilityCache = enabled != 0;
+            }
+            else if (key == "Temporal") {
+                int enabled = 0;
+                ss>>enabled;
+                ro.temporal = enabled != 0;
+            }
+            else if (key == "Accelerator") {
+                int accelerator = 0;
+                ss>>accelerator;
+                ro.accelerator = RenderOption::Accelerator(accelerator);
+            }
+            else if (key == "Interval") ss>>job.interval;
+            else if (key == "Camera") {
+                auto& c = job.camera;
+                ss>>c.position.x>>c.position.y>>c.position.z>>c.lookAt.x>>c.lookAt.y>>c.lookAt.z>>c.fov;
+            }
+            else if (key == "Ambient") ss>>job.ambient.x>>job.ambient.y>>job.ambient.z;
+            else if (key == "") continue;
+            else {
+                error = "Unknown request field: " + key;
+                return false;
+            }
+            if (ss.fail()) {
+                error = "Invalid request line: " + line;
+                return false;
+            }
+        }
+        error = "Connection closed.";
+        return false;
+    }
+}
@@ -0,0 +1,270 @@
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <list>
+#include <filesystem>
+#include <cstdio>
+
+#include "Commands.hpp"
+#include "RenderProtocol.hpp"
+#include "component/RenderComponent.hpp"
+#include "component/ComponentLoader.hpp"
+#include "scene/ScnParser.hpp"
+#include "server/Server.hpp"
+#include "server/TileStream.hpp"
+
+namespace NRenderer
+{
+    namespace
+    {
+        // 󳡾Ļ棬ʹõǰ
+        // ļ·С޸ʱıFNV-1aϣ
+        class SceneCache
+        {
+        private:
+            struct Entry
+            {
+                string key;
+                SharedScene scene;
+            };
+            list<Entry> entries;
+            size_t capacity;
+        public:
+            explicit SceneCache(size_t capacity)
+                : entries           ()
+                , capacity          (capacity)
+            {}
+            SharedScene find(const string& key) {
+                for (auto it = entries.begin(); it != entries.end(); ++it) {
+                    if (it->key == key) {
+                        entries.splice(entries.begin(), entries, it);
+                        return entries.front().scene;
+                    }
+                }
+                return nullptr;
+            }
+            void insert(const string& key, SharedScene scene) {
+                entries.push_front({key, scene});
+                if (entries.size() > capacity) entries.pop_back();
+            }
+        };
+
+        uint64_t fnv1a(const string& s) {
+            uint64_t h = 14695981039346656037ull;
+            for (unsigned char c : s) {
+                h ^= c;
+                h *= 1099511628211ull;
+            }
+            return h;
+        }
+
+        // 񳡾Ļ
+        // : Ƿɹļʱfalse
+        bool sceneKey(const RenderJob& job, string& key) {
+            if (job.inlineScene) {
+                char buf[32];
+                snprintf(buf, sizeof(buf), "%016llx", (unsigned long long)fnv1a(job.sceneText));
+                key = string("inline:") + buf + ":" + to_string(job.sceneText.size());
+                return true;
+            }
+            error_code ec;
+            auto size = filesystem::file_size(job.scenePath, ec);
+            if (ec) return false;
+            auto time = filesystem::last_write_time(job.scenePath, ec);
+            if (ec) return false;
+            key = "file:" + filesystem::absolute(job.scenePath).string() + ":" + to_string(size)
+                + ":" + to_string(time.time_since_epoch().count());
+            return true;
+        }
+
+        double millisecondsSince(chrono::steady_clock::time_point begin) {
+            return chrono::duration<double, milli>(chrono::steady_clock::now() - begin).count();
+        }
+
+        // Ⱦ
+        // ˳ִУĻΪȫΨһȾڹ߳нУ̰߳ͽ֡
+        class RenderService
+        {
+        private:
+            SceneCache cache;
+            bool running;
+            unsigned int jobCount;
+
+            // һֻ֡һ֡仯Ŀ
+            bool sendFrame(LocalSocket& client, TileEncoder& encoder, unsigned int seq, size_t& bytes) {
+                vector<RGBA> pixels;
+                unsigned int w = 0, h = 0;
+                getServer().screen.copyPixels(pixels, w, h);
+                unsigned int tiles = 0;
+                auto data = encoder.encode(pixels.data(), w, h, tiles);
+                bytes += data.size();
+                return client.sendLine("Frame " + to_string(seq) + " " + to_string(tiles) + " " + to_string(data.size()))
+                    && client.sendAll(data.data(), data.size());
+            }
+
+            // ִһ
+            // : ͻ˵ǷȻ
+            bool runJob(LocalSocket& client, const RenderJob& job) {
+                auto begin = chrono::steady_clock::now();
+                jobCount++;
+
+                string key;
+                if (!sceneKey(job, key)) {
+                    return client.sendLine("Error File does not exist!");
+                }
+                auto parsed = cache.find(key);
+                bool cached = parsed != nullptr;
+                if (!cached) {
+                    ScnParser parser;
+                    parsed = job.inlineScene ? parser.parseText(job.sceneText) : parser.parseFile(job.scenePath);
+                    if (parsed == nullptr) {
+                        return client.sendLine("Error " + parser.getErrorInfo());
+                    }
+                    cache.insert(key, parsed);
+                }
+                auto& server = getServer();
+                auto component = server.componentFactory.createComponent<RenderComponent>("Render", job.component);
+                if (component == nullptr) {
+                    return client.sendLine("Error Render component not found: " + job.component);
+                }
+
+                // ޸ĳΣִУֱڻĳñѡ
+                auto spScene = parsed;
+                spScene->renderOption = job.option;
+                spScene->renderOption.previewInterval = job.interval;
+                spScene->camera = job.camera;
+                spScene->camera.aspect = float(job.option.width)/float(job.option.height);
+                spScene->ambient.type = Ambient::Type::CONSTANT;
+                spScene->ambient.constant = job.ambient;
+
+                // ڷȡԤ꼸ٽṹӻеõͬһ
+                // ʱظȫ׼
+                auto hits = server.preparedScenes.getHits();
+                auto prepared = server.preparedScenes.acquire(*spScene);
+                bool preparedCached = server.preparedScenes.getHits() != hits;
+
+                double prepareMs = millisecondsSince(begin);
+                bool connected = client.sendLine("Accepted " + to_string(cached ? 1 : 0) + " " + to_string(preparedCached ? 1 : 0)
+                    + " " + to_string(prepareMs));
+
+                // һµĸ±־
+                vector<RGBA> discard;
+                unsigned int w, h;
+                server.screen.copyPixels(discard, w, h);
+
+                auto renderBegin = chrono::steady_clock::now();
+                atomic<bool> finished{false};
+                string renderError;
+                thread worker([&]() {
+                    try {
+                        component->exec([](){}, [](){}, spScene);
+                    }
+                    catch (const exception& e) {
+                        renderError = e.what();
+                    }
+                    catch (...) {
+                        renderError = "Render component failed.";
+                    }
+                    finished = true;
+                });
+
+                TileEncoder encoder;
+                unsigned int frames = 0;
+                size_t frameBytes = 0;
+                auto interval = chrono::milliseconds(max(job.interval, 10u));
+                auto last = chrono::steady_clock::now();
+                while (!finished) {
+                    this_thread::sleep_for(chrono::milliseconds(5));
+                    if (!connected) continue;
+                    // һ֡ĴԤһ־ͷͣȴˢ¼֮󰴼
+                    bool firstFrame = frames == 0 && server.screen.isUpdated();
+                    if (!firstFrame && chrono::steady_clock::now() - last < interval) continue;
+                    last = chrono::steady_clock::now();
+                    connected = client.sendLine("Progress " + to_string(server.statistics.getProgress()));
+                    if (connected && server.screen.isUpdated()) {
+                        connected = sendFrame(client, encoder, frames++, frameBytes);
+                    }
+                }
+                worker.join();
+                double renderMs = millisecondsSince(renderBegin);
+                if (connected && renderError.empty()) {
+                    connected = sendFrame(client, encoder, frames++, frameBytes);
+                }
+
+                cout<<"job "<<jobCount<<": "<<job.component<<" "<<(job.inlineScene ? string("<inline>") : job.scenePath)
+                    <<(cached ? " (cached scene)" : "")<<(preparedCached ? " (cached preparation)" : "")<<", prepare "<<prepareMs<<" ms, render "<<renderMs<<" ms, "
+                    <<frames<<" frames, "<<frameBytes<<" bytes"<<endl;
+                if (!connected) return false;
+                if (!renderError.empty()) return client.sendLine("Error " + renderError);
+                return client.sendLine("Done " + to_string(renderMs) + " " + to_string(frames) + " " + to_string(frameBytes));
+            }
+
+            // һϵȫ
+            void serveClient(LocalSocket& client) {
+                string line;
+                while (client.recvLine(line)) {
+                    if (line == "Job") {
+                        RenderJob job;
+                        string error;
+                        if (!receiveJob(client, job, error)) {
+                            client.sendLine("Error " + error);
+                            return;
+                        }
+                        if (!runJob(client, job)) return;
+                    }
+                    else if (line == "Shutdown") {
+                        running = false;
+                        return;
+                    }
+                    else if (!line.empty()) {
+                        client.sendLine("Error Unknown request: " + line);
+                        return;
+                    }
+                }
+            }
+        public:
+            RenderService()
+                : cache             (4)
+                , running           (true)
+                , jobCount          (0)
+            {}
+
+            int run(LocalSocket& listener) {
+                while (running) {
+                    auto client = listener.accept();
+                    if (!client.valid()) continue;
+                    serveClient(client);
+                }
+                return 0;
+            }
+        };
+    }
+
+    int serveCommand(const Arguments& args) {
+        if (hasFlag(args, "-h") || hasFlag(args, "--help")) {
+            cout<<"Usage: NRCli serve [--socket <path>] [--components-dir <dir>]"<<endl
+                <<"  ڱ׽ṩȾʹNRCli submitύ"<<endl;
+            return 1;
+        }
+        string socketPath = DEFAULT_SOCKET_PATH;
+        string componentsDir = "components";
+        findOption(args, "--socket", socketPath);
+        findOption(args, "--components-dir", componentsDir);
+
+        ComponentLoader loader;
+        loader.init(componentsDir);
+
+        LocalSocket listener;
+        if (!listener.listen(socketPath)) {
+            cerr<<listener.getErrorInfo()<<endl;
+            return 1;
+        }
+        cout<<"Listening on "<<socketPath<<endl;
+        RenderService service;
+        int ret = service.run(listener);
+        listener.close();
+        remove(socketPath.c_str());
+        return ret;
+    }
+}
@@ -0,0 +1,188 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <cstdio>
+
+#include "Commands.hpp"
+#include "RenderProtocol.hpp"
+#include "server/TileStream.hpp"
+
+namespace NRenderer
+{
+    namespace
+    {
+        void submitUsage() {
+            cout<<"Usage: NRCli submit (--scene <file.scn> | --inline <file.scn>) [options]"<<endl
+                <<"       NRCli submit --shutdown [--socket <path>]"<<endl
+                <<"  --socket <path>         ׽·Ĭ"<<DEFAULT_SOCKET_PATH<<""<<endl
+                <<"  --scene <file.scn>      ɷȡĳļ"<<endl
+                <<"  --inline <file.scn>     ȡļ"<<endl
+                <<"  --component <name>      ȾĬSimplePathTracer"<<endl
+                <<"  --width <n> --height <n> --spp <n> --depth <n> --threads <n>"<<endl
+                <<"  --sampler <mode>        randomĬϣblue-noise"<<endl
+                <<"  --visibility-cache      Դɼ"<<endl
+                <<"  --accelerator <type>    ٽṹautoĬϣbvhgrid"<<endl
+                <<"  --temporal              һ֡ĽͶӰϣύƶ"<<endl
+                <<"  --camera <px,py,pz,lx,ly,lz[,fov]>"<<endl
+                <<"  --ambient <r,g,b>"<<endl
+                <<"  --interval <ms>         ֡ͼĬ250"<<endl
+                <<"  --repeat <n>            ͬһظύn"<<endl
+                <<"  -o <image.ppm>          յ֡"<<endl;
+        }
+
+        bool writePpm(const string& path, const TileDecoder& decoder) {
+            FILE* file = fopen(path.c_str(), "wb");
+            if (file == nullptr) return false;
+            unsigned int w = decoder.getWidth(), h = decoder.getHeight();
+            auto& frame = decoder.getFrame();
+            fprintf(file, "P6\n%u %u\n255\n", w, h);
+            for (size_t i = 0; i < size_t(w)*h; i++) {
+                fwrite(&frame[i*4], 1, 3, file);
+            }
+            bool ok = ferror(file) == 0;
+            fclose(file);
+            return ok;
+        }
+
+        // һȫ¼
+        // : Ƿɹ
+        bool receiveEvents(LocalSocket& socket, TileDecoder& decoder) {
+            string line;
+            vector<uint8_t> data;
+            while (socket.recvLine(line)) {
+                istringstream ss{line};
+                string event;
+                ss>>event;
+                if (event == "Accepted") {
+                    int parsed = 0, prepared = 0;
+                    double ms = 0;
+                    ss>>parsed>>prepared>>ms;
+                    cout<<"accepted: "<<(parsed ? "cached scene" : "scene parsed")<<", "
+                        <<(prepared ? "cached preparation" : "scene prepared")<<", prepare "<<ms<<" ms"<<endl;
+                }
+                else if (event == "Progress") {
+                    float progress = 0;
+                    ss>>progress;
+                    cout<<"progress "<<int(progress*100.f)<<"%"<<endl;
+                }
+                else if (event == "Frame") {
+                    unsigned int seq = 0, tiles = 0;
+                    size_t bytes = 0;
+                    ss>>seq>>tiles>>bytes;
+                    data.resize(bytes);
+                    if (!socket.recvAll(data.data(), bytes)) break;
+                    if (!decoder.apply(data.data(), bytes)) {
+                        cerr<<"Corrupted frame "<<seq<<endl;
+                        return false;
+                    }
+                    cout<<"frame "<<seq<<": "<<tiles<<" tiles, "<<bytes<<" bytes"<<endl;
+                }
+                else if (event == "Done") {
+                    double ms = 0;
+                    unsigned int frames = 0;
+                    size_t bytes = 0;
+                    ss>>ms>>frames>>bytes;
+                    cout<<"done: render "<<ms<<" ms, "<<frames<<" frames, "<<bytes<<" bytes"<<endl;
+                    return true;
+                }
+                else if (event == "Error") {
+                    string message;
+                    getline(ss>>ws, message);
+                    cerr<<"Error: "<<message<<endl;
+                    return false;
+                }
+            }
+            cerr<<socket.getErrorInfo()<<endl;
+            return false;
+        }
+    }
+
+    int submitCommand(const Arguments& args) {
+        string socketPath = DEFAULT_SOCKET_PATH;
+        findOption(args, "--socket", socketPath);
+        LocalSocket socket;
+
+        if (hasFlag(args, "--shutdown")) {
+            if (!socket.connect(socketPath) || !socket.sendLine("Shutdown")) {
+                cerr<<socket.getErrorInfo()<<endl;
+                return 1;
+            }
+            return 0;
+        }
+
+        RenderJob job;
+        string sceneFile, output, s;
+        if (findOption(args, "--inline", sceneFile)) {
+            ifstream file(sceneFile, ios::binary);
+            if (!file.is_open()) {
+                cerr<<"File does not exist: "<<sceneFile<<endl;
+                return 1;
+            }
+            job.inlineScene = true;
+            job.sceneText.assign(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+        }
+        else if (!findOption(args, "--scene", job.scenePath)) {
+            submitUsage();
+            return 1;
+        }
+        findOption(args, "--component", job.component);
+        auto& ro = job.option;
+        readOption(args, "--width", ro.width);
+        readOption(args, "--height", ro.height);
+        readOption(args, "--spp", ro.samplesPerPixel);
+        readOption(args, "--depth", ro.depth);
+        readOption(args, "--threads", ro.threads);
+        readOption(args, "--interval", job.interval);
+        ro.visibilityCache = hasFlag(args, "--visibility-cache");
+        ro.temporal = hasFlag(args, "--temporal");
+        if (!readSamplerOption(args, ro.sampler)) {
+            cerr<<"--sampler expects random or blue-noise"<<endl;
+            return 1;
+        }
+        if (!readAcceleratorOption(args, ro.accelerator)) {
+            cerr<<"--accelerator expects auto, bvh or grid"<<endl;
+            return 1;
+        }
+        if (findOption(args, "--camera", s)) {
+            auto v = parseList(s);
+            if (v.size() < 6) {
+                cerr<<"--camera expects px,py,pz,lx,ly,lz[,fov]"<<endl;
+                return 1;
+            }
+            job.camera.position = {v[0], v[1], v[2]};
+            job.camera.lookAt = {v[3], v[4], v[5]};
+            if (v.size() > 6) job.camera.fov = v[6];
+        }
+        if (findOption(args, "--ambient", s)) {
+            auto v = parseList(s);
+            if (v.size() == 3) job.ambient = {v[0], v[1], v[2]};
+        }
+        unsigned int repeat = 1;
+        readOption(args, "--repeat", repeat);
+        findOption(args, "-o", output);
+
+        if (!socket.connect(socketPath)) {
+            cerr<<socket.getErrorInfo()<<endl;
+            return 1;
+        }
+        TileDecoder decoder;
+        for (unsigned int i = 0; i < repeat; i++) {
+            // Ϊÿ¿ʼ
+            decoder = TileDecoder{};
+            if (!sendJob(socket, job)) {
+                cerr<<socket.getErrorInfo()<<endl;
+                return 1;
+            }
+            if (!receiveEvents(socket, decoder)) return 1;
+        }
+        if (!output.empty()) {
+            if (!writePpm(output, decoder)) {
+                cerr<<"Failed to write "<<output<<endl;
+                return 1;
+            }
+            cout<<"Saved "<<output<<endl;
+        }
+        return 0;
+    }
+}
@@ -0,0 +1,50 @@
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <cmath>
+
+#include "Commands.hpp"
+#include "server/SharedFrameBuffer.hpp"
+
+namespace NRenderer
+{
+    // ڴ֡ļ򵥼ͬʱҲⲿȡʾ
+    int watchCommand(const Arguments& args) {
+        if (args.empty() || hasFlag(args, "-h") || hasFlag(args, "--help")) {
+            cout<<"Usage: NRCli watch <name> [--interval <ms>] [--once]"<<endl;
+            return 1;
+        }
+        const string& name = args[0];
+        unsigned int interval = 200;
+        readOption(args, "--interval", interval);
+        bool once = hasFlag(args, "--once");
+
+        SharedFrameReader reader;
+        reader.open(name);  // ʧʱread
+        vector<RGBA> pixels;
+        uint64_t lastFrame = 0;
+        while (true) {
+            unsigned int w = 0, h = 0;
+            uint64_t frame = 0;
+            if (reader.read(pixels, w, h, frame)) {
+                if (frame != lastFrame || once) {
+                    // ƽȿԴԷӳȾ
+                    double luminance = 0.0;
+                    for (auto& p : pixels) {
+                        double l = 0.2126*p.r + 0.7152*p.g + 0.0722*p.b;
+                        if (isfinite(l)) luminance += l;
+                    }
+                    if (!pixels.empty()) luminance /= double(pixels.size());
+                    cout<<"frame "<<frame<<": "<<w<<"x"<<h<<", mean luminance "<<luminance<<endl;
+                    lastFrame = frame;
+                }
+            }
+            else if (once) {
+                cerr<<"Shared frame buffer "<<name<<" is not available."<<endl;
+                return 1;
+            }
+            if (once) return 0;
+            this_thread::sleep_for(chrono::milliseconds(interval));
+        }
+    }
+}
@@ -0,0 +1,58 @@
+#pragma once
+#ifndef __IRRADIANCE_BAKER_HPP__
+#define __IRRADIANCE_BAKER_HPP__
+
+// նȺ決ͷļ
+// SimplePathTracerĻ㾲̬ն
+
+#include "scene/Scene.hpp"
+#include "scene/BakedIrradiance.hpp"
+#include "SimplePathTracer.hpp"
+
+#include <atomic>
+
+namespace IrradianceBake
+{
+    using namespace NRenderer;
+    using namespace std;
+
+    // նȺ決
+    // εĶ㡢ƽͼtexelǺ決㣬
+    // 決㰴ָ̣߳ÿ߳ȡһ
+    class IrradianceBaker
+    {
+    private:
+        // 決
+        struct BakePoint
+        {
+            Vec3 position;      // µλ
+            Vec3 normal;        // λ
+            Vec3* output;       // дλ
+        };
+
+        static constexpr size_t BATCH_SIZE = 64;    // ÿĺ決
+
+        SharedScene spScene;                        // ָ
+        Scene& scene;                               // 
+        SimplePathTracer::SimplePathTracerRenderer integrator;  // ·׷ٻ
+        unsigned int samples;                       // ÿ決ĲȡȾõÿز
+        unsigned int threads;                       // ߳
+        vector<BakePoint> points;                   // ȫ決
+        atomic<size_t> nextBatch;                   // һ
+        atomic<size_t> finishedBatches;             // ɵϱ
+
+        // 決̣߳ȡһ決ֱȫ
+        void bakeTask();
+    public:
+        // 캯
+        // spScene: ָ
+        IrradianceBaker(SharedScene spScene);
+        ~IrradianceBaker() = default;
+
+        // ִк決
+        // : 決
+        shared_ptr<BakedIrradiance> bake();
+    };
+}
+
+#endif
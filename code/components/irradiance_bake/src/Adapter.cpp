@@ -0,0 +1,39 @@
+// նȺ決ʵ
+// 決ɽ汣浽ʲԱߣRayCastʾȫֹ
+#include "server/Server.hpp"
+#include "component/RenderComponent.hpp"
+#include "IrradianceBaker.hpp"
+
+using namespace std;
+using namespace NRenderer;
+
+namespace IrradianceBake
+{
+    // 
+    // ̳Ⱦ決ıĻ
+    class Adapter : public RenderComponent
+    {
+    public:
+        // 決
+        // spScene: ָ
+        void render(SharedScene spScene) {
+            IrradianceBaker baker{spScene};
+            getServer().irradiance.publish(baker.bake());
+            getServer().logger.success("Irradiance baked");
+        }
+    };
+}
+
+// Ϣ
+const static string description =
+    "Irradiance Baker.\n"
+    "Bakes diffuse irradiance with the SimplePathTracer integrator:\n"
+    " - per vertex for triangles\n"
+    " - six axis directions for spheres\n"
+    " - lightmaps for planes\n"
+    "Samples per pixel is used as samples per bake point.\n"
+    "Use RayCast afterwards to view the result."
+    ;
+
+// ע
+REGISTER_RENDERER(IrradianceBake, description, IrradianceBake::Adapter);
@@ -0,0 +1,102 @@
+// նȺ決ʵ
+// ռ決㲢мն
+#include "IrradianceBaker.hpp"
+#include "server/Server.hpp"
+
+#include <thread>
+#include <chrono>
+
+namespace IrradianceBake
+{
+    // 캯
+    // spScene: ָ
+    IrradianceBaker::IrradianceBaker(SharedScene spScene)
+        : spScene               (spScene)
+        , scene                 (*spScene)
+        , integrator            (spScene)
+        , samples               (max(1u, spScene->renderOption.samplesPerPixel))
+        , threads               (spScene->renderOption.threads)
+        , points                ()
+        , nextBatch             (0)
+        , finishedBatches       (0)
+    {
+        if (threads == 0) threads = max(1u, thread::hardware_concurrency());
+    }
+
+    // 決߳
+    // ĴС̶ȣ粿ڵʱ߳ȡʣ
+    void IrradianceBaker::bakeTask() {
+        size_t batches = (points.size() + BATCH_SIZE - 1)/BATCH_SIZE;
+        for (size_t batch = nextBatch++; batch < batches; batch = nextBatch++) {
+            size_t end = min(points.size(), (batch + 1)*BATCH_SIZE);
+            for (size_t i = batch*BATCH_SIZE; i < end; i++) {
+                auto& p = points[i];
+                *p.output = integrator.irradiance(p.position, p.normal, samples);
+            }
+            finishedBatches++;
+        }
+    }
+
+    // ִк決
+    // : 決
+    shared_ptr<BakedIrradiance> IrradianceBaker::bake() {
+        integrator.prepare();
+        auto prepared = getServer().preparedScenes.acquire(scene);
+        auto baked = BakedIrradiance::create(prepared->key,
+            prepared->triangles.size(), prepared->spheres.size(), prepared->planes.size());
+
+        // ΣڼĽӷ촦Ϊڵ
+        points.clear();
+        for (size_t i = 0; i < prepared->triangles.size(); i++) {
+            auto& t = prepared->triangles[i];
+            Vec3 n = glm::cross(t.v2 - t.v1, t.v3 - t.v1);
+            if (glm::dot(n, n) <= 0.f) continue;
+            n = glm::dot(n, t.normal) < 0.f ? -glm::normalize(n) : glm::normalize(n);
+            Vec3 center = (t.v1 + t.v2 + t.v3)/3.f;
+            for (int k = 0; k < 3; k++) {
+                points.push_back({ t.v[k] + (center - t.v[k])*0.01f, n, &baked->triangles[i*3 + k] });
+            }
+        }
+        // 壺᷽ϵı
+        const Vec3 axes[6] = { {1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1} };
+        for (size_t i = 0; i < prepared->spheres.size(); i++) {
+            auto& s = prepared->spheres[i];
+            for (int k = 0; k < 6; k++) {
+                points.push_back({ s.position + axes[k]*s.radius, axes[k], &baked->spheres[i*6 + k] });
+            }
+        }
+        // ƽ棺ͼtexel
+        unsigned int res = baked->planeResolution;
+        for (size_t i = 0; i < prepared->planes.size(); i++) {
+            auto& pl = prepared->planes[i];
+            Vec3 n = glm::normalize(pl.normal);
+            for (unsigned int t = 0; t < res; t++) {
+                for (unsigned int s = 0; s < res; s++) {
+                    Vec3 position = pl.position + pl.u*((float(s) + 0.5f)/float(res)) + pl.v*((float(t) + 0.5f)/float(res));
+                    points.push_back({ position, n, &baked->planes[baked->planeTexel(Index(i), s, t)] });
+                }
+            }
+        }
+
+        auto begin = chrono::steady_clock::now();
+        size_t batches = (points.size() + BATCH_SIZE - 1)/BATCH_SIZE;
+        nextBatch = 0;
+        finishedBatches = 0;
+        getServer().statistics.reportProgress(0.f);
+        vector<thread> t(threads);
+        for (auto& th : t) {
+            th = thread(&IrradianceBaker::bakeTask, this);
+        }
+        while (finishedBatches < batches) {
+            this_thread::sleep_for(chrono::milliseconds(10));
+            getServer().statistics.reportProgress(float(finishedBatches)/float(batches));
+        }
+        for (auto& th : t) th.join();
+        getServer().statistics.reportProgress(1.f);
+
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+        getServer().logger.log("Baked " + to_string(points.size()) + " points ("
+            + to_string(samples) + " samples each) in " + to_string(seconds) + " s");
+        return baked;
+    }
+}
@@ -0,0 +1,54 @@
+#pragma once
+#ifndef __PROBE_BAKER_HPP__
+#define __PROBE_BAKER_HPP__
+
+// ̽決ͷļ
+// SimplePathTracerĻն̽
+
+#include "scene/Scene.hpp"
+#include "scene/IrradianceVolume.hpp"
+#include "SimplePathTracer.hpp"
+
+#include <atomic>
+
+namespace ProbeVolume
+{
+    using namespace NRenderer;
+    using namespace std;
+
+    // ̽決
+    // ͬͬ̽ʱֻº決޸ĵļ帽̽룬̽ԭĽ
+    // Ҫ決̽밴ָ̣߳ÿ߳ȡһ
+    class ProbeBaker
+    {
+    private:
+        static constexpr size_t BATCH_SIZE = 4;         // ÿ̽ÿ̽Ҫ׷ٵĹ߽϶࣬СԱ־
+        static constexpr float DIRTY_MARGIN = 2.f;      // ޸ĵļΧҪº決ķΧ̽ƣ
+        static constexpr float FULL_REBAKE_RATIO = 0.5f;    // Ҫº決̽볬ñʱֱ決
+
+        SharedScene spScene;                        // ָ
+        Scene& scene;                               // 
+        SimplePathTracer::SimplePathTracerRenderer integrator;  // ·׷ٻ
+        unsigned int samples;                       // ÿ̽ĲȡȾõÿز
+        unsigned int threads;                       // ߳
+        IrradianceVolume* volume;                   // ں決̽
+        vector<size_t> dirty;                       // Ҫ決̽
+        atomic<size_t> nextBatch;                   // һ
+        atomic<size_t> finishedBatches;             // ɵϱ
+
+        // 決̣߳ȡһֱ̽ȫ
+        void bakeTask();
+    public:
+        // 캯
+        // spScene: ָ
+        ProbeBaker(SharedScene spScene);
+        ~ProbeBaker() = default;
+
+        // ִк決
+        // previous: еǰ̽ûʱΪ
+        // : 決ûмʱΪ
+        SharedIrradianceVolume bake(SharedIrradianceVolume previous);
+    };
+}
+
+#endif
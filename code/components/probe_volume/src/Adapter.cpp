@@ -0,0 +1,41 @@
+// ̽決ʵ
+// ̽RayCastֵཻʾƵȫֹ
+#include "server/Server.hpp"
+#include "component/RenderComponent.hpp"
+#include "ProbeBaker.hpp"
+
+using namespace std;
+using namespace NRenderer;
+
+namespace ProbeVolume
+{
+    // 
+    // ̳Ⱦ決ıĻ
+    class Adapter : public RenderComponent
+    {
+    public:
+        // 決̽
+        // spScene: ָ
+        void render(SharedScene spScene) {
+            ProbeBaker baker{spScene};
+            auto volume = baker.bake(getServer().irradiance.getVolume());
+            if (volume == nullptr) return;
+            getServer().irradiance.publishVolume(volume);
+            getServer().logger.success("Irradiance probes baked");
+        }
+    };
+}
+
+// Ϣ
+const static string description =
+    "Irradiance Probe Volume.\n"
+    "Bakes a grid of probes storing incident radiance as 3rd order\n"
+    "spherical harmonics with the SimplePathTracer integrator.\n"
+    "Running it again after editing geometry only re-bakes probes\n"
+    "near the changed objects.\n"
+    "Samples per pixel is used as samples per probe.\n"
+    "Use RayCast afterwards to preview global illumination."
+    ;
+
+// ע
+REGISTER_RENDERER(ProbeVolume, description, ProbeVolume::Adapter);
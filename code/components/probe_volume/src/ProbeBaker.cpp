@@ -0,0 +1,102 @@
+// ̽決ʵ
+// ȷҪ決̽벢м
+#include "ProbeBaker.hpp"
+#include "server/Server.hpp"
+
+#include <thread>
+#include <chrono>
+
+namespace ProbeVolume
+{
+    // 캯
+    // spScene: ָ
+    ProbeBaker::ProbeBaker(SharedScene spScene)
+        : spScene               (spScene)
+        , scene                 (*spScene)
+        , integrator            (spScene)
+        , samples               (max(1u, spScene->renderOption.samplesPerPixel))
+        , threads               (spScene->renderOption.threads)
+        , volume                (nullptr)
+        , dirty                 ()
+        , nextBatch             (0)
+        , finishedBatches       (0)
+    {
+        if (threads == 0) threads = max(1u, thread::hardware_concurrency());
+    }
+
+    // 決߳
+    // ̽ļȣ翿Դλڼڲʱ߳ȡʣ
+    void ProbeBaker::bakeTask() {
+        constexpr unsigned int N = IrradianceVolume::SH_COEFFICIENTS;
+        size_t batches = (dirty.size() + BATCH_SIZE - 1)/BATCH_SIZE;
+        for (size_t batch = nextBatch++; batch < batches; batch = nextBatch++) {
+            size_t end = min(dirty.size(), (batch + 1)*BATCH_SIZE);
+            for (size_t i = batch*BATCH_SIZE; i < end; i++) {
+                size_t p = dirty[i];
+                float backfaces = integrator.radianceSH(volume->position(p), samples, &volume->coefficients[p*N]);
+                volume->valid[p] = backfaces <= IrradianceVolume::INVALID_BACKFACE_RATIO ? 1 : 0;
+            }
+            finishedBatches++;
+        }
+    }
+
+    // ִк決
+    // Դʡ򳡾Χб仯ʱ決ֻ決޸ĵļ帽̽
+    // ӹջѾֲı仯Զⲿֲ챣һ決ΪԤԽ
+    SharedIrradianceVolume ProbeBaker::bake(SharedIrradianceVolume previous) {
+        integrator.prepare();
+        auto prepared = getServer().preparedScenes.acquire(scene);
+        Vec3 sceneMin, sceneMax;
+        if (!prepared->bounds(sceneMin, sceneMax)) {
+            getServer().logger.warning("ûм壬δ決̽");
+            return nullptr;
+        }
+        auto baked = IrradianceVolume::create(prepared->key, IrradianceVolume::hashLighting(scene), samples, sceneMin, sceneMax);
+        baked->source = prepared;
+
+        dirty.clear();
+        bool incremental = previous != nullptr && previous->source != nullptr
+            && previous->lightingKey == baked->lightingKey && previous->samples == samples && previous->sameGrid(*baked);
+        Vec3 changedMin, changedMax;
+        if (incremental && IrradianceVolume::changedBounds(*previous->source, *prepared, changedMin, changedMax)) {
+            float margin = DIRTY_MARGIN*max({ baked->spacing.x, baked->spacing.y, baked->spacing.z });
+            dirty = previous->probesNear(changedMin, changedMax, margin);
+            if (dirty.empty()) {
+                getServer().logger.log("̽");
+                return previous;
+            }
+            if (float(dirty.size()) > FULL_REBAKE_RATIO*float(baked->size())) dirty.clear();
+            else {
+                baked->coefficients = previous->coefficients;
+                baked->valid = previous->valid;
+            }
+        }
+        if (dirty.empty()) {
+            for (size_t p = 0; p < baked->size(); p++) dirty.push_back(p);
+        }
+        volume = baked.get();
+
+        auto begin = chrono::steady_clock::now();
+        size_t batches = (dirty.size() + BATCH_SIZE - 1)/BATCH_SIZE;
+        nextBatch = 0;
+        finishedBatches = 0;
+        getServer().statistics.reportProgress(0.f);
+        vector<thread> t(threads);
+        for (auto& th : t) {
+            th = thread(&ProbeBaker::bakeTask, this);
+        }
+        while (finishedBatches < batches) {
+            this_thread::sleep_for(chrono::milliseconds(10));
+            getServer().statistics.reportProgress(float(finishedBatches)/float(batches));
+        }
+        for (auto& th : t) th.join();
+        getServer().statistics.reportProgress(1.f);
+        volume = nullptr;
+
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+        getServer().logger.log("Baked " + to_string(dirty.size()) + " of " + to_string(baked->size()) + " probes ("
+            + to_string(baked->counts.x) + "x" + to_string(baked->counts.y) + "x" + to_string(baked->counts.z) + ", "
+            + to_string(samples) + " samples each) in " + to_string(seconds) + " s");
+        return baked;
+    }
+}
@@ -6,6 +6,10 @@
 // ˹ͶȾĺĹ
 
 #include "scene/Scene.hpp"
+#include "scene/PreparedScene.hpp"
+#include "scene/RayQuery.hpp"
+#include "scene/BakedIrradiance.hpp"
+#include "scene/IrradianceVolume.hpp"
 #include "Camera.hpp"
 #include "intersections/intersections.hpp"
 #include "shaders/ShaderCreator.hpp"
@@ -23,6 +27,12 @@ namespace RayCast
         Scene& scene;                           // 
         RayCast::Camera camera;                 // 
         vector<SharedShader> shaderPrograms;    // ɫб
+        SharedPreparedScene prepared;           // µļBVHɷ沢乲
+        SharedBakedIrradiance baked;            // 뵱ǰһµĺ決նȣûʱΪ
+        SharedIrradianceVolume volume;          // ûк決նʱʹõ̽ûлһʱΪ
+        vector<RayIn> shadowRays;               // һҪԵӰ
+        vector<unsigned int> shadowPixels;      // Ӱ߶Ӧ
+        vector<uint8_t> shadowResults;          // ӰǷڵ
 
     public:
         // 캯
@@ -53,15 +63,16 @@ namespace RayCast
         // Уɫ
         RGB gamma(const RGB& rgb);
 
-        // ׷
-        // r: 
-        // ظù߶Ӧɫ
-        RGB trace(const Ray& r);
+        // ׷һй
+        // rays: һе
+        // hits: дߵཻ
+        // colors: д߶Ӧɫ
+        void traceRow(const vector<RayIn>& rays, vector<HitOut>& hits, vector<RGB>& colors);
 
-        // ཻ
-        // r: 
-        // ཻ¼
-        HitRecord closestHit(const Ray& r);
+        // ѯཻĺ決ն
+        // hit: ߵཻ
+        // طն
+        RGB bakedIrradiance(const HitOut& hit) const;
     };
 }
 
@@ -1,27 +0,0 @@
-#pragma once
-#ifndef __VERTEX_TRANSFORM_HPP__
-#define __VERTEX_TRANSFORM_HPP__
-
-// 任ͷļ
-// ˳ģͶ任
-
-#include "scene/Scene.hpp"
-
-namespace RayCast
-{
-    using namespace NRenderer;
-
-    // 任
-    // 𽫳еģʹӾֲת
-    class VertexTransformer
-    {
-    private:
-    public:
-        // ִж任
-        // spScene: ָ
-        // ģʹӾֲת
-        void exec(SharedScene spScene);
-    };
-}
-
-#endif
\ No newline at end of file
@@ -30,6 +30,10 @@ namespace RayCast
         // normal: 淨
         // ɫɫֵ
         virtual RGB shade(const Vec3& in, const Vec3& out, const Vec3& normal) const;
+
+        // ䷴
+        // ɫ
+        virtual RGB albedo() const;
     };
 }
 
@@ -39,6 +39,10 @@ namespace RayCast
         // normal: 淨
         // ɫɫֵ
         virtual RGB shade(const Vec3& in, const Vec3& out, const Vec3& normal) const = 0;
+
+        // ䷴
+        // ɺ決նȼɫ
+        virtual RGB albedo() const = 0;
     };
     SHARE(Shader);  // ָ
 }
@@ -1,7 +1,7 @@
 // ͶȾʵ
 // ʵ˻ĹͶȾ㷨Ӱ
 #include "RayCastRenderer.hpp"
-#include "VertexTransformer.hpp"
+#include "server/Server.hpp"
 #include "intersections/intersections.hpp"
 
 namespace RayCast
@@ -28,9 +28,21 @@ namespace RayCast
         // ػ
         auto pixels = new RGBA[width*height];
 
-        // ִж任
-        VertexTransformer vertexTransformer{};
-        vertexTransformer.exec(spScene);
+        // ȡµļBVHδ仯ʱֱӸû
+        prepared = getServer().preparedScenes.acquire(scene);
+
+        // ȡ決նȣں決֮仯ʱ
+        baked = getServer().irradiance.get();
+        if (baked != nullptr && baked->key != prepared->key) {
+            getServer().logger.warning("決뵱ǰһ£Ѻ");
+            baked = nullptr;
+        }
+        // ûõĺ決նʱʹ̽伸λ뵱ǰͬʱͬ
+        volume = baked == nullptr ? getServer().irradiance.getVolume() : nullptr;
+        if (volume != nullptr && (volume->key != prepared->key || volume->lightingKey != IrradianceVolume::hashLighting(scene))) {
+            getServer().logger.warning("̽뵱ǰһ£ѺԣProbeVolume");
+            volume = nullptr;
+        }
 
         // ɫ
         ShaderCreator shaderCreator{};
@@ -38,15 +50,20 @@ namespace RayCast
             shaderPrograms.push_back(shaderCreator.create(mtl, scene.textures));
         }
 
-        // ÿؽй׷
+        // 󽻣һеһཻҪӰһڵ
+        vector<RayIn> rays(width);
+        vector<HitOut> hits(width);
+        vector<RGB> colors(width);
         for (int i=0; i<height; i++) {
             for (int j=0; j < width; j++) {
                 // ɹ
                 auto ray = camera.shoot(float(j)/float(width), float(i)/float(height));
-                // ׷ٹ߻ȡɫ
-                auto color = trace(ray);
+                rays[j] = { ray.origin, 0.01f, ray.direction, FLOAT_INF };
+            }
+            traceRow(rays, hits, colors);
+            for (int j=0; j < width; j++) {
                 // ɫ
-                color = clamp(color);
+                auto color = clamp(colors[j]);
                 color = gamma(color);
                 pixels[(height-i-1)*width+j] = {color, 1};
             }
@@ -55,76 +72,76 @@ namespace RayCast
         return {pixels, width, height};
     }
     
-    // ׷
-    // r: 
-    // ظù߶Ӧɫ
-    RGB RayCastRenderer::trace(const Ray& r) {
-        // ûеԴغɫ
-        if (scene.pointLightBuffer.size() < 1) return {0, 0, 0};
-        // ȡһԴ
-        auto& l = scene.pointLightBuffer[0];
-        // ཻ
-        auto closestHitObj = closestHit(r);
-        
-        if (closestHitObj) {
-            auto& hitRec = *closestHitObj;
+    // ׷һй
+    // к決նȻ̽ʱϲõȫֹգټϵһԴֱӹ
+    // rays: һе
+    // hits: ߵཻ
+    // colors: ߶Ӧɫ
+    void RayCastRenderer::traceRow(const vector<RayIn>& rays, vector<HitOut>& hits, vector<RGB>& colors) {
+        fill(colors.begin(), colors.end(), RGB{0, 0, 0});
+        // ûеԴҲûк決նȣغɫ
+        if (scene.pointLightBuffer.size() < 1 && baked == nullptr && volume == nullptr) return;
+        const PreparedScene& ps = *prepared;
+        RayQuery::intersect(ps, rays, hits);
+
+        shadowRays.clear();
+        shadowPixels.clear();
+        for (size_t j = 0; j < rays.size(); j++) {
+            auto& hit = hits[j];
+            if (!hit.hit()) continue;
+            auto& shader = shaderPrograms[hit.material.index()];
+            // 決ȫֹգ = *ն/
+            if (baked != nullptr) {
+                colors[j] += shader->albedo()*bakedIrradiance(hit)/PI;
+            }
+            else if (volume != nullptr) {
+                // ƽ˫ɼ۲ߵһֵ
+                Vec3 normal = glm::dot(hit.normal, rays[j].direction) > 0.f ? -hit.normal : hit.normal;
+                colors[j] += shader->albedo()*volume->irradiance(hit.position, normal)/PI;
+            }
+            if (scene.pointLightBuffer.size() < 1) continue;
+
+            // ȡһԴ
+            auto& l = scene.pointLightBuffer[0];
             // Դ
-            auto out = glm::normalize(l.position - hitRec.hitPoint);
+            auto out = glm::normalize(l.position - hit.position);
             // ԴǷڱ汳
-            if (glm::dot(out, hitRec.normal) < 0) {
-                return {0, 0, 0};
-            }
+            if (glm::dot(out, hit.normal) < 0) continue;
             // 㵽Դľ
-            auto distance = glm::length(l.position - hitRec.hitPoint);
-            // Ӱ
-            auto shadowRay = Ray{hitRec.hitPoint, out};
-            auto shadowHit = closestHit(shadowRay);
-            // ɫ
-            auto c = shaderPrograms[hitRec.material.index()]->shade(-r.direction, out, hitRec.normal);
-            // ûڵڵڹԴ棬ɫ
-            if ((!shadowHit) || (shadowHit && shadowHit->t > distance)) {
-                return c * l.intensity;
-            }
-            // ӰУغɫ
-            else {
-                return Vec3{0};
-            }
+            auto distance = glm::length(l.position - hit.position);
+            // Ӱߣ벻distanceڵڵ
+            shadowRays.push_back({ hit.position, 0.01f, out, nextafter(distance, FLOAT_INF) });
+            shadowPixels.push_back(unsigned(j));
         }
-        else {
-            return {0, 0, 0};
+        if (shadowRays.empty()) return;
+
+        shadowResults.resize(shadowRays.size());
+        RayQuery::occluded(ps, shadowRays, shadowResults);
+        auto& l = scene.pointLightBuffer[0];
+        for (size_t k = 0; k < shadowRays.size(); k++) {
+            // ûڵɫӰ
+            if (shadowResults[k]) continue;
+            unsigned j = shadowPixels[k];
+            auto& shader = shaderPrograms[hits[j].material.index()];
+            colors[j] += shader->shade(-rays[j].direction, shadowRays[k].direction, hits[j].normal) * l.intensity;
         }
     }
 
-    // ཻ
-    // r: 
-    // ཻ¼
-    HitRecord RayCastRenderer::closestHit(const Ray& r) {
-        HitRecord closestHit = nullopt;
-        float closest = FLOAT_INF;
-        // ཻ
-        for (auto& s : scene.sphereBuffer) {
-            auto hitRecord = Intersection::xSphere(r, s, 0.01, closest);
-            if (hitRecord && hitRecord->t < closest) {
-                closest = hitRecord->t;
-                closestHit = hitRecord;
-            }
-        }
-        // εཻ
-        for (auto& t : scene.triangleBuffer) {
-            auto hitRecord = Intersection::xTriangle(r, t, 0.01, closest);
-            if (hitRecord && hitRecord->t < closest) {
-                closest = hitRecord->t;
-                closestHit = hitRecord;
-            }
-        }
-        // ƽཻ
-        for (auto& p : scene.planeBuffer) {
-            auto hitRecord = Intersection::xPlane(r, p, 0.01, closest);
-            if (hitRecord && hitRecord->t < closest) {
-                closest = hitRecord->t;
-                closestHit = hitRecord;
-            }
+    // ѯཻĺ決ն
+    // ƽ水ֵཻ尴ֵ߲
+    // hit: ߵཻ
+    // طն
+    RGB RayCastRenderer::bakedIrradiance(const HitOut& hit) const {
+        const PreparedScene& ps = *prepared;
+        const PrimitiveRef& primitive = hit.primitive;
+        switch (primitive.type)
+        {
+        case PrimitiveRef::Type::SPHERE:
+            return baked->sphere(primitive.index, hit.normal);
+        case PrimitiveRef::Type::TRIANGLE:
+            return baked->triangle(primitive.index, ps.triangles[primitive.index], hit.position);
+        default:
+            return baked->plane(primitive.index, ps.planes[primitive.index], hit.position);
         }
-        return closestHit; 
     }
 }
\ No newline at end of file
@@ -1,41 +0,0 @@
-// 任ʵ
-// ʵ˳ģͶ任
-#include "VertexTransformer.hpp"
-#include "glm/gtc/matrix_transform.hpp"
-
-namespace RayCast
-{
-    // ִж任
-    // spScene: ָ
-    // ģʹӾֲת
-    void VertexTransformer::exec(SharedScene spScene) {
-        auto& scene = *spScene;
-        // енڵ
-        for (auto& node : scene.nodes) {
-            // 任
-            Mat4x4 t{1};
-            auto& model = spScene->models[node.model];
-            // ӦƽƱ任
-            t = glm::translate(t, model.translation);
-
-            // ݽڵӦñ任
-            if (node.type == Node::Type::TRIANGLE) {
-                // 任ε
-                for (int i=0; i<3; i++) {
-                    auto& v = scene.triangleBuffer[node.entity].v[i];
-                    v = t*Vec4{v, 1};
-                }
-            }
-            else if (node.type == Node::Type::SPHERE) {
-                // 任λ
-                auto& v = scene.sphereBuffer[node.entity].position;
-                v = t*Vec4{v, 1};
-            }
-            else if (node.type == Node::Type::PLANE) {
-                // 任ƽλ
-                auto& v = scene.planeBuffer[node.entity].position;
-                v = t*Vec4{v, 1};
-            }
-        }
-    }
-}
\ No newline at end of file
@@ -25,4 +25,10 @@ namespace RayCast
         // Lambert䣺diffuseColor * cos(theta)
         return diffuseColor * glm::dot(out, normal);
     }
+
+    // ䷴
+    // ɫ
+    RGB Lambertian::albedo() const {
+        return diffuseColor;
+    }
 }
\ No newline at end of file
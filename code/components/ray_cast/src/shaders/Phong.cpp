@@ -52,4 +52,10 @@ namespace RayCast
 
         return diffuse + specular;
     }
+
+    // ䷴
+    // ɫ
+    RGB Phong::albedo() const {
+        return diffuseColor;
+    }
 }
\ No newline at end of file
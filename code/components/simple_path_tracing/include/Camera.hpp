@@ -4,6 +4,7 @@
 
 #include "scene/Camera.hpp"
 #include "geometry/vec.hpp"
+#include "server/TemporalHistory.hpp"
 
 #include "samplers/SamplerInstance.hpp"
 
@@ -61,13 +62,26 @@ namespace SimplePathTracer
             vertical = 2*halfHeight*focusDis*v;
         }
 
+        /**
+         * ƽ棬ڰռĵͶӰر
+         * ͷƫƲ룬DepthOfFieldΪfalseʱshootĹһ
+         */
+        TemporalHistory::View view() const {
+            return { position, lowerLeft, horizontal, vertical };
+        }
+
         /**
          * 
+         * @tparam DepthOfField ǷھͷϲȦΪ0ʱԹرʡȥһβ
          * @param s ˮƽ [0,1]
          * @param t ֱ [0,1]
          * @return Ĺ
          */
+        template<bool DepthOfField = true>
         Ray shoot(float s, float t) const {
+            if constexpr (!DepthOfField) {
+                return Ray{ position, glm::normalize(lowerLeft + s*horizontal + t*vertical - position) };
+            }
             // ʹԲβɾͷƫƣʵ־Ч
             auto r = defaultSamplerInstance<UniformInCircle>().sample2d();
             float rx = r.x * lenRadius;
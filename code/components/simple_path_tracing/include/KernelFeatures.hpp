@@ -0,0 +1,42 @@
+#pragma once
+#ifndef __KERNEL_FEATURES_HPP__
+#define __KERNEL_FEATURES_HPP__
+
+#include <cstddef>
+
+namespace SimplePathTracer
+{
+    /**
+     * Ⱦں˵
+     * traceclosestHitObjectΪģûеڱڱ
+     * ֻεĳжͼԪͣûԴĳٱԴ
+     * еʱ飬˰ȫԵһں˶ȷȾó
+     */
+    namespace Kernel
+    {
+        constexpr unsigned int SPHERES = 1u << 0;           // 
+        constexpr unsigned int TRIANGLES = 1u << 1;         // 
+        constexpr unsigned int PLANES = 1u << 2;            // ƽ
+        constexpr unsigned int AREA_LIGHTS = 1u << 3;       // Դ
+        constexpr unsigned int DEPTH_OF_FIELD = 1u << 4;    // Ȧ0Ҫھͷϲ
+        constexpr unsigned int VISIBILITY_CACHE = 1u << 5;  // ԴɼԻ
+        constexpr unsigned int ALL = (1u << 6) - 1;         // ͨںˣԶʱ
+
+        constexpr bool has(unsigned int features, unsigned int feature) {
+            return (features & feature) != 0;
+        }
+
+        // ԤʵػںˣȾʱѡһȫԵںˣʱʹͨں
+        // ֻǳϣͬͼԪϡԴ޾ʹÿɼԻ
+        constexpr unsigned int SPECIALIZED[] = {
+            SPHERES | AREA_LIGHTS,
+            TRIANGLES | AREA_LIGHTS,
+            SPHERES | PLANES | AREA_LIGHTS,
+            TRIANGLES | PLANES | AREA_LIGHTS,
+            SPHERES | TRIANGLES | PLANES | AREA_LIGHTS
+        };
+        constexpr size_t SPECIALIZED_COUNT = sizeof(SPECIALIZED)/sizeof(SPECIALIZED[0]);
+    }
+}
+
+#endif
@@ -0,0 +1,111 @@
+#pragma once
+#ifndef __PROFILER_HPP__
+#define __PROFILER_HPP__
+
+#include <cstdint>
+#include <chrono>
+
+#if defined(_MSC_VER)
+    #include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+    #include <x86intrin.h>
+#endif
+
+namespace SimplePathTracer
+{
+    /**
+     * ȡʱ
+     * x86ƽ̨˻Ϊ߾ʱӵļ
+     */
+    inline uint64_t readCycles() {
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return uint64_t(std::chrono::high_resolution_clock::now().time_since_epoch().count());
+#endif
+    }
+
+    /**
+     * 
+     * ͳƹһûз֧ڼ
+     */
+    struct ProfilerBase
+    {
+        uint64_t rays = 0;
+    };
+
+    /**
+     * շ
+     * зΪգΪģʱȫͳƴ룬·ûκη֧
+     */
+    struct NoProfiler
+    {
+        static constexpr bool enabled = false;
+        static constexpr bool countNodes = false;
+        static constexpr uint64_t rays = 0;
+        void beginPixel() {}
+        float endPixel() { return 0.f; }
+        void ray() {}
+        void nodes(unsigned int) {}
+        void shaderCall() {}
+    };
+
+    /**
+     * ׼Է
+     * ֻͳƹ¼شۣbench
+     */
+    struct BenchProfiler : public ProfilerBase
+    {
+        static constexpr bool enabled = false;
+        static constexpr bool countNodes = false;
+        void beginPixel() {}
+        float endPixel() { return 0.f; }
+        void ray() { rays++; }
+        void nodes(unsigned int) {}
+        void shaderCall() {}
+    };
+
+    /**
+     * ʱڷ
+     * ¼ÿأȫĵʱ
+     */
+    struct CycleProfiler : public ProfilerBase
+    {
+        static constexpr bool enabled = true;
+        static constexpr bool countNodes = false;
+        uint64_t start = 0;
+        void beginPixel() { start = readCycles(); }
+        float endPixel() { return float(readCycles() - start); }
+        void ray() { rays++; }
+        void nodes(unsigned int) {}
+        void shaderCall() {}
+    };
+
+    /**
+     * 
+     * @tparam Rays Ƿͳƹ
+     * @tparam Nodes ǷͳBVHڵ
+     * @tparam Shaders Ƿͳɫô
+     */
+    template<bool Rays, bool Nodes, bool Shaders>
+    struct CountProfiler : public ProfilerBase
+    {
+        static constexpr bool enabled = true;
+        static constexpr bool countNodes = Nodes;
+        uint64_t count = 0;
+        void beginPixel() { count = 0; }
+        float endPixel() { return float(count); }
+        void ray() {
+            rays++;
+            if constexpr (Rays) count++;
+        }
+        void nodes(unsigned int n) { if constexpr (Nodes) count += n; }
+        void shaderCall() { if constexpr (Shaders) count++; }
+    };
+
+    using RayProfiler = CountProfiler<true, false, false>;
+    using NodeProfiler = CountProfiler<false, true, false>;
+    using ShaderCallProfiler = CountProfiler<false, false, true>;
+}
+
+#endif
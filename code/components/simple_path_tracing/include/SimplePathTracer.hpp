@@ -8,9 +8,21 @@
 #include "intersections/HitRecord.hpp"
 
 #include "shaders/ShaderCreator.hpp"
+#include "server/CostMap.hpp"
+#include "server/Statistics.hpp"
+#include "server/AccumulationBuffer.hpp"
+#include "server/TemporalHistory.hpp"
+#include "scene/IrradianceVolume.hpp"
+#include "scene/PreparedScene.hpp"
+#include "VisibilityCache.hpp"
+#include "KernelFeatures.hpp"
 
 #include <tuple>
-#include <shaders/BVHNode.hpp>
+#include <utility>
+#include <thread>
+#include <algorithm>
+#include <atomic>
+
 namespace SimplePathTracer
 {
     using namespace NRenderer;
@@ -24,6 +36,7 @@ namespace SimplePathTracer
     class SimplePathTracerRenderer
     {
     public:
+        static constexpr int COARSE_BLOCK = 8;  // Ԥйһߵؿ߳
     private:
         SharedScene spScene;        // ָ
         Scene& scene;               // 
@@ -32,13 +45,30 @@ namespace SimplePathTracer
         unsigned int height;        // ͼ߶
         unsigned int depth;         // ݹ
         unsigned int samples;       // ÿز
+        unsigned int threads;       // Ⱦ߳
+        unsigned int previewInterval;   // ȾˢĻļ룩
+        atomic<unsigned int> finishedTasks; // ɵȾ߳
+        atomic<unsigned int> finishedRows;  // ɵϱ
+        unique_ptr<atomic<bool>[]> rowFinished; // Ƿд꣨releaseԤֻдУԤʱΪ
+        RenderOption::Heatmap heatmap;  // شͼ
+        string heatmapOutput;       // ͼ·չ
+        RenderOption::SamplerMode samplerMode;  // ģʽ
+        unsigned int sampleSeed;    // ӣ0ʾʹõǰʱ
+        bool accumulate;            // Ƿۻ
+        bool useVisibilityCache;    // ǷʹԴɼԻ
+        bool temporal;              // ǷͶӰһ֡ۻ
+        bool countRays;             // Ƿͳƹ׼ԣ
 
         using SCam = SimplePathTracer::Camera;
-        SCam camera;                // 
+        vector<SCam> cameras;       // ӽǵScene::viewsΪʱֻг
 
         vector<SharedShader> shaderPrograms;  // ɫб
-        std::shared_ptr<BVHNode> bvhRoot;
-        
+        vector<char> sampleLights;      // ǷԹԴʽӽĲΪ0
+        SharedPreparedScene prepared;   // µļBVHɷ沢乲
+        unique_ptr<VisibilityCache> visibilityCache;    // ԴɼԻ棬δʱΪ
+        unique_ptr<TemporalHistory> history;            // ֡ͶӰʷȾ滻еʷδʱΪ
+        const TemporalHistory* previousHistory;         // пõһ֡ʷûʱΪ
+
     public:
         /**
          * 캯
@@ -47,12 +77,25 @@ namespace SimplePathTracer
         SimplePathTracerRenderer(SharedScene spScene)
             : spScene               (spScene)
             , scene                 (*spScene)
-            , camera                (spScene->camera)
         {
+            if (scene.views.empty()) cameras.emplace_back(scene.camera);
+            for (auto& view : scene.views) cameras.emplace_back(view);
             width = scene.renderOption.width;
             height = scene.renderOption.height;
             depth = scene.renderOption.depth;
             samples = scene.renderOption.samplesPerPixel;
+            heatmap = scene.renderOption.heatmap;
+            heatmapOutput = scene.renderOption.heatmapOutput;
+            samplerMode = scene.renderOption.sampler;
+            sampleSeed = scene.renderOption.sampleSeed;
+            accumulate = scene.renderOption.accumulate;
+            useVisibilityCache = scene.renderOption.visibilityCache;
+            temporal = scene.renderOption.temporal;
+            countRays = scene.renderOption.countRays;
+            previousHistory = nullptr;
+            threads = scene.renderOption.threads;
+            previewInterval = scene.renderOption.previewInterval;
+            if (threads == 0) threads = max(1u, thread::hardware_concurrency());
         }
         ~SimplePathTracerRenderer() = default;
 
@@ -60,6 +103,7 @@ namespace SimplePathTracer
         
         /**
          * ִȾ
+         * ӽʱӽдServer::viewsصһӽ
          * @return Ⱦݡȡ߶ȣ
          */
         RenderResult render();
@@ -70,16 +114,113 @@ namespace SimplePathTracer
          */
         void release(const RenderResult& r);
 
+        /**
+         * ׼ɫԤӣrenderԶ
+         * ʹirradiance決ǰҪȵ
+         */
+        void prepare();
+
+        /**
+         * һնȣֵڶ߳ͬʱ
+         * ֱӹtraceͬԴϲӹڰϾȲtrace׷ٵ
+         * @param position ϵĵ㣨꣩
+         * @param normal 淨
+         * @param samples 
+         * @return ն
+         */
+        RGB irradiance(const Vec3& position, const Vec3& normal, unsigned int samples);
+
+        /**
+         * ռһȵгͶӰֵڶ߳ͬʱ
+         * irradianceͬػֱӹӹգӹϾȲ
+         * @param position ռеĵ㣨꣩
+         * @param samples ӹյĲÿԴȡͬĲ
+         * @param coefficients дIrradianceVolume::SH_COEFFICIENTSϵ
+         * @return ӹȻм屳ıϴʱõλڼڲ
+         */
+        float radianceSH(const Vec3& position, unsigned int samples, Vec3* coefficients);
+
     private:
+        /**
+         * õں
+         * prepare֮
+         */
+        unsigned int sceneFeatures() const;
+
+        /**
+         * ӰɫĳݵĹϣ塢ʡԴ׷ȣ
+         * ͬʱһ֡ͶӰʷٿ
+         * prepareȡԤ֮
+         */
+        uint64_t shadingKey() const;
+
+        /**
+         * ֡ͶӰʷҷпԼʹõһ֡ʷ
+         */
+        void prepareHistory();
+
+        /**
+         * ѡȫԵػں˲Ⱦʱʹͨں
+         * @tparam Profiler ۷ֻڲ¼ش۵NoProfilerBenchProfiler
+         * @param features õں
+         * @param pixels ӽǵػ
+         * @param stats Ⱦͳ
+         * @param acc ۻҪʱΪ
+         */
+        template<typename Profiler, size_t... I>
+        void renderSpecialized(unsigned int features, index_sequence<I...>, RGBA* const* pixels, RenderStatistics& stats, AccumulationBuffer* acc);
+
+        /**
+         * ԤԤBVH㣩ɫУȾи
+         * ÿCOARSE_BLOCKCOARSE_BLOCKؿֻڿ׷һߣ͵Ļ
+         * ֻȾһӽǣʹÿɼԻ棬дۻͶӰʷ
+         * @param features õں
+         * @param pixels һӽǵػ
+         */
+        template<size_t... I>
+        void renderCoarse(unsigned int features, index_sequence<I...>, RGBA* pixels);
+
+        /**
+         * ָں˶߳ȾԤ
+         * @tparam Features ں
+         * @param pixels һӽǵػ
+         */
+        template<unsigned int Features>
+        void renderCoarseAll(RGBA* pixels);
+
+        /**
+         * ߳Ⱦ
+         * @tparam Profiler ۷NoProfilerʱκͳƿ
+         * @tparam Features ں
+         * @param pixels ӽǵػ
+         * @param costMap һӽǵشͼNoProfilerʱΪ
+         * @param stats Ⱦͳƣ¼ÿ̵߳Ĺʱ
+         * @param acc һӽǵĲۻҪʱΪ
+         */
+        template<typename Profiler, unsigned int Features>
+        void renderAll(RGBA* const* pixels, CostMap* costMap, RenderStatistics& stats, AccumulationBuffer* acc);
+
         /**
          * Ⱦ񣨶̣߳
-         * @param pixels ػ
+         * @tparam Profiler ۷
+         * @tparam Features ں
+         * @param pixels ӽǵػ
+         * @param costMap һӽǵشͼ
          * @param width ͼ
          * @param height ͼ߶
          * @param off ʼƫ
          * @param step 
+         * @param stats Ⱦͳƣ߳дoff
+         * @param acc һӽǵĲۻҪʱΪ
          */
-        void renderTask(RGBA* pixels, int width, int height, int off, int step);
+        template<typename Profiler, unsigned int Features>
+        void renderTask(RGBA* const* pixels, CostMap* costMap, int width, int height, int off, int step, RenderStatistics* stats, AccumulationBuffer* acc);
+
+        /**
+         * дشͼPFMͼαɫPPMͼ
+         * @param costMap شͼ
+         */
+        void exportHeatmap(const CostMap& costMap);
 
         /**
          * GammaУ
@@ -92,16 +233,41 @@ namespace SimplePathTracer
          * ·׷
          * @param ray 
          * @param currDepth ǰݹ
+         * @param profiler ۷
+         * @param firstHit Ϊʱд״ཻλ뷨ߣཻͶӰʱweightΪ1
          * @return ɫ
          */
-        RGB trace(const Ray& ray, int currDepth);
+        template<typename Profiler, unsigned int Features>
+        RGB trace(const Ray& ray, int currDepth, Profiler& profiler, TemporalHistory::Texel* firstHit = nullptr);
         
         /**
          * ཻ
          * @param r 
+         * @param profiler ۷
          * @return ཻ¼
          */
-        HitRecord closestHitObject(const Ray& r);
+        template<typename Profiler, unsigned int Features>
+        HitRecord closestHitObject(const Ray& r, Profiler& profiler);
+
+        /**
+         * ԤһͼԪ
+         * ûеͼԪͲɴ룬ֻʣһʱж
+         * @param r 
+         * @param prim ͼԪ
+         * @param tMin С
+         * @param tMax 
+         * @return ཻ¼
+         */
+        template<unsigned int Features>
+        HitRecord intersect(const Ray& r, const PrimitiveRef& prim, float tMin, float tMax) const;
+
+        /**
+         * ߰ڵ
+         * @param packet ߰ʱֻδڵĹ
+         * @param profiler ۷
+         */
+        template<typename Profiler, unsigned int Features>
+        void occluded(RayPacket4& packet, Profiler& profiler);
         
         /**
          * ཻĹԴ
@@ -1,29 +0,0 @@
-#pragma once
-#ifndef __VERTEX_TRANSFORM_HPP__
-#define __VERTEX_TRANSFORM_HPP__
-
-#include "scene/Scene.hpp"
-
-namespace SimplePathTracer
-{
-    using namespace NRenderer;
-    
-    /**
-     * 任
-     * 𽫳еļӾֲϵתϵ
-     * Ӧģ͵ı任ƽơתţ
-     */
-    class VertexTransformer
-    {
-    private:
-    public:
-        /**
-         * ִж任
-         * мĶӾֲת
-         * @param spScene ָ
-         */
-        void exec(SharedScene spScene);
-    };
-}
-
-#endif
\ No newline at end of file
@@ -0,0 +1,78 @@
+#pragma once
+#ifndef __VISIBILITY_CACHE_HPP__
+#define __VISIBILITY_CACHE_HPP__
+
+#include "geometry/vec.hpp"
+
+#include <atomic>
+#include <memory>
+#include <cstdint>
+
+namespace SimplePathTracer
+{
+    using namespace NRenderer;
+    using namespace std;
+
+    /**
+     * ԴɼԻ
+     * ռ仮Ϊأԣء߳򡢹ԴΪ¼ӰߵĿɼ
+     * ɫͬһԴĿɼͬȫɼȫڵؿ󲿷Ӱ
+     * ʹÿѰַĹϣĿȾ֮߳乲ֻԭӲ
+     */
+    class VisibilityCache
+    {
+    public:
+        // ضԹԴĿɼԷ
+        enum class State
+        {
+            UNKNOWN,    // 򲿷ֿɼ׷Ӱ
+            VISIBLE,    // ȫɼ
+            OCCLUDED    // ȫڵ
+        };
+
+        static constexpr unsigned int MIN_SAMPLES = 16;         // 
+        static constexpr unsigned int MAX_SAMPLES = 256;        // ʱ룬ʹƸ
+        static constexpr float VERIFY_PROBABILITY = 0.125f;     // ѷ׷Ӱߵĸ
+
+        /**
+         * 캯
+         * @param sceneMin ΧС
+         * @param sceneMax Χ
+         * @param slotBits ϣС2ݴΣ
+         */
+        VisibilityCache(const Vec3& sceneMin, const Vec3& sceneMax, unsigned int slotBits = 18);
+        VisibilityCache(const VisibilityCache&) = delete;
+        ~VisibilityCache() = default;
+
+        /**
+         * ɫԹԴĿʱ
+         * @param position ɫ
+         * @param normal ɫ㷨
+         * @param light Դ±
+         * @return Ŀ±꣬ԴʱNONE
+         */
+        uint32_t lookup(const Vec3& position, const Vec3& normal, unsigned int light);
+
+        // Ŀĵǰ
+        State state(uint32_t slot) const;
+
+        // ¼һοɼԲԵĽ
+        // visible: ɼӰtotal: ԵӰ
+        void record(uint32_t slot, unsigned int visible, unsigned int total);
+
+        static constexpr uint32_t NONE = ~0u;
+
+    private:
+        struct Slot
+        {
+            atomic<uint64_t> key{0};        // 0ʾĿ
+            atomic<uint32_t> counts{0};     // 16λΪɼ16λΪ
+        };
+        unique_ptr<Slot[]> slots;
+        uint32_t mask;
+        Vec3 origin;
+        float invCellSize;
+    };
+}
+
+#endif
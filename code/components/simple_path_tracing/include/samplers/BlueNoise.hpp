@@ -0,0 +1,159 @@
+#pragma once
+#ifndef __BLUE_NOISE_HPP__
+#define __BLUE_NOISE_HPP__
+
+#include <atomic>
+#include <cmath>
+
+namespace SimplePathTracer
+{
+    /**
+     * ƽ̵ֵͼ
+     * ״ʹʱɣֻ֮һάȡֵvoid-and-cluster㷨
+     * άȡֵһάȡֵĻϲڶŻʹصĶάȡֵ˴Զ
+     */
+    class BlueNoiseMask
+    {
+    public:
+        static constexpr int SIZE = 64;     // ߳2
+
+        /**
+         * ȡȫʵ״εʱ
+         */
+        static const BlueNoiseMask& instance() {
+            static const BlueNoiseMask mask{};
+            return mask;
+        }
+
+        /**
+         * ȡָصһάȡֵ갴ͼı߳
+         */
+        float at(int x, int y) const {
+            return values[index(x, y)];
+        }
+
+        /**
+         * ȡָصĶάȡֵһatͬ갴ͼı߳
+         */
+        void at2(int x, int y, float& u, float& v) const {
+            int i = index(x, y);
+            u = values[i];
+            v = pairs[i];
+        }
+
+    private:
+        float values[SIZE*SIZE];    // һάȡֵҲǶάȡֵĵһ
+        float pairs[SIZE*SIZE];     // άȡֵĵڶ
+
+        static int index(int x, int y) {
+            return (y & (SIZE - 1))*SIZE + (x & (SIZE - 1));
+        }
+
+        BlueNoiseMask();
+    };
+
+    /**
+     * زάֲ߳̾
+     * ģʽʱÿʼǰȾ̵߳beginSample֮˳ȡάȣ
+     * ÿεãһάάռһάȣ
+     * ÿάȡÿڲŶӦͼһƽƣͲµ˼ڸƵӽȵϸ
+     * ƽֻSIZE*SIZE֣Ž϶ʱظȡֵתCranley-Patterson
+     * תȡR2УͬһصתͬıͼĿռֲ߲ͬĽ
+     * MAX_DIMENSIONSάȣ·˻ص
+     */
+    class SampleStream
+    {
+    public:
+        static constexpr unsigned int MAX_DIMENSIONS = 64;
+
+        /**
+         * ȡǰ̵߳ĲάĬϹر
+         */
+        static SampleStream& current() {
+            thread_local static SampleStream stream{};
+            return stream;
+        }
+
+        /**
+         * ֡ӣͼƽƣȾʱͬӵõͬĲ
+         * Sampler::setBaseSeedͬҪȾ̵߳enable֮ǰ
+         */
+        static void setFrameSeed(unsigned int s) {
+            frameSeed() = s;
+        }
+
+        /**
+         * رյǰ̵߳
+         */
+        void enable(bool on);
+
+        /**
+         * ʼһµĲ
+         * @param x غ
+         * @param y 
+         * @param index ڵĲ
+         */
+        void beginSample(int x, int y, unsigned int index) {
+            // Ű(2, 3)KroneckerƽƣάʹõR2вͬⲻͬάŵƽغ
+            px = x + seedX + int(fraction(0.5 + 0.4142135623730950*index)*BlueNoiseMask::SIZE);
+            py = y + seedY + int(fraction(0.5 + 0.7320508075688772*index)*BlueNoiseMask::SIZE);
+            rotationU = float(fraction(0.7548776662466927*index));
+            rotationV = float(fraction(0.5698402909980532*index));
+            dimension = 0;
+        }
+
+        /**
+         * ȡһάȵһάȡֵ
+         * @return δάʱfalseӦ
+         */
+        bool next(float& v) {
+            if (!enabled || dimension >= MAX_DIMENSIONS) return false;
+            unsigned int d = dimension++;
+            v = rotate(mask->at(px + offsetX[d], py + offsetY[d]), rotationU);
+            return true;
+        }
+
+        /**
+         * ȡһάȵĶάȡֵά򡢹Դϵĵ㣩Ӧʹӿ
+         * @return δάʱfalseӦ
+         */
+        bool next2(float& u, float& v) {
+            if (!enabled || dimension >= MAX_DIMENSIONS) return false;
+            unsigned int d = dimension++;
+            mask->at2(px + offsetX[d], py + offsetY[d], u, v);
+            u = rotate(u, rotationU);
+            v = rotate(v, rotationV);
+            return true;
+        }
+
+    private:
+        bool enabled = false;
+        const BlueNoiseMask* mask = nullptr;
+        int px = 0;                         // ǰȡͼλ
+        int py = 0;
+        int seedX = 0;                      // ֡Ӿƽ
+        int seedY = 0;
+        float rotationU = 0.f;              // ǰŵȡֵת
+        float rotationV = 0.f;
+        unsigned int dimension = 0;
+        int offsetX[MAX_DIMENSIONS] = {};   // άȶȡͼʱƽƣʹͬάȻ
+        int offsetY[MAX_DIMENSIONS] = {};
+
+        static double fraction(double x) {
+            return x - floor(x);
+        }
+
+        // [0, 1)ϻƵƽȡֵ
+        static float rotate(float v, float rotation) {
+            v += rotation;
+            return v >= 1.f ? v - 1.f : v;
+        }
+
+        static std::atomic<unsigned int>& frameSeed() {
+            static std::atomic<unsigned int> s{0};
+            return s;
+        }
+    };
+}
+
+#endif
@@ -17,13 +17,13 @@ namespace SimplePathTracer
         uniform_real_distribution<float> u;
     public:
         HemiSphere()
-            : e               ((unsigned int)time(0) + insideSeed())
+            : e               (seed())
             , u               (0, 1)
         {}
 
         Vec3 sample3d() override {
-            float epsilon1 = u(e);
-            float epsilon2 = u(e);
+            float epsilon1, epsilon2;
+            uniform2(e, u, epsilon1, epsilon2);
             float r = sqrt(1 - epsilon1 * epsilon1);
             float x = cos(2*C_PI*epsilon2) * r;
             float y = sin(2*C_PI*epsilon2) * r;
@@ -25,7 +25,7 @@ namespace SimplePathTracer
          * 캯ʼ
          */
         Marsaglia()
-            : e               ((unsigned int)time(0) + insideSeed())
+            : e               (seed())
             , u               (-1, 1)
         {}
 
@@ -35,13 +35,15 @@ namespace SimplePathTracer
          * @return άλ
          */
         Vec3 sample3d() override {
-            float u_{0}, v_{0};
-            float r2{0};
-            do {
+            // ֻеһγԴӲάȡֵܾ֤ÿεռõά̶
+            float u_, v_;
+            uniform2(e, u, u_, v_);
+            float r2 = u_*u_ + v_*v_;
+            while (r2 > 1) {  // ܾȷڵλԲ
                 u_ = u(e);
                 v_ = u(e);
                 r2 = u_*u_ + v_*v_;
-            } while (r2 > 1);  // ܾȷڵλԲ
+            }
             
             // Marsaglia任Բڵӳ䵽
             float x = 2 * u_ * sqrt(1 - r2);
@@ -2,11 +2,16 @@
 #ifndef __SAMPLER_HPP__
 #define __SAMPLER_HPP__
 
-#include <mutex>
+#include "server/InstrumentedMutex.hpp"
+#include "BlueNoise.hpp"
+
+#include <ctime>
+#include <atomic>
+#include <random>
 
 namespace SimplePathTracer
 {
-    using std::mutex;
+    using NRenderer::InstrumentedMutex;
     
     /**
      * 
@@ -20,14 +25,77 @@ namespace SimplePathTracer
          * @return ֵ
          */
         static int insideSeed() {
-            static mutex m;
+            static InstrumentedMutex m{"Sampler::insideSeed"};
             static int seed = 0;
             m.lock();
             seed++;
             m.unlock();
             return seed;
         }
+
+        /**
+         * ӣ0ʾʹõǰʱ
+         */
+        static std::atomic<unsigned int>& baseSeed() {
+            static std::atomic<unsigned int> s{0};
+            return s;
+        }
+
+        /**
+         * ȡ²ʵ
+         * ָ˻ʱɻŻϵõͬĻӲص
+         * @return ֵ
+         */
+        static unsigned int seed() {
+            unsigned int base = baseSeed();
+            if (base == 0) return (unsigned int)time(0) + insideSeed();
+            // splitmix32ĻϣӲص
+            unsigned int x = base*0x9E3779B9u + (unsigned int)insideSeed();
+            x = (x ^ (x >> 16))*0x85EBCA6Bu;
+            x = (x ^ (x >> 13))*0xC2B2AE35u;
+            return x ^ (x >> 16);
+        }
+
+        /**
+         * ɷֲڵľ
+         * ǰ߳̿ʱӲάȡֵʹ
+         * @param e 
+         * @param u ȷֲ
+         * @return 
+         */
+        template<typename Engine>
+        static float uniform(Engine& e, std::uniform_real_distribution<float>& u) {
+            float v;
+            if (SampleStream::current().next(v)) return u.a() + (u.b() - u.a())*v;
+            return u(e);
+        }
+
+        /**
+         * һԷֲڵľάӦʹӿĻռϵõάֲ
+         * @param e 
+         * @param u ȷֲ
+         * @param x һ
+         * @param y ڶ
+         */
+        template<typename Engine>
+        static void uniform2(Engine& e, std::uniform_real_distribution<float>& u, float& x, float& y) {
+            if (SampleStream::current().next2(x, y)) {
+                x = u.a() + (u.b() - u.a())*x;
+                y = u.a() + (u.b() - u.a())*y;
+                return;
+            }
+            x = u(e);
+            y = u(e);
+        }
     public:
+        /**
+         * ֮󴴽ĲʵʹõĻ
+         * ʵֲ߳̾ģȾ֮߳󴴽ŻЧ
+         * @param s ӣ0ʾʹõǰʱ
+         */
+        static void setBaseSeed(unsigned int s) {
+            baseSeed() = s;
+        }
         virtual ~Sampler() = default;
         Sampler() = default;
     };
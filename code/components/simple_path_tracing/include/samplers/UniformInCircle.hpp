@@ -14,15 +14,17 @@ namespace SimplePathTracer
         uniform_real_distribution<float> u;
     public:
         UniformInCircle()
-            : e               ((unsigned int)time(0) + insideSeed())
+            : e               (seed())
             , u               (-1, 1)
         {}
         Vec2 sample2d() override {
-            float x{0}, y{0};
-            do {
+            // ֻеһγԴӲάȡֵܾ֤ÿεռõά̶
+            float x, y;
+            uniform2(e, u, x, y);
+            while((x*2 + y*2) > 1) {
                 x = u(e);
                 y = u(e);
-            } while((x*2 + y*2) > 1);
+            }
             return { x, y };
         }
     
@@ -24,7 +24,7 @@ namespace SimplePathTracer
          * 캯ʼ
          */
         UniformInSquare()
-            : e               ((unsigned int)time(0) + insideSeed())
+            : e               (seed())
             , u               (-1, 1)
         {}
         
@@ -33,7 +33,9 @@ namespace SimplePathTracer
          * @return ά
          */
         Vec2 sample2d() override {
-            return {u(e), u(e)};
+            float x, y;
+            uniform2(e, u, x, y);
+            return { x, y };
         }
     };
 }
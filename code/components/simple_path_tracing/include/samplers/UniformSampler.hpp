@@ -24,7 +24,7 @@ namespace SimplePathTracer
          * 캯ʼ
          */
         UniformSampler()
-            : e                 ((unsigned int)time(0) + insideSeed())
+            : e                 (seed())
             , u                 (0, 1)
         {}
         
@@ -33,7 +33,7 @@ namespace SimplePathTracer
          * @return 
          */
         float sample1d() override {
-            return u(e);
+            return uniform(e, u);
         }
     };
 }
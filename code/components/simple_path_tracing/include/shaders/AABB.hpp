@@ -1,74 +0,0 @@
-#pragma once
-#ifndef __AABB_HPP__
-#define __AABB_HPP__
-
-#include "geometry/vec.hpp"
-#include "Ray.hpp"
-
-namespace SimplePathTracer
-{
-    using namespace NRenderer;
-
-    /**
-     * Χ
-     */
-    struct AABB {
-        Vec3 min;
-        Vec3 max;
-
-        AABB() : min(FLT_MAX), max(-FLT_MAX) {}
-        AABB(const Vec3& min, const Vec3& max) : min(min), max(max) {}
-
-        /**
-         * չΧ԰
-         */
-        void expand(const Vec3& point) {
-            min = glm::min(min, point);
-            max = glm::max(max, point);
-        }
-
-        /**
-         * չΧ԰һAABB
-         */
-        void expand(const AABB& other) {
-            min = glm::min(min, other.min);
-            max = glm::max(max, other.max);
-        }
-
-        /**
-         * Χ
-         */
-        Vec3 center() const {
-            return (min + max) * 0.5f;
-        }
-
-        /**
-         * AABB
-         */
-        bool intersect(const Ray& ray, float tMin, float tMax) const {
-            for (int i = 0; i < 3; i++) {
-                float invD = 1.0f / ray.direction[i];
-                float t0 = (min[i] - ray.origin[i]) * invD;
-                float t1 = (max[i] - ray.origin[i]) * invD;
-
-                if (invD < 0.0f) std::swap(t0, t1);
-
-                tMin = t0 > tMin ? t0 : tMin;
-                tMax = t1 < tMax ? t1 : tMax;
-
-                if (tMax <= tMin) return false;
-            }
-            return true;
-        }
-
-        /**
-         * 
-         */
-        float surfaceArea() const {
-            Vec3 d = max - min;
-            return 2.0f * (d.x * d.y + d.x * d.z + d.y * d.z);
-        }
-    };
-}
-
-#endif
\ No newline at end of file
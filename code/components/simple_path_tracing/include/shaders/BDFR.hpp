@@ -77,28 +77,15 @@ namespace SimplePathTracer
             float pdf;
             Vec3 wi = sampleGXXDirection(wo, normal, pdf);
 
-            // ȷڷ߰
-            if (glm::dot(wi, normal) < 0) {
-                // Ч˵򵥵ҼȨ
-                wi = sampleDiffuseDirection(normal);
-                pdf = calculateDiffusePDF(wi, normal);
-            }
-
-            // BRDFֵ
-            Vec3 brdfValue = evaluateBRDF(wi, wo, normal);
-
-            // յ˥ϵ
-            float NdotL = glm::max(0.0f, glm::dot(normal, wi));
-            Vec3 attenuation = brdfValue * NdotL / (pdf + 1e-6f);
-
-            // ֵֹȶ
-            if (glm::length(attenuation) > 100.0f) {
-                attenuation = Vec3(1.0f, 1.0f, 1.0f);
+            // 䵽·ľ򱻱գpdfΪ0ټ·
+            if (glm::dot(wi, normal) <= 0) {
+                return { Ray{origin, wi}, Vec3{0}, Vec3{0}, 0.0f };
             }
 
+            // ˥ϵΪBRDFֵpdfɻͳһ
             return {
                 Ray{origin, wi},
-                attenuation,
+                evaluateBRDF(wi, wo, normal),
                 Vec3{0},
                 pdf
             };
@@ -129,6 +116,14 @@ namespace SimplePathTracer
             return evaluateBRDF(wi, wo, normal);
         }
 
+        /**
+         * ꣺沿ΪGGX󲨰꣬ǽ䲿
+         */
+        Lobes lobes() const override
+        {
+            return { metallic < 1.0f ? (Lobe::DIFFUSE | Lobe::GLOSSY) : Lobe::GLOSSY, roughness };
+        }
+
     private:
         /**
          *  Disney BRDF
@@ -163,16 +158,16 @@ namespace SimplePathTracer
             Vec3 result = Vec3(0);
 
             // 䲿֣ǽ
-            result += diffuse * (1.0f - metallic);
+            result += diffuse * baseColor * (1.0f - metallic);
 
-            // 淴䲿֣ͷǽУ
+            // 淴䲿֣ͷǽУɫF0ȻbaseColorõ
             result += specular;
 
             // 
             result += sheenTerm * (1.0f - metallic);
             result += clearcoatTerm;
 
-            return result * baseColor;
+            return result;
         }
 
         /**
@@ -209,7 +204,7 @@ namespace SimplePathTracer
             float D_denom = (NdotH * NdotH * (alpha2 - 1.0f) + 1.0f);
             float D = alpha2 / (PI * D_denom * D_denom);
 
-            // ڵSmith ģͣ
+            // ڵSmith ģͣGѾ1/(4NdotLNdotV)
             float G1_V = NdotV + std::sqrt(alpha2 + (1.0f - alpha2) * NdotV * NdotV);
             float G1_L = NdotL + std::sqrt(alpha2 + (1.0f - alpha2) * NdotL * NdotL);
             float G = 1.0f / (G1_V * G1_L);
@@ -224,7 +219,7 @@ namespace SimplePathTracer
                 F = glm::mix(F, F * tint, specularTint);
             }
 
-            return (D * G * F) / (4.0f * NdotL * NdotV);
+            return D * G * F;
         }
 
         /**
@@ -240,7 +235,7 @@ namespace SimplePathTracer
             // ֲ
             float D = alpha2 / (PI * std::pow(NdotH * NdotH * (alpha2 - 1.0f) + 1.0f, 2.0f));
 
-            // Ἰ
+            // ἸͬѾ1/(4NdotLNdotV)
             float G_V = 1.0f / (NdotV + std::sqrt(alpha2 + (1.0f - alpha2) * NdotV * NdotV));
             float G_L = 1.0f / (NdotL + std::sqrt(alpha2 + (1.0f - alpha2) * NdotL * NdotL));
             float G = G_V * G_L;
@@ -248,7 +243,7 @@ namespace SimplePathTracer
             // 
             Vec3 F = Vec3(0.04f) + (Vec3(1.0f) - Vec3(0.04f)) * std::pow(1.0f - LdotH, 5.0f);
 
-            return clearcoat * D * G * F / (4.0f * NdotL * NdotV);
+            return clearcoat * D * G * F;
         }
 
         /**
@@ -289,9 +284,13 @@ namespace SimplePathTracer
          */
         Vec3 sampleDiffuseDirection(const Vec3& normal) const
         {
-            Vec3 random = defaultSamplerInstance<HemiSphere>().sample3d();
+            // HemiSphereǾȰﰴҼȨcalculateDiffusePDFһ
+            float epsilon1 = defaultSamplerInstance<UniformSampler>().sample1d();
+            float epsilon2 = defaultSamplerInstance<UniformSampler>().sample1d();
+            float r = std::sqrt(epsilon1);
+            float phi = 2.0f * PI * epsilon2;
             Onb onb{ normal };
-            return onb.local(random);
+            return glm::normalize(onb.local(Vec3(r * std::cos(phi), r * std::sin(phi), std::sqrt(glm::max(0.0f, 1.0f - epsilon1)))));
         }
 
         /**
@@ -396,23 +395,10 @@ namespace SimplePathTracer
                 pdf_diffuse = calculateDiffusePDF(wi, normal);
             }
 
-            // GXXҪԲȨ - ƽʽ
-            float weight_diffuse = (diffuseRatio * pdf_diffuse) /
-                (diffuseRatio * pdf_diffuse + specularRatio * pdf_specular + 1e-6f);
-            float weight_specular = (specularRatio * pdf_specular) /
-                (diffuseRatio * pdf_diffuse + specularRatio * pdf_specular + 1e-6f);
-
-            // ѡĲӦöӦȨ
-            if (choice < diffuseRatio) {
-                pdf = pdf_diffuse;
-                // ӦMISȨص
-                return wi;
-            }
-            else {
-                pdf = pdf_specular;
-                // ӦMISȨص  
-                return wi;
-            }
+            // ҪԲƽʽѡʻֲԵpdf
+            // ȼڶѡԵƽʽȨغٳԸòԵpdf
+            pdf = diffuseRatio * pdf_diffuse + specularRatio * pdf_specular;
+            return wi;
         }
 
         /**
@@ -432,6 +418,7 @@ namespace SimplePathTracer
             Vec3 h = glm::normalize(wi + wo);
             float NdotH = glm::max(0.0f, glm::dot(normal, h));
             float HdotWo = glm::max(0.0f, glm::dot(h, wo));
+            if (HdotWo <= 0) return 0.0f;
 
             float alpha = roughness * roughness;
             float alpha2 = alpha * alpha;
@@ -1,169 +0,0 @@
-#pragma once
-#ifndef __BVH_BUILDER_HPP__
-#define __BVH_BUILDER_HPP__
-
-#include "BVHNode.hpp"
-#include <algorithm>
-
-namespace SimplePathTracer
-{
-    /**
-     * BVH
-     */
-    class BVHBuilder {
-    private:
-        /**
-         * Ϣṹ
-         */
-        struct BuildPrimitive {
-            AABB bbox;
-            Triangle* triangle = nullptr;
-            Sphere* sphere = nullptr;
-            Plane* plane = nullptr;
-            Vec3 center;
-        };
-
-    public:
-        /**
-         * BVH
-         */
-        std::shared_ptr<BVHNode> build(Scene& scene) {
-            std::vector<BuildPrimitive> primitives;
-
-            // ռͼԪ
-            for (auto& tri : scene.triangleBuffer) {
-                BuildPrimitive prim;
-                prim.triangle = &tri;
-                prim.bbox = calculateTriangleBBox(tri);
-                prim.center = prim.bbox.center();
-                primitives.push_back(prim);
-            }
-
-            // ռͼԪ
-            for (auto& sph : scene.sphereBuffer) {
-                BuildPrimitive prim;
-                prim.sphere = &sph;
-                prim.bbox = calculateSphereBBox(sph);
-                prim.center = prim.bbox.center();
-                primitives.push_back(prim);
-            }
-
-            // ռƽͼԪ
-            for (auto& pl : scene.planeBuffer) {
-                BuildPrimitive prim;
-                prim.plane = &pl;
-                prim.bbox = calculatePlaneBBox(pl);
-                prim.center = prim.bbox.center();
-                primitives.push_back(prim);
-            }
-
-            return recursiveBuild(primitives, 0, primitives.size());
-        }
-
-    private:
-        /**
-         * ݹ鹹BVH
-         */
-        std::shared_ptr<BVHNode> recursiveBuild(std::vector<BuildPrimitive>& primitives,
-            size_t start, size_t end) {
-            if (end - start == 0) return nullptr;
-
-            // ͼԪʱҶӽڵ
-            if (end - start <= 4) {
-                std::vector<Triangle> triangles;
-                std::vector<Sphere> spheres;
-                std::vector<Plane> planes;
-
-                for (size_t i = start; i < end; i++) {
-                    if (primitives[i].triangle) {
-                        triangles.push_back(*primitives[i].triangle);
-                    }
-                    else if (primitives[i].sphere) {
-                        spheres.push_back(*primitives[i].sphere);
-                    }
-                    else if (primitives[i].plane) {
-                        planes.push_back(*primitives[i].plane);
-                    }
-                }
-                return std::make_shared<BVHLeaf>(triangles, spheres, planes);
-            }
-
-            // ͼԪİΧ
-            AABB centroidBounds;
-            for (size_t i = start; i < end; i++) {
-                centroidBounds.expand(primitives[i].center);
-            }
-
-            // ѡзָ
-            int axis = centroidBounds.max.x - centroidBounds.min.x >
-                centroidBounds.max.y - centroidBounds.min.y ? 0 : 1;
-            axis = centroidBounds.max[axis] - centroidBounds.min[axis] >
-                centroidBounds.max.z - centroidBounds.min.z ? axis : 2;
-
-            // 
-            std::sort(primitives.begin() + start, primitives.begin() + end,
-                [axis](const BuildPrimitive& a, const BuildPrimitive& b) {
-                    return a.center[axis] < b.center[axis];
-                });
-
-            // мָ
-            size_t mid = start + (end - start) / 2;
-            auto left = recursiveBuild(primitives, start, mid);
-            auto right = recursiveBuild(primitives, mid, end);
-
-            return std::make_shared<BVHInternal>(left, right);
-        }
-
-        /**
-         * εİΧ
-         */
-        AABB calculateTriangleBBox(const Triangle& tri) {
-            AABB bbox;
-            bbox.expand(tri.v1);
-            bbox.expand(tri.v2);
-            bbox.expand(tri.v3);
-            return bbox;
-        }
-
-        /**
-         * İΧ
-         */
-        AABB calculateSphereBBox(const Sphere& sph) {
-            AABB bbox;
-            bbox.min = sph.position - Vec3(sph.radius);
-            bbox.max = sph.position + Vec3(sph.radius);
-            return bbox;
-        }
-
-        /**
-         * ƽİΧУ
-         */
-        AABB calculatePlaneBBox(const Plane& pl) {
-            AABB bbox;
-            // ƽģΪ䴴һްΧ
-            // ʹһϴķΧɼ
-            const float largeValue = 1000.0f;
-            Vec3 center = pl.position;
-
-            // ݷ߷ȷΧз
-            Vec3 normal = glm::normalize(pl.normal);
-
-            // 뷨߶İΧ
-            for (int i = 0; i < 3; i++) {
-                if (std::abs(normal[i]) > 0.9f) {
-                    // ҪᣬʹýСķΧ
-                    bbox.min[i] = center[i] - 0.1f;
-                    bbox.max[i] = center[i] + 0.1f;
-                }
-                else {
-                    // ʹýϴķΧ
-                    bbox.min[i] = center[i] - largeValue;
-                    bbox.max[i] = center[i] + largeValue;
-                }
-            }
-            return bbox;
-        }
-    };
-}
-
-#endif
\ No newline at end of file
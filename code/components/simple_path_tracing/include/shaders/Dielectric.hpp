@@ -100,6 +100,8 @@ namespace SimplePathTracer
                 float eta = etaI / etaT;
                 albedo *= (1.0f - reflectProb) * (eta * eta);
             }
+            // deltaBRDF1/|cos|evaluateBRDFһ£|cos|/pdfȨǡΪ/pdf
+            albedo /= glm::abs(glm::dot(glm::normalize(wi), normalCorrected)) + 1e-6f;
 
             // СƫƱཻ
             Vec3 offset = normalCorrected * 0.001f;
@@ -177,6 +179,11 @@ namespace SimplePathTracer
             return evaluateBRDF(wi, wo, normalCorrected, etaI, etaT);
         }
 
+        // 䶼ֻھȷϷ
+        Lobes lobes() const override {
+            return { Lobe::DELTA, 0.f };
+        }
+
     private:
         /**
          * ĽBRDF
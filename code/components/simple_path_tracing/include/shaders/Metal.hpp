@@ -36,47 +36,66 @@ namespace SimplePathTracer
             // ䷽
             Vec3 perfectReflectDir = reflect(incident, normal);
 
-            // ݴֲڶŶ䷽
-            Vec3 finalDirection = perturbDirection(perfectReflectDir, roughness);
-
-            if (glm::dot(finalDirection, normal) < 0) {
-                finalDirection = perfectReflectDir;
+            // 뾵棺deltaBRDFΪalbedo/cosȣcos/pdfȨǡΪalbedo
+            if (roughness < 0.001f) {
+                float cosTheta = glm::max(glm::dot(perfectReflectDir, normal), 0.0f);
+                return {
+                    Ray{origin, perfectReflectDir},
+                    albedo / (cosTheta + 1e-6f),
+                    Vec3{0},
+                    1.0f
+                };
             }
 
-            Vec3 attenuation = albedo;
-            float pdf = 1.0f;
+            // һPhong䷽ΧҪԲpdf = (n+1)/2Сcos^n 
+            float n = exponent();
+            float epsilon1 = defaultSamplerInstance<UniformSampler>().sample1d();
+            float epsilon2 = defaultSamplerInstance<UniformSampler>().sample1d();
+            float cosAlpha = std::pow(epsilon1, 1.0f / (n + 1.0f));
+            float sinAlpha = std::sqrt(glm::max(0.0f, 1.0f - cosAlpha * cosAlpha));
+            float phi = 2.0f * PI * epsilon2;
+            Onb onb{ perfectReflectDir };
+            Vec3 direction = glm::normalize(onb.local(Vec3{ sinAlpha * std::cos(phi), sinAlpha * std::sin(phi), cosAlpha }));
+
+            // 䵽·ķ򱻱գpdfΪ0ټ·
+            if (glm::dot(direction, normal) <= 0) {
+                return { Ray{origin, direction}, Vec3{0}, Vec3{0}, 0.0f };
+            }
 
             return {
-                Ray{origin, finalDirection},
-                attenuation,
+                Ray{origin, direction},
+                getBRDF(direction, incident, normal),
                 Vec3{0},
-                pdf
+                (n + 1.0f) / (2.0f * PI) * std::pow(cosAlpha, n)
             };
         }
 
         Vec3 evaluateDirectLighting(const Ray& ray, const Vec3& hitPoint, const Vec3& normal,
             const AreaLight& light, const Vec3& lightDir, float lightDistance) const {
             Vec3 incident = glm::normalize(ray.direction);
-            Vec3 perfectReflectDir = reflect(incident, normal);
-
-            // 㾵淴䷽Դһ
-            float reflectionAlignment = glm::max(0.0f, glm::dot(perfectReflectDir, lightDir));
 
-            // ǴֲڶȵӰ
-            float specular = std::pow(reflectionAlignment, 1.0f / (roughness + 0.001f));
+            // shadeʹͬһBRDF
+            Vec3 brdf = getBRDF(lightDir, incident, normal);
+            float cosTheta = glm::max(0.0f, glm::dot(normal, lightDir));
 
             // ˥
             float attenuation = 1.0f / (lightDistance * lightDistance);
 
-            return albedo * light.radiance * specular * attenuation;
+            return brdf * light.radiance * cosTheta * attenuation;
         }
 
+        // һPhong BRDFalbedo(n+2)/2Сcos^n Ϊwi䷽ļнǣwoΪ߷
         Vec3 getBRDF(const Vec3& wi, const Vec3& wo, const Vec3& normal) const {
-            // 򻯵ĽBRDF
             Vec3 perfectReflectDir = reflect(wo, normal);
             float alignment = glm::max(0.0f, glm::dot(perfectReflectDir, wi));
-            float specular = std::pow(alignment, 1.0f / (roughness + 0.001f));
-            return albedo * specular;
+            float n = exponent();
+            return albedo * ((n + 2.0f) / (2.0f * PI) * std::pow(alignment, n));
+        }
+
+        // ֲڶȵ0.001ʱshadeֱӷ䷽
+        Lobes lobes() const override {
+            if (roughness < 0.001f) return { Lobe::DELTA, 0.f };
+            return { Lobe::GLOSSY, roughness };
         }
 
     private:
@@ -85,17 +104,10 @@ namespace SimplePathTracer
             return v - 2.0f * glm::dot(v, n) * n;
         }
 
-        Vec3 perturbDirection(const Vec3& perfectReflect, float roughness) const
+        // PhongֲָڶԽСԽխ
+        float exponent() const
         {
-            if (roughness < 0.001f) {
-                return perfectReflect;
-            }
-
-            Vec3 random = defaultSamplerInstance<HemiSphere>().sample3d();
-            Onb onb{ perfectReflect };
-            Vec3 perturbed = glm::normalize(onb.local(random));
-
-            return glm::normalize(glm::mix(perfectReflect, perturbed, roughness));
+            return 1.0f / (roughness + 0.001f);
         }
     };
 }
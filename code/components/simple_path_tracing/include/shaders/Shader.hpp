@@ -14,6 +14,33 @@ namespace SimplePathTracer
 
     constexpr float PI = 3.1415926535898f;
 
+    /**
+     * BSDF
+     */
+    namespace Lobe
+    {
+        constexpr unsigned int DIFFUSE = 1u << 0;   // 
+        constexpr unsigned int GLOSSY = 1u << 1;    // дֲڶȵĹ
+        constexpr unsigned int DELTA = 1u << 2;     // 뾵淴
+    }
+
+    /**
+     * ʰĲ
+     * ݴ˾ǷԹԴʽNEEֻд棨deltaԴ
+     * Դ뷴䷽غϵĸΪ0ֻͨshadeĹ߻йԴõֱӹգ
+     * ֲڶȵĹ󲨰궼ԹԴ
+     */
+    struct Lobes
+    {
+        unsigned int flags = Lobe::DIFFUSE;
+        float roughness = 1.f;      // 󲨰Ĵֲڶ
+
+        // ǷҪԹԴʽ
+        bool sampleLights() const {
+            return (flags & (Lobe::DIFFUSE | Lobe::GLOSSY)) != 0;
+        }
+    };
+
     /**
      * ɫ
      * ֱӹռӿ
@@ -53,6 +80,13 @@ namespace SimplePathTracer
          * ȡʵBRDFֵ - 
          */
         virtual Vec3 getBRDF(const Vec3& wi, const Vec3& wo, const Vec3& normal) const = 0;
+
+        /**
+         * ʰĲ꣬ĬΪ
+         */
+        virtual Lobes lobes() const {
+            return {};
+        }
     };
     SHARE(Shader);
 }
@@ -1,12 +1,19 @@
 #include "server/Server.hpp"
+#include "server/TaskGraph.hpp"
 
 #include "SimplePathTracer.hpp"
 
-#include "VertexTransformer.hpp"
 #include "intersections/intersections.hpp"
 
 #include "glm/gtc/matrix_transform.hpp"
-#include <shaders/BVHBuilder.hpp>
+#include "Profiler.hpp"
+#include "Onb.hpp"
+
+#include <thread>
+#include <chrono>
+#include <cmath>
+#include <bit>
+#include <cstring>
 
 namespace SimplePathTracer
 {
@@ -23,73 +30,425 @@ namespace SimplePathTracer
     /**
      * Ⱦ̣߳
      * ָΧڵУ·׷ټ
-     * @param pixels ػ
+     * ӽʱÿһȾӽǣӽǹͬһ߳з䣬ӽǣԣͬһзʵļ
+     * @param pixels ӽǵػ
+     * @param costMap һӽǵشͼProfilerʱд룩
      * @param width ͼ
      * @param height ͼ߶
      * @param off ʼƫ
      * @param step вڶ̷߳䣩
+     * @param stats Ⱦͳƣ߳дoff
+     * @param acc һӽǵĲۻҪʱΪգ̴߳лص
      */
-    void SimplePathTracerRenderer::renderTask(RGBA* pixels, int width, int height, int off, int step) {
+    template<typename Profiler, unsigned int Features>
+    void SimplePathTracerRenderer::renderTask(RGBA* const* pixels, CostMap* costMap, int width, int height, int off, int step, RenderStatistics* stats, AccumulationBuffer* acc) {
+        auto begin = chrono::steady_clock::now();
+        Profiler profiler{};
+        auto& stream = SampleStream::current();
+        stream.enable(samplerMode == RenderOption::SamplerMode::BLUE_NOISE);
         for (int i = off; i < height; i += step) {  // 
-            for (int j = 0; j < width; j++) {    // ÿе
-                Vec3 color{ 0, 0, 0 };         // ʼɫ
-
-                // ز
-                for (int k = 0; k < samples; k++) {
-                    // 
-                    auto r = defaultSamplerInstance<UniformInSquare>().sample2d();
-                    float rx = r.x;
-                    float ry = r.y;
-                    float x = (float(j) + rx) / float(width);   // һx
-                    float y = (float(i) + ry) / float(height);  // һy
-
-                    // 
-                    auto ray = camera.shoot(x, y);
-                    color += trace(ray, 0);  // ·׷
+            for (size_t view = 0; view < cameras.size(); view++) {
+                const SCam& camera = cameras[view];
+                RGBA* viewPixels = pixels[view];
+                AccumulationBuffer* viewAcc = view == 0 ? acc : nullptr;
+                for (int j = 0; j < width; j++) {    // ÿе
+                    Vec3 color{ 0, 0, 0 };         // ʼɫ
+                    Vec3 squareSum{ 0, 0, 0 };     // ɫƽͣۻʱʹ
+                    TemporalHistory::Texel firstHit{};  // һ״ཻ㣬ͶӰʱʹ
+                    profiler.beginPixel();
+
+                    // ز
+                    for (int k = 0; k < samples; k++) {
+                        stream.beginSample(j, i, unsigned(k));
+                        // 
+                        auto r = defaultSamplerInstance<UniformInSquare>().sample2d();
+                        float rx = r.x;
+                        float ry = r.y;
+                        float x = (float(j) + rx) / float(width);   // һx
+                        float y = (float(i) + ry) / float(height);  // һy
+
+                        // 
+                        auto ray = camera.shoot<Kernel::has(Features, Kernel::DEPTH_OF_FIELD)>(x, y);
+                        auto c = trace<Profiler, Features>(ray, 0, profiler, k == 0 && history != nullptr ? &firstHit : nullptr);  // ·׷
+                        color += c;
+                        if (viewAcc != nullptr) squareSum += c*c;
+                    }
+                    if (viewAcc != nullptr) {
+                        viewAcc->add(height - i - 1, j, color, squareSum, samples);
+                    }
+                    color /= samples;  // ƽ
+                    // ͶӰ״ཻһ֡еʷ뱾֡ĲЧȨƽ
+                    // ۻֻ¼֡Ķʷ
+                    if (history != nullptr) {
+                        if (firstHit.weight > 0.f) {
+                            float weight = 0.f;
+                            if (previousHistory != nullptr) {
+                                auto previous = previousHistory->reproject(firstHit.position, firstHit.normal);
+                                if (previous.weight > 0.f) {
+                                    color = (color*float(samples) + previous.radiance*previous.weight)/(float(samples) + previous.weight);
+                                    weight = previous.weight;
+                                }
+                            }
+                            firstHit.radiance = color;
+                            firstHit.weight = min(float(samples) + weight, TemporalHistory::MAX_WEIGHT);
+                        }
+                        history->set(i, j, firstHit);
+                    }
+                    color = glm::max(color, Vec3{0.f});  // ɼԻΪƽԿС0
+                    color = gamma(color);  // GammaУ
+                    viewPixels[(height - i - 1) * width + j] = { color, 1 };  // 洢أתy꣩
+                    if constexpr (Profiler::enabled) {
+                        auto cost = profiler.endPixel();
+                        if (view == 0) costMap->at(height - i - 1, j) = cost;
+                    }
                 }
-                color /= samples;  // ƽ
-                color = gamma(color);  // GammaУ
-                pixels[(height - i - 1) * width + j] = { color, 1 };  // 洢أתy꣩
             }
+            if (rowFinished) rowFinished[i].store(true, memory_order_release);
+            finishedRows++;
         }
+        stats->threadBusySeconds[off] = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+        stats->threadRays[off] = profiler.rays;
+        finishedTasks++;
+    }
+
+    /**
+     * ߳Ⱦ
+     * @param pixels ػ
+     * @param costMap شͼ
+     * @param stats Ⱦͳ
+     * @param acc ۻ
+     */
+    template<typename Profiler, unsigned int Features>
+    void SimplePathTracerRenderer::renderAll(RGBA* const* pixels, CostMap* costMap, RenderStatistics& stats, AccumulationBuffer* acc) {
+        const int taskNums = int(threads);
+        stats.threads = threads;
+        stats.threadBusySeconds.assign(taskNums, 0.0);
+        stats.threadRays.assign(taskNums, 0);
+
+        auto begin = chrono::steady_clock::now();
+        finishedTasks = 0;
+        finishedRows = 0;
+        getServer().statistics.reportProgress(0.f);
+        // Ԥ͵ĻʼʱƵǰ棨Ԥֻ֮дУ
+        // ȡȾ߳д
+        vector<RGBA> preview;
+        vector<bool> copied;
+        if (previewInterval > 0) {
+            preview.assign(pixels[0], pixels[0] + size_t(width)*height);
+            copied.assign(height, false);
+            rowFinished = make_unique<atomic<bool>[]>(height);
+            for (unsigned int i = 0; i < height; i++) rowFinished[i].store(false, memory_order_relaxed);
+        }
+        vector<thread> t(taskNums);
+        for (int i = 0; i < taskNums; i++) {
+            t[i] = thread(&SimplePathTracerRenderer::renderTask<Profiler, Features>,
+                this, pixels, costMap, width, height, i, taskNums, &stats, acc);
+        }
+        // ڰδɵ֡͵Ļ乲ڴ澵񣩲ϱȣڹ۲Ⱦ
+        if (previewInterval > 0) {
+            auto last = chrono::steady_clock::now();
+            while (finishedTasks < unsigned(taskNums)) {
+                this_thread::sleep_for(chrono::milliseconds(10));
+                getServer().statistics.reportProgress(float(finishedRows)/float(height));
+                auto now = chrono::steady_clock::now();
+                if (now - last >= chrono::milliseconds(previewInterval)) {
+                    for (unsigned int i = 0; i < height; i++) {
+                        if (copied[i] || !rowFinished[i].load(memory_order_acquire)) continue;
+                        size_t row = size_t(height - i - 1)*width;   // renderTaskͬyת
+                        copy(pixels[0] + row, pixels[0] + row + width, preview.begin() + row);
+                        copied[i] = true;
+                    }
+                    getServer().screen.set(preview.data(), width, height);
+                    last = now;
+                }
+            }
+        }
+        for (int i = 0; i < taskNums; i++) {
+            t[i].join();  // ȴ߳
+        }
+        rowFinished.reset();
+        stats.wallSeconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+        stats.rays = 0;
+        for (auto r : stats.threadRays) stats.rays += r;
+    }
+
+    /**
+     * ѡػں˲Ⱦ
+     * ۵ʽSPECIALIZED˳·ֵһȫԵں˱ʹ
+     */
+    template<typename Profiler, size_t... I>
+    void SimplePathTracerRenderer::renderSpecialized(unsigned int features, index_sequence<I...>, RGBA* const* pixels, RenderStatistics& stats, AccumulationBuffer* acc) {
+        bool rendered = (false || ... || ((features & ~Kernel::SPECIALIZED[I]) == 0
+            && (renderAll<Profiler, Kernel::SPECIALIZED[I]>(pixels, nullptr, stats, acc), true)));
+        if (!rendered) renderAll<Profiler, Kernel::ALL>(pixels, nullptr, stats, acc);
+    }
+
+    /**
+     * ԤĶ߳Ⱦ
+     * ̰߳ؿУĵһߵĽд
+     * @param pixels һӽǵػ
+     */
+    template<unsigned int Features>
+    void SimplePathTracerRenderer::renderCoarseAll(RGBA* pixels) {
+        const int w = int(width);
+        const int h = int(height);
+        const int blocksX = (w + COARSE_BLOCK - 1)/COARSE_BLOCK;
+        const int blocksY = (h + COARSE_BLOCK - 1)/COARSE_BLOCK;
+        const int taskNums = int(threads);
+        vector<thread> t(taskNums);
+        for (int n = 0; n < taskNums; n++) {
+            t[n] = thread([=, this]() {
+                NoProfiler profiler{};
+                const SCam& camera = cameras[0];
+                for (int by = n; by < blocksY; by += taskNums) {
+                    const int i0 = by*COARSE_BLOCK, i1 = min(i0 + COARSE_BLOCK, h);
+                    for (int bx = 0; bx < blocksX; bx++) {
+                        const int j0 = bx*COARSE_BLOCK, j1 = min(j0 + COARSE_BLOCK, w);
+                        float x = float(j0 + j1)*0.5f/float(w);
+                        float y = float(i0 + i1)*0.5f/float(h);
+                        auto ray = camera.shoot<Kernel::has(Features, Kernel::DEPTH_OF_FIELD)>(x, y);
+                        RGB color = gamma(glm::max(trace<NoProfiler, Features>(ray, 0, profiler), Vec3{0.f}));
+                        for (int i = i0; i < i1; i++) {
+                            for (int j = j0; j < j1; j++) pixels[(h - i - 1)*w + j] = { color, 1 };
+                        }
+                    }
+                }
+            });
+        }
+        for (auto& th : t) th.join();
+        getServer().screen.set(pixels, width, height);
+    }
+
+    /**
+     * ѡػںȾԤ
+     * ɼԻᱻԤĲı䣬ԤʹãͨںҲȥһ
+     */
+    template<size_t... I>
+    void SimplePathTracerRenderer::renderCoarse(unsigned int features, index_sequence<I...>, RGBA* pixels) {
+        features &= ~Kernel::VISIBILITY_CACHE;
+        bool rendered = (false || ... || ((features & ~Kernel::SPECIALIZED[I]) == 0
+            && (renderCoarseAll<Kernel::SPECIALIZED[I]>(pixels), true)));
+        if (!rendered) renderCoarseAll<(Kernel::ALL & ~Kernel::VISIBILITY_CACHE)>(pixels);
+    }
+
+    /**
+     * õں
+     * ͼԪͰԤжϣӽǵĹȦΪ0ʱҪھͷϲ
+     */
+    unsigned int SimplePathTracerRenderer::sceneFeatures() const {
+        unsigned int features = 0;
+        if (!prepared->spheres.empty()) features |= Kernel::SPHERES;
+        if (!prepared->triangles.empty()) features |= Kernel::TRIANGLES;
+        if (!prepared->planes.empty()) features |= Kernel::PLANES;
+        if (!scene.areaLightBuffer.empty()) features |= Kernel::AREA_LIGHTS;
+        if (scene.views.empty() ? scene.camera.aperture > 0.f
+            : any_of(scene.views.begin(), scene.views.end(), [](const NRenderer::Camera& c) { return c.aperture > 0.f; })) {
+            features |= Kernel::DEPTH_OF_FIELD;
+        }
+        if (visibilityCache != nullptr) features |= Kernel::VISIBILITY_CACHE;
+        return features;
+    }
+
+    /**
+     * дشͼRenderOption::heatmapOutputָ·.pfm.ppmչ
+     * @param costMap شͼ
+     */
+    void SimplePathTracerRenderer::exportHeatmap(const CostMap& costMap) {
+        const string& base = heatmapOutput;
+        if (base.empty()) {
+            getServer().logger.warning("Heatmap recorded but no output path is set");
+            return;
+        }
+        bool ok = costMap.writePfm(base + ".pfm") && costMap.writeFalseColor(base + ".ppm");
+        if (ok) {
+            getServer().logger.success("Heatmap written to " + base + ".pfm / " + base + ".ppm (max "
+                + to_string(costMap.max()) + ", mean " + to_string(costMap.mean()) + ")");
+        }
+        else {
+            getServer().logger.error("Failed to write heatmap " + base);
+        }
+    }
+
+    /**
+     * ׼Ⱦ
+     * ʼɫ򣬻ȡԤ֮󴴽Ĳʹõ
+     */
+    void SimplePathTracerRenderer::prepare() {
+        // ɫ뼸Ԥͼͬʱ
+        TaskGraph graph{};
+        // ʼɫ
+        graph.add([this]() {
+            shaderPrograms.clear();
+            ShaderCreator shaderCreator{};
+            sampleLights.clear();
+            for (auto& m : scene.materials) {
+                shaderPrograms.push_back(shaderCreator.create(m, scene.textures));
+                sampleLights.push_back(shaderPrograms.back()->lobes().sampleLights());
+            }
+        });
+        // ȡµļBVHδ仯ʱֱӸû棬δʱBVHɶ̹߳
+        graph.add([this]() {
+            prepared = getServer().preparedScenes.acquire(scene);
+        });
+        graph.run(threads);
+
+        // ɼԻ水ΧлأÿȾ½
+        visibilityCache.reset();
+        Vec3 sceneMin, sceneMax;
+        if (useVisibilityCache && prepared->bounds(sceneMin, sceneMax)) {
+            visibilityCache = make_unique<VisibilityCache>(sceneMin, sceneMax);
+        }
+
+        prepareHistory();
+
+        // Ⱦ߳ڴ֮󴴽ֲ߳̾Ĳʹµ
+        // ָʱʹʷĸ֡֡ŴӣϵͬĲ
+        unsigned int seed = sampleSeed;
+        if (seed != 0 && history != nullptr) seed += history->getFrame();
+        Sampler::setBaseSeed(seed);
+        SampleStream::setFrameSeed(seed != 0 ? seed : (unsigned int)time(0));
+    }
+
+    /**
+     * ֡ͶӰʷ
+     * ЧɫԾͷϲͬλÿĶ㣬޷һ״ཻͶӰʷ
+     * ʷֻӦһӽǣӽȾʱʷ
+     * һ֡ĳݲͬʱʹʷߴԲͬ
+     */
+    void SimplePathTracerRenderer::prepareHistory() {
+        history.reset();
+        previousHistory = nullptr;
+        if (!temporal || cameras.size() > 1 || (scene.views.empty() ? scene.camera : scene.views[0]).aperture > 0.f) return;
+        uint64_t key = shadingKey();
+        const TemporalHistory& last = getServer().temporalHistory;
+        bool usable = !last.empty() && last.getKey() == key;
+        if (usable) previousHistory = &last;
+        history = make_unique<TemporalHistory>(width, height, key, usable ? last.getFrame() + 1 : 0, cameras[0].view());
+    }
+
+    namespace
+    {
+        // FNV-1a32λִ
+        struct Hasher
+        {
+            uint64_t h = 1469598103934665603ull;
+            void word(uint32_t w) {
+                h ^= w;
+                h *= 1099511628211ull;
+            }
+            void value(uint64_t v) {
+                word(uint32_t(v));
+                word(uint32_t(v >> 32));
+            }
+            void value(float f) {
+                uint32_t w;
+                memcpy(&w, &f, sizeof(w));
+                word(w);
+            }
+            template<int N>
+            void value(const glm::vec<N, float>& v) {
+                for (int i = 0; i < N; i++) value(v[i]);
+            }
+            void value(int i) {
+                word(uint32_t(i));
+            }
+            void value(const Handle& handle) {
+                word(uint32_t(handle.getValue()));
+            }
+        };
+    }
+
+    uint64_t SimplePathTracerRenderer::shadingKey() const {
+        Hasher hasher{};
+        hasher.value(prepared->key);
+        hasher.word(depth);
+        hasher.value(scene.ambient.constant);
+        hasher.word(uint32_t(scene.areaLightBuffer.size()));
+        for (auto& a : scene.areaLightBuffer) {
+            hasher.value(a.radiance);
+            hasher.value(a.position);
+            hasher.value(a.u);
+            hasher.value(a.v);
+        }
+        hasher.word(uint32_t(scene.materials.size()));
+        for (auto& m : scene.materials) {
+            hasher.word(m.type);
+            hasher.word(uint32_t(m.properties.size()));
+            for (auto& p : m.properties) {
+                visit([&](const auto& wrapper) { hasher.value(wrapper.value); }, p.valueWrapper);
+            }
+        }
+        return hasher.h;
     }
 
     /**
      * Ⱦ
      * ʼɫִж߳ȾȾ
+     * ӽʱӽͬһȾ߳ɣһӽΪؽȫӽдServer::views
+     * ۻͼֻ¼һӽ
      * @return Ⱦݡȡ߶ȣ
      */
     auto SimplePathTracerRenderer::render() -> RenderResult {
-        // ʼɫ
-        shaderPrograms.clear();
-        ShaderCreator shaderCreator{};
-        for (auto& m : scene.materials) {
-            shaderPrograms.push_back(shaderCreator.create(m, scene.textures));
-        }
+        prepare();
 
-        // ػ
-        RGBA* pixels = new RGBA[width * height]{};
+        // ӽǵػ
+        vector<RGBA*> pixels(cameras.size());
+        for (auto& p : pixels) p = new RGBA[width * height]{};
 
-        // ֲת
-        VertexTransformer vertexTransformer{};
-        vertexTransformer.exec(spScene);
+        unique_ptr<AccumulationBuffer> acc{};
+        if (accumulate) acc = make_unique<AccumulationBuffer>(width, height);
 
-        BVHBuilder builder;
-        bvhRoot = builder.build(scene);
-        getServer().logger.log("BVH built successfully");
+        // Ҫ۲ȾʱʹԤ֡صȴĵһȾ
+        // ׼ԡͼָӵȾԤԤ̻߳Ĳţʹ޷
+        if (previewInterval > 0 && heatmap == RenderOption::Heatmap::NONE && !countRays && sampleSeed == 0) {
+            renderCoarse(sceneFeatures(), make_index_sequence<Kernel::SPECIALIZED_COUNT>{}, pixels[0]);
+        }
 
-        // ߳Ⱦ
-        const auto taskNums = 8;  // ʹ8߳
-        thread t[taskNums];
-        for (int i = 0; i < taskNums; i++) {
-            t[i] = thread(&SimplePathTracerRenderer::renderTask,
-                this, pixels, width, height, i, taskNums);
+        // ߳Ⱦͼѡرʱʹ޿NoProfiler׼ʹֻͳƹߵBenchProfiler
+        // ַֻʹػںˣͼͳʹͨںˣʵ
+        RenderStatistics stats{};
+        stats.component = "SimplePathTracer";
+        stats.samples = uint64_t(width) * height * samples * cameras.size();
+        if (heatmap == RenderOption::Heatmap::NONE && countRays) {
+            renderSpecialized<BenchProfiler>(sceneFeatures(), make_index_sequence<Kernel::SPECIALIZED_COUNT>{}, pixels.data(), stats, acc.get());
         }
-        for (int i = 0; i < taskNums; i++) {
-            t[i].join();  // ȴ߳
+        else if (heatmap == RenderOption::Heatmap::NONE) {
+            renderSpecialized<NoProfiler>(sceneFeatures(), make_index_sequence<Kernel::SPECIALIZED_COUNT>{}, pixels.data(), stats, acc.get());
+        }
+        else {
+            CostMap costMap{width, height};
+            switch (heatmap)
+            {
+            case RenderOption::Heatmap::CYCLES:
+                renderAll<CycleProfiler, Kernel::ALL>(pixels.data(), &costMap, stats, acc.get());
+                break;
+            case RenderOption::Heatmap::RAYS:
+                renderAll<RayProfiler, Kernel::ALL>(pixels.data(), &costMap, stats, acc.get());
+                break;
+            case RenderOption::Heatmap::NODES:
+                renderAll<NodeProfiler, Kernel::ALL>(pixels.data(), &costMap, stats, acc.get());
+                break;
+            default:
+                renderAll<ShaderCallProfiler, Kernel::ALL>(pixels.data(), &costMap, stats, acc.get());
+                break;
+            }
+            exportHeatmap(costMap);
+        }
+        if (acc != nullptr) getServer().accumulation = move(*acc);
+        // һӽǵĻΪؽreleaseͷţӽǸƺͷ
+        getServer().views.clear();
+        if (!scene.views.empty()) {
+            for (auto p : pixels) getServer().views.emplace_back(p, p + width * height);
+            for (size_t i = 1; i < pixels.size(); i++) delete[] pixels[i];
+        }
+        if (history != nullptr) {
+            getServer().temporalHistory = move(*history);
+            history.reset();
+            previousHistory = nullptr;
         }
+        getServer().statistics.reportRender(stats);
         getServer().logger.log("Done...");
-        return { pixels, width, height };
+        return { pixels[0], width, height };
     }
 
     /**
@@ -101,47 +460,175 @@ namespace SimplePathTracer
         delete[] p;  // ͷػ
     }
 
+    /**
+     * һն
+     * ֱӹգtraceͬÿԴϲɼԲԣԴ˵ҼȨ
+     * ӹգڷڰϾȲpdfΪ1/2УֱйԴķѼֱӹգظ
+     * @param position ϵĵ
+     * @param normal 淨
+     * @param samples 
+     * @return ն
+     */
+    RGB SimplePathTracerRenderer::irradiance(const Vec3& position, const Vec3& normal, unsigned int samples) {
+        if (samples == 0) return RGB{0.f};
+        NoProfiler profiler{};
+        Vec3 origin = position + normal*0.001f;
+        Vec3 direct{0.f};
+        for (const auto& areaLight : scene.areaLightBuffer) {
+            Vec3 lightNormal = glm::normalize(glm::cross(areaLight.u, areaLight.v));
+            float lightArea = glm::length(areaLight.u)*glm::length(areaLight.v);
+            for (unsigned int i = 0; i < samples; i++) {
+                // traceһ£positionǽǵ㣬uv[-1, 1]
+                Vec2 uv = defaultSamplerInstance<UniformInSquare>().sample2d();
+                Vec3 lightSamplePoint = areaLight.position + areaLight.u*uv.x + areaLight.v*uv.y;
+                Vec3 lightDir = lightSamplePoint - origin;
+                float lightDistance = glm::length(lightDir);
+                lightDir = lightDir/lightDistance;
+                float cosLight = glm::dot(lightNormal, -lightDir);
+                float cosSurface = glm::dot(normal, lightDir);
+                if (cosLight <= 0.f || cosSurface <= 0.f) continue;
+                auto shadowHit = closestHitObject<NoProfiler, Kernel::ALL>(Ray{origin, lightDir}, profiler);
+                if (!shadowHit || shadowHit->t > lightDistance - 0.001f) {
+                    direct += areaLight.radiance*lightArea*cosLight*cosSurface/(lightDistance*lightDistance);
+                }
+            }
+        }
+        direct /= float(samples);
+
+        Vec3 indirect{0.f};
+        if (depth > 0) {
+            Onb onb{normal};
+            for (unsigned int i = 0; i < samples; i++) {
+                Vec3 direction = onb.local(defaultSamplerInstance<HemiSphere>().sample3d());
+                Ray ray{origin, direction};
+                auto [t, emitted] = closestHitLight(ray);
+                if (t != FLOAT_INF) {
+                    auto hit = closestHitObject<NoProfiler, Kernel::ALL>(ray, profiler);
+                    if (!hit || hit->t >= t) continue;
+                }
+                indirect += trace<NoProfiler, Kernel::ALL>(ray, 1, profiler)*glm::dot(normal, direction);
+            }
+            indirect *= 2.f*PI/float(samples);
+        }
+        return direct + indirect;
+    }
+
+    /**
+     * ռһȵгͶӰ
+     * ֱӹգÿԴϲɼʱȳǣ*/ƽͶӰԴ
+     * ӹգϾȲpdfΪ1/4УֱйԴķѼֱӹգظ
+     * Ϊ0ʱӹգЩͳƱ
+     * @param position ռеĵ
+     * @param samples 
+     * @param coefficients гϵ
+     * @return Ȼм屳ļӹ߱
+     */
+    float SimplePathTracerRenderer::radianceSH(const Vec3& position, unsigned int samples, Vec3* coefficients) {
+        constexpr unsigned int N = IrradianceVolume::SH_COEFFICIENTS;
+        fill(coefficients, coefficients + N, Vec3{0.f});
+        if (samples == 0) return 0.f;
+        NoProfiler profiler{};
+        float basis[N];
+        for (const auto& areaLight : scene.areaLightBuffer) {
+            Vec3 lightNormal = glm::normalize(glm::cross(areaLight.u, areaLight.v));
+            float lightArea = glm::length(areaLight.u)*glm::length(areaLight.v);
+            for (unsigned int i = 0; i < samples; i++) {
+                // traceһ£positionǽǵ㣬uv[-1, 1]
+                Vec2 uv = defaultSamplerInstance<UniformInSquare>().sample2d();
+                Vec3 lightSamplePoint = areaLight.position + areaLight.u*uv.x + areaLight.v*uv.y;
+                Vec3 lightDir = lightSamplePoint - position;
+                float lightDistance = glm::length(lightDir);
+                lightDir = lightDir/lightDistance;
+                float cosLight = glm::dot(lightNormal, -lightDir);
+                if (cosLight <= 0.f) continue;
+                auto shadowHit = closestHitObject<NoProfiler, Kernel::ALL>(Ray{position, lightDir}, profiler);
+                if (shadowHit && shadowHit->t <= lightDistance - 0.001f) continue;
+                IrradianceVolume::shBasis(lightDir, basis);
+                Vec3 radiance = areaLight.radiance*lightArea*cosLight/(lightDistance*lightDistance*float(samples));
+                for (unsigned int k = 0; k < N; k++) coefficients[k] += radiance*basis[k];
+            }
+        }
+
+        unsigned int backfaces = 0;
+        for (unsigned int i = 0; i < samples; i++) {
+            Vec3 direction = glm::normalize(defaultSamplerInstance<Marsaglia>().sample3d());
+            Ray ray{position, direction};
+            auto hit = closestHitObject<NoProfiler, Kernel::ALL>(ray, profiler);
+            auto [t, emitted] = closestHitLight(ray);
+            if (t != FLOAT_INF && (!hit || hit->t >= t)) continue;
+            if (hit && glm::dot(hit->normal, direction) > 0.f) backfaces++;
+            if (depth == 0) continue;
+            Vec3 radiance = trace<NoProfiler, Kernel::ALL>(ray, 1, profiler)*(4.f*PI/float(samples));
+            IrradianceVolume::shBasis(direction, basis);
+            for (unsigned int k = 0; k < N; k++) coefficients[k] += radiance*basis[k];
+        }
+        return float(backfaces)/float(samples);
+    }
+
     /**
      * ҹཻ
-     * м壬ҵཻ
+     * Ԥļٽṹҵཻ
      * @param r 
      * @return ཻ¼
      */
-    HitRecord SimplePathTracerRenderer::closestHitObject(const Ray& r) {
-        if (bvhRoot) {
-            return bvhRoot->intersect(r, 0.000001f, FLOAT_INF);
-        }
-
+    template<typename Profiler, unsigned int Features>
+    HitRecord SimplePathTracerRenderer::closestHitObject(const Ray& r, Profiler& profiler) {
+        profiler.ray();
         HitRecord closestHit = nullopt;
-        float closest = FLOAT_INF;
+        const PreparedScene& ps = *prepared;
+        unsigned int visited = ps.traverse(r.origin, r.direction, 0.000001f, FLOAT_INF,
+            [&](const PrimitiveRef& prim, float closest) {
+                HitRecord hitRecord = intersect<Features>(r, prim, 0.000001f, closest);
+                if (hitRecord && hitRecord->t < closest) {
+                    closestHit = hitRecord;
+                    return hitRecord->t;
+                }
+                return closest;
+            });
+        profiler.nodes(visited);
+        return closestHit;
+    }
 
-        // 
-        for (auto& s : scene.sphereBuffer) {
-            auto hitRecord = Intersection::xSphere(r, s, 0.000001, closest);
-            if (hitRecord && hitRecord->t < closest) {
-                closest = hitRecord->t;
-                closestHit = hitRecord;
-            }
+    /**
+     * ߰ڵ
+     * ʹBVHʱ4߹һαҵһڵֹͣùߵ
+     * @param packet ߰
+     */
+    template<typename Profiler, unsigned int Features>
+    void SimplePathTracerRenderer::occluded(RayPacket4& packet, Profiler& profiler) {
+        for (int i = 0; i < RayPacket4::SIZE; i++) {
+            if (packet.isActive(i)) profiler.ray();
         }
+        const PreparedScene& ps = *prepared;
+        unsigned int visited = ps.occluded4(packet,
+            [&](const PrimitiveRef& prim, int lane) {
+                Ray r{packet.origins[lane], packet.directions[lane]};
+                return bool(intersect<Features>(r, prim, packet.tMin[lane], packet.tMax[lane]));
+            });
+        profiler.nodes(visited);
+    }
 
-        // 
-        for (auto& t : scene.triangleBuffer) {
-            auto hitRecord = Intersection::xTriangle(r, t, 0.000001, closest);
-            if (hitRecord && hitRecord->t < closest) {
-                closest = hitRecord->t;
-                closestHit = hitRecord;
+    /**
+     * һͼԪ
+     * 塢Ρƽ˳жͣһͼԪͲҪж
+     */
+    template<unsigned int Features>
+    HitRecord SimplePathTracerRenderer::intersect(const Ray& r, const PrimitiveRef& prim, float tMin, float tMax) const {
+        const PreparedScene& ps = *prepared;
+        if constexpr (Kernel::has(Features, Kernel::SPHERES)) {
+            if (!Kernel::has(Features, Kernel::TRIANGLES | Kernel::PLANES) || prim.type == PrimitiveRef::Type::SPHERE) {
+                return Intersection::xSphere(r, ps.spheres[prim.index], tMin, tMax);
             }
         }
-
-        // ƽ
-        for (auto& p : scene.planeBuffer) {
-            auto hitRecord = Intersection::xPlane(r, p, 0.000001, closest);
-            if (hitRecord && hitRecord->t < closest) {
-                closest = hitRecord->t;
-                closestHit = hitRecord;
+        if constexpr (Kernel::has(Features, Kernel::TRIANGLES)) {
+            if (!Kernel::has(Features, Kernel::PLANES) || prim.type == PrimitiveRef::Type::TRIANGLE) {
+                return Intersection::xTriangle(r, ps.triangles[prim.index], tMin, tMax);
             }
         }
-        return closestHit;
+        if constexpr (Kernel::has(Features, Kernel::PLANES)) {
+            return Intersection::xPlane(r, ps.planes[prim.index], tMin, tMax);
+        }
+        return nullopt;
     }
 
     /**
@@ -170,20 +657,62 @@ namespace SimplePathTracer
      * ʵؿ·׷㷨ݹɫ
      * @param r 
      * @param currDepth ǰݹ
+     * @param profiler ۷
      * @return ɫ
      */
-    RGB SimplePathTracerRenderer::trace(const Ray& r, int currDepth) {
-        auto hitObject = closestHitObject(r);
-        auto [t, emittedFromLight] = closestHitLight(r);
+    template<typename Profiler, unsigned int Features>
+    RGB SimplePathTracerRenderer::trace(const Ray& r, int currDepth, Profiler& profiler, TemporalHistory::Texel* firstHit) {
+        auto hitObject = closestHitObject<Profiler, Features>(r, profiler);
+        // ûԴں˲Դ
+        float t = FLOAT_INF;
+        Vec3 emittedFromLight{};
+        if constexpr (Kernel::has(Features, Kernel::AREA_LIGHTS)) {
+            tie(t, emittedFromLight) = closestHitLight(r);
+        }
 
         if (hitObject && hitObject->t < t) {
             auto mtlHandle = hitObject->material;
+            // ɫӽǱ仯ԴʹͬһжϣͶӰ
+            if (firstHit != nullptr && sampleLights[mtlHandle.index()]) {
+                firstHit->position = hitObject->hitPoint;
+                firstHit->normal = hitObject->normal;
+                firstHit->weight = 1.f;
+            }
 
-            // ֱӹ
+            // ֱӹգûԴںйԴΪ0ѭ
+            // ʲԹԴԴ򲻻ڷ䷽ϣ
+            // ֱӹȫ水ʲĹ߻йԴõ൱ڹԴMISȨΪ0
             Vec3 directLighting(0.0f);
+            const size_t lightCount = Kernel::has(Features, Kernel::AREA_LIGHTS) && sampleLights[mtlHandle.index()]
+                ? scene.areaLightBuffer.size() : 0;
+
+            for (unsigned int light = 0; light < lightCount; light++) {
+                const auto& areaLight = scene.areaLightBuffer[light];
+
+                // ɼԻ棺жΪȫɼȫڵֻVERIFY_PROBABILITYĸ׷Ӱ
+                // ȫڵʱδ׷ٵĹ߹Ϊ0׷ٵĿɼ߰1/qȨ
+                // ȫɼʱδ׷ٵĹΪɼ׷ٵıڵ߹1 - 1/qʵɼ
+                // ֻλڱϷĹ߲뻺棬·ĹǱ汾ڵ͸Ҫ׷
+                uint32_t slot = VisibilityCache::NONE;
+                auto cached = VisibilityCache::State::UNKNOWN;
+                bool testShadow = true;
+                if (Kernel::has(Features, Kernel::VISIBILITY_CACHE) && visibilityCache != nullptr) {
+                    slot = visibilityCache->lookup(hitObject->hitPoint, hitObject->normal, light);
+                    if (slot != VisibilityCache::NONE) cached = visibilityCache->state(slot);
+                    if (cached != VisibilityCache::State::UNKNOWN) {
+                        testShadow = defaultSamplerInstance<UniformSampler>().sample1d() < VisibilityCache::VERIFY_PROBABILITY;
+                    }
+                }
 
-            for (const auto& areaLight : scene.areaLightBuffer) {
-                for (int i = 0; i < 4; i++) {
+                // ͬһɫͬһԴ4Ӱ߷Ϊһ߰һBVH
+                RayPacket4 shadowRays{};
+                Vec3 lightDirs[RayPacket4::SIZE];
+                float lightDistances[RayPacket4::SIZE];
+                float cosLights[RayPacket4::SIZE];
+                unsigned int sampled = 0;       // λڹԴĹ
+                unsigned int aboveSurface = 0;  // λڱϷĹ
+                const Vec3 shadowOrigin = hitObject->hitPoint + hitObject->normal * 0.001f;
+                for (int i = 0; i < RayPacket4::SIZE; i++) {
                     // 1. ڹԴһ
                     Vec2 uv = defaultSamplerInstance<UniformInSquare>().sample2d();
 
@@ -201,31 +730,54 @@ namespace SimplePathTracer
 
                     // ȷ߳ȷҪת
                     float cosLight = glm::dot(lightNormal, -lightDir);
-                    if (cosLight <= 0.0f) continue; // ڹԴ
+                    if (cosLight <= 0.0f) continue; // ڹԴ棬ɼԲ
 
-                    // 3. ɼԲ
-                    Ray shadowRay(hitObject->hitPoint + hitObject->normal * 0.001f, lightDir);
-                    auto shadowHit = closestHitObject(shadowRay);
+                    sampled |= 1u << i;
+                    if (glm::dot(hitObject->normal, lightDir) > 0.f) aboveSurface |= 1u << i;
+                    lightDirs[i] = lightDir;
+                    lightDistances[i] = lightDistance;
+                    cosLights[i] = cosLight;
 
-                    if (!shadowHit || shadowHit->t > lightDistance - 0.001f) {
-                        // 4.uv
-                        float lightArea = glm::length(areaLight.u) * glm::length(areaLight.v);
-
-                        // 5. ShaderBRDF
-                        Vec3 lightContribution = shaderPrograms[mtlHandle.index()]->evaluateDirectLighting(
-                            r, hitObject->hitPoint, hitObject->normal,
-                            areaLight, lightDir, lightDistance
-                        );
+                    // 3. ɼԲԣ벻lightDistance - 0.001ڵڵɼɻĹ߲׷
+                    if (!testShadow && (aboveSurface & (1u << i)) != 0) continue;
+                    shadowRays.set(i, shadowOrigin, lightDir, 0.000001f, nextafter(lightDistance - 0.001f, FLOAT_INF));
+                }
+                occluded<Profiler, Features>(shadowRays, profiler);
+                if (testShadow && slot != VisibilityCache::NONE) {
+                    visibilityCache->record(slot, popcount(shadowRays.active & aboveSurface), popcount(aboveSurface));
+                }
 
-                        // 6. ӦMonte CarloȨ
-                        directLighting += lightContribution * lightArea * cosLight;
+                for (int i = 0; i < RayPacket4::SIZE; i++) {
+                    if ((sampled & (1u << i)) == 0) continue;
+                    float visibility = shadowRays.isActive(i) ? 1.f : 0.f;
+                    if ((aboveSurface & (1u << i)) != 0) {
+                        if (cached == VisibilityCache::State::OCCLUDED) {
+                            visibility /= VisibilityCache::VERIFY_PROBABILITY;
+                        }
+                        else if (cached == VisibilityCache::State::VISIBLE) {
+                            if (!testShadow) visibility = 1.f;
+                            else if (visibility == 0.f) visibility = 1.f - 1.f/VisibilityCache::VERIFY_PROBABILITY;
+                        }
                     }
+                    if (visibility == 0.f) continue;
+                    // 4.uv
+                    float lightArea = glm::length(areaLight.u) * glm::length(areaLight.v);
+
+                    // 5. ShaderBRDF
+                    profiler.shaderCall();
+                    Vec3 lightContribution = shaderPrograms[mtlHandle.index()]->evaluateDirectLighting(
+                        r, hitObject->hitPoint, hitObject->normal,
+                        areaLight, lightDirs[i], lightDistances[i]
+                    );
+
+                    // 6. ӦMonte CarloȨ
+                    directLighting += lightContribution * lightArea * cosLights[i] * visibility;
                 }
             }
 
             // ƽ
-            if (!scene.areaLightBuffer.empty()) {
-                directLighting /= (4.0f * scene.areaLightBuffer.size());
+            if (lightCount > 0) {
+                directLighting /= (4.0f * lightCount);
             }
 
             // 
@@ -234,10 +786,16 @@ namespace SimplePathTracer
             }
 
             // ӹ
+            profiler.shaderCall();
             auto scattered = shaderPrograms[mtlHandle.index()]->shade(r, hitObject->hitPoint, hitObject->normal);
-            auto next = trace(scattered.ray, currDepth + 1);
-            float n_dot_in = glm::dot(hitObject->normal, scattered.ray.direction);
             float pdf = scattered.pdf;
+            // ʧܣpdfΪ0ʱټ0õNaNȾ
+            if (!(pdf > 0.f)) {
+                return scattered.emitted + directLighting;
+            }
+            auto next = trace<Profiler, Features>(scattered.ray, currDepth + 1, profiler);
+            // λڱ·ȡֵ
+            float n_dot_in = glm::abs(glm::dot(hitObject->normal, scattered.ray.direction));
 
             return scattered.emitted + directLighting + scattered.attenuation * next * n_dot_in / pdf;
         }
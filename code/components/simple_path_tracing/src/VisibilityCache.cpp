@@ -0,0 +1,86 @@
+#include "VisibilityCache.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace SimplePathTracer
+{
+    namespace
+    {
+        constexpr unsigned int CELLS_PER_AXIS = 256;    // ΧжԽ߷ϵ
+        constexpr unsigned int MAX_PROBES = 16;         // ̽
+        constexpr unsigned int LIGHT_BITS = 13;
+
+        uint64_t mix(uint64_t x) {
+            x ^= x >> 30;
+            x *= 0xbf58476d1ce4e5b9ull;
+            x ^= x >> 27;
+            x *= 0x94d049bb133111ebull;
+            x ^= x >> 31;
+            return x;
+        }
+
+        // ߵ᷽ĿɼԲͬ
+        uint64_t normalBin(const Vec3& n) {
+            Vec3 a = glm::abs(n);
+            if (a.x >= a.y && a.x >= a.z) return n.x >= 0 ? 0 : 1;
+            if (a.y >= a.z) return n.y >= 0 ? 2 : 3;
+            return n.z >= 0 ? 4 : 5;
+        }
+    }
+
+    VisibilityCache::VisibilityCache(const Vec3& sceneMin, const Vec3& sceneMax, unsigned int slotBits)
+        : slots             (make_unique<Slot[]>(size_t(1) << slotBits))
+        , mask              ((1u << slotBits) - 1)
+        , origin            (sceneMin)
+    {
+        float diagonal = glm::length(sceneMax - sceneMin);
+        invCellSize = diagonal > 0.f ? float(CELLS_PER_AXIS)/diagonal : 1.f;
+    }
+
+    uint32_t VisibilityCache::lookup(const Vec3& position, const Vec3& normal, unsigned int light) {
+        if (light + 1 >= (1u << LIGHT_BITS)) return NONE;
+        Vec3 cell = glm::floor((position - origin)*invCellSize);
+        // Χĵ㣨ƽϣڱԵ
+        auto coord = [](float c) { return uint64_t(std::clamp(c, 0.f, 65535.f)); };
+        uint64_t key = (coord(cell.x) << 48) | (coord(cell.y) << 32) | (coord(cell.z) << 16)
+            | (normalBin(normal) << LIGHT_BITS) | uint64_t(light + 1);
+        uint32_t index = uint32_t(mix(key)) & mask;
+        for (unsigned int i = 0; i < MAX_PROBES; i++) {
+            Slot& slot = slots[index];
+            uint64_t current = slot.key.load(memory_order_relaxed);
+            if (current == key) return index;
+            if (current == 0) {
+                if (slot.key.compare_exchange_strong(current, key, memory_order_relaxed) || current == key) return index;
+            }
+            index = (index + 1) & mask;
+        }
+        return NONE;
+    }
+
+    auto VisibilityCache::state(uint32_t slot) const -> State {
+        uint32_t counts = slots[slot].counts.load(memory_order_relaxed);
+        uint32_t visible = counts >> 16;
+        uint32_t total = counts & 0xffff;
+        if (total < MIN_SAMPLES) return State::UNKNOWN;
+        if (visible == total) return State::VISIBLE;
+        if (visible == 0) return State::OCCLUDED;
+        return State::UNKNOWN;
+    }
+
+    void VisibilityCache::record(uint32_t slot, unsigned int visible, unsigned int total) {
+        if (total == 0) return;
+        auto& counts = slots[slot].counts;
+        uint32_t current = counts.load(memory_order_relaxed);
+        uint32_t next;
+        do {
+            uint32_t v = (current >> 16) + visible;
+            uint32_t t = (current & 0xffff) + total;
+            if (t > MAX_SAMPLES) {
+                v /= 2;
+                t /= 2;
+            }
+            next = (v << 16) | t;
+        } while (!counts.compare_exchange_weak(current, next, memory_order_relaxed));
+    }
+}
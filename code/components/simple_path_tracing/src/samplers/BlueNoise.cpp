@@ -0,0 +1,168 @@
+#include "samplers/BlueNoise.hpp"
+
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <cmath>
+
+namespace SimplePathTracer
+{
+    using namespace std;
+
+    namespace
+    {
+        constexpr int N = BlueNoiseMask::SIZE;
+        constexpr int AREA = N*N;
+
+        // ÿѷõĵ㰴ƾĸ˹Χ
+        // ߵѷõܵŴأ͵ĿλĿն
+        class EnergyField
+        {
+        private:
+            vector<float> kernel;   // ȡֵĸ˹
+            vector<float> energy;
+        public:
+            vector<char> filled;
+
+            EnergyField()
+                : kernel            (AREA)
+                , energy            (AREA, 0.f)
+                , filled            (AREA, 0)
+            {
+                const float sigma = 1.5f;
+                for (int dy = 0; dy < N; dy++) {
+                    for (int dx = 0; dx < N; dx++) {
+                        int x = min(dx, N - dx);
+                        int y = min(dy, N - dy);
+                        kernel[dy*N + dx] = exp(-float(x*x + y*y)/(2.f*sigma*sigma));
+                    }
+                }
+            }
+
+            void set(int index, bool on) {
+                filled[index] = on ? 1 : 0;
+                float sign = on ? 1.f : -1.f;
+                int px = index % N, py = index / N;
+                for (int y = 0; y < N; y++) {
+                    const float* row = &kernel[((y - py + N) & (N - 1))*N];
+                    float* e = &energy[y*N];
+                    for (int x = 0; x < N; x++) {
+                        e[x] += sign*row[(x - px + N) & (N - 1)];
+                    }
+                }
+            }
+
+            int tightestCluster() const {
+                int best = -1;
+                for (int i = 0; i < AREA; i++) {
+                    if (filled[i] && (best < 0 || energy[i] > energy[best])) best = i;
+                }
+                return best;
+            }
+
+            int largestVoid() const {
+                int best = -1;
+                for (int i = 0; i < AREA; i++) {
+                    if (!filled[i] && (best < 0 || energy[i] < energy[best])) best = i;
+                }
+                return best;
+            }
+        };
+    }
+
+    BlueNoiseMask::BlueNoiseMask() {
+        // ʼͼԼʮ֮һĵ㣬ʹù̶ӣ֤ÿɵͼͬ
+        EnergyField field{};
+        mt19937 rng{20050};
+        const int initial = AREA/10;
+        for (int placed = 0; placed < initial; ) {
+            int i = int(rng() % AREA);
+            if (field.filled[i]) continue;
+            field.set(i, true);
+            placed++;
+        }
+        // ŴеĵƵնֱͼȶ
+        for (int iteration = 0; iteration < AREA; iteration++) {
+            int cluster = field.tightestCluster();
+            field.set(cluster, false);
+            int hole = field.largestVoid();
+            field.set(hole, true);
+            if (hole == cluster) break;
+        }
+
+        vector<int> rank(AREA, 0);
+        // ׶һӳʼͼƳŴеĵ㣬Ӹߵ
+        EnergyField removing = field;
+        for (int r = initial - 1; r >= 0; r--) {
+            int cluster = removing.tightestCluster();
+            removing.set(cluster, false);
+            rank[cluster] = r;
+        }
+        // ׶ζӳʼͼʼնӵ͵
+        for (int r = initial; r < AREA; r++) {
+            int hole = field.largestVoid();
+            field.set(hole, true);
+            rank[hole] = r;
+        }
+        for (int i = 0; i < AREA; i++) {
+            values[i] = (float(rank[i]) + 0.5f)/float(AREA);
+        }
+
+        // άȡֵһһάȡֵڶȡֲֵУ
+        // ٽؼĵڶԽGeorgievFajardoķ
+        // ʹصȡֵڶάҲ˴Զ
+        for (int i = 0; i < AREA; i++) {
+            pairs[i] = (float(i) + 0.5f)/float(AREA);
+        }
+        shuffle(pairs, pairs + AREA, rng);
+        constexpr int RADIUS = 3;           // ռ˵Ľضϰ뾶
+        constexpr float SIGMA = 2.1f;       // ռ˵ı׼
+        float spatial[2*RADIUS + 1][2*RADIUS + 1];
+        for (int dy = -RADIUS; dy <= RADIUS; dy++) {
+            for (int dx = -RADIUS; dx <= RADIUS; dx++) {
+                spatial[dy + RADIUS][dx + RADIUS] = exp(-float(dx*dx + dy*dy)/(SIGMA*SIGMA));
+            }
+        }
+        // pȡֵΪ(u, v)ʱotherΪһ
+        auto localEnergy = [&](int p, float u, float v, int other) {
+            int px = p % N, py = p / N;
+            float e = 0.f;
+            for (int dy = -RADIUS; dy <= RADIUS; dy++) {
+                for (int dx = -RADIUS; dx <= RADIUS; dx++) {
+                    int q = ((py + dy) & (N - 1))*N + ((px + dx) & (N - 1));
+                    if (q == p || q == other) continue;
+                    float du = values[q] - u;
+                    float dv = pairs[q] - v;
+                    e += spatial[dy + RADIUS][dx + RADIUS]*exp(-sqrt(du*du + dv*dv));
+                }
+            }
+            return e;
+        };
+        for (int iteration = 0; iteration < 16*AREA; iteration++) {
+            int a = int(rng() % AREA);
+            int b = int(rng() % AREA);
+            if (a == b) continue;
+            float before = localEnergy(a, values[a], pairs[a], b) + localEnergy(b, values[b], pairs[b], a);
+            float after = localEnergy(a, values[a], pairs[b], b) + localEnergy(b, values[b], pairs[a], a);
+            if (after < before) swap(pairs[a], pairs[b]);
+        }
+    }
+
+    void SampleStream::enable(bool on) {
+        enabled = on;
+        if (!on) return;
+        mask = &BlueNoiseMask::instance();
+        // ֡ӻϵõƽ
+        unsigned int x = frameSeed()*0x9E3779B9u;
+        x = (x ^ (x >> 16))*0x7FEB352Du;
+        x = (x ^ (x >> 15))*0x846CA68Bu;
+        x ^= x >> 16;
+        seedX = int(x % BlueNoiseMask::SIZE);
+        seedY = int((x >> 16) % BlueNoiseMask::SIZE);
+        for (unsigned int d = 0; d < MAX_DIMENSIONS; d++) {
+            // ƽȡR2Уʹάͼϵλ÷ɢ
+            offsetX[d] = int(fraction(0.5 + 0.7548776662466927*d)*BlueNoiseMask::SIZE);
+            offsetY[d] = int(fraction(0.5 + 0.5698402909980532*d)*BlueNoiseMask::SIZE);
+        }
+    }
+}
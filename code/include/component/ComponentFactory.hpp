@@ -3,6 +3,7 @@
 #define __NR_COMPONENT_FACTORY_HPP__
 
 #include "Instance.hpp"
+#include "server/InstrumentedMutex.hpp"
 #include <functional>
 #include <unordered_map>
 #include <vector>
@@ -20,6 +21,7 @@ namespace NRenderer
     {
         ComponentInfo info;
         function<SharedInstance()> constructor;
+        function<bool()> loader;    // ǿձʾڵĿδأúеע滻Ŀ
     };
     class DLL_EXPORT ComponentFactory final
     {
@@ -28,6 +30,11 @@ namespace NRenderer
         virtual ~ComponentFactory() = default;
         bool registerComponent(const string& type, const string& name, const string& description, function<SharedInstance()> constructor);
         void unregisterComponent(const string& type, const string& name);
+        // Ǽδص״δʱloaderڵĿ
+        // : ǷǼǳɹͬѴʱԣ
+        bool registerLazyComponent(const string& type, const string& name, const string& description, function<bool()> loader);
+        // ƳδصĿѼصӰ
+        void unregisterLazyComponent(const string& type, const string& name);
         template<typename T>
         shared_ptr<T> createComponent(const string& type, const string& name) {
             return static_pointer_cast<T>(createInstance(type, name));
@@ -42,6 +49,7 @@ namespace NRenderer
             return prefix + "." + type + "." + id;
         }
         unordered_map<string, unordered_map<string, ComponentWrapper> > constructors;
+        mutable InstrumentedMutex mtx{"ComponentFactory"};  // ڸԵDLL߳עᣬȾ߳д
     };
 } // namespace NRenderer
 
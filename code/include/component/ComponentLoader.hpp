@@ -0,0 +1,72 @@
+// 
+// ͨ嵥ļӳټ̬⣺ʱֻȡ嵥ǼϢ״δʱżضӦĿ
+#pragma once
+#ifndef __NR_COMPONENT_LOADER_HPP__
+#define __NR_COMPONENT_LOADER_HPP__
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+#include "ComponentFactory.hpp"
+#include "server/DynamicLibrary.hpp"
+#include "server/InstrumentedMutex.hpp"
+
+namespace NRenderer
+{
+    using namespace std;
+
+    // 嵥еһ̬Ŀ
+    struct DLL_EXPORT ManifestEntry
+    {
+        string file;                        // ļĿ¼
+        uintmax_t size = 0;                 // ļС
+        int64_t modifiedTime = 0;           // ޸ʱ
+        vector<ComponentInfo> components;   // ע
+    };
+
+    // 
+    // 嵥ļȱʧ𻵻ļһ£С޸ʱ仯ʱضӦĿռϢ
+    // ԶдĿ¼嵥ֻʽsaveManifestʱдNRCli list --write-manifest
+    class DLL_EXPORT ComponentLoader
+    {
+    private:
+        string directory;                                   // Ŀ¼
+        vector<ManifestEntry> entries;                      // ǰ嵥
+        vector<unique_ptr<DynamicLibrary>> libraries;       // ѼصĶ̬
+        vector<pair<string, string>> lazyComponents;        // δصͣƣ
+        bool stale = false;                                 // 嵥ļǷĿ¼һ
+        mutable InstrumentedMutex mtx{"ComponentLoader"};
+
+        // Ŀ¼µָ⣨Ѽʱֱӷأ
+        // : Ƿسɹ
+        bool load(const string& file);
+        // ָǷѼأ
+        bool isLoaded(const string& file) const;
+        bool readManifest(const string& path, vector<ManifestEntry>& result) const;
+        bool writeManifest(const string& path) const;
+    public:
+        ComponentLoader() = default;
+        ComponentLoader(const ComponentLoader&) = delete;
+        ~ComponentLoader();
+
+        // ɨĿ¼嵥Ǽ嵥ڵĿֱӼ
+        // directory: Ŀ¼
+        // : Ǽǵ
+        size_t init(const string& directory);
+
+        // ȡǰ嵥
+        vector<ManifestEntry> getManifest() const;
+        // 嵥ļǷȱʧ
+        bool isManifestStale() const;
+        // ѵǰ嵥дĿ¼
+        // : Ƿдɹ
+        bool saveManifest();
+
+        // 嵥ļ
+        static constexpr const char* MANIFEST_FILE = "components.manifest";
+    };
+} // namespace NRenderer
+
+#endif
@@ -0,0 +1,112 @@
+// 決նȶ
+// ̬նȺ決ΰ㡢尴᷽ƽ水ͼ洢
+// ɺ決㣬泡ʲ棬RayCastʵʱʾȫֹ
+#pragma once
+#ifndef __NR_BAKED_IRRADIANCE_HPP__
+#define __NR_BAKED_IRRADIANCE_HPP__
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "Model.hpp"
+#include "IrradianceVolume.hpp"
+#include "common/macros.hpp"
+#include "server/InstrumentedMutex.hpp"
+
+namespace NRenderer
+{
+    using namespace std;
+
+    // 決ն
+    // PreparedSceneеļһһӦkeyΪݵĹϣ仯
+    // նΪֵĳΪ *ն/
+    class DLL_EXPORT BakedIrradiance
+    {
+    public:
+        static constexpr unsigned int DEFAULT_PLANE_RESOLUTION = 32;   // ƽͼĬϱ߳texel
+
+        uint64_t key;                   // ݵĹϣPreparedScene::keyȽ
+        unsigned int planeResolution;   // ƽͼı߳
+        vector<Vec3> triangles;         // ÿ3ķն
+        vector<Vec3> spheres;           // ÿ6+x-x+y-y+z-zķն
+        vector<Vec3> planes;            // ÿƽplaneResolution*planeResolutiontexelķնȣvд
+
+        BakedIrradiance()
+            : key               (0)
+            , planeResolution   (DEFAULT_PLANE_RESOLUTION)
+            , triangles         ()
+            , spheres           ()
+            , planes            ()
+        {}
+        // 洢նȳʼΪ0
+        BakedIrradiance(uint64_t key, size_t triangleCount, size_t sphereCount, size_t planeCount,
+            unsigned int planeResolution = DEFAULT_PLANE_RESOLUTION);
+        ~BakedIrradiance() = default;
+
+        // NRServerд決빹캯ͬ
+        // ָĿƿɾ֮λNRServerжغԿɰȫͷţӦʹcreatemake_shared
+        static shared_ptr<BakedIrradiance> create(uint64_t key, size_t triangleCount, size_t sphereCount, size_t planeCount,
+            unsigned int planeResolution = DEFAULT_PLANE_RESOLUTION);
+
+        // ƽͼtexel(s, t)±
+        size_t planeTexel(Index plane, unsigned int s, unsigned int t) const {
+            return (size_t(plane)*planeResolution + t)*planeResolution + s;
+        }
+
+        // һķնȣڶֵ
+        // triangle: µΣpoint: ϵĵ
+        Vec3 triangle(Index index, const Triangle& triangle, const Vec3& point) const;
+        // һķնȣֵ
+        Vec3 sphere(Index index, const Vec3& normal) const;
+        // ƽһķնȣڹͼ˫Բֵ
+        // plane: µƽ棬point: ƽϵĵ
+        Vec3 plane(Index index, const Plane& plane, const Vec3& point) const;
+
+        // дƺ決ļ
+        // : Ƿдɹ
+        bool write(const string& path) const;
+        // ȡƺ決ļ
+        // : Ƿȡɹʧʱֲ
+        bool read(const string& path);
+    };
+    using SharedBakedIrradiance = shared_ptr<const BakedIrradiance>;
+
+    // ǰĺ決ն
+    // 決Ⱦ߳з̱߳浽ʲԱߣʵʱȡ
+    // ֻ̽ڴУ̽決
+    class DLL_EXPORT IrradianceStore
+    {
+    private:
+        mutable InstrumentedMutex mtx;  // ³Ա
+        SharedBakedIrradiance current;  // ǰĺ決
+        bool unsaved;                   // currentǷΪδº決
+        SharedIrradianceVolume volume;  // ǰ̽
+    public:
+        IrradianceStore()
+            : mtx               ("IrradianceStore")
+            , current           ()
+            , unsaved           (false)
+            , volume            ()
+        {}
+        IrradianceStore(const IrradianceStore&) = delete;
+        ~IrradianceStore() = default;
+
+        // µĺ決Ϊδ
+        void publish(SharedBakedIrradiance baked);
+        // ôļȡĺ決
+        void restore(SharedBakedIrradiance baked);
+        // ȡǰĺ決ûʱΪ
+        SharedBakedIrradiance get() const;
+        // ȡδĺ決Ϊѱ棬ûʱΪ
+        SharedBakedIrradiance takeUnsaved();
+        // µ̽
+        void publishVolume(SharedIrradianceVolume volume);
+        // ȡǰ̽ûʱΪ
+        SharedIrradianceVolume getVolume() const;
+        // 決̽
+        void clear();
+    };
+} // namespace NRenderer
+
+#endif
@@ -0,0 +1,96 @@
+// ն̽
+// Χڹϵ̽룬ÿ̽г¼
+// ̽決㣬ֲ仯ֻº決̽룬RayCastʵʱֵཻõƵȫֹ
+#pragma once
+#ifndef __NR_IRRADIANCE_VOLUME_HPP__
+#define __NR_IRRADIANCE_VOLUME_HPP__
+
+#include <vector>
+#include <cstdint>
+
+#include "Scene.hpp"
+#include "PreparedScene.hpp"
+#include "common/macros.hpp"
+
+namespace NRenderer
+{
+    using namespace std;
+
+    // ն̽
+    // keyΪ決ʱݵĹϣlightingKeyΪԴ뻷Ĺϣ뵱ǰͬʱ
+    // նΪֵĳΪ *ն/
+    class DLL_EXPORT IrradianceVolume
+    {
+    public:
+        static constexpr unsigned int SH_COEFFICIENTS = 9;      // гϵ
+        static constexpr unsigned int DEFAULT_RESOLUTION = 16;  // ΧϵĬ̽
+        static constexpr float INVALID_BACKFACE_RATIO = 0.25f;  // 屳Ĺֵ߱̽λڼڲֵ
+
+        uint64_t key;                   // ݵĹϣPreparedScene::keyȽ
+        uint64_t lightingKey;           // Դ뻷ĹϣhashLightingĽȽ
+        unsigned int samples;           // ÿ̽Ĳ
+        Vec3 origin;                    // һ̽λãΧСԪģ
+        Vec3 spacing;                   // ̽ڸϵļ
+        glm::uvec3 counts;              // ϵ̽
+        vector<Vec3> coefficients;      // ÿ̽SH_COEFFICIENTSȵгϵxyz˳̽
+        vector<uint8_t> valid;          // ̽Ƿֵ
+        SharedPreparedScene source;     // 決ʱԤʱ³Ƚϱ޸ĵļ
+
+        IrradianceVolume()
+            : key               (0)
+            , lightingKey       (0)
+            , samples           (0)
+            , origin            (0.f)
+            , spacing           (1.f)
+            , counts            (0)
+            , coefficients      ()
+            , valid             ()
+            , source            ()
+        {}
+        // ڰΧڰԪķ̽룬Ϊresolutionᰴͬļȡ
+        // ϵʼΪ0̽ʼΪЧ
+        IrradianceVolume(uint64_t key, uint64_t lightingKey, unsigned int samples,
+            const Vec3& min, const Vec3& max, unsigned int resolution = DEFAULT_RESOLUTION);
+        ~IrradianceVolume() = default;
+
+        // NRServerд̽빹캯ͬ
+        // BakedIrradiance::createͬӦʹcreateʹƿ鲻ж
+        static shared_ptr<IrradianceVolume> create(uint64_t key, uint64_t lightingKey, unsigned int samples,
+            const Vec3& min, const Vec3& max, unsigned int resolution = DEFAULT_RESOLUTION);
+
+        // ̽
+        size_t size() const {
+            return valid.size();
+        }
+        // Ϊ(x, y, z)̽±
+        size_t probe(unsigned int x, unsigned int y, unsigned int z) const {
+            return (size_t(z)*counts.y + y)*counts.x + x;
+        }
+        // ̽λã꣩
+        Vec3 position(size_t probe) const;
+        // Ƿһͬͬʱߵ̽һһӦ
+        bool sameGrid(const IrradianceVolume& other) const;
+
+        // һķն
+        // ڰΧõ8̽ԲֵųЧ̽룬λڱ汳̽ȨغСմǽй©
+        // position: ϵĵ㣬normal: ۲ߵĵλ
+        Vec3 irradiance(const Vec3& position, const Vec3& normal) const;
+
+        // [min, max]ľ벻margin̽
+        vector<size_t> probesNear(const Vec3& min, const Vec3& max, float margin) const;
+
+        // λϵгֵ
+        static void shBasis(const Vec3& direction, float basis[SH_COEFFICIENTS]);
+        // ȵгϵ㷨߷ϵķնȣҺ˾
+        static Vec3 shIrradiance(const Vec3* coefficients, const Vec3& normal);
+
+        // Ԥб޸ĵļ壨޸ǰ󣩵İΧ
+        // : ߵͼԪͬȽʱΪtrueû޸ʱminķmax
+        static bool changedBounds(const PreparedScene& previous, const PreparedScene& current, Vec3& min, Vec3& max);
+        // Ӱ·׷ٽĹԴ뻷Ĺϣ
+        static uint64_t hashLighting(const Scene& scene);
+    };
+    using SharedIrradianceVolume = shared_ptr<const IrradianceVolume>;
+} // namespace NRenderer
+
+#endif
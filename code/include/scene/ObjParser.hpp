@@ -0,0 +1,46 @@
+// OBJģļ
+// OpenGL.obj.mtlʿΪݴֻ¼·ɵ߽
+#pragma once
+#ifndef __NR_OBJ_PARSER_HPP__
+#define __NR_OBJ_PARSER_HPP__
+
+#include <string>
+#include <istream>
+#include <unordered_map>
+
+#include "StagedScene.hpp"
+#include "common/macros.hpp"
+
+namespace NRenderer
+{
+    using namespace std;
+
+    // OBJ
+    // ļΪһģͣÿo/gΪһڵ㣬ֻ֧ǻ
+    class DLL_EXPORT ObjParser
+    {
+    private:
+        string lastErrorInfo;   // һδϢ
+
+        // MTLʿ
+        // directory: ʿĿ¼ڶλļ
+        bool parseMtl(StagedScene& staged, const string& directory, istream& in, unordered_map<string, size_t>& mtlMap);
+    public:
+        ObjParser()
+            : lastErrorInfo     ()
+        {}
+        ~ObjParser() = default;
+
+        // .objļݴ
+        // progress: ȡǣΪ
+        // : Ƿɹȡʱfalse
+        bool stageFile(const string& path, StagedScene& staged, ImportProgress* progress = nullptr);
+
+        // ȡϢ
+        string getErrorInfo() const {
+            return lastErrorInfo;
+        }
+    };
+} // namespace NRenderer
+
+#endif
@@ -0,0 +1,549 @@
+// Ԥ
+// ȾõĳԤµļٽṹɷݻ
+// ͬһлȾRayCastԤSimplePathTracerȾʱظԤ
+#pragma once
+#ifndef __NR_PREPARED_SCENE_HPP__
+#define __NR_PREPARED_SCENE_HPP__
+
+#include <vector>
+#include <list>
+#include <memory>
+#include <cstdint>
+#include <algorithm>
+#include <mutex>
+#include <atomic>
+#include <cmath>
+#include <limits>
+
+#include "Scene.hpp"
+#include "common/macros.hpp"
+#include "server/InstrumentedMutex.hpp"
+
+// x86ƽ̨Ϲ߰İΧвʹSSE
+#if defined(_M_X64) || defined(__SSE2__)
+    #include <xmmintrin.h>
+    #define NR_PACKET_SSE 1
+#else
+    #define NR_PACKET_SSE 0
+#endif
+
+namespace NRenderer
+{
+    using namespace std;
+
+    // ٽṹеͼԪ
+    struct PrimitiveRef
+    {
+        enum class Type : uint32_t
+        {
+            SPHERE,
+            TRIANGLE,
+            PLANE
+        };
+        Type type;      // ͼԪ
+        Index index;    // PreparedSceneӦе±
+    };
+
+    // ƽBVHڵ
+    // ڵ㰴˳ţڲڵӽڵӽڵ±Ϊoffset
+    // ҶӽڵͼԪΪprimitives[offset, offset + count)
+    struct BvhNode
+    {
+        Vec3 min;           // ΧС
+        uint32_t offset;    // ڲڵ㣺ӽڵ±ꣻҶӽڵ㣺һͼԪ±
+        Vec3 max;           // Χ
+        uint16_t count;     // ҶӽڵͼԪ0ʾڲڵ
+        uint16_t axis;      // ڲڵĻᣬڰ߷˳
+    };
+
+    // 4ɵĹ߰
+    // ֻжڵĹߣͬһɫͬһԴӰߣ4߹һBVH
+    // 뷽ֿţΧвԶ4ͬʱ
+    struct RayPacket4
+    {
+        static constexpr int SIZE = 4;
+        alignas(16) float origin[3][SIZE];      // xyz
+        alignas(16) float invDir[3][SIZE];      // xyz
+        alignas(16) float tMin[SIZE];
+        alignas(16) float tMax[SIZE];
+        Vec3 origins[SIZE];                     // 㣬ͼԪ󽻺ʹ
+        Vec3 directions[SIZE];                  // 
+        unsigned int active = 0;                // ԵĹ룬ֻδڵĹ
+
+        // õlane߲ʹԣδõĹ߲
+        void set(int lane, const Vec3& o, const Vec3& d, float t0, float t1) {
+            const Vec3 inv = 1.f/d;
+            for (int a = 0; a < 3; a++) {
+                origin[a][lane] = o[a];
+                invDir[a][lane] = inv[a];
+            }
+            tMin[lane] = t0;
+            tMax[lane] = t1;
+            origins[lane] = o;
+            directions[lane] = d;
+            active |= 1u << lane;
+        }
+
+        bool isActive(int lane) const {
+            return (active & (1u << lane)) != 0;
+        }
+    };
+
+    // BVH
+    // Ⱦ޹أֻͼԪãڱʱԼ󽻺ͼԪ
+    // ӳٹʱֻϲڵ㣬ͼԪlazySizeռλڵ棬
+    // ߵһνռλڵʱŹÿֻһΣ߳ͬʱʱ̵߳ȴ
+    class DLL_EXPORT SceneBvh
+    {
+    public:
+        static constexpr uint16_t LAZY = 0xFFFF;    // ռλڵcountoffsetΪsubtreesе±
+
+        // ӳٹ
+        struct Subtree
+        {
+            once_flag once;                 // ֻ֤һ
+            atomic<bool> built{false};      // Ƿѹͳ
+            vector<PrimitiveRef> primitives;    // ǰΪͼԪҶӽڵ
+            vector<BvhNode> nodes;          // Ľڵ㣬ٰռλڵ
+        };
+
+        vector<BvhNode> nodes;
+        vector<PrimitiveRef> primitives;
+        vector<shared_ptr<Subtree>> subtrees;   // ӳٹBVHʱ
+
+        // µļ幹
+        // lazySize: 0ʱӳٹͼԪֵBVHʹڼ뱣ЧҲ޸
+        // threads: ӳٹʱ1Ȼֳϲڵ㣬ɶ߳ͬʱ²뵥̹߳ͬ
+        void build(const vector<Sphere>& spheres, const vector<Triangle>& triangles, const vector<Plane>& planes, size_t lazySize = 0, unsigned int threads = 1);
+        // ṹ䣬޸ĺļԵ¼Χ
+        // 빹ʱֻͬʺСΧ޸ģΧƶήͱЧ
+        // ֧ӳٹBVH
+        void refit(const vector<Sphere>& spheres, const vector<Triangle>& triangles, const vector<Plane>& planes);
+
+        // Ƿӳٹ
+        bool isLazy() const {
+            return !subtrees.empty();
+        }
+        // ѹӳ
+        size_t builtSubtrees() const;
+
+        // ཻҶӽڵ
+        // hit:  float(const PrimitiveRef&, float tMax) ĺµ루δཻʱشtMax
+        // : ʵĽڵ
+        template<typename Hit>
+        unsigned int traverse(const Vec3& origin, const Vec3& direction, float tMin, float tMax, Hit&& hit) const {
+            if (nodes.empty()) return 0;
+            const Vec3 invDir = 1.f/direction;
+            const bool negative[3] = { invDir.x < 0.f, invDir.y < 0.f, invDir.z < 0.f };
+            unsigned int visited = 0;
+            traverseNodes(nodes.data(), primitives.data(), origin, invDir, negative, tMin, tMax, hit, visited);
+            return visited;
+        }
+
+        // ߰ڵ
+        // 4߹һαڵֻҪһԵĹཻͼ£ڵĹ˳ȫڵʱ
+        // occluded:  bool(const PrimitiveRef&, int lane) ĺصlane[tMin, tMax)ǷͼԪཻ
+        // : ʵĽڵpacket.activeֻδڵĹ
+        template<typename Occluded>
+        unsigned int occluded4(RayPacket4& packet, Occluded&& occluded) const {
+            if (nodes.empty() || packet.active == 0) return 0;
+            // Ӱ߷һԵĹ߾ӽڵķ˳
+            int first = 0;
+            while (!packet.isActive(first)) first++;
+            const bool negative[3] = { packet.invDir[0][first] < 0.f, packet.invDir[1][first] < 0.f, packet.invDir[2][first] < 0.f };
+            unsigned int visited = 0;
+            occludeNodes(nodes.data(), primitives.data(), packet, negative, occluded, visited);
+            return visited;
+        }
+
+    private:
+        // ӳļ壬ָ򹹽ʱݣƶȻЧ
+        const Sphere* lazySpheres = nullptr;
+        const Triangle* lazyTriangles = nullptr;
+        const Plane* lazyPlanes = nullptr;
+
+        // ѹδʱȹ
+        const Subtree& expand(uint32_t subtree) const;
+
+        template<typename Hit>
+        void traverseNodes(const BvhNode* nodes, const PrimitiveRef* primitives, const Vec3& origin, const Vec3& invDir,
+            const bool negative[3], float tMin, float& tMax, Hit& hit, unsigned int& visited) const {
+            uint32_t stack[64];
+            int top = 0;
+            uint32_t current = 0;
+            while (true) {
+                const BvhNode& node = nodes[current];
+                visited++;
+                if (intersectBox(node, origin, invDir, tMin, tMax)) {
+                    if (node.count == LAZY) {
+                        // ڲռλڵ㣬ݹһ
+                        const Subtree& subtree = expand(node.offset);
+                        traverseNodes(subtree.nodes.data(), subtree.primitives.data(), origin, invDir, negative, tMin, tMax, hit, visited);
+                    }
+                    else if (node.count > 0) {
+                        for (uint32_t i = node.offset; i < node.offset + node.count; i++) {
+                            tMax = hit(primitives[i], tMax);
+                        }
+                    }
+                    else {
+                        // ȷʹ߷ϽϽӽڵ
+                        if (negative[node.axis]) {
+                            stack[top++] = current + 1;
+                            current = node.offset;
+                        }
+                        else {
+                            stack[top++] = node.offset;
+                            current = current + 1;
+                        }
+                        continue;
+                    }
+                }
+                if (top == 0) break;
+                current = stack[--top];
+            }
+        }
+
+        template<typename Occluded>
+        void occludeNodes(const BvhNode* nodes, const PrimitiveRef* primitives, RayPacket4& packet,
+            const bool negative[3], Occluded& occluded, unsigned int& visited) const {
+            uint32_t stack[64];
+            int top = 0;
+            uint32_t current = 0;
+            while (true) {
+                const BvhNode& node = nodes[current];
+                visited++;
+                unsigned int mask = intersectBox4(node, packet) & packet.active;
+                if (mask != 0) {
+                    if (node.count == LAZY) {
+                        const Subtree& subtree = expand(node.offset);
+                        occludeNodes(subtree.nodes.data(), subtree.primitives.data(), packet, negative, occluded, visited);
+                        if (packet.active == 0) break;
+                    }
+                    else if (node.count > 0) {
+                        for (uint32_t i = node.offset; i < node.offset + node.count && mask != 0; i++) {
+                            for (int lane = 0; lane < RayPacket4::SIZE; lane++) {
+                                if ((mask & (1u << lane)) != 0 && occluded(primitives[i], lane)) {
+                                    mask &= ~(1u << lane);
+                                    packet.active &= ~(1u << lane);
+                                }
+                            }
+                        }
+                        if (packet.active == 0) break;
+                    }
+                    else {
+                        if (negative[node.axis]) {
+                            stack[top++] = current + 1;
+                            current = node.offset;
+                        }
+                        else {
+                            stack[top++] = node.offset;
+                            current = current + 1;
+                        }
+                        continue;
+                    }
+                }
+                if (top == 0) break;
+                current = stack[--top];
+            }
+        }
+
+        static bool intersectBox(const BvhNode& node, const Vec3& origin, const Vec3& invDir, float tMin, float tMax) {
+            Vec3 t0 = (node.min - origin)*invDir;
+            Vec3 t1 = (node.max - origin)*invDir;
+            Vec3 tNear = glm::min(t0, t1);
+            Vec3 tFar = glm::max(t0, t1);
+            float enter = std::max(std::max(tNear.x, tNear.y), std::max(tNear.z, tMin));
+            float exit = std::min(std::min(tFar.x, tFar.y), std::min(tFar.z, tMax));
+            return enter <= exit;
+        }
+
+        // 4ͬʱΧ󽻣ཻߵ
+        static unsigned int intersectBox4(const BvhNode& node, const RayPacket4& packet) {
+#if NR_PACKET_SSE
+            __m128 enter = _mm_load_ps(packet.tMin);
+            __m128 exit = _mm_load_ps(packet.tMax);
+            for (int a = 0; a < 3; a++) {
+                __m128 o = _mm_load_ps(packet.origin[a]);
+                __m128 inv = _mm_load_ps(packet.invDir[a]);
+                __m128 t0 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.min[a]), o), inv);
+                __m128 t1 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.max[a]), o), inv);
+                enter = _mm_max_ps(enter, _mm_min_ps(t0, t1));
+                exit = _mm_min_ps(exit, _mm_max_ps(t0, t1));
+            }
+            return unsigned(_mm_movemask_ps(_mm_cmple_ps(enter, exit)));
+#else
+            unsigned int mask = 0;
+            for (int lane = 0; lane < RayPacket4::SIZE; lane++) {
+                float enter = packet.tMin[lane];
+                float exit = packet.tMax[lane];
+                for (int a = 0; a < 3; a++) {
+                    float t0 = (node.min[a] - packet.origin[a][lane])*packet.invDir[a][lane];
+                    float t1 = (node.max[a] - packet.origin[a][lane])*packet.invDir[a][lane];
+                    enter = std::max(enter, std::min(t0, t1));
+                    exit = std::min(exit, std::max(t0, t1));
+                }
+                if (enter <= exit) mask |= 1u << lane;
+            }
+            return mask;
+#endif
+        }
+    };
+
+    // 
+    // SceneBvhĲѯӿͬʺϴСֲȵͼԪͬС塢Σ
+    // һ㰴ͼԪ־ͼԪý϶ĵԪٻΪڶ񣬹3D-DDA˳ʵԪ
+    // ԽԪͼԪÿԪжãʱͬһͼԪܱԶ
+    class DLL_EXPORT SceneGrid
+    {
+    public:
+        static constexpr uint32_t SUBGRID = 0xFFFFFFFF;     // ΪڶĵԪcountoffsetΪsubgridsе±
+
+        // ԪͼԪΪprimitives[offset, offset + count)
+        struct Cell
+        {
+            uint32_t offset;
+            uint32_t count;
+        };
+
+        // ڶ񣬸ǵһһԪ
+        struct Subgrid
+        {
+            Vec3 min;                   // ΧС
+            Vec3 cellSize;              // ԪС
+            glm::uvec3 resolution;      // ĵԪ
+            uint32_t firstCell;         // һԪcellsе±
+        };
+
+        Vec3 min{0.f};                  // ΧС
+        Vec3 max{0.f};                  // Χ
+        Vec3 cellSize{1.f};             // һĵԪС
+        glm::uvec3 resolution{0u};      // һĵԪ
+        vector<Cell> cells;             // һĵԪxyz˳ţ֮ǸڶĵԪ
+        vector<Subgrid> subgrids;
+        vector<PrimitiveRef> primitives;
+
+        // µļ幹
+        // ͼԪü뵥Ԫʱȣthreads1ʱ̷ֶ߳μд룬뵥̹߳ͬ
+        // requireUniform: ΪtrueʱһͳжͼԪֲظùࡢڼл󲿷ֵԪΪʱ
+        // : Ƿ񹹽ɣδʱΪ
+        bool build(const vector<Sphere>& spheres, const vector<Triangle>& triangles, const vector<Plane>& planes, unsigned int threads = 1, bool requireUniform = false);
+
+        bool empty() const {
+            return cells.empty();
+        }
+
+        // ཻĵԪӿSceneBvh::traverseͬ
+        // : ʵĵԪ
+        template<typename Hit>
+        unsigned int traverse(const Vec3& origin, const Vec3& direction, float tMin, float tMax, Hit&& hit) const {
+            if (cells.empty()) return 0;
+            const Vec3 invDir = 1.f/direction;
+            unsigned int visited = 0;
+            auto leaf = [&](const Cell& cell, float exit) {
+                for (uint32_t i = cell.offset; i < cell.offset + cell.count; i++) {
+                    tMax = hit(primitives[i], tMax);
+                }
+                // ڵǰԪ֮ʱ֮ĵԪ
+                return tMax > exit;
+            };
+            walkLeaves(origin, direction, invDir, tMin, tMax, leaf, visited);
+            return visited;
+        }
+
+        // ߰ڵԣӿSceneBvh::occluded4ͬ
+        // ߾ĵԪͬ߱ҵڵֹͣ
+        template<typename Occluded>
+        unsigned int occluded4(RayPacket4& packet, Occluded&& occluded) const {
+            if (cells.empty() || packet.active == 0) return 0;
+            unsigned int visited = 0;
+            for (int lane = 0; lane < RayPacket4::SIZE; lane++) {
+                if (!packet.isActive(lane)) continue;
+                const Vec3 invDir{ packet.invDir[0][lane], packet.invDir[1][lane], packet.invDir[2][lane] };
+                bool blocked = false;
+                auto leaf = [&](const Cell& cell, float) {
+                    for (uint32_t i = cell.offset; i < cell.offset + cell.count; i++) {
+                        if (occluded(primitives[i], lane)) {
+                            blocked = true;
+                            return false;
+                        }
+                    }
+                    return true;
+                };
+                walkLeaves(packet.origins[lane], packet.directions[lane], invDir, packet.tMin[lane], packet.tMax[lane], leaf, visited);
+                if (blocked) packet.active &= ~(1u << lane);
+            }
+            return visited;
+        }
+
+    private:
+        // ߾˳ʰͼԪĵԪ
+        // leaf:  bool(const Cell&, float exit) ĺexitΪ뿪õԪľ룬falseʱֹͣ
+        template<typename Leaf>
+        void walkLeaves(const Vec3& origin, const Vec3& direction, const Vec3& invDir, float tMin, float tMax, Leaf& leaf, unsigned int& visited) const {
+            walk(min, cellSize, resolution, 0, true, origin, direction, invDir, tMin, tMax, [&](uint32_t index, float enter, float exit) {
+                visited++;
+                const Cell& cell = cells[index];
+                if (cell.count == 0) return true;
+                if (cell.count != SUBGRID) return leaf(cell, exit);
+                // ڶֱʹõһ㵥Ԫ䣬ٴβüĸ©ӹԵĹ
+                const Subgrid& sub = subgrids[cell.offset];
+                return walk(sub.min, sub.cellSize, sub.resolution, sub.firstCell, false, origin, direction, invDir, enter, exit,
+                    [&](uint32_t inner, float, float innerExit) {
+                        visited++;
+                        const Cell& c = cells[inner];
+                        return c.count == 0 || leaf(c, innerExit);
+                    });
+            });
+        }
+
+        // 3D-DDA߾˳[tMin, tMax]ڵĵԪ
+        // clip: ǷȰüΧУüʱڵĵԪΧض
+        // visit:  bool(uint32_t cell, float enter, float exit) ĺfalseʱֹͣ
+        // : ǷȫԪδvisitֹͣ
+        template<typename Visit>
+        static bool walk(const Vec3& gridMin, const Vec3& cellSize, const glm::uvec3& resolution, uint32_t firstCell, bool clip,
+            const Vec3& origin, const Vec3& direction, const Vec3& invDir, float tMin, float tMax, Visit&& visit) {
+            const Vec3 gridMax = gridMin + cellSize*Vec3(resolution);
+            float enter = tMin;
+            float exit = tMax;
+            if (clip) {
+                for (int a = 0; a < 3; a++) {
+                    if (direction[a] == 0.f) {
+                        if (origin[a] < gridMin[a] || origin[a] > gridMax[a]) return true;
+                        continue;
+                    }
+                    float t0 = (gridMin[a] - origin[a])*invDir[a];
+                    float t1 = (gridMax[a] - origin[a])*invDir[a];
+                    enter = std::max(enter, std::min(t0, t1));
+                    exit = std::min(exit, std::max(t0, t1));
+                }
+                if (!(enter <= exit)) return true;
+            }
+            const Vec3 start = origin + enter*direction;
+            int cell[3], step[3];
+            float next[3], delta[3];
+            for (int a = 0; a < 3; a++) {
+                // ȽضϵΧȡȡͬ
+                cell[a] = int(std::clamp((start[a] - gridMin[a])/cellSize[a], 0.f, float(resolution[a] - 1)));
+                if (direction[a] > 0.f) {
+                    step[a] = 1;
+                    next[a] = (gridMin[a] + float(cell[a] + 1)*cellSize[a] - origin[a])*invDir[a];
+                    delta[a] = cellSize[a]*invDir[a];
+                }
+                else if (direction[a] < 0.f) {
+                    step[a] = -1;
+                    next[a] = (gridMin[a] + float(cell[a])*cellSize[a] - origin[a])*invDir[a];
+                    delta[a] = -cellSize[a]*invDir[a];
+                }
+                else {
+                    step[a] = 0;
+                    next[a] = numeric_limits<float>::infinity();
+                    delta[a] = 0.f;
+                }
+            }
+            float t = enter;
+            while (true) {
+                int axis = next[0] < next[1] ? (next[0] < next[2] ? 0 : 2) : (next[1] < next[2] ? 1 : 2);
+                float cellExit = std::min(next[axis], exit);
+                uint32_t index = firstCell + (uint32_t(cell[2])*resolution.y + uint32_t(cell[1]))*resolution.x + uint32_t(cell[0]);
+                if (!visit(index, t, cellExit)) return false;
+                if (next[axis] >= exit) return true;
+                cell[axis] += step[axis];
+                if (cell[axis] < 0 || cell[axis] >= int(resolution[axis])) return true;
+                t = next[axis];
+                next[axis] += delta[axis];
+            }
+        }
+    };
+
+    // Ԥĳ
+    // ɺֻɱȾ߳ͬʱʹ
+    // Ѱģ͵ƽƱ任꣬ʡԴԴԭȡ
+    struct PreparedScene
+    {
+        uint64_t key = 0;               // ݵĹϣ
+        vector<Sphere> spheres;         // µ壬Scene::sphereBufferһһӦ
+        vector<Triangle> triangles;     // µΣScene::triangleBufferһһӦ
+        vector<Plane> planes;           // µƽ棬Scene::planeBufferһһӦ
+        RenderOption::Accelerator accelerator = RenderOption::Accelerator::BVH;     // ʹõļٽṹֻBVHGRID
+        SceneBvh bvh;                   // BVHacceleratorΪBVHʱʹ
+        SceneGrid grid;                 // acceleratorΪGRIDʱʹ
+
+        // ʹõļٽṹ뷵ֵͬSceneBvh::traverse
+        template<typename Hit>
+        unsigned int traverse(const Vec3& origin, const Vec3& direction, float tMin, float tMax, Hit&& hit) const {
+            if (accelerator == RenderOption::Accelerator::GRID) return grid.traverse(origin, direction, tMin, tMax, hit);
+            return bvh.traverse(origin, direction, tMin, tMax, hit);
+        }
+
+        // ʹõļٽṹ߰ڵԣ뷵ֵͬSceneBvh::occluded4
+        template<typename Occluded>
+        unsigned int occluded4(RayPacket4& packet, Occluded&& occluded) const {
+            if (accelerator == RenderOption::Accelerator::GRID) return grid.occluded4(packet, occluded);
+            return bvh.occluded4(packet, occluded);
+        }
+
+        // Χ
+        // : Ƿм
+        bool bounds(Vec3& min, Vec3& max) const {
+            if (accelerator == RenderOption::Accelerator::GRID) {
+                if (grid.empty()) return false;
+                min = grid.min;
+                max = grid.max;
+                return true;
+            }
+            if (bvh.nodes.empty()) return false;
+            min = bvh.nodes[0].min;
+            max = bvh.nodes[0].max;
+            return true;
+        }
+    };
+    using SharedPreparedScene = shared_ptr<const PreparedScene>;
+
+    // Ԥ
+    // Գݣģͱ任ڵ뼸建壩ĹϣΪʹõ
+    class DLL_EXPORT PreparedSceneCache
+    {
+    private:
+        mutable InstrumentedMutex mtx;      // бڼУͬһظ
+        list<SharedPreparedScene> entries;  // ʹǰΪʹ
+        size_t capacity;                    // ౣĳ
+        uint64_t hits;                      // д
+        uint64_t misses;                    // δд
+        uint64_t refits;                    // δʱһν¼ΧеĴ
+    public:
+        PreparedSceneCache(size_t capacity = 2)
+            : mtx               ("PreparedSceneCache")
+            , entries           ()
+            , capacity          (capacity)
+            , hits              (0)
+            , misses            (0)
+            , refits            (0)
+        {}
+        PreparedSceneCache(const PreparedSceneCache&) = delete;
+        ~PreparedSceneCache() = default;
+    private:
+        // ѼĹϣԤ
+        static SharedPreparedScene build(const Scene& scene, uint64_t key, unsigned int threads);
+    public:
+
+        // 㳡ݵĹϣ
+        static uint64_t hashGeometry(const Scene& scene);
+        // Ԥ
+        // threads: BVH߳0ʾʹӲ߳
+        static SharedPreparedScene prepare(const Scene& scene, unsigned int threads = 0);
+
+        // ȡԤûʱ
+        // scene.renderOption.acceleratorѡٽṹAUTOʱͼԪ϶ҷֲȵĳʹ񣬲ɸһּٽṹĻ
+        // scene.changesȷ޸ķΧ޸ĽʱһνBVHṹֻ¼Χ
+        SharedPreparedScene acquire(const Scene& scene);
+        // ջ
+        void clear();
+
+        uint64_t getHits() const;
+        uint64_t getMisses() const;
+        uint64_t getRefits() const;
+    };
+} // namespace NRenderer
+
+#endif
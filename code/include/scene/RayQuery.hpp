@@ -0,0 +1,61 @@
+// ߲ѯ
+// ԤϳཻڵȾظʵֱBVHͼԪ󽻵ѭ
+#pragma once
+#ifndef __NR_RAY_QUERY_HPP__
+#define __NR_RAY_QUERY_HPP__
+
+#include <span>
+#include <limits>
+#include <cstdint>
+
+#include "PreparedScene.hpp"
+#include "common/macros.hpp"
+
+namespace NRenderer
+{
+    using namespace std;
+
+    // ѯĹߣֻ(tMin, tMax)ڵཻ
+    struct RayIn
+    {
+        Vec3 origin;
+        float tMin = 0.f;
+        Vec3 direction;         // ҪΪλtdirectionĳȼ
+        float tMax = numeric_limits<float>::infinity();
+    };
+
+    // ཻĽ
+    struct HitOut
+    {
+        float t = numeric_limits<float>::infinity();    // ཻ룬δཻʱΪ
+        PrimitiveRef primitive = {};    // ཻͼԪ
+        Vec3 position = {};             // ཻ㣨꣩
+        Vec3 normal = {};               // λߣ峯⣬ƽΪ¼ķ
+        Handle material = {};           // ͼԪĲ
+
+        bool hit() const {
+            return t != numeric_limits<float>::infinity();
+        }
+    };
+
+    // ߲ѯ
+    // ͼԪRayCastԭеʵһ£ƽ˫ɼ
+    namespace RayQuery
+    {
+        // ﵽֵthreads1ʱֿ齻߳
+        constexpr size_t PARALLEL_BATCH_SIZE = 4096;
+
+        // ߵཻ
+        DLL_EXPORT HitOut intersect(const PreparedScene& scene, const RayIn& ray);
+
+        // һߵཻhitsraysһһӦ
+        // threads: ϴʱʹõ߳0ʾʹӲ߳Ⱦ߳еʱһ㱣Ϊ1
+        DLL_EXPORT void intersect(const PreparedScene& scene, span<const RayIn> rays, span<HitOut> hits, unsigned int threads = 1);
+
+        // һߵڵԣ(tMin, tMax)һͼԪཻʱresultsΪ1Ϊ0
+        // ÿ4ڵĹһ߰һBVHͬһӰڴʱЧ
+        DLL_EXPORT void occluded(const PreparedScene& scene, span<const RayIn> rays, span<uint8_t> results, unsigned int threads = 1);
+    }
+} // namespace NRenderer
+
+#endif
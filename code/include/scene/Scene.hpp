@@ -12,15 +12,59 @@ namespace NRenderer
 {
     struct RenderOption
     {
+        // شͼȾ
+        enum class Heatmap
+        {
+            NONE,           // ¼
+            CYCLES,         // ʱڣrdtsc
+            RAYS,           // Ӱߣ
+            NODES,          // ٽṹڵ
+            SHADER_CALLS    // ɫô
+        };
+        // ģʽ
+        enum class SamplerMode
+        {
+            RANDOM,         // ض
+            BLUE_NOISE      // ֮䰴ͼתĵͲУͲڸƵ
+        };
+        // ٽṹ
+        enum class Accelerator
+        {
+            AUTO,           // ͼԪֲѡ
+            BVH,            // ΰΧ
+            GRID            // ʺϴСֲȵͼԪ
+        };
         unsigned int width;
         unsigned int height;
         unsigned int depth;
         unsigned int samplesPerPixel;
+        unsigned int threads;       // Ⱦ߳0ʾʹӲ߳
+        unsigned int previewInterval;   // ȾˢĻļ룩0ʾֻڽʱˢ
+        Heatmap heatmap;
+        string heatmapOutput;       // ͼ·չд<·>.pfmԭʼۣ<·>.ppmαɫΪʱд
+        SamplerMode sampler;
+        unsigned int sampleSeed;    // ӣ0ʾʹõǰʱ䣻Ⱦʱÿʹòͬ
+        bool accumulate;            // ǷÿصĲдServer::accumulationںϲζȾ
+        bool visibilityCache;       // ǷռػԴĿɼԣȷӰ
+        bool temporal;              // Ƿһ֡ۻͶӰǰӽǲ²ϣڽԤеƶ
+        Accelerator accelerator;    // Ԥʹõļٽṹ
+        bool countRays;             // Ƿͳ׷ٵĹֻڻ׼ԣرʱȾ·ûм
         RenderOption()
             : width             (500)
             , height            (500)
             , depth             (4)
             , samplesPerPixel   (16)
+            , threads           (8)
+            , previewInterval   (0)
+            , heatmap           (Heatmap::NONE)
+            , heatmapOutput     ()
+            , sampler           (SamplerMode::RANDOM)
+            , sampleSeed        (0)
+            , accumulate        (false)
+            , visibilityCache   (false)
+            , temporal          (false)
+            , accelerator       (Accelerator::AUTO)
+            , countRays         (false)
         {}
     };
 
@@ -35,9 +79,40 @@ namespace NRenderer
         Handle environmentMap = {};
     };
 
+    // ޸ļ¼
+    // ¼رⲿ޸ĵļдȾǰԤݴֻ޸Ĺļ
+    // allΪtrueʾ޸ķΧδ֪µ롢ɾɵĳȣҪԤ
+    struct SceneChanges
+    {
+        bool all = true;
+        vector<Index> spheres;      // ݱ޸ĵ壨±겻䣩
+        vector<Index> triangles;    // ݱ޸ĵ
+        vector<Index> planes;       // ݱ޸ĵƽ
+
+        // ΪΧδ֪
+        void markAll() {
+            all = true;
+            spheres.clear();
+            triangles.clear();
+            planes.clear();
+        }
+        // ޸ļ¼ֻ֮¼ȷ޸
+        void clear() {
+            all = false;
+            spheres.clear();
+            triangles.clear();
+            planes.clear();
+        }
+        bool empty() const {
+            return !all && spheres.empty() && triangles.empty() && planes.empty();
+        }
+    };
+
     struct Scene
     {
         Camera camera;
+        vector<Camera> views;       // ӽȾΪʱһȾӽǶcamera
+
 
         RenderOption renderOption;
 
@@ -61,6 +136,8 @@ namespace NRenderer
         vector<AreaLight> areaLightBuffer;
         vector<DirectionalLight> directionalLightBuffer;
         vector<SpotLight> spotLightBuffer;
+
+        SceneChanges changes;       // һȾ޸
     };
     using SharedScene = shared_ptr<Scene>;
 } // namespace NRenderer
@@ -0,0 +1,80 @@
+// 򻯳
+// ɴģѹԳֱSceneҲд.scnļ
+#pragma once
+#ifndef __NR_SCENE_GENERATOR_HPP__
+#define __NR_SCENE_GENERATOR_HPP__
+
+#include <string>
+#include <cstdint>
+
+#include "Scene.hpp"
+#include "common/macros.hpp"
+
+namespace NRenderer
+{
+    using namespace std;
+
+    // ɲ
+    // ɹ̶ͬȫͬĳ
+    struct GeneratorOptions
+    {
+        uint32_t seed = 0x4E52u;            // 
+        float extent = 500.f;               // ߳ͼԪֲ[-extent, extent]ڣ
+
+        size_t spheres = 1000;              // 
+        size_t meshes = 0;                  // ϸǻ棩
+        size_t meshTriangles = 0;           // ϸ
+        size_t terrainTriangles = 0;        // θ߶ȳ
+        size_t areaLights = 1;              // Դ
+
+        unsigned int gridX = 0;             // ʵXʵ
+        unsigned int gridY = 0;             // ʵYʵ
+        unsigned int gridZ = 0;             // ʵZʵ
+        size_t instanceTriangles = 80;      // ÿʵԭ͵
+
+        unsigned int materials = 12;        // 
+        bool mixedMaterials = true;         // ǷʹɫֻͣʹLambertian
+
+        // ɵͼԪ
+        size_t primitiveCount() const {
+            return spheres + meshTriangles + terrainTriangles
+                + size_t(gridX)*gridY*gridZ*instanceTriangles;
+        }
+    };
+
+    // 򻯳
+    // N塢MεϸKԴʵԼϲ
+    class DLL_EXPORT SceneGenerator
+    {
+    private:
+        GeneratorOptions options;
+        string lastErrorInfo;   // һδϢ
+
+        // ȷ˳ɳݣSinkգSceneдļ
+        template<typename Sink>
+        void emit(Sink& sink) const;
+    public:
+        SceneGenerator(const GeneratorOptions& options)
+            : options           (options)
+            , lastErrorInfo     ()
+        {}
+        ~SceneGenerator() = default;
+
+        // ֱɳ󣨾ֲ꣬SceneBuilderһ£
+        SharedScene generate() const;
+
+        // дΪ.scnļ
+        // : дǷɹ
+        bool writeScn(const string& path);
+
+        // ȡϢ
+        string getErrorInfo() const {
+            return lastErrorInfo;
+        }
+
+        // Ϊɵĳһܿȫݵ
+        Camera suggestCamera() const;
+    };
+} // namespace NRenderer
+
+#endif
@@ -0,0 +1,59 @@
+// SCNı
+// OpenGLֱӰ.scnıΪScene󣬹༭ĵйȾʹ
+#pragma once
+#ifndef __NR_SCN_PARSER_HPP__
+#define __NR_SCN_PARSER_HPP__
+
+#include <string>
+#include <istream>
+
+#include "Scene.hpp"
+#include "StagedScene.hpp"
+#include "common/macros.hpp"
+
+namespace NRenderer
+{
+    using namespace std;
+
+    // SCN
+    // ﷨Ϣ༭ԭеScnImporterһ
+    // ֻΡԴȾɵ
+    class DLL_EXPORT ScnParser
+    {
+    private:
+        string lastErrorInfo;   // һδϢ
+
+        ImportProgress* progress;   // ȡǣΪ
+
+        // ڴеıд
+        bool stageBuffer(const char* data, size_t size, StagedScene& staged);
+    public:
+        ScnParser()
+            : lastErrorInfo     ()
+            , progress          (nullptr)
+        {}
+        ~ScnParser() = default;
+
+        // ݴȱڴ
+        // progress: ȡǣΪ
+        // : Ƿɹȡʱfalse
+        bool stage(istream& in, StagedScene& staged, ImportProgress* progress = nullptr);
+        // .scnļݴļڴӳ䷽ʽȡ
+        bool stageFile(const string& path, StagedScene& staged, ImportProgress* progress = nullptr);
+
+        // 
+        // : õĳʧʱnullptr
+        SharedScene parse(istream& in);
+        // ڴе.scnı
+        SharedScene parseText(const string& text);
+        // .scnļ
+        SharedScene parseFile(const string& path);
+
+        // ȡϢ
+        string getErrorInfo() const {
+            return lastErrorInfo;
+        }
+    };
+} // namespace NRenderer
+
+#endif
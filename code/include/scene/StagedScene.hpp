@@ -0,0 +1,54 @@
+// ݴ
+// ں̨߳аļΪݴٰ߳ϲʲ̲ӴOpenGL
+#pragma once
+#ifndef __NR_STAGED_SCENE_HPP__
+#define __NR_STAGED_SCENE_HPP__
+
+#include <string>
+#include <vector>
+#include <atomic>
+
+#include "Scene.hpp"
+
+namespace NRenderer
+{
+    using namespace std;
+
+    // ȡ
+    // ̨дȲȡǣ̶߳ȡȻȡ
+    class ImportProgress
+    {
+    private:
+        atomic<float> fraction;     // ɱ0-1
+        atomic<bool> cancelled;     // Ƿȡ
+    public:
+        ImportProgress()
+            : fraction          (0.f)
+            , cancelled         (false)
+        {}
+        ImportProgress(const ImportProgress&) = delete;
+
+        void report(float f) { fraction = f; }
+        float get() const { return fraction; }
+        void cancel() { cancelled = true; }
+        bool isCancelled() const { return cancelled; }
+        void reset() { fraction = 0.f; cancelled = false; }
+    };
+
+    // ݴĵ
+    // ֻʹsceneеĲʡģ͡ڵ㡢Դ壬Ⱦ
+    // е±꣨ʾڵʵģ͡ģ͵Ľڵ㡢Դʵ壩ֻڱڲЧϲʱƫ
+    struct StagedScene
+    {
+        Scene scene;
+        vector<string> materialNames;   // scene.materialsһһӦ
+        vector<string> textureNames;    // scene.texturesһһӦ
+        vector<string> texturePaths;    // ļ·Ϊʱɵ߽
+        vector<string> modelNames;      // scene.modelsһһӦ
+        vector<string> nodeNames;       // scene.nodesһһӦ
+        vector<string> lightNames;      // scene.lightsһһӦ
+        vector<string> sourceFiles;     // ļȡļ.mtlڼļ޸
+    };
+} // namespace NRenderer
+
+#endif
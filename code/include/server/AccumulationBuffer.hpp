@@ -0,0 +1,88 @@
+// ۻ
+// ¼ÿصĲɫ֮͡ƽȾĽԺϲΪһγʱȾĽ
+#pragma once
+#ifndef __NR_ACCUMULATION_BUFFER_HPP__
+#define __NR_ACCUMULATION_BUFFER_HPP__
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "geometry/vec.hpp"
+#include "common/macros.hpp"
+
+namespace NRenderer
+{
+    using namespace std;
+
+    // ۻ
+    // Ⱦػһ£0Ϊͼ񶥲
+    // ɫΪֵδGammaУԶļʱΪȾļ
+    class DLL_EXPORT AccumulationBuffer
+    {
+    private:
+        unsigned int width;         // 
+        unsigned int height;        // ߶
+        vector<Vec3> sums;          // ÿزɫ֮
+        vector<Vec3> squareSums;    // ÿزɫƽͣڹƷ
+        vector<uint32_t> counts;    // ÿز
+    public:
+        AccumulationBuffer()
+            : width             (0)
+            , height            (0)
+            , sums              ()
+            , squareSums        ()
+            , counts            ()
+        {}
+        AccumulationBuffer(unsigned int width, unsigned int height)
+            : width             (width)
+            , height            (height)
+            , sums              (size_t(width)*height, Vec3{0.f})
+            , squareSums        (size_t(width)*height, Vec3{0.f})
+            , counts            (size_t(width)*height, 0)
+        {}
+        ~AccumulationBuffer() = default;
+
+        unsigned int getWidth() const { return width; }
+        unsigned int getHeight() const { return height; }
+        bool empty() const { return counts.empty(); }
+
+        // ۼһصĲrowΪУ0ΪcolΪ
+        // sum: ɫ֮ͣsquareSum: ɫƽͣcount: 
+        void add(unsigned int row, unsigned int col, const Vec3& sum, const Vec3& squareSum, uint32_t count) {
+            size_t i = size_t(row)*width + col;
+            sums[i] += sum;
+            squareSums[i] += squareSum;
+            counts[i] += count;
+        }
+
+        // ز
+        uint32_t count(unsigned int row, unsigned int col) const {
+            return counts[size_t(row)*width + col];
+        }
+        // ɫֵ
+        Vec3 mean(unsigned int row, unsigned int col) const;
+        // ɫֵķƣԲ2ʱΪ0
+        Vec3 variance(unsigned int row, unsigned int col) const;
+
+        // ϲһߴͬĻ
+        // : ߴ粻ͬʱfalseֲ
+        bool merge(const AccumulationBuffer& other);
+
+        // ѾֵתΪأGammaΪ2SimplePathTracerһ£
+        vector<RGBA> resolve() const;
+
+        // дۻļ
+        // : Ƿдɹ
+        bool write(const string& path) const;
+        // ȡۻļ
+        // : Ƿȡɹʧʱֲ
+        bool read(const string& path);
+        // дÿطƽֵΪͨPFMͼ񣬿жϻҪٲ
+        // : Ƿдɹ
+        bool writeVariancePfm(const string& path) const;
+    };
+    SHARE(AccumulationBuffer);
+} // namespace NRenderer
+
+#endif
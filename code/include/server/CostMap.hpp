@@ -0,0 +1,57 @@
+// شͼ
+// ¼ȾÿصĿʱڻ/ڵ/ɫôȵ
+#pragma once
+#ifndef __NR_COST_MAP_HPP__
+#define __NR_COST_MAP_HPP__
+
+#include <string>
+#include <vector>
+
+#include "common/macros.hpp"
+
+namespace NRenderer
+{
+    using namespace std;
+
+    // شͼ
+    // Ⱦػһ£0Ϊͼ񶥲
+    class DLL_EXPORT CostMap
+    {
+    private:
+        unsigned int width;     // 
+        unsigned int height;    // ߶
+        vector<float> costs;    // ÿش
+    public:
+        CostMap(unsigned int width, unsigned int height)
+            : width             (width)
+            , height            (height)
+            , costs             (size_t(width)*height, 0.f)
+        {}
+        ~CostMap() = default;
+
+        // ȡشۣrowΪУ0ΪcolΪ
+        float& at(unsigned int row, unsigned int col) {
+            return costs[size_t(row)*width + col];
+        }
+        float at(unsigned int row, unsigned int col) const {
+            return costs[size_t(row)*width + col];
+        }
+        unsigned int getWidth() const { return width; }
+        unsigned int getHeight() const { return height; }
+
+        // 
+        float max() const;
+        // ƽ
+        float mean() const;
+
+        // дͨPFMͼԭʼֵΪAOVⲿз
+        // : Ƿдɹ
+        bool writePfm(const string& path) const;
+        // дαɫPPMͼ񣨰ֵһ----죩
+        // : Ƿдɹ
+        bool writeFalseColor(const string& path) const;
+    };
+    SHARE(CostMap);
+} // namespace NRenderer
+
+#endif
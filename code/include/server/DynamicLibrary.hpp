@@ -0,0 +1,43 @@
+// ̬װ
+// LoadLibrarydlopenƽ̨죬ʱԶͷ
+#pragma once
+#ifndef __NR_DYNAMIC_LIBRARY_HPP__
+#define __NR_DYNAMIC_LIBRARY_HPP__
+
+#include <string>
+
+#include "common/macros.hpp"
+
+namespace NRenderer
+{
+    using namespace std;
+
+    // ̬
+    class DLL_EXPORT DynamicLibrary
+    {
+    private:
+        void* handle;           // ƽ̨صĿ
+        string path;            // ļ·
+        string lastErrorInfo;   // һδϢ
+    public:
+        DynamicLibrary();
+        DynamicLibrary(const DynamicLibrary&) = delete;
+        DynamicLibrary& operator=(const DynamicLibrary&) = delete;
+        ~DynamicLibrary();
+
+        // ض̬⣬еľ̬ʼעᣩڴʱִ
+        // : Ƿسɹ
+        bool open(const string& path);
+        // ͷŶ̬
+        void close();
+
+        bool isOpen() const { return handle != nullptr; }
+        const string& getPath() const { return path; }
+        string getErrorInfo() const { return lastErrorInfo; }
+
+        // ǰƽ̨̬չ".dll"".so"
+        static string extension();
+    };
+} // namespace NRenderer
+
+#endif
@@ -0,0 +1,88 @@
+// ͳƵĻ
+// NR_LOCK_STATSʱ¼ÿĻȡȴʱ䣬ȼstd::mutex
+#pragma once
+#ifndef __NR_INSTRUMENTED_MUTEX_HPP__
+#define __NR_INSTRUMENTED_MUTEX_HPP__
+
+#include <mutex>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "common/macros.hpp"
+
+namespace NRenderer
+{
+    using namespace std;
+
+    // ͳƿ
+    struct LockStatistics
+    {
+        string name;                // 
+        uint64_t acquisitions = 0;  // ȡ
+        uint64_t contended = 0;     // ҪȴĻȡ
+        double waitSeconds = 0.0;   // ȴʱܺ
+    };
+
+    // ͬļַڳڼ䱣ֲ
+    struct LockCounter
+    {
+        atomic<uint64_t> acquisitions{0};
+        atomic<uint64_t> contended{0};
+        atomic<uint64_t> waitNanoseconds{0};
+    };
+
+    // ȡָƵļʱ
+    DLL_EXPORT LockCounter& getLockCounter(const string& name);
+    // ȡоͳƿ
+    DLL_EXPORT vector<LockStatistics> getLockStatistics();
+    // м
+    DLL_EXPORT void resetLockStatistics();
+
+#ifdef NR_LOCK_STATS
+    // ͳƵĻ
+    // ȳ޵ȴȡʧʱżʱδ·ֻһԭ
+    class InstrumentedMutex
+    {
+    private:
+        mutex m;
+        LockCounter& counter;
+    public:
+        explicit InstrumentedMutex(const char* name)
+            : m                 ()
+            , counter           (getLockCounter(name))
+        {}
+        InstrumentedMutex(const InstrumentedMutex&) = delete;
+
+        void lock() {
+            if (!m.try_lock()) {
+                auto begin = chrono::steady_clock::now();
+                m.lock();
+                auto wait = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - begin).count();
+                counter.contended.fetch_add(1, memory_order_relaxed);
+                counter.waitNanoseconds.fetch_add(uint64_t(wait), memory_order_relaxed);
+            }
+            counter.acquisitions.fetch_add(1, memory_order_relaxed);
+        }
+        bool try_lock() {
+            if (!m.try_lock()) return false;
+            counter.acquisitions.fetch_add(1, memory_order_relaxed);
+            return true;
+        }
+        void unlock() {
+            m.unlock();
+        }
+    };
+#else
+    // δͳʱstd::mutexƲ
+    class InstrumentedMutex : public mutex
+    {
+    public:
+        explicit InstrumentedMutex(const char*) {}
+    };
+#endif
+} // namespace NRenderer
+
+#endif
@@ -12,6 +12,7 @@
 #include <mutex>
 
 #include "common/macros.hpp"
+#include "InstrumentedMutex.hpp"
 
 #undef ERROR
 
@@ -54,7 +55,7 @@ namespace NRenderer
         };
     private:
         vector<LogText> msgs;    // ־Ϣб
-        mutex   mtx;             // ֤̰߳ȫ
+        InstrumentedMutex mtx;   // ֤̰߳ȫ
 
     public:
         // ĬϹ캯
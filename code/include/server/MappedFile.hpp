@@ -0,0 +1,39 @@
+// ֻļӳ
+// ļӳ䵽ڴ棬ļĵʹãи
+#pragma once
+#ifndef __NR_MAPPED_FILE_HPP__
+#define __NR_MAPPED_FILE_HPP__
+
+#include <string>
+
+#include "common/macros.hpp"
+
+namespace NRenderer
+{
+    using namespace std;
+
+    // ֻļӳ䣨ƽ̨ز֣
+    class DLL_EXPORT MappedFile
+    {
+    private:
+        const char* address;
+        size_t size;
+        void* file;         // Windowsµļ
+        void* mapping;      // Windowsµӳ
+        bool opened;        // ļ޷ӳ䣬Ϊ򿪳ɹ
+    public:
+        MappedFile();
+        MappedFile(const MappedFile&) = delete;
+        ~MappedFile();
+
+        // ӳļļڻ޷ȡʱfalse
+        bool open(const string& path);
+        void close();
+
+        const char* data() const { return address; }
+        size_t getSize() const { return size; }
+        bool isOpen() const { return opened; }
+    };
+} // namespace NRenderer
+
+#endif
@@ -6,7 +6,11 @@
 
 #include "geometry/vec.hpp"
 #include "common/macros.hpp"
-#include <mutex>
+#include "InstrumentedMutex.hpp"
+#include "SharedFrameBuffer.hpp"
+
+#include <memory>
+#include <vector>
 
 namespace NRenderer
 {
@@ -19,7 +23,8 @@ namespace NRenderer
         unsigned int width;     // Ļ
         unsigned int height;    // Ļ߶
         mutable bool updated;   // ±־
-        mutable mutex mtx;      // ֤̰߳ȫ
+        mutable InstrumentedMutex mtx;  // ֤̰߳ȫ
+        unique_ptr<SharedFrameBuffer> mirror;   // ڴ澵δʱΪ
 
     public:
         // ĬϹ캯
@@ -43,6 +48,16 @@ namespace NRenderer
         void release();
         // Ƿи
         bool isUpdated() const;
+        // Ƶǰݣ̰߳ȫͬʱ±־
+        // : ϴζȡǷи
+        bool copyPixels(vector<RGBA>& out, unsigned int& width, unsigned int& height) const;
+
+        // ֮ÿһ֡񵽾ڴ棬ⲿ̶ȡ
+        // ҲͨNR_SCREEN_MIRRORʱ
+        // : Ƿɹ
+        bool enableMirror(const string& name);
+        // رչڴ澵
+        void disableMirror();
     };  
 } // namespace NRenderer
 
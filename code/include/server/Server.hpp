@@ -6,6 +6,11 @@
 
 #include "Screen.hpp"
 #include "Logger.hpp"
+#include "Statistics.hpp"
+#include "AccumulationBuffer.hpp"
+#include "TemporalHistory.hpp"
+#include "scene/PreparedScene.hpp"
+#include "scene/BakedIrradiance.hpp"
 #include "component/ComponentFactory.hpp"
 
 namespace NRenderer
@@ -17,6 +22,12 @@ namespace NRenderer
         Logger logger = {};             // ־ϵͳ
         Screen screen = {};             // Ļ
         ComponentFactory componentFactory = {};  // 
+        Statistics statistics = {};     // ͳ
+        AccumulationBuffer accumulation = {};   // һȾĲۻȾRenderOption::accumulateʱȾд
+        vector<vector<RGBA>> views = {};        // ӽȾʱӽǵأscreenߴͬͬȾScene::viewsΪʱȾд
+        TemporalHistory temporalHistory{};      // һ֡ͶӰʷȾRenderOption::temporalʱȡ滻
+        PreparedSceneCache preparedScenes{};    // ȾõԤ
+        IrradianceStore irradiance{};           // ǰĺ決նȣɺ決
         Server() = default;
     };
 } // namespace NRenderer
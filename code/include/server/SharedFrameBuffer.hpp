@@ -0,0 +1,129 @@
+// ڴ֡嶨
+// Ļĵǰ֡񵽾ڴУⲿ鿴ؽ̿㿽ضȡȾ
+#pragma once
+#ifndef __NR_SHARED_FRAME_BUFFER_HPP__
+#define __NR_SHARED_FRAME_BUFFER_HPP__
+
+#include <string>
+#include <vector>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+#include "geometry/vec.hpp"
+#include "common/macros.hpp"
+
+namespace NRenderer
+{
+    using namespace std;
+
+    // ڴͷݽ
+    // sequenceΪ˳дΪдΪż
+    struct alignas(64) SharedFrameHeader
+    {
+        static constexpr uint32_t MAGIC = 0x4E524642;   // "NRFB"
+        static constexpr uint32_t VERSION = 1;
+
+        // ظʽ
+        enum Format : uint32_t
+        {
+            RGBA32F = 0     // ÿ4floatScreenһ
+        };
+
+        uint32_t magic;
+        uint32_t version;
+        uint32_t format;
+        uint32_t capacity;              // ɵ
+        atomic<uint32_t> retired;       // 0ʾöѱĶȡȡҪ´
+        atomic<uint32_t> sequence;      // ˳
+        uint32_t width;                 // ǰ֡
+        uint32_t height;                // ǰ֡߶
+        uint64_t frameCount;            // ѷ֡
+    };
+    static_assert(atomic<uint32_t>::is_always_lock_free, "shared frame header requires lock-free atomics");
+
+    // ڴӳ䣨ƽ̨ز֣
+    class DLL_EXPORT SharedMemory
+    {
+    private:
+        string name;
+        void* address;
+        size_t size;
+        void* handle;       // Windowsµӳ
+        bool owner;         // ڹرʱɾڴ
+    public:
+        SharedMemory();
+        SharedMemory(const SharedMemory&) = delete;
+        ~SharedMemory();
+
+        // 򸲸ǣָСĹڴ
+        bool create(const string& name, size_t size);
+        // ѴڵĹڴ
+        bool open(const string& name);
+        void close();
+
+        void* data() const { return address; }
+        size_t getSize() const { return size; }
+        bool isOpen() const { return address != nullptr; }
+    };
+
+    // ֡д
+    class DLL_EXPORT SharedFrameBuffer
+    {
+    private:
+        string name;
+        SharedMemory memory;
+        uint64_t frameCount;
+
+        SharedFrameHeader* header() const;
+        bool allocate(size_t pixels);
+    public:
+        SharedFrameBuffer();
+        SharedFrameBuffer(const SharedFrameBuffer&) = delete;
+        ~SharedFrameBuffer();
+
+        // ֡壬nameΪ·ƣ"nrenderer"
+        bool create(const string& name, unsigned int width, unsigned int height);
+        void close();
+        bool isOpen() const { return memory.isOpen(); }
+
+        // һ֡ߴ糬ʱԶؽĹڴ
+        void publish(const RGBA* pixels, unsigned int width, unsigned int height);
+    };
+
+    // ֡ȡ
+    // 㿽ȡbeginRead() -> ȡdata() -> validate()validateʧʱ
+    class DLL_EXPORT SharedFrameReader
+    {
+    private:
+        string name;
+        SharedMemory memory;
+
+        SharedFrameHeader* header() const;
+    public:
+        SharedFrameReader() = default;
+
+        // 򿪹֡壬Ҳдؽ´
+        bool open(const string& name);
+        void close();
+        bool isOpen() const { return memory.isOpen(); }
+        // дǷؽڴ
+        bool isRetired() const;
+
+        // ʼȡ˳дʱȴдɣ
+        uint32_t beginRead() const;
+        // beginReadʼڼ֡Ƿ޸
+        bool validate(uint32_t sequence) const;
+
+        unsigned int getWidth() const;
+        unsigned int getHeight() const;
+        uint64_t getFrameCount() const;
+        const RGBA* data() const;
+
+        // һһµ֡
+        // : Ƿȡɹδ򿪻ѱȡʱʧܣ
+        bool read(vector<RGBA>& pixels, unsigned int& width, unsigned int& height, uint64_t& frame);
+    };
+} // namespace NRenderer
+
+#endif
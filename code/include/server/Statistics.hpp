@@ -0,0 +1,71 @@
+// ͳϢඨ
+// ռȾϱͳƣйߣչԲԣȡ
+#pragma once
+#ifndef __NR_STATISTICS_HPP__
+#define __NR_STATISTICS_HPP__
+
+#include <vector>
+#include <string>
+#include <mutex>
+#include <cstdint>
+
+#include "common/macros.hpp"
+#include "InstrumentedMutex.hpp"
+
+namespace NRenderer
+{
+    using namespace std;
+
+    // ȾͳϢ
+    struct RenderStatistics
+    {
+        string component;                   // ϱȾ
+        unsigned int threads = 0;           // Ⱦ߳
+        double wallSeconds = 0.0;           // Ⱦ׶εܺʱ׼
+        vector<double> threadBusySeconds;   // ÿ̵߳ʵʹʱ
+        vector<uint64_t> threadRays;        // ÿ߳׷ٵĹ
+        uint64_t rays = 0;                  // ׷ٵĹӰߣֻRenderOption::countRaysͼʱͳ
+        uint64_t samples = 0;               // 
+
+        // ߳̿ʱ = ܺʱ - ʱ
+        double idleSeconds(size_t thread) const {
+            return wallSeconds > threadBusySeconds[thread] ? wallSeconds - threadBusySeconds[thread] : 0.0;
+        }
+    };
+
+    // ͳϢ
+    // ȾȾʱϱȡһεĸ
+    class DLL_EXPORT Statistics
+    {
+    private:
+        RenderStatistics lastRender;    // һȾͳ
+        unsigned int renderCount;       // ϱȾ
+        float progress;                 // ǰȾĽȣ0-1
+        mutable mutex mtx;              // ֤̰߳ȫ
+    public:
+        Statistics();
+        Statistics(const Statistics&) = delete;
+        ~Statistics() = default;
+
+        // ϱһȾͳϢ
+        void reportRender(const RenderStatistics& stats);
+        // ȡһȾͳϢ
+        RenderStatistics getLastRender() const;
+        // ȡϱȾжͳǷµȾ
+        unsigned int getRenderCount() const;
+
+        // ϱǰȾĽȣ0-1ȾȾеãreportRenderὫΪ1
+        void reportProgress(float progress);
+        // ȡǰȾĽ
+        float getProgress() const;
+
+        // ǷNR_LOCK_STATS루δʱͳΪգ
+        bool lockStatsEnabled() const;
+        // ȡľͳ
+        vector<LockStatistics> getLockStatistics() const;
+        // ͳ
+        void resetLockStatistics();
+    };
+} // namespace NRenderer
+
+#endif
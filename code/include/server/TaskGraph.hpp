@@ -0,0 +1,53 @@
+// ͼ
+// ໥׼裨ɫ任BVHȣ߳ͬʱִУ
+// ϵǰȫɺſʼ
+#pragma once
+#ifndef __NR_TASK_GRAPH_HPP__
+#define __NR_TASK_GRAPH_HPP__
+
+#include <vector>
+#include <functional>
+#include <initializer_list>
+
+#include "common/macros.hpp"
+
+namespace NRenderer
+{
+    using namespace std;
+
+    // ͼ
+    // addȫٵrunִУrunʱɣͼպظʹ
+    class DLL_EXPORT TaskGraph
+    {
+    public:
+        using TaskId = size_t;
+    private:
+        struct Task
+        {
+            function<void()> work;          // 
+            vector<TaskId> successors;      // 
+            unsigned int dependencies;      // ǰ
+        };
+        vector<Task> tasks;
+    public:
+        TaskGraph() = default;
+        TaskGraph(const TaskGraph&) = delete;
+        ~TaskGraph() = default;
+
+        // һ
+        // after: ǰ񣬱֮ǰ
+        // : 
+        TaskId add(function<void()> work, initializer_list<TaskId> after = {});
+        TaskId add(function<void()> work, const vector<TaskId>& after);
+
+        size_t size() const { return tasks.size(); }
+        void clear() { tasks.clear(); }
+
+        // ִȫ񣬵߳Ҳִ
+        // threads: ͬʱִ̣߳߳0ʾʹӲ߳
+        // ׳쳣ʱٿʼµ񣬵ִе׳һ쳣
+        void run(unsigned int threads = 0);
+    };
+} // namespace NRenderer
+
+#endif
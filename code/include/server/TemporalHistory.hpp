@@ -0,0 +1,87 @@
+// ʱͶӰʷ
+// Ԥƶ󣬰һ֡ۻ״ཻͶӰӽǣµĲ
+#pragma once
+#ifndef __NR_TEMPORAL_HISTORY_HPP__
+#define __NR_TEMPORAL_HISTORY_HPP__
+
+#include <vector>
+#include <cstdint>
+
+#include "geometry/vec.hpp"
+#include "common/macros.hpp"
+
+namespace NRenderer
+{
+    using namespace std;
+
+    // һ֡ͶӰʷ
+    // ذдţ0ΪͼײȾйһtķһ
+    class DLL_EXPORT TemporalHistory
+    {
+    public:
+        // ĳƽ棺һ(s, t)ӦlowerLeft + s*horizontal + t*vertical - origint = 0Ϊͼײ
+        struct View
+        {
+            Vec3 origin;
+            Vec3 lowerLeft;
+            Vec3 horizontal;
+            Vec3 vertical;
+        };
+
+        // һصʷ
+        struct Texel
+        {
+            Vec3 radiance = {};     // ۻķȾֵֵ
+            float weight = 0.f;     // Ч0ʾûпõʷδ塢ʵȣ
+            Vec3 position = {};     // ߵ״ཻ
+            Vec3 normal = {};       // ״ཻķ
+        };
+
+        static constexpr float MAX_WEIGHT = 64.f;           // Чޣʹձ仯µĲӰʧ
+        static constexpr float DEPTH_TOLERANCE = 0.01f;     // ཻ㵽ʷƽľޣڵһ֡ľ
+        static constexpr float NORMAL_TOLERANCE = 0.9f;     // ߼нҵ
+
+    private:
+        unsigned int width;         // 
+        unsigned int height;        // ߶
+        uint64_t key;               // ݵĹϣһ֡ͬʱʷ
+        unsigned int frame;         // ʹʷ֡ţָ֡Ĳ
+        View view;                  // ֡ĳƽ
+        Mat3x3 toView;              // ռ䷽(k, k*s, k*t)ı任
+        vector<Texel> texels;       // ÿصʷ
+    public:
+        TemporalHistory()
+            : width             (0)
+            , height            (0)
+            , key               (0)
+            , frame             (0)
+            , view              ()
+            , toView            (1.f)
+            , texels            ()
+        {}
+        TemporalHistory(unsigned int width, unsigned int height, uint64_t key, unsigned int frame, const View& view);
+        ~TemporalHistory() = default;
+
+        unsigned int getWidth() const { return width; }
+        unsigned int getHeight() const { return height; }
+        uint64_t getKey() const { return key; }
+        unsigned int getFrame() const { return frame; }
+        bool empty() const { return texels.empty(); }
+
+        // дһصʷrowΪУ0ΪײcolΪ
+        void set(unsigned int row, unsigned int col, const Texel& texel) {
+            texels[size_t(row)*width + col] = texel;
+        }
+        const Texel& at(unsigned int row, unsigned int col) const {
+            return texels[size_t(row)*width + col];
+        }
+
+        // һ֡һ״ཻʷ
+        // ཻͶӰ֡ĳƽϣ4˫ԲֵȻ߲һµز룬
+        // ЧصĲֵȨСԵȲֿõλøµĲ
+        // : ֵõʷʱweightΪ0
+        Texel reproject(const Vec3& position, const Vec3& normal) const;
+    };
+} // namespace NRenderer
+
+#endif
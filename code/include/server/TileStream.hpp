@@ -0,0 +1,66 @@
+// ֡ķֿ
+// ֡г16x16Ŀ飬ֻһηͷ仯Ŀ
+// Ϊֵֽڲ֣RGBA8PackBitsγѹĲּȫΪ0
+#pragma once
+#ifndef __NR_TILE_STREAM_HPP__
+#define __NR_TILE_STREAM_HPP__
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#include "geometry/vec.hpp"
+#include "common/macros.hpp"
+
+namespace NRenderer
+{
+    using namespace std;
+
+    // ݸʽΪС:
+    //   uint32 width, uint32 height, uint32 tileCount
+    //   tileCount: uint16 tileX, uint16 tileY, uint32 bytes, bytesֽڵPackBits
+    // ߴ仯ʱ˶Ѿ֡Ϊȫ0൱֡ش
+    constexpr unsigned int FRAME_TILE_SIZE = 16;
+
+    // Ͷˣ¼Ѿ͵֡
+    class DLL_EXPORT TileEncoder
+    {
+    private:
+        unsigned int width;
+        unsigned int height;
+        vector<uint8_t> sent;       // ѷ͵֡RGBA8ȣ
+        vector<uint8_t> delta;      // Ĳֻ
+    public:
+        TileEncoder();
+        ~TileEncoder() = default;
+
+        // һ֡
+        // pixels: Ļأ0-1ΧRGBA
+        // changedTiles: ΰĿ
+        // : ݣûб仯ʱֻͷ
+        vector<uint8_t> encode(const RGBA* pixels, unsigned int width, unsigned int height, unsigned int& changedTiles);
+    };
+
+    // նˣάյ֡
+    class DLL_EXPORT TileDecoder
+    {
+    private:
+        unsigned int width;
+        unsigned int height;
+        vector<uint8_t> frame;      // ǰ֡RGBA8ȣ
+    public:
+        TileDecoder();
+        ~TileDecoder() = default;
+
+        // Ӧһ
+        // : ǷЧЧʱ֡ݲȷ
+        bool apply(const uint8_t* data, size_t size);
+
+        unsigned int getWidth() const { return width; }
+        unsigned int getHeight() const { return height; }
+        // ȡǰ֡RGBA8ȣ
+        const vector<uint8_t>& getFrame() const { return frame; }
+    };
+} // namespace NRenderer
+
+#endif
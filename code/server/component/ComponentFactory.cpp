@@ -9,10 +9,13 @@ NRenderer::ComponentFactory& getComponentFactory() {
 namespace NRenderer
 {
     bool ComponentFactory::registerComponent(const string& type, const string& name, const string& desc, function<SharedInstance()> constructor) {
+        lock_guard<InstrumentedMutex> lock{mtx};
         auto& ncMap = constructors[type];
-        if (ncMap.find(name) == ncMap.end()) {
+        auto it = ncMap.find(name);
+        // ӳٵǼǵĿɿеʵע滻
+        if (it == ncMap.end() || it->second.loader) {
             ComponentInfo ci{getId(type, name), type, name, desc};
-            ComponentWrapper cw{ci, constructor};
+            ComponentWrapper cw{ci, constructor, nullptr};
             ncMap[name] = cw;
             return true;
         }
@@ -23,22 +26,57 @@ namespace NRenderer
     }
 
     void ComponentFactory::unregisterComponent(const string& type, const string& name) {
+        lock_guard<InstrumentedMutex> lock{mtx};
         auto& ncMap = constructors[type];
         ncMap.erase(name);
     }
 
-    SharedInstance ComponentFactory::createInstance(const string& type, const string& name) {
+    bool ComponentFactory::registerLazyComponent(const string& type, const string& name, const string& desc, function<bool()> loader) {
+        lock_guard<InstrumentedMutex> lock{mtx};
         auto& ncMap = constructors[type];
-        if (ncMap.find(name) != ncMap.end()) {
-            return ncMap[name].constructor();
+        if (ncMap.find(name) != ncMap.end()) return false;
+        ComponentInfo ci{getId(type, name), type, name, desc};
+        ncMap[name] = ComponentWrapper{ci, nullptr, loader};
+        return true;
+    }
+
+    void ComponentFactory::unregisterLazyComponent(const string& type, const string& name) {
+        lock_guard<InstrumentedMutex> lock{mtx};
+        auto& ncMap = constructors[type];
+        auto it = ncMap.find(name);
+        if (it != ncMap.end() && it->second.loader) {
+            ncMap.erase(it);
         }
-        else {
-            return nullptr;
+    }
+
+    SharedInstance ComponentFactory::createInstance(const string& type, const string& name) {
+        function<SharedInstance()> constructor;
+        function<bool()> loader;
+        {
+            lock_guard<InstrumentedMutex> lock{mtx};
+            auto& ncMap = constructors[type];
+            auto it = ncMap.find(name);
+            if (it == ncMap.end()) return nullptr;
+            constructor = it->second.constructor;
+            loader = it->second.loader;
+        }
+        // ڵĿδأʱеע滻ӳٵǼǵĿ
+        // ع̻ٴν˱
+        if (loader) {
+            if (!loader()) return nullptr;
+            lock_guard<InstrumentedMutex> lock{mtx};
+            auto& ncMap = constructors[type];
+            auto it = ncMap.find(name);
+            if (it == ncMap.end() || it->second.loader) return nullptr;
+            constructor = it->second.constructor;
         }
+        // ⹹죬캯ٴη
+        return constructor();
     }
 
     vector<ComponentInfo> ComponentFactory::getComponentsInfo(const string& type) {
         vector<ComponentInfo> infos;
+        lock_guard<InstrumentedMutex> lock{mtx};
         if (type == "") {
             for (auto& ncMap : constructors) {
                 for (auto& it : ncMap.second) {
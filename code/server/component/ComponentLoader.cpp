@@ -0,0 +1,237 @@
+#include "component/ComponentLoader.hpp"
+#include "server/Server.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <set>
+
+namespace NRenderer
+{
+    namespace
+    {
+        const string MANIFEST_HEADER = "# NRenderer component manifest v1";
+
+        // пܺлƱд嵥ǰת
+        string escape(const string& s) {
+            string r;
+            for (char c : s) {
+                if (c == '\\') r += "\\\\";
+                else if (c == '\n') r += "\\n";
+                else if (c == '\t') r += "\\t";
+                else r += c;
+            }
+            return r;
+        }
+
+        string unescape(const string& s) {
+            string r;
+            for (size_t i = 0; i < s.size(); i++) {
+                if (s[i] == '\\' && i + 1 < s.size()) {
+                    char c = s[++i];
+                    r += c == 'n' ? '\n' : (c == 't' ? '\t' : c);
+                }
+                else r += s[i];
+            }
+            return r;
+        }
+
+        vector<string> split(const string& line) {
+            vector<string> fields;
+            stringstream ss{line};
+            string field;
+            while (getline(ss, field, '\t')) fields.push_back(field);
+            return fields;
+        }
+
+        int64_t modifiedTime(const filesystem::path& p) {
+            error_code ec;
+            auto t = filesystem::last_write_time(p, ec);
+            return ec ? 0 : int64_t(t.time_since_epoch().count());
+        }
+    }
+
+    ComponentLoader::~ComponentLoader() {
+        auto& factory = getServer().componentFactory;
+        // ѼصĿڳԱʱжأעĹ캯֮ʧЧȴƳ
+        for (auto& e : entries) {
+            if (!isLoaded(e.file)) continue;
+            for (auto& ci : e.components) {
+                factory.unregisterComponent(ci.type, ci.name);
+            }
+        }
+        // ӳٵǼǵĿ޷ټأƳ
+        for (auto& [type, name] : lazyComponents) {
+            factory.unregisterLazyComponent(type, name);
+        }
+    }
+
+    bool ComponentLoader::isLoaded(const string& file) const {
+        string path = (filesystem::path(directory) / file).string();
+        for (auto& lib : libraries) {
+            if (lib->getPath() == path) return true;
+        }
+        return false;
+    }
+
+    bool ComponentLoader::readManifest(const string& path, vector<ManifestEntry>& result) const {
+        ifstream file(path);
+        if (!file.is_open()) return false;
+        string line;
+        if (!getline(file, line) || line != MANIFEST_HEADER) return false;
+        while (getline(file, line)) {
+            if (line.empty() || line[0] == '#') continue;
+            auto fields = split(line);
+            if (fields[0] == "Library" && fields.size() == 4) {
+                ManifestEntry e;
+                e.file = fields[1];
+                try {
+                    e.size = stoull(fields[2]);
+                    e.modifiedTime = stoll(fields[3]);
+                }
+                catch (const exception&) {
+                    return false;
+                }
+                result.push_back(e);
+            }
+            else if (fields[0] == "Component" && fields.size() >= 3 && !result.empty()) {
+                ComponentInfo ci;
+                ci.type = fields[1];
+                ci.name = fields[2];
+                ci.id = "NR." + ci.type + "." + ci.name;
+                ci.description = fields.size() > 3 ? unescape(fields[3]) : "";
+                result.back().components.push_back(ci);
+            }
+            else {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool ComponentLoader::writeManifest(const string& path) const {
+        ofstream file(path, ios::trunc);
+        if (!file.is_open()) return false;
+        file<<MANIFEST_HEADER<<"\n";
+        file<<"# Regenerate with 'NRCli list --write-manifest' after adding, removing or modifying a library.\n";
+        lock_guard<InstrumentedMutex> lock{mtx};
+        for (auto& e : entries) {
+            file<<"Library\t"<<e.file<<"\t"<<e.size<<"\t"<<e.modifiedTime<<"\n";
+            for (auto& ci : e.components) {
+                file<<"Component\t"<<ci.type<<"\t"<<ci.name<<"\t"<<escape(ci.description)<<"\n";
+            }
+        }
+        return file.good();
+    }
+
+    bool ComponentLoader::load(const string& file) {
+        lock_guard<InstrumentedMutex> lock{mtx};
+        if (isLoaded(file)) return true;
+        string path = (filesystem::path(directory) / file).string();
+        auto lib = make_unique<DynamicLibrary>();
+        if (!lib->open(path)) {
+            getServer().logger.error("Failed to load component library " + file + ": " + lib->getErrorInfo());
+            return false;
+        }
+        libraries.push_back(std::move(lib));
+        getServer().logger.log("Component library loaded: " + file);
+        return true;
+    }
+
+    size_t ComponentLoader::init(const string& directory) {
+        auto& factory = getServer().componentFactory;
+        {
+            lock_guard<InstrumentedMutex> lock{mtx};
+            this->directory = directory;
+        }
+        string manifestPath = (filesystem::path(directory) / MANIFEST_FILE).string();
+        vector<ManifestEntry> cached;
+        bool dirty = !readManifest(manifestPath, cached);
+
+        // ļ򣬱֤嵥ȶ
+        vector<filesystem::path> files;
+        error_code ec;
+        for (auto& entry : filesystem::directory_iterator(directory, ec)) {
+            if (entry.is_regular_file() && entry.path().extension() == DynamicLibrary::extension()) {
+                files.push_back(entry.path());
+            }
+        }
+        sort(files.begin(), files.end());
+
+        vector<ManifestEntry> current;
+        size_t componentNums = 0;
+        for (auto& p : files) {
+            ManifestEntry entry;
+            entry.file = p.filename().string();
+            entry.size = filesystem::file_size(p, ec);
+            entry.modifiedTime = modifiedTime(p);
+
+            auto it = find_if(cached.begin(), cached.end(), [&](const ManifestEntry& e) { return e.file == entry.file; });
+            if (it != cached.end() && it->size == entry.size && it->modifiedTime == entry.modifiedTime) {
+                // 嵥ЧֻǼؿ
+                entry.components = it->components;
+                string file = entry.file;
+                for (auto& ci : entry.components) {
+                    if (factory.registerLazyComponent(ci.type, ci.name, ci.description, [this, file]() { return load(file); })) {
+                        lock_guard<InstrumentedMutex> lock{mtx};
+                        lazyComponents.push_back({ci.type, ci.name});
+                    }
+                }
+            }
+            else {
+                // ޸ĵĿ⣺أռע
+                dirty = true;
+                set<string> before;
+                for (auto& ci : factory.getComponentsInfo()) before.insert(ci.id);
+                if (load(entry.file)) {
+                    for (auto& ci : factory.getComponentsInfo()) {
+                        if (before.count(ci.id) == 0) entry.components.push_back(ci);
+                    }
+                }
+                // ʧܵĿҲ¼嵥Уûļ仯ǰظ
+            }
+            componentNums += entry.components.size();
+            current.push_back(entry);
+        }
+        if (current.size() != cached.size()) dirty = true;  // пⱻɾ
+
+        {
+            lock_guard<InstrumentedMutex> lock{mtx};
+            entries = current;
+        }
+        {
+            lock_guard<InstrumentedMutex> lock{mtx};
+            stale = dirty;
+        }
+        if (dirty) {
+            getServer().logger.log("Component manifest " + manifestPath + " is missing or out of date, libraries were loaded eagerly. Run 'NRCli list --write-manifest' to update it.");
+        }
+        return componentNums;
+    }
+
+    bool ComponentLoader::isManifestStale() const {
+        lock_guard<InstrumentedMutex> lock{mtx};
+        return stale;
+    }
+
+    bool ComponentLoader::saveManifest() {
+        string path;
+        {
+            lock_guard<InstrumentedMutex> lock{mtx};
+            path = (filesystem::path(directory) / MANIFEST_FILE).string();
+        }
+        if (!writeManifest(path)) {
+            getServer().logger.warning("Failed to write component manifest " + path);
+            return false;
+        }
+        lock_guard<InstrumentedMutex> lock{mtx};
+        stale = false;
+        return true;
+    }
+
+    vector<ManifestEntry> ComponentLoader::getManifest() const {
+        lock_guard<InstrumentedMutex> lock{mtx};
+        return entries;
+    }
+} // namespace NRenderer
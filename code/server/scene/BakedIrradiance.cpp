@@ -0,0 +1,169 @@
+#include "scene/BakedIrradiance.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <mutex>
+#include <algorithm>
+#include <filesystem>
+
+namespace NRenderer
+{
+    namespace
+    {
+        // ļʽ8ֽڱʶιϣuint64ƽͼ߳uint32
+        // ΪΡƽķնȣÿ3floatݰֽСˣ洢
+        const char BAKE_MAGIC[8] = { 'N', 'R', 'B', 'A', 'K', 'E', '0', '1' };
+        constexpr size_t BAKE_HEADER_SIZE = sizeof(BAKE_MAGIC) + sizeof(uint64_t) + 4*sizeof(uint32_t);
+
+        // ͷеǷļСһ£δʣп۳˷
+        bool matchesFileSize(const uint32_t counts[4], uintmax_t fileSize) {
+            if (fileSize < BAKE_HEADER_SIZE || (fileSize - BAKE_HEADER_SIZE) % sizeof(Vec3) != 0) return false;
+            uintmax_t remaining = (fileSize - BAKE_HEADER_SIZE)/sizeof(Vec3);
+            const uintmax_t texels = uintmax_t(counts[3])*counts[3];
+            const uintmax_t perItem[3] = { 3, 6, texels };
+            for (int i = 0; i < 3; i++) {
+                if (counts[i] == 0) continue;
+                if (perItem[i] == 0 || counts[i] > remaining/perItem[i]) return false;
+                remaining -= counts[i]*perItem[i];
+            }
+            return remaining == 0;
+        }
+    }
+
+    BakedIrradiance::BakedIrradiance(uint64_t key, size_t triangleCount, size_t sphereCount, size_t planeCount,
+        unsigned int planeResolution)
+        : key               (key)
+        , planeResolution   (planeResolution)
+        , triangles         (triangleCount*3, Vec3{0.f})
+        , spheres           (sphereCount*6, Vec3{0.f})
+        , planes            (planeCount*planeResolution*planeResolution, Vec3{0.f})
+    {}
+
+    shared_ptr<BakedIrradiance> BakedIrradiance::create(uint64_t key, size_t triangleCount, size_t sphereCount, size_t planeCount,
+        unsigned int planeResolution) {
+        return make_shared<BakedIrradiance>(key, triangleCount, sphereCount, planeCount, planeResolution);
+    }
+
+    Vec3 BakedIrradiance::triangle(Index index, const Triangle& triangle, const Vec3& point) const {
+        // ꣺ռı
+        Vec3 n = glm::cross(triangle.v2 - triangle.v1, triangle.v3 - triangle.v1);
+        float area = glm::dot(n, n);
+        if (area <= 0.f) return triangles[size_t(index)*3];
+        float b1 = glm::dot(glm::cross(triangle.v2 - point, triangle.v3 - point), n)/area;
+        float b2 = glm::dot(glm::cross(triangle.v3 - point, triangle.v1 - point), n)/area;
+        b1 = std::clamp(b1, 0.f, 1.f);
+        b2 = std::clamp(b2, 0.f, 1.f - b1);
+        float b3 = 1.f - b1 - b2;
+        const Vec3* v = &triangles[size_t(index)*3];
+        return v[0]*b1 + v[1]*b2 + v[2]*b3;
+    }
+
+    Vec3 BakedIrradiance::sphere(Index index, const Vec3& normal) const {
+        // ߷ƽȨȨ֮Ϊ1
+        const Vec3* v = &spheres[size_t(index)*6];
+        Vec3 w = normal*normal;
+        return w.x*v[normal.x >= 0.f ? 0 : 1]
+            + w.y*v[normal.y >= 0.f ? 2 : 3]
+            + w.z*v[normal.z >= 0.f ? 4 : 5];
+    }
+
+    Vec3 BakedIrradiance::plane(Index index, const Plane& plane, const Vec3& point) const {
+        // ͬƽϵĵΪ position + u*s + v*tst[0, 1]
+        Mat3x3 d{plane.u, plane.v, glm::cross(plane.u, plane.v)};
+        Vec3 st = glm::inverse(d)*(point - plane.position);
+        float res = float(planeResolution);
+        float x = std::clamp(st.x*res - 0.5f, 0.f, res - 1.f);
+        float y = std::clamp(st.y*res - 0.5f, 0.f, res - 1.f);
+        unsigned int s0 = unsigned(x), t0 = unsigned(y);
+        unsigned int s1 = std::min(s0 + 1, planeResolution - 1), t1 = std::min(t0 + 1, planeResolution - 1);
+        float fx = x - float(s0), fy = y - float(t0);
+        Vec3 top = planes[planeTexel(index, s0, t0)]*(1.f - fx) + planes[planeTexel(index, s1, t0)]*fx;
+        Vec3 bottom = planes[planeTexel(index, s0, t1)]*(1.f - fx) + planes[planeTexel(index, s1, t1)]*fx;
+        return top*(1.f - fy) + bottom*fy;
+    }
+
+    bool BakedIrradiance::write(const string& path) const {
+        FILE* file = fopen(path.c_str(), "wb");
+        if (file == nullptr) return false;
+        uint32_t counts[4] = { uint32_t(triangles.size()/3), uint32_t(spheres.size()/6),
+            uint32_t(planes.size()/(size_t(planeResolution)*planeResolution)), planeResolution };
+        fwrite(BAKE_MAGIC, 1, sizeof(BAKE_MAGIC), file);
+        fwrite(&key, sizeof(uint64_t), 1, file);
+        fwrite(counts, sizeof(uint32_t), 4, file);
+        fwrite(triangles.data(), sizeof(Vec3), triangles.size(), file);
+        fwrite(spheres.data(), sizeof(Vec3), spheres.size(), file);
+        fwrite(planes.data(), sizeof(Vec3), planes.size(), file);
+        bool ok = ferror(file) == 0;
+        fclose(file);
+        return ok;
+    }
+
+    bool BakedIrradiance::read(const string& path) {
+        error_code ec;
+        uintmax_t fileSize = filesystem::file_size(path, ec);
+        if (ec) return false;
+        FILE* file = fopen(path.c_str(), "rb");
+        if (file == nullptr) return false;
+        char magic[sizeof(BAKE_MAGIC)] = {};
+        uint64_t fileKey = 0;
+        uint32_t counts[4] = {};
+        bool ok = fread(magic, 1, sizeof(magic), file) == sizeof(magic)
+            && memcmp(magic, BAKE_MAGIC, sizeof(magic)) == 0
+            && fread(&fileKey, sizeof(uint64_t), 1, file) == 1
+            && fread(counts, sizeof(uint32_t), 4, file) == 4
+            && counts[3] > 0
+            && matchesFileSize(counts, fileSize);     // ǰУ飬ضϻ𻵵ļᵼ¾޴ķ
+        BakedIrradiance baked{};
+        if (ok) {
+            baked = BakedIrradiance{fileKey, counts[0], counts[1], counts[2], counts[3]};
+            ok = fread(baked.triangles.data(), sizeof(Vec3), baked.triangles.size(), file) == baked.triangles.size()
+                && fread(baked.spheres.data(), sizeof(Vec3), baked.spheres.size(), file) == baked.spheres.size()
+                && fread(baked.planes.data(), sizeof(Vec3), baked.planes.size(), file) == baked.planes.size();
+        }
+        fclose(file);
+        if (ok) *this = move(baked);
+        return ok;
+    }
+
+    void IrradianceStore::publish(SharedBakedIrradiance baked) {
+        lock_guard<InstrumentedMutex> lock{mtx};
+        current = baked;
+        unsaved = baked != nullptr;
+    }
+
+    void IrradianceStore::restore(SharedBakedIrradiance baked) {
+        lock_guard<InstrumentedMutex> lock{mtx};
+        current = baked;
+        unsaved = false;
+    }
+
+    SharedBakedIrradiance IrradianceStore::get() const {
+        lock_guard<InstrumentedMutex> lock{mtx};
+        return current;
+    }
+
+    SharedBakedIrradiance IrradianceStore::takeUnsaved() {
+        lock_guard<InstrumentedMutex> lock{mtx};
+        if (!unsaved) return nullptr;
+        unsaved = false;
+        return current;
+    }
+
+    void IrradianceStore::publishVolume(SharedIrradianceVolume volume) {
+        lock_guard<InstrumentedMutex> lock{mtx};
+        this->volume = volume;
+    }
+
+    SharedIrradianceVolume IrradianceStore::getVolume() const {
+        lock_guard<InstrumentedMutex> lock{mtx};
+        return volume;
+    }
+
+    void IrradianceStore::clear() {
+        lock_guard<InstrumentedMutex> lock{mtx};
+        current = nullptr;
+        unsaved = false;
+        volume = nullptr;
+    }
+} // namespace NRenderer
@@ -0,0 +1,230 @@
+#include "scene/IrradianceVolume.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <variant>
+#include <algorithm>
+
+namespace NRenderer
+{
+    namespace
+    {
+        // Һ˾׵ϵ
+        constexpr float COSINE_LOBE[3] = { 3.14159265f, 2.09439510f, 0.78539816f };
+        constexpr unsigned int COEFFICIENT_BAND[IrradianceVolume::SH_COEFFICIENTS] = { 0, 1, 1, 1, 2, 2, 2, 2, 2 };
+
+        // FNV-1a32λִ
+        struct Hasher
+        {
+            uint64_t h = 1469598103934665603ull;
+            void word(uint32_t w) {
+                h ^= w;
+                h *= 1099511628211ull;
+            }
+            void value(float f) {
+                uint32_t w;
+                memcpy(&w, &f, sizeof(w));
+                word(w);
+            }
+            template<int N>
+            void value(const glm::vec<N, float>& v) {
+                for (int i = 0; i < N; i++) value(v[i]);
+            }
+            void value(int i) {
+                word(uint32_t(i));
+            }
+            void value(const Handle& handle) {
+                word(uint32_t(handle.getValue()));
+            }
+        };
+
+        // չΧʹp
+        void grow(Vec3& min, Vec3& max, const Vec3& p) {
+            min = glm::min(min, p);
+            max = glm::max(max, p);
+        }
+
+        void growSphere(Vec3& min, Vec3& max, const Sphere& s) {
+            grow(min, max, s.position - Vec3{s.radius});
+            grow(min, max, s.position + Vec3{s.radius});
+        }
+
+        void growTriangle(Vec3& min, Vec3& max, const Triangle& t) {
+            for (auto& v : t.v) grow(min, max, v);
+        }
+
+        void growPlane(Vec3& min, Vec3& max, const Plane& p) {
+            grow(min, max, p.position);
+            grow(min, max, p.position + p.u);
+            grow(min, max, p.position + p.v);
+            grow(min, max, p.position + p.u + p.v);
+        }
+
+        bool sameSphere(const Sphere& a, const Sphere& b) {
+            return a.position == b.position && a.radius == b.radius && a.material.getValue() == b.material.getValue();
+        }
+
+        bool sameTriangle(const Triangle& a, const Triangle& b) {
+            return a.v1 == b.v1 && a.v2 == b.v2 && a.v3 == b.v3 && a.normal == b.normal
+                && a.material.getValue() == b.material.getValue();
+        }
+
+        bool samePlane(const Plane& a, const Plane& b) {
+            return a.position == b.position && a.u == b.u && a.v == b.v && a.normal == b.normal
+                && a.material.getValue() == b.material.getValue();
+        }
+    }
+
+    IrradianceVolume::IrradianceVolume(uint64_t key, uint64_t lightingKey, unsigned int samples,
+        const Vec3& min, const Vec3& max, unsigned int resolution)
+        : key               (key)
+        , lightingKey       (lightingKey)
+        , samples           (samples)
+        , origin            (0.f)
+        , spacing           (1.f)
+        , counts            (1)
+        , coefficients      ()
+        , valid             ()
+        , source            ()
+    {
+        Vec3 extent = glm::max(max - min, Vec3{0.f});
+        float longest = std::max({ extent.x, extent.y, extent.z });
+        float cell = longest > 0.f ? longest/float(std::max(resolution, 1u)) : 1.f;
+        for (int axis = 0; axis < 3; axis++) {
+            // ƽֻһ̽룬ȡcell
+            counts[axis] = std::max(1u, unsigned(std::ceil(extent[axis]/cell - 0.001f)));
+            spacing[axis] = extent[axis] > 0.f ? extent[axis]/float(counts[axis]) : cell;
+            origin[axis] = min[axis] + (extent[axis] > 0.f ? spacing[axis]*0.5f : 0.f);
+        }
+        size_t total = size_t(counts.x)*counts.y*counts.z;
+        coefficients.assign(total*SH_COEFFICIENTS, Vec3{0.f});
+        valid.assign(total, 1);
+    }
+
+    shared_ptr<IrradianceVolume> IrradianceVolume::create(uint64_t key, uint64_t lightingKey, unsigned int samples,
+        const Vec3& min, const Vec3& max, unsigned int resolution) {
+        return make_shared<IrradianceVolume>(key, lightingKey, samples, min, max, resolution);
+    }
+
+    Vec3 IrradianceVolume::position(size_t probe) const {
+        size_t x = probe%counts.x;
+        size_t y = probe/counts.x%counts.y;
+        size_t z = probe/(size_t(counts.x)*counts.y);
+        return origin + spacing*Vec3{float(x), float(y), float(z)};
+    }
+
+    bool IrradianceVolume::sameGrid(const IrradianceVolume& other) const {
+        return counts == other.counts && origin == other.origin && spacing == other.spacing;
+    }
+
+    Vec3 IrradianceVolume::irradiance(const Vec3& position, const Vec3& normal) const {
+        if (valid.empty()) return Vec3{0.f};
+        Vec3 grid = glm::clamp((position - origin)/spacing, Vec3{0.f}, Vec3{counts - 1u});
+        glm::uvec3 base = glm::min(glm::uvec3(grid), counts - 1u);
+        Vec3 f = grid - Vec3{base};
+        Vec3 sum{0.f}, fallback{0.f};
+        float total = 0.f, fallbackTotal = 0.f;
+        for (unsigned int corner = 0; corner < 8; corner++) {
+            glm::uvec3 offset{ corner & 1, (corner >> 1) & 1, (corner >> 2) & 1 };
+            glm::uvec3 c = glm::min(base + offset, counts - 1u);
+            float w = (offset.x ? f.x : 1.f - f.x)*(offset.y ? f.y : 1.f - f.y)*(offset.z ? f.z : 1.f - f.z);
+            if (w <= 0.f) continue;
+            size_t p = probe(c.x, c.y, c.z);
+            Vec3 e = shIrradiance(&coefficients[p*SH_COEFFICIENTS], normal);
+            // ̽붼Чλڱʱ˻ͨԲֵ
+            fallback += e*w;
+            fallbackTotal += w;
+            if (!valid[p]) continue;
+            // ̽λڱ汳ʱȨؽӽ0ԱһСʹֵ
+            Vec3 toProbe = this->position(p) - position;
+            float length = glm::length(toProbe);
+            float facing = length > 0.f ? (glm::dot(toProbe/length, normal) + 1.f)*0.5f : 1.f;
+            w *= facing*facing + 0.05f;
+            sum += e*w;
+            total += w;
+        }
+        Vec3 result = total > 0.f ? sum/total : (fallbackTotal > 0.f ? fallback/fallbackTotal : Vec3{0.f});
+        // гڹձ仯ҴΪ
+        return glm::max(result, Vec3{0.f});
+    }
+
+    vector<size_t> IrradianceVolume::probesNear(const Vec3& min, const Vec3& max, float margin) const {
+        vector<size_t> result;
+        Vec3 lo = min - Vec3{margin}, hi = max + Vec3{margin};
+        for (size_t p = 0; p < size(); p++) {
+            Vec3 q = position(p);
+            if (glm::all(glm::greaterThanEqual(q, lo)) && glm::all(glm::lessThanEqual(q, hi))) result.push_back(p);
+        }
+        return result;
+    }
+
+    void IrradianceVolume::shBasis(const Vec3& d, float basis[SH_COEFFICIENTS]) {
+        basis[0] = 0.282095f;
+        basis[1] = 0.488603f*d.y;
+        basis[2] = 0.488603f*d.z;
+        basis[3] = 0.488603f*d.x;
+        basis[4] = 1.092548f*d.x*d.y;
+        basis[5] = 1.092548f*d.y*d.z;
+        basis[6] = 0.315392f*(3.f*d.z*d.z - 1.f);
+        basis[7] = 1.092548f*d.x*d.z;
+        basis[8] = 0.546274f*(d.x*d.x - d.y*d.y);
+    }
+
+    Vec3 IrradianceVolume::shIrradiance(const Vec3* coefficients, const Vec3& normal) {
+        float basis[SH_COEFFICIENTS];
+        shBasis(normal, basis);
+        Vec3 e{0.f};
+        for (unsigned int i = 0; i < SH_COEFFICIENTS; i++) {
+            e += coefficients[i]*(COSINE_LOBE[COEFFICIENT_BAND[i]]*basis[i]);
+        }
+        return e;
+    }
+
+    bool IrradianceVolume::changedBounds(const PreparedScene& previous, const PreparedScene& current, Vec3& min, Vec3& max) {
+        min = Vec3{numeric_limits<float>::max()};
+        max = Vec3{-numeric_limits<float>::max()};
+        if (previous.spheres.size() != current.spheres.size()
+            || previous.triangles.size() != current.triangles.size()
+            || previous.planes.size() != current.planes.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < current.spheres.size(); i++) {
+            if (sameSphere(previous.spheres[i], current.spheres[i])) continue;
+            growSphere(min, max, previous.spheres[i]);
+            growSphere(min, max, current.spheres[i]);
+        }
+        for (size_t i = 0; i < current.triangles.size(); i++) {
+            if (sameTriangle(previous.triangles[i], current.triangles[i])) continue;
+            growTriangle(min, max, previous.triangles[i]);
+            growTriangle(min, max, current.triangles[i]);
+        }
+        for (size_t i = 0; i < current.planes.size(); i++) {
+            if (samePlane(previous.planes[i], current.planes[i])) continue;
+            growPlane(min, max, previous.planes[i]);
+            growPlane(min, max, current.planes[i]);
+        }
+        return true;
+    }
+
+    uint64_t IrradianceVolume::hashLighting(const Scene& scene) {
+        Hasher hasher{};
+        hasher.value(scene.ambient.constant);
+        hasher.word(uint32_t(scene.areaLightBuffer.size()));
+        for (auto& a : scene.areaLightBuffer) {
+            hasher.value(a.radiance);
+            hasher.value(a.position);
+            hasher.value(a.u);
+            hasher.value(a.v);
+        }
+        hasher.word(uint32_t(scene.materials.size()));
+        for (auto& m : scene.materials) {
+            hasher.word(m.type);
+            hasher.word(uint32_t(m.properties.size()));
+            for (auto& p : m.properties) {
+                visit([&](const auto& wrapper) { hasher.value(wrapper.value); }, p.valueWrapper);
+            }
+        }
+        return hasher.h;
+    }
+} // namespace NRenderer
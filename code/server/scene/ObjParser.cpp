@@ -0,0 +1,245 @@
+#include "scene/ObjParser.hpp"
+
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <cctype>
+
+// OBJģļʵ
+// ߼༭ԭеObjImporterһ£ֻ¼·
+
+namespace NRenderer
+{
+    namespace
+    {
+        // ȡ·еĿ¼֣ĩβķָ
+        string directoryOf(const string& path) {
+            auto pos = path.find_last_of("\\/");
+            return pos == string::npos ? string() : path.substr(0, pos + 1);
+        }
+
+        // ȡ·еļ
+        string fileNameOf(const string& path) {
+            auto pos = path.find_last_of("\\/");
+            return pos == string::npos ? path : path.substr(pos + 1);
+        }
+    }
+
+    bool ObjParser::parseMtl(StagedScene& staged, const string& directory, istream& in, unordered_map<string, size_t>& mtlMap) {
+        using PW = Property::Wrapper;
+        auto& scene = staged.scene;
+        Material* currMaterial = nullptr;  // ǰڴĲ
+
+        // Ǽݴеľ
+        auto addTexture = [&](const string& fileName) {
+            Handle h{ (unsigned int)scene.textures.size() };
+            scene.textures.emplace_back();
+            staged.textureNames.push_back(fileName);
+            staged.texturePaths.push_back(directory + fileName);
+            return h;
+        };
+
+        string currLine;
+        stringstream ss{};
+        while(getline(in, currLine)) {
+            ss.clear();
+            ss.str(currLine);
+            string token;
+            ss>>token;
+            transform(token.begin(), token.end(), token.begin(), ::tolower);
+            if (token == "" || token[0] == '#') continue;
+
+            if (token == "newmtl") {  // ²ʶ
+                ss>>token;
+                mtlMap[token] = scene.materials.size();
+                scene.materials.emplace_back();
+                staged.materialNames.push_back(token);
+                currMaterial = &scene.materials.back();
+                currMaterial->type = 1;
+                continue;
+            }
+            // Զĳʣֵ֧Ժ
+            if (currMaterial == nullptr) continue;
+            if (token == "kd") {  // ɫ
+                float f1 = 0, f2 = 0, f3 = 0;
+                ss>>f1>>f2>>f3;
+                currMaterial->registerProperty("diffuseColor", PW::RGBType{Vec3{f1, f2, f3}});
+            }
+            else if (token == "ks") {  // 淴ɫ
+                float f1 = 0, f2 = 0, f3 = 0;
+                ss>>f1>>f2>>f3;
+                currMaterial->registerProperty("specularColor", PW::RGBType{Vec3{f1, f2, f3}});
+            }
+            else if (token == "ns") {  // 淴ָ
+                float f = 0;
+                ss>>f;
+                currMaterial->registerProperty("specularEx", PW::FloatType{f});
+            }
+            else if (token == "map_kd") {  // ͼ
+                ss>>token;
+                currMaterial->registerProperty(Property{"diffuseMap", PW::TextureIdType{addTexture(token)}});
+            }
+            else if (token == "map_ks") {  // 淴ͼ
+                ss>>token;
+                currMaterial->registerProperty(Property{"specularMap", PW::TextureIdType{addTexture(token)}});
+            }
+            else if (token == "map_bump" || token == "bump") {  // ͹ͼ
+                ss>>token;
+                currMaterial->registerProperty(Property{"bumpMap", PW::TextureIdType{addTexture(token)}});
+            }
+        }
+        return true;
+    }
+
+    bool ObjParser::stageFile(const string& path, StagedScene& staged, ImportProgress* progress) {
+        ifstream file(path, ios::binary | ios::ate);
+        if (!file.is_open()) {
+            lastErrorInfo = "File does not exist!";
+            return false;
+        }
+        const size_t totalBytes = size_t(file.tellg());
+        file.seekg(0);
+        lastErrorInfo = "";
+
+        auto& scene = staged.scene;
+        scene.models.emplace_back();
+        staged.modelNames.push_back(fileNameOf(path));
+        const Index model = Index(scene.models.size() - 1);
+
+        unordered_map<string, size_t> mtlMap;  // Ƶ±ӳ
+
+        // ݻ
+        vector<Vec3> positions;  // λ
+        vector<Vec3> normals;    // 㷨
+        vector<Vec2> uvs;        // 
+
+        // ǰУļڵĶ±굽±ӳ
+        unordered_map<long, Index> pMap, tMap, nMap;
+        Mesh* currMesh = nullptr;
+
+        // ʼһµڵ
+        auto beginMesh = [&](const string& name) {
+            Node node{};
+            node.type = Node::Type::MESH;
+            node.model = model;
+            node.entity = Index(scene.meshBuffer.size());
+            scene.models[model].nodes.push_back(Index(scene.nodes.size()));
+            scene.nodes.push_back(node);
+            staged.nodeNames.push_back(name);
+            scene.meshBuffer.emplace_back();
+            currMesh = &scene.meshBuffer.back();
+            pMap.clear();
+            tMap.clear();
+            nMap.clear();
+        };
+
+        // ļеĶ±ӳΪڵ±꣬Ҫʱƶ
+        auto mapIndex = [](long i, auto& map, auto& source, auto& target) -> Index {
+            auto finded = map.find(i);
+            if (finded != map.end()) return finded->second;
+            Index idx = Index(target.size());
+            map.insert({i, idx});
+            target.push_back(source[i - 1]);
+            return idx;
+        };
+
+        string currLine;
+        stringstream ss{};
+        size_t readBytes = 0, readLines = 0;
+        while (getline(file, currLine)) {
+            readBytes += currLine.size() + 1;
+            if (progress != nullptr && (++readLines & 0xFFF) == 0) {
+                if (progress->isCancelled()) {
+                    lastErrorInfo = "Import cancelled.";
+                    return false;
+                }
+                progress->report(float(min(readBytes, totalBytes))/float(max<size_t>(totalBytes, 1)));
+            }
+            ss.clear();
+            ss.str(currLine);
+            string token;
+            ss>>token;
+
+            if (token == "mtllib") {  // ʿļ
+                string mtlFileName;
+                ss>>mtlFileName;
+                auto directory = directoryOf(path);
+                ifstream mtlFile(directory + mtlFileName);
+                if (!mtlFile.is_open()) {
+                    lastErrorInfo = "Cannot file .mtl file";
+                    return false;
+                }
+                staged.sourceFiles.push_back(directory + mtlFileName);
+                if (!parseMtl(staged, directory, mtlFile, mtlMap)) return false;
+            }
+            else if (token == "usemtl") {  // ʹò
+                string mtlName;
+                ss>>mtlName;
+                auto mtlItr = mtlMap.find(mtlName);
+                if (mtlItr == mtlMap.end()) {
+                    lastErrorInfo = "Cannot find material: " + mtlName;
+                    return false;
+                }
+                if (currMesh == nullptr) beginMesh("Undefined");
+                currMesh->material.setIndex(Index(mtlItr->second));
+            }
+            else if (token == "v") {  // λ
+                float f1 = 0, f2 = 0, f3 = 0;
+                ss>>f1>>f2>>f3;
+                positions.push_back({ f1, f2, f3 });
+            }
+            else if (token == "vt") {  // 
+                float f1 = 0, f2 = 0;
+                ss>>f1>>f2;
+                uvs.push_back({ f1, f2 });
+            }
+            else if (token == "vn") {  // 㷨
+                float f1 = 0, f2 = 0, f3 = 0;
+                ss>>f1>>f2>>f3;
+                normals.push_back({ f1, f2, f3 });
+            }
+            else if (token == "o" || token == "g") {  // 
+                string name = "undefined";
+                ss>>name;
+                beginMesh(name);
+            }
+            else if (token == "f") {  // 棨Σ
+                if (currMesh == nullptr) beginMesh("Undefined");
+                for (int i = 0; i < 3; i++) {
+                    string vertexToken;
+                    if (!(ss>>vertexToken)) {
+                        lastErrorInfo = "Only Triangulated mesh is supported!";
+                        return false;
+                    }
+                    // ֧ vv/tv//nv/t/n ָʽ
+                    long v = -1, t = -1, n = -1;
+                    char c = '\0';
+                    stringstream vertexStream{vertexToken};
+                    auto begin = vertexToken.find_first_of('/');
+                    auto end = vertexToken.find_last_of('/');
+                    if (begin == vertexToken.npos) vertexStream>>v;
+                    else if (begin == end) vertexStream>>v>>c>>t;
+                    else if (begin + 1 == end) vertexStream>>v>>c>>c>>n;
+                    else vertexStream>>v>>c>>t>>c>>n;
+
+                    if (v < 1 || size_t(v) > positions.size()
+                        || (t != -1 && (t < 1 || size_t(t) > uvs.size()))
+                        || (n != -1 && (n < 1 || size_t(n) > normals.size()))) {
+                        lastErrorInfo = "Invalid vertex index: " + vertexToken;
+                        return false;
+                    }
+                    currMesh->positionIndices.push_back(mapIndex(v, pMap, positions, currMesh->positions));
+                    if (t != -1) currMesh->uvIndices.push_back(mapIndex(t, tMap, uvs, currMesh->uvs));
+                    if (n != -1) currMesh->normalIndices.push_back(mapIndex(n, nMap, normals, currMesh->normals));
+                }
+                string extra;
+                if (ss>>extra) {
+                    lastErrorInfo = "Only Triangulated mesh is supported!";
+                    return false;
+                }
+            }
+        }
+        if (progress != nullptr) progress->report(1.f);
+        return true;
+    }
+} // namespace NRenderer
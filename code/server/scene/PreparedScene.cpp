@@ -0,0 +1,704 @@
+#include "scene/PreparedScene.hpp"
+#include "server/TaskGraph.hpp"
+
+#include <cstring>
+#include <mutex>
+#include <cfloat>
+#include <thread>
+
+namespace NRenderer
+{
+    namespace
+    {
+        // ͼԪΧУʱʹ
+        struct BuildItem
+        {
+            Vec3 min;
+            Vec3 max;
+            Vec3 center;
+            PrimitiveRef ref;
+        };
+
+        constexpr uint32_t LEAF_SIZE = 4;   // ҶӽڵͼԪ
+        constexpr size_t REFIT_DIVISOR = 4; // ޸ĵͼԪ1/4ʱ¹
+        constexpr size_t LAZY_THRESHOLD = 65536;    // ͼԪﵽֵʱӳٹBVH²
+        constexpr size_t LAZY_SUBTREE_SIZE = 2048;  // ӳٹͼԪ
+        constexpr size_t PARALLEL_BUILD_SIZE = 4096;    // ͼԪﵽֵʱ̹߳BVH
+        constexpr size_t PARALLEL_SUBTREES_PER_THREAD = 4;  // ÿ߳ƽֵƽĹʱ
+
+        constexpr float GRID_DENSITY = 0.5f;            // һÿͼԪӦĵԪ
+        constexpr float SUBGRID_DENSITY = 1.f;          // ڶÿͼԪöӦĵԪ
+        constexpr uint32_t SUBGRID_THRESHOLD = 16;      // ͼԪóֵĵһ㵥Ԫֵڶ
+        constexpr unsigned int MAX_GRID_RESOLUTION = 256;   // һÿԪ
+        constexpr unsigned int MAX_SUBGRID_RESOLUTION = 8;  // ڶÿԪ
+        constexpr size_t GRID_CHUNK_SIZE = 4096;        // мʱÿεͼԪ
+        constexpr size_t GRID_SORT_COUNTERS = size_t(1) << 22;  // иεԪޣ16MBԪ϶ʱٶ
+        constexpr size_t GRID_MIN_PRIMITIVES = 4096;    // ԶѡʱʹͼԪ
+        constexpr float MAX_GRID_DUPLICATION = 2.5f;    // ԶѡʱÿͼԪƽޣ˵ڿԽԪĴͼԪ
+        constexpr float MAX_GRID_CLUSTERING = 8.f;      // ԶѡʱԪǿյԪƽֵ֮ȵޣ˵ͼԪ
+        constexpr float MIN_GRID_OCCUPANCY = 0.5f;      // ԶѡʱǿյԪռޣ˵ͼԪֲֻϣģ͡ΣBVH
+
+        // ˻İΧУƽеΣ΢Ӻ񣬱ʱ򸡵©
+        void pad(BuildItem& item) {
+            item.min -= Vec3{1e-4f};
+            item.max += Vec3{1e-4f};
+            item.center = (item.min + item.max)*0.5f;
+        }
+
+        BuildItem bounds(const Sphere& s, Index i) {
+            BuildItem item{ s.position - Vec3{s.radius}, s.position + Vec3{s.radius}, {}, { PrimitiveRef::Type::SPHERE, i } };
+            pad(item);
+            return item;
+        }
+
+        BuildItem bounds(const Triangle& t, Index i) {
+            BuildItem item{ glm::min(t.v[0], glm::min(t.v[1], t.v[2])), glm::max(t.v[0], glm::max(t.v[1], t.v[2])), {}, { PrimitiveRef::Type::TRIANGLE, i } };
+            pad(item);
+            return item;
+        }
+
+        BuildItem bounds(const Plane& p, Index i) {
+            // ƽpositionΪǵ㡢uvΪߵƽı
+            Vec3 corners[4] = { p.position, p.position + p.u, p.position + p.v, p.position + p.u + p.v };
+            BuildItem item{ Vec3{FLT_MAX}, Vec3{-FLT_MAX}, {}, { PrimitiveRef::Type::PLANE, i } };
+            for (auto& c : corners) {
+                item.min = glm::min(item.min, c);
+                item.max = glm::max(item.max, c);
+            }
+            pad(item);
+            return item;
+        }
+
+        bool same(const Handle& a, const Handle& b) {
+            return a.getValue() == b.getValue();
+        }
+
+        bool same(const Sphere& a, const Sphere& b) {
+            return same(a.material, b.material) && a.direction == b.direction && a.position == b.position && a.radius == b.radius;
+        }
+
+        bool same(const Triangle& a, const Triangle& b) {
+            return same(a.material, b.material) && a.v[0] == b.v[0] && a.v[1] == b.v[1] && a.v[2] == b.v[2] && a.normal == b.normal;
+        }
+
+        bool same(const Plane& a, const Plane& b) {
+            return same(a.material, b.material) && a.normal == b.normal && a.position == b.position && a.u == b.u && a.v == b.v;
+        }
+
+        // ͳһνͬͼԪͬͼԪ붼޸ļ¼
+        // : ͬͼԪδ¼޸ʱSIZE_MAX
+        template<typename T>
+        size_t countChanged(const vector<T>& current, const vector<T>& previous, const vector<Index>& marked) {
+            vector<bool> allowed(current.size(), false);
+            for (auto i : marked) {
+                if (i < allowed.size()) allowed[i] = true;
+            }
+            size_t changed = 0;
+            for (size_t i = 0; i < current.size(); i++) {
+                if (same(current[i], previous[i])) continue;
+                if (!allowed[i]) return SIZE_MAX;
+                changed++;
+            }
+            return changed;
+        }
+
+        BuildItem bounds(const PrimitiveRef& ref, const Sphere* spheres, const Triangle* triangles, const Plane* planes) {
+            return ref.type == PrimitiveRef::Type::SPHERE ? bounds(spheres[ref.index], ref.index)
+                : ref.type == PrimitiveRef::Type::TRIANGLE ? bounds(triangles[ref.index], ref.index)
+                : bounds(planes[ref.index], ref.index);
+        }
+
+        // [begin, end)ڵ±
+        // subtreesΪʱͼԪlazySizeֻռλڵ
+        uint32_t buildRecursive(vector<BuildItem>& items, size_t begin, size_t end, vector<BvhNode>& nodes, vector<PrimitiveRef>& primitives,
+            vector<shared_ptr<SceneBvh::Subtree>>* subtrees, size_t lazySize) {
+            uint32_t index = uint32_t(nodes.size());
+            nodes.emplace_back();
+            Vec3 bmin{FLT_MAX}, bmax{-FLT_MAX}, cmin{FLT_MAX}, cmax{-FLT_MAX};
+            for (size_t i = begin; i < end; i++) {
+                bmin = glm::min(bmin, items[i].min);
+                bmax = glm::max(bmax, items[i].max);
+                cmin = glm::min(cmin, items[i].center);
+                cmax = glm::max(cmax, items[i].center);
+            }
+            nodes[index].min = bmin;
+            nodes[index].max = bmax;
+
+            if (end - begin <= LEAF_SIZE) {
+                nodes[index].offset = uint32_t(primitives.size());
+                nodes[index].count = uint16_t(end - begin);
+                nodes[index].axis = 0;
+                for (size_t i = begin; i < end; i++) primitives.push_back(items[i].ref);
+                return index;
+            }
+
+            if (subtrees != nullptr && end - begin <= lazySize) {
+                auto subtree = make_shared<SceneBvh::Subtree>();
+                subtree->primitives.reserve(end - begin);
+                for (size_t i = begin; i < end; i++) subtree->primitives.push_back(items[i].ref);
+                nodes[index].offset = uint32_t(subtrees->size());
+                nodes[index].count = SceneBvh::LAZY;
+                nodes[index].axis = 0;
+                subtrees->push_back(move(subtree));
+                return index;
+            }
+
+            // ķֲᰴλ
+            Vec3 extent = cmax - cmin;
+            int axis = extent.x > extent.y ? 0 : 1;
+            axis = extent[axis] > extent.z ? axis : 2;
+            size_t mid = begin + (end - begin)/2;
+            nth_element(items.begin() + begin, items.begin() + mid, items.begin() + end,
+                [axis](const BuildItem& a, const BuildItem& b) { return a.center[axis] < b.center[axis]; });
+
+            buildRecursive(items, begin, mid, nodes, primitives, subtrees, lazySize);
+            uint32_t right = buildRecursive(items, mid, end, nodes, primitives, subtrees, lazySize);
+            nodes[index].offset = right;
+            nodes[index].count = 0;
+            nodes[index].axis = uint16_t(axis);
+            return index;
+        }
+
+        // λֵõBVHڵ
+        uint32_t countNodes(size_t count) {
+            if (count <= LEAF_SIZE) return 1;
+            return 1 + countNodes(count/2) + countNodes(count - count/2);
+        }
+
+        // Ŀ굥ԪȷĵԪʹԪӽ
+        glm::uvec3 gridResolution(const Vec3& extent, float cells, unsigned int maxResolution) {
+            float scale = std::cbrt(cells/(extent.x*extent.y*extent.z));
+            glm::uvec3 resolution;
+            for (int a = 0; a < 3; a++) {
+                resolution[a] = unsigned(std::clamp(extent[a]*scale, 1.f, float(maxResolution)));
+            }
+            return resolution;
+        }
+
+        // ΧиǵĵԪΧ[lo, hi]Ĳֱض
+        // Ƚضϵ[0, last]תΪȡͬҲҪfloor
+        void cellRange(const BuildItem& item, const Vec3& gridMin, const Vec3& invCellSize, const glm::uvec3& resolution, glm::uvec3& lo, glm::uvec3& hi) {
+            for (int a = 0; a < 3; a++) {
+                float last = float(resolution[a] - 1);
+                lo[a] = unsigned(std::clamp((item.min[a] - gridMin[a])*invCellSize[a], 0.f, last));
+                hi[a] = unsigned(std::clamp((item.max[a] - gridMin[a])*invCellSize[a], 0.f, last));
+            }
+        }
+
+        // ԰ΧиǵÿԪf(Ԫ±)
+        template<typename F>
+        void forCells(const BuildItem& item, const Vec3& gridMin, const Vec3& invCellSize, const glm::uvec3& resolution, F&& f) {
+            glm::uvec3 lo, hi;
+            cellRange(item, gridMin, invCellSize, resolution, lo, hi);
+            for (unsigned int z = lo.z; z <= hi.z; z++) {
+                for (unsigned int y = lo.y; y <= hi.y; y++) {
+                    uint32_t row = (z*resolution.y + y)*resolution.x;
+                    for (unsigned int x = lo.x; x <= hi.x; x++) f(row + x);
+                }
+            }
+        }
+
+        // ̹߳
+        struct BuildJob
+        {
+            size_t begin;
+            size_t end;
+            uint32_t index;     // ڵ±
+        };
+
+        // buildRecursiveͬػ֣дԤȷõλãڵΪnodes[index]ҶӽڵͼԪΪprimitives[begin, end)
+        // jobsΪʱͼԪsplitSizeֻ¼ɵй
+        // : ֮ĵһڵ±
+        uint32_t buildAt(vector<BuildItem>& items, size_t begin, size_t end, uint32_t index, vector<BvhNode>& nodes, vector<PrimitiveRef>& primitives,
+            vector<BuildJob>* jobs, size_t splitSize) {
+            if (jobs != nullptr && end - begin <= splitSize) {
+                jobs->push_back({ begin, end, index });
+                return index + countNodes(end - begin);
+            }
+            Vec3 bmin{FLT_MAX}, bmax{-FLT_MAX}, cmin{FLT_MAX}, cmax{-FLT_MAX};
+            for (size_t i = begin; i < end; i++) {
+                bmin = glm::min(bmin, items[i].min);
+                bmax = glm::max(bmax, items[i].max);
+                cmin = glm::min(cmin, items[i].center);
+                cmax = glm::max(cmax, items[i].center);
+            }
+            BvhNode& node = nodes[index];
+            node.min = bmin;
+            node.max = bmax;
+
+            if (end - begin <= LEAF_SIZE) {
+                node.offset = uint32_t(begin);
+                node.count = uint16_t(end - begin);
+                node.axis = 0;
+                for (size_t i = begin; i < end; i++) primitives[i] = items[i].ref;
+                return index + 1;
+            }
+
+            Vec3 extent = cmax - cmin;
+            int axis = extent.x > extent.y ? 0 : 1;
+            axis = extent[axis] > extent.z ? axis : 2;
+            size_t mid = begin + (end - begin)/2;
+            nth_element(items.begin() + begin, items.begin() + mid, items.begin() + end,
+                [axis](const BuildItem& a, const BuildItem& b) { return a.center[axis] < b.center[axis]; });
+
+            uint32_t right = buildAt(items, begin, mid, index + 1, nodes, primitives, jobs, splitSize);
+            node.offset = right;
+            node.count = 0;
+            node.axis = uint16_t(axis);
+            return buildAt(items, mid, end, right, nodes, primitives, jobs, splitSize);
+        }
+
+        // FNV-1a32λִ
+        struct Hasher
+        {
+            uint64_t h = 1469598103934665603ull;
+            void word(uint32_t w) {
+                h ^= w;
+                h *= 1099511628211ull;
+            }
+            void value(float f) {
+                uint32_t w;
+                memcpy(&w, &f, sizeof(w));
+                word(w);
+            }
+            void value(const Vec3& v) {
+                value(v.x);
+                value(v.y);
+                value(v.z);
+            }
+            void value(const Handle& handle) {
+                word(uint32_t(handle.getValue()));
+            }
+        };
+    }
+
+    void SceneBvh::build(const vector<Sphere>& spheres, const vector<Triangle>& triangles, const vector<Plane>& planes, size_t lazySize, unsigned int threads) {
+        nodes.clear();
+        primitives.clear();
+        subtrees.clear();
+        lazySpheres = spheres.data();
+        lazyTriangles = triangles.data();
+        lazyPlanes = planes.data();
+        vector<BuildItem> items;
+        items.reserve(spheres.size() + triangles.size() + planes.size());
+        for (size_t i = 0; i < spheres.size(); i++) items.push_back(bounds(spheres[i], Index(i)));
+        for (size_t i = 0; i < triangles.size(); i++) items.push_back(bounds(triangles[i], Index(i)));
+        for (size_t i = 0; i < planes.size(); i++) items.push_back(bounds(planes[i], Index(i)));
+        if (items.empty()) return;
+        // lazySizeʱӳٹû
+        bool lazy = lazySize > LEAF_SIZE && items.size() > lazySize;
+        if (lazy) {
+            nodes.reserve(2*items.size()/lazySize + 1);
+            buildRecursive(items, 0, items.size(), nodes, primitives, &subtrees, lazySize);
+            return;
+        }
+        if (threads > 1 && items.size() >= PARALLEL_BUILD_SIZE) {
+            // ڵֻȡͼԪԤȷд뻥صĽڵͼԪ
+            // ϲڵڱ̹߳²ͼй뵥̹߳ȫͬ
+            nodes.resize(countNodes(items.size()));
+            primitives.resize(items.size());
+            vector<BuildJob> jobs;
+            size_t splitSize = max<size_t>(items.size()/(size_t(threads)*PARALLEL_SUBTREES_PER_THREAD), LEAF_SIZE);
+            buildAt(items, 0, items.size(), 0, nodes, primitives, &jobs, splitSize);
+            TaskGraph graph{};
+            for (auto& job : jobs) {
+                graph.add([&, job]() { buildAt(items, job.begin, job.end, job.index, nodes, primitives, nullptr, 0); });
+            }
+            graph.run(threads);
+            return;
+        }
+        nodes.reserve(2*items.size()/LEAF_SIZE + 1);
+        primitives.reserve(items.size());
+        buildRecursive(items, 0, items.size(), nodes, primitives, nullptr, 0);
+    }
+
+    auto SceneBvh::expand(uint32_t index) const -> const Subtree& {
+        Subtree& subtree = *subtrees[index];
+        call_once(subtree.once, [&]() {
+            vector<BuildItem> items;
+            items.reserve(subtree.primitives.size());
+            for (auto& ref : subtree.primitives) items.push_back(bounds(ref, lazySpheres, lazyTriangles, lazyPlanes));
+            vector<PrimitiveRef> sorted;
+            sorted.reserve(items.size());
+            subtree.nodes.reserve(2*items.size()/LEAF_SIZE + 1);
+            buildRecursive(items, 0, items.size(), subtree.nodes, sorted, nullptr, 0);
+            subtree.primitives = move(sorted);
+            subtree.built.store(true, memory_order_release);
+        });
+        return subtree;
+    }
+
+    size_t SceneBvh::builtSubtrees() const {
+        size_t built = 0;
+        for (auto& subtree : subtrees) {
+            if (subtree->built.load(memory_order_acquire)) built++;
+        }
+        return built;
+    }
+
+    void SceneBvh::refit(const vector<Sphere>& spheres, const vector<Triangle>& triangles, const vector<Plane>& planes) {
+        lazySpheres = spheres.data();
+        lazyTriangles = triangles.data();
+        lazyPlanes = planes.data();
+        // ӽڵ±Ǵڸڵ㣬ɱ֤ȴӽڵ
+        for (size_t i = nodes.size(); i-- > 0;) {
+            BvhNode& node = nodes[i];
+            Vec3 bmin{FLT_MAX}, bmax{-FLT_MAX};
+            if (node.count > 0) {
+                for (uint32_t p = node.offset; p < node.offset + node.count; p++) {
+                    BuildItem item = bounds(primitives[p], spheres.data(), triangles.data(), planes.data());
+                    bmin = glm::min(bmin, item.min);
+                    bmax = glm::max(bmax, item.max);
+                }
+            }
+            else {
+                const BvhNode& left = nodes[i + 1];
+                const BvhNode& right = nodes[node.offset];
+                bmin = glm::min(left.min, right.min);
+                bmax = glm::max(left.max, right.max);
+            }
+            node.min = bmin;
+            node.max = bmax;
+        }
+    }
+
+    bool SceneGrid::build(const vector<Sphere>& spheres, const vector<Triangle>& triangles, const vector<Plane>& planes, unsigned int threads, bool requireUniform) {
+        cells.clear();
+        subgrids.clear();
+        primitives.clear();
+        resolution = glm::uvec3{0u};
+        threads = std::max(1u, threads);
+        size_t count = spheres.size() + triangles.size() + planes.size();
+        if (count == 0) return false;
+        vector<BuildItem> items(count);
+        size_t chunks = threads > 1 ? std::clamp<size_t>(count/GRID_CHUNK_SIZE, 1, threads) : 1;
+        size_t chunkSize = (count + chunks - 1)/chunks;
+        vector<Vec3> chunkMin(chunks, Vec3{FLT_MAX}), chunkMax(chunks, Vec3{-FLT_MAX});
+        TaskGraph graph{};
+        for (size_t k = 0; k < chunks; k++) {
+            graph.add([&, k]() {
+                size_t end = std::min(count, (k + 1)*chunkSize);
+                for (size_t i = k*chunkSize; i < end; i++) {
+                    BuildItem& item = items[i];
+                    if (i < spheres.size()) item = bounds(spheres[i], Index(i));
+                    else if (i < spheres.size() + triangles.size()) item = bounds(triangles[i - spheres.size()], Index(i - spheres.size()));
+                    else item = bounds(planes[i - spheres.size() - triangles.size()], Index(i - spheres.size() - triangles.size()));
+                    chunkMin[k] = glm::min(chunkMin[k], item.min);
+                    chunkMax[k] = glm::max(chunkMax[k], item.max);
+                }
+            });
+        }
+        graph.run(threads);
+
+        Vec3 bmin{FLT_MAX}, bmax{-FLT_MAX};
+        for (size_t k = 0; k < chunks; k++) {
+            bmin = glm::min(bmin, chunkMin[k]);
+            bmax = glm::max(bmax, chunkMax[k]);
+        }
+        // ͼԪʱûкȣһСĺ
+        Vec3 extent = bmax - bmin;
+        float longest = std::max(std::max(extent.x, extent.y), extent.z);
+        extent = glm::max(extent, Vec3{std::max(longest*1e-3f, 1e-4f)});
+        glm::uvec3 res = gridResolution(extent, std::max(1.f, float(count)*GRID_DENSITY), MAX_GRID_RESOLUTION);
+        Vec3 size = extent/Vec3(res);
+        Vec3 invSize = 1.f/size;
+        uint32_t topCells = res.x*res.y*res.z;
+
+        // 򣺸ηֱͳÿԪǰ׺ͺд뻥صλã˳뵥߳ͬ
+        // ÿҪһݸȫԪļGRID_SORT_COUNTERSƣԪܶʱ˻Ϊ߳
+        // ķֶΧеķֶ޹أҰ˳еͼԪ
+        size_t sortChunks = std::clamp<size_t>(GRID_SORT_COUNTERS/topCells, 1, chunks);
+        size_t sortChunkSize = (count + sortChunks - 1)/sortChunks;
+        vector<vector<uint32_t>> cursors(sortChunks, vector<uint32_t>(topCells, 0));
+        graph.clear();
+        for (size_t k = 0; k < sortChunks; k++) {
+            graph.add([&, k]() {
+                auto& counts = cursors[k];
+                size_t end = std::min(count, (k + 1)*sortChunkSize);
+                for (size_t i = k*sortChunkSize; i < end; i++) {
+                    forCells(items[i], bmin, invSize, res, [&](uint32_t c) { counts[c]++; });
+                }
+            });
+        }
+        graph.run(threads);
+
+        vector<Cell> top(topCells);
+        uint64_t total = 0;
+        uint32_t fullest = 0, occupied = 0;
+        for (uint32_t c = 0; c < topCells; c++) {
+            top[c].offset = uint32_t(total);
+            for (size_t k = 0; k < sortChunks; k++) {
+                uint32_t n = cursors[k][c];
+                cursors[k][c] = uint32_t(total);
+                total += n;
+            }
+            top[c].count = uint32_t(total - top[c].offset);
+            if (top[c].count > 0) occupied++;
+            fullest = std::max(fullest, top[c].count);
+            // 32λ±
+            if (total >= SUBGRID) return false;
+        }
+        if (requireUniform) {
+            float duplication = float(total)/float(count);
+            float mean = float(total)/float(occupied);
+            float occupancy = float(occupied)/float(topCells);
+            if (duplication > MAX_GRID_DUPLICATION || float(fullest) > MAX_GRID_CLUSTERING*mean || occupancy < MIN_GRID_OCCUPANCY) return false;
+        }
+
+        vector<PrimitiveRef> refs(total);
+        graph.clear();
+        for (size_t k = 0; k < sortChunks; k++) {
+            graph.add([&, k]() {
+                auto& cursor = cursors[k];
+                size_t end = std::min(count, (k + 1)*sortChunkSize);
+                for (size_t i = k*sortChunkSize; i < end; i++) {
+                    forCells(items[i], bmin, invSize, res, [&](uint32_t c) { refs[cursor[c]++] = items[i].ref; });
+                }
+            });
+        }
+        graph.run(threads);
+        cursors.clear();
+        items.clear();
+
+        // ý϶ĵԪֵڶ񣬸ڶԪ±˳λ
+        vector<uint32_t> split;
+        uint32_t cellCount = topCells;
+        for (uint32_t c = 0; c < topCells; c++) {
+            if (top[c].count <= SUBGRID_THRESHOLD) continue;
+            Subgrid sub;
+            glm::uvec3 index{ c % res.x, (c/res.x) % res.y, c/(res.x*res.y) };
+            sub.resolution = gridResolution(size, float(top[c].count)*SUBGRID_DENSITY, MAX_SUBGRID_RESOLUTION);
+            sub.min = bmin + Vec3(index)*size;
+            sub.cellSize = size/Vec3(sub.resolution);
+            sub.firstCell = cellCount;
+            cellCount += sub.resolution.x*sub.resolution.y*sub.resolution.z;
+            split.push_back(c);
+            subgrids.push_back(sub);
+        }
+        cells.resize(cellCount, Cell{0, 0});
+        vector<vector<PrimitiveRef>> subRefs(split.size());
+        graph.clear();
+        size_t subgridsPerTask = std::max<size_t>(1, split.size()/(size_t(threads)*PARALLEL_SUBTREES_PER_THREAD));
+        for (size_t first = 0; first < split.size(); first += subgridsPerTask) {
+            size_t last = std::min(split.size(), first + subgridsPerTask);
+            graph.add([&, first, last]() {
+                vector<BuildItem> inner;
+                for (size_t s = first; s < last; s++) {
+                    const Subgrid& sub = subgrids[s];
+                    const Cell& source = top[split[s]];
+                    inner.clear();
+                    for (uint32_t i = source.offset; i < source.offset + source.count; i++) {
+                        inner.push_back(bounds(refs[i], spheres.data(), triangles.data(), planes.data()));
+                    }
+                    const Vec3 invSubSize = 1.f/sub.cellSize;
+                    Cell* subCells = cells.data() + sub.firstCell;
+                    uint32_t subCount = sub.resolution.x*sub.resolution.y*sub.resolution.z;
+                    for (auto& item : inner) {
+                        forCells(item, sub.min, invSubSize, sub.resolution, [&](uint32_t c) { subCells[c].count++; });
+                    }
+                    uint32_t offset = 0;
+                    for (uint32_t c = 0; c < subCount; c++) {
+                        subCells[c].offset = offset;
+                        offset += subCells[c].count;
+                        subCells[c].count = 0;
+                    }
+                    auto& out = subRefs[s];
+                    out.resize(offset);
+                    for (auto& item : inner) {
+                        forCells(item, sub.min, invSubSize, sub.resolution, [&](uint32_t c) {
+                            out[subCells[c].offset + subCells[c].count++] = item.ref;
+                        });
+                    }
+                }
+            });
+        }
+        graph.run(threads);
+
+        // ϲΪһ飺δֵĵһ㵥ԪǸڶ
+        size_t merged = 0;
+        for (uint32_t c = 0; c < topCells; c++) {
+            if (top[c].count <= SUBGRID_THRESHOLD) merged += top[c].count;
+        }
+        for (auto& r : subRefs) merged += r.size();
+        if (merged >= SUBGRID) return false;
+        primitives.reserve(merged);
+        for (uint32_t c = 0; c < topCells; c++) {
+            cells[c] = { uint32_t(primitives.size()), top[c].count };
+            if (top[c].count > SUBGRID_THRESHOLD) continue;
+            primitives.insert(primitives.end(), refs.begin() + top[c].offset, refs.begin() + top[c].offset + top[c].count);
+        }
+        for (size_t s = 0; s < split.size(); s++) {
+            cells[split[s]] = { uint32_t(s), SUBGRID };
+            const Subgrid& sub = subgrids[s];
+            uint32_t base = uint32_t(primitives.size());
+            uint32_t subCount = sub.resolution.x*sub.resolution.y*sub.resolution.z;
+            for (uint32_t c = 0; c < subCount; c++) cells[sub.firstCell + c].offset += base;
+            primitives.insert(primitives.end(), subRefs[s].begin(), subRefs[s].end());
+        }
+
+        min = bmin;
+        max = bmin + extent;
+        cellSize = size;
+        resolution = res;
+        return true;
+    }
+
+    uint64_t PreparedSceneCache::hashGeometry(const Scene& scene) {
+        // ֶμ㣬ṹֽڵӰ
+        Hasher hasher{};
+        hasher.word(uint32_t(scene.models.size()));
+        for (auto& m : scene.models) {
+            hasher.value(m.translation);
+            hasher.value(m.scale);
+        }
+        hasher.word(uint32_t(scene.nodes.size()));
+        for (auto& n : scene.nodes) {
+            hasher.word(uint32_t(n.type));
+            hasher.word(n.entity);
+            hasher.word(n.model);
+        }
+        hasher.word(uint32_t(scene.sphereBuffer.size()));
+        for (auto& s : scene.sphereBuffer) {
+            hasher.value(s.material);
+            hasher.value(s.direction);
+            hasher.value(s.position);
+            hasher.value(s.radius);
+        }
+        hasher.word(uint32_t(scene.triangleBuffer.size()));
+        for (auto& t : scene.triangleBuffer) {
+            hasher.value(t.material);
+            hasher.value(t.v[0]);
+            hasher.value(t.v[1]);
+            hasher.value(t.v[2]);
+            hasher.value(t.normal);
+        }
+        hasher.word(uint32_t(scene.planeBuffer.size()));
+        for (auto& p : scene.planeBuffer) {
+            hasher.value(p.material);
+            hasher.value(p.normal);
+            hasher.value(p.position);
+            hasher.value(p.u);
+            hasher.value(p.v);
+        }
+        return hasher.h;
+    }
+
+    namespace
+    {
+        // Ƽ岢ģ͵ƽƱ任꣬ԭеVertexTransformerһ
+        void transformToWorld(const Scene& scene, PreparedScene& prepared) {
+            prepared.spheres = scene.sphereBuffer;
+            prepared.triangles = scene.triangleBuffer;
+            prepared.planes = scene.planeBuffer;
+            for (auto& node : scene.nodes) {
+                const Vec3 t = scene.models[node.model].translation;
+                if (node.type == Node::Type::TRIANGLE) {
+                    for (auto& v : prepared.triangles[node.entity].v) v += t;
+                }
+                else if (node.type == Node::Type::SPHERE) {
+                    prepared.spheres[node.entity].position += t;
+                }
+                else if (node.type == Node::Type::PLANE) {
+                    prepared.planes[node.entity].position += t;
+                }
+            }
+        }
+
+        // ޸ļ¼޸ܷbase¼Χ
+        // ͬbaseͬͼԪ붼޸ļ¼
+        bool canRefit(const Scene& scene, const PreparedScene& prepared, const PreparedScene& base) {
+            if (scene.changes.all || base.accelerator != RenderOption::Accelerator::BVH || base.bvh.isLazy()) return false;
+            if (scene.renderOption.accelerator == RenderOption::Accelerator::GRID) return false;
+            if (prepared.spheres.size() != base.spheres.size()
+                || prepared.triangles.size() != base.triangles.size()
+                || prepared.planes.size() != base.planes.size()) return false;
+            size_t total = prepared.spheres.size() + prepared.triangles.size() + prepared.planes.size();
+            size_t changed = 0;
+            for (size_t c : {
+                countChanged(prepared.spheres, base.spheres, scene.changes.spheres),
+                countChanged(prepared.triangles, base.triangles, scene.changes.triangles),
+                countChanged(prepared.planes, base.planes, scene.changes.planes) }) {
+                if (c == SIZE_MAX) return false;
+                changed += c;
+            }
+            return changed*REFIT_DIVISOR <= total;
+        }
+    }
+
+    SharedPreparedScene PreparedSceneCache::prepare(const Scene& scene, unsigned int threads) {
+        return build(scene, hashGeometry(scene), threads);
+    }
+
+    SharedPreparedScene PreparedSceneCache::build(const Scene& scene, uint64_t key, unsigned int threads) {
+        if (threads == 0) threads = max(1u, thread::hardware_concurrency());
+        auto prepared = make_shared<PreparedScene>();
+        prepared->key = key;
+        transformToWorld(scene, *prepared);
+        size_t total = prepared->spheres.size() + prepared->triangles.size() + prepared->planes.size();
+        // ĹͼԪԹϵֲʱҲBVHԶѡʱһͳжǷ
+        auto requested = scene.renderOption.accelerator;
+        bool grid = requested == RenderOption::Accelerator::GRID
+            || (requested == RenderOption::Accelerator::AUTO && total >= GRID_MIN_PRIMITIVES);
+        if (grid && prepared->grid.build(prepared->spheres, prepared->triangles, prepared->planes, threads, requested == RenderOption::Accelerator::AUTO)) {
+            prepared->accelerator = RenderOption::Accelerator::GRID;
+            return prepared;
+        }
+        // 󳡾ֻϲڵ㣬δٸ׸سǰĵȴ
+        prepared->bvh.build(prepared->spheres, prepared->triangles, prepared->planes, total >= LAZY_THRESHOLD ? LAZY_SUBTREE_SIZE : 0, threads);
+        return prepared;
+    }
+
+    SharedPreparedScene PreparedSceneCache::acquire(const Scene& scene) {
+        uint64_t key = hashGeometry(scene);
+        lock_guard<InstrumentedMutex> lock{mtx};
+        auto requested = scene.renderOption.accelerator;
+        for (auto it = entries.begin(); it != entries.end(); it++) {
+            if ((*it)->key == key && (requested == RenderOption::Accelerator::AUTO || (*it)->accelerator == requested)) {
+                auto prepared = *it;
+                entries.erase(it);
+                entries.push_front(prepared);
+                hits++;
+                return prepared;
+            }
+        }
+        misses++;
+        SharedPreparedScene prepared;
+        if (!scene.changes.all && !entries.empty()) {
+            // һν޸ģBVHṹ
+            auto refitted = make_shared<PreparedScene>();
+            refitted->key = key;
+            transformToWorld(scene, *refitted);
+            const PreparedScene& base = *entries.front();
+            if (canRefit(scene, *refitted, base)) {
+                refitted->bvh = base.bvh;
+                refitted->bvh.refit(refitted->spheres, refitted->triangles, refitted->planes);
+                refits++;
+                prepared = refitted;
+            }
+        }
+        if (!prepared) prepared = build(scene, key, 0);
+        entries.push_front(prepared);
+        while (entries.size() > capacity) entries.pop_back();
+        return prepared;
+    }
+
+    void PreparedSceneCache::clear() {
+        lock_guard<InstrumentedMutex> lock{mtx};
+        entries.clear();
+    }
+
+    uint64_t PreparedSceneCache::getHits() const {
+        lock_guard<InstrumentedMutex> lock{mtx};
+        return hits;
+    }
+
+    uint64_t PreparedSceneCache::getMisses() const {
+        lock_guard<InstrumentedMutex> lock{mtx};
+        return misses;
+    }
+
+    uint64_t PreparedSceneCache::getRefits() const {
+        lock_guard<InstrumentedMutex> lock{mtx};
+        return refits;
+    }
+} // namespace NRenderer
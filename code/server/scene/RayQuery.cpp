@@ -0,0 +1,157 @@
+#include "scene/RayQuery.hpp"
+#include "server/TaskGraph.hpp"
+
+#include <cmath>
+#include <thread>
+#include <algorithm>
+
+namespace NRenderer::RayQuery
+{
+    namespace
+    {
+        // Moller-Trumbore㷨(tMin, tMax)ڵཻ룬δཻʱtMax
+        float hitTriangle(const Vec3& origin, const Vec3& direction, const Triangle& t, float tMin, float tMax) {
+            Vec3 e1 = t.v[1] - t.v[0];
+            Vec3 e2 = t.v[2] - t.v[0];
+            Vec3 p = glm::cross(direction, e2);
+            float det = glm::dot(e1, p);
+            Vec3 s;
+            if (det > 0) s = origin - t.v[0];
+            else {
+                s = t.v[0] - origin;
+                det = -det;
+            }
+            if (det < 0.000001f) return tMax;
+            float u = glm::dot(s, p);
+            if (u > det || u < 0.f) return tMax;
+            Vec3 q = glm::cross(s, e1);
+            float v = glm::dot(direction, q);
+            if (v < 0.f || v + u > det) return tMax;
+            float w = glm::dot(e2, q)*(1.f/det);
+            return (w >= tMax || w <= tMin) ? tMax : w;
+        }
+
+        float hitSphere(const Vec3& origin, const Vec3& direction, const Sphere& s, float tMin, float tMax) {
+            Vec3 oc = origin - s.position;
+            float a = glm::dot(direction, direction);
+            float b = glm::dot(oc, direction);
+            float c = glm::dot(oc, oc) - s.radius*s.radius;
+            float discriminant = b*b - a*c;
+            if (discriminant <= 0) return tMax;
+            float root = sqrt(discriminant);
+            // ȳԽϽĽ㣬ʱȡԶĽ
+            float t = (-b - root)/a;
+            if (t < tMax && t > tMin) return t;
+            t = (-b + root)/a;
+            if (t < tMax && t > tMin) return t;
+            return tMax;
+        }
+
+        // positionΪǵ㡢uvΪߵƽı
+        float hitPlane(const Vec3& origin, const Vec3& direction, const Plane& p, float tMin, float tMax) {
+            Vec3 normal = glm::normalize(p.normal);
+            float cosine = glm::dot(direction, normal);
+            if (cosine < 0.0000001f && cosine > -0.00000001f) return tMax;
+            float t = (glm::dot(p.position, normal) - glm::dot(normal, origin))/cosine;
+            if (t >= tMax || t <= tMin) return tMax;
+            Vec3 local = glm::inverse(Mat3x3{ p.u, p.v, glm::cross(p.u, p.v) })*(origin + t*direction - p.position);
+            if (local.x <= 1 && local.x >= 0 && local.y <= 1 && local.y >= 0) return t;
+            return tMax;
+        }
+
+        float hitPrimitive(const PreparedScene& scene, const PrimitiveRef& prim, const Vec3& origin, const Vec3& direction, float tMin, float tMax) {
+            switch (prim.type)
+            {
+            case PrimitiveRef::Type::SPHERE:
+                return hitSphere(origin, direction, scene.spheres[prim.index], tMin, tMax);
+            case PrimitiveRef::Type::TRIANGLE:
+                return hitTriangle(origin, direction, scene.triangles[prim.index], tMin, tMax);
+            default:
+                return hitPlane(origin, direction, scene.planes[prim.index], tMin, tMax);
+            }
+        }
+
+        // [0, count)ֿ齻̣߳ٻֻһ߳ʱֱڵ߳
+        template<typename Work>
+        void forChunks(size_t count, unsigned int threads, Work&& work) {
+            if (threads == 0) threads = max(1u, thread::hardware_concurrency());
+            if (threads == 1 || count < PARALLEL_BATCH_SIZE) {
+                work(size_t(0), count);
+                return;
+            }
+            // ÿ̷ֵ߳飬Ĺߴ۲ͬʱܱ־⣻СΪ4ıɢ߰
+            size_t chunk = max<size_t>((count/(size_t(threads)*4) + 3)/4*4, PARALLEL_BATCH_SIZE/4);
+            TaskGraph graph{};
+            for (size_t begin = 0; begin < count; begin += chunk) {
+                size_t end = min(count, begin + chunk);
+                graph.add([&work, begin, end]() { work(begin, end); });
+            }
+            graph.run(threads);
+        }
+    }
+
+    HitOut intersect(const PreparedScene& scene, const RayIn& ray) {
+        HitOut hit{};
+        float closest = ray.tMax;
+        scene.traverse(ray.origin, ray.direction, ray.tMin, ray.tMax,
+            [&](const PrimitiveRef& prim, float tMax) {
+                float t = hitPrimitive(scene, prim, ray.origin, ray.direction, ray.tMin, tMax);
+                if (t < tMax) {
+                    closest = t;
+                    hit.primitive = prim;
+                }
+                return t;
+            });
+        if (closest == ray.tMax) return hit;
+        hit.t = closest;
+        hit.position = ray.origin + closest*ray.direction;
+        switch (hit.primitive.type)
+        {
+        case PrimitiveRef::Type::SPHERE: {
+            auto& s = scene.spheres[hit.primitive.index];
+            hit.normal = (hit.position - s.position)/s.radius;
+            hit.material = s.material;
+            break;
+        }
+        case PrimitiveRef::Type::TRIANGLE: {
+            auto& t = scene.triangles[hit.primitive.index];
+            hit.normal = glm::normalize(t.normal);
+            hit.material = t.material;
+            break;
+        }
+        default: {
+            auto& p = scene.planes[hit.primitive.index];
+            hit.normal = glm::normalize(p.normal);
+            hit.material = p.material;
+            break;
+        }
+        }
+        return hit;
+    }
+
+    void intersect(const PreparedScene& scene, span<const RayIn> rays, span<HitOut> hits, unsigned int threads) {
+        forChunks(min(rays.size(), hits.size()), threads, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) hits[i] = intersect(scene, rays[i]);
+        });
+    }
+
+    void occluded(const PreparedScene& scene, span<const RayIn> rays, span<uint8_t> results, unsigned int threads) {
+        forChunks(min(rays.size(), results.size()), threads, [&](size_t begin, size_t end) {
+            for (size_t first = begin; first < end; first += RayPacket4::SIZE) {
+                RayPacket4 packet{};
+                int lanes = int(min<size_t>(RayPacket4::SIZE, end - first));
+                for (int lane = 0; lane < lanes; lane++) {
+                    auto& ray = rays[first + lane];
+                    packet.set(lane, ray.origin, ray.direction, ray.tMin, ray.tMax);
+                }
+                scene.occluded4(packet, [&](const PrimitiveRef& prim, int lane) {
+                    float tMax = packet.tMax[lane];
+                    return hitPrimitive(scene, prim, packet.origins[lane], packet.directions[lane], packet.tMin[lane], tMax) < tMax;
+                });
+                for (int lane = 0; lane < lanes; lane++) {
+                    results[first + lane] = packet.isActive(lane) ? 0 : 1;
+                }
+            }
+        });
+    }
+} // namespace NRenderer::RayQuery
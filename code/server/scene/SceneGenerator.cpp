@@ -0,0 +1,424 @@
+#include "scene/SceneGenerator.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <vector>
+
+// 򻯳ʵ
+// Scene.scnļͬһ·֤ȫһ
+
+namespace NRenderer
+{
+    namespace
+    {
+        constexpr float GEN_PI = 3.14159265358979f;
+
+        // ɸֵ
+        // mt19937ɱ׼ϸ涨תҲʵ֣һ
+        struct Random
+        {
+            mt19937 e;
+            Random(uint32_t seed, uint32_t stream)
+                : e                 (seed + stream*0x9E3779B9u)
+            {}
+            float uniform() {
+                return float(e() >> 8) * (1.f/16777216.f);
+            }
+            float range(float a, float b) {
+                return a + (b - a)*uniform();
+            }
+            uint32_t below(uint32_t n) {
+                return n == 0 ? 0 : e() % n;
+            }
+            Vec3 color(float a, float b) {
+                float r = range(a, b);
+                float g = range(a, b);
+                return {r, g, range(a, b)};
+            }
+        };
+
+        // ʹöıĳͼԪӰ
+        enum Stream : uint32_t
+        {
+            STREAM_MATERIAL = 1,
+            STREAM_LIGHT,
+            STREAM_SPHERE,
+            STREAM_MESH,
+            STREAM_TERRAIN
+        };
+
+        // Ϊμ㼸η
+        void computeNormal(Triangle& t) {
+            auto n = glm::cross(t.v[1] - t.v[0], t.v[2] - t.v[0]);
+            float len = glm::length(n);
+            t.normal = len > 0.f ? n / len : Vec3{0, 0, 1};
+        }
+
+        // ǻ棨΢count
+        template<typename F>
+        void tessellateSphere(float radius, size_t count, float bumpPhase, F&& out) {
+            if (count == 0) return;
+            size_t stacks = size_t(ceil(sqrt(double(count)/4.0))) + 1;
+            size_t slices = stacks*2;
+            auto vertex = [&](size_t i, size_t j) -> Vec3 {
+                float theta = GEN_PI*float(i)/float(stacks);
+                float phi = 2.f*GEN_PI*float(j % slices)/float(slices);
+                float r = radius*(1.f + 0.08f*sin(5.f*theta + bumpPhase)*cos(3.f*phi));
+                return { r*sin(theta)*cos(phi), r*cos(theta), r*sin(theta)*sin(phi) };
+            };
+            size_t emitted = 0;
+            for (size_t i = 0; i < stacks && emitted < count; i++) {
+                for (size_t j = 0; j < slices && emitted < count; j++) {
+                    Vec3 p00 = vertex(i, j), p01 = vertex(i, j + 1);
+                    Vec3 p10 = vertex(i + 1, j), p11 = vertex(i + 1, j + 1);
+                    Triangle t;
+                    if (i != 0) {
+                        t.v[0] = p00; t.v[1] = p01; t.v[2] = p11;
+                        computeNormal(t);
+                        out(t);
+                        if (++emitted >= count) break;
+                    }
+                    if (i + 1 != stacks) {
+                        t.v[0] = p00; t.v[1] = p11; t.v[2] = p10;
+                        computeNormal(t);
+                        out(t);
+                        ++emitted;
+                    }
+                }
+            }
+        }
+
+        // SceneĽ
+        struct SceneSink
+        {
+            Scene& scene;
+            Index currModel = 0;
+
+            void material(const string&, const Material& m) {
+                scene.materials.push_back(m);
+            }
+            void areaLight(const string&, const AreaLight& a) {
+                Light l{Light::Type::AREA};
+                l.entity = scene.areaLightBuffer.size();
+                scene.lights.push_back(l);
+                scene.areaLightBuffer.push_back(a);
+            }
+            void beginModel(const string&, const Vec3& translation) {
+                Model m;
+                m.translation = translation;
+                currModel = scene.models.size();
+                scene.models.push_back(m);
+            }
+            void sphere(const Sphere& s) {
+                addNode(Node::Type::SPHERE, scene.sphereBuffer.size());
+                scene.sphereBuffer.push_back(s);
+            }
+            void triangle(const Triangle& t) {
+                addNode(Node::Type::TRIANGLE, scene.triangleBuffer.size());
+                scene.triangleBuffer.push_back(t);
+            }
+            void endModel() {}
+
+            void addNode(Node::Type type, size_t entity) {
+                Node n;
+                n.type = type;
+                n.entity = Index(entity);
+                n.model = currModel;
+                scene.models[currModel].nodes.push_back(Index(scene.nodes.size()));
+                scene.nodes.push_back(n);
+            }
+        };
+
+        // д.scnıĽ
+        // ʽScnImporterĸʽһ£(Material/Light/Model)֯
+        struct ScnSink
+        {
+            FILE* file;
+            const vector<string>& mtlNames;
+            size_t nodeCount = 0;
+            string block;           // ǰڵĿ飬Ϊձʾڿ
+
+            void begin(const char* name) {
+                end();
+                fprintf(file, "Begin %s\n\n", name);
+                block = name;
+            }
+            void end() {
+                if (!block.empty()) fputs("\nEnd\n\n", file);
+                block.clear();
+            }
+            void vec(const char* key, const Vec3& v) {
+                fprintf(file, "%s %.7g %.7g %.7g\n", key, v.x, v.y, v.z);
+            }
+
+            void material(const string& name, const Material& m) {
+                if (block != "Material") begin("Material");
+                fprintf(file, "Material %s %u\n", name.c_str(), m.type);
+                using PT = Property::Type;
+                using PW = Property::Wrapper;
+                for (auto& p : m.properties) {
+                    if (p.type == PT::RGB) {
+                        auto v = get<PW::RGBType>(p.valueWrapper).value;
+                        fprintf(file, "Prop %s RGB %.7g %.7g %.7g\n", p.key.c_str(), v.x, v.y, v.z);
+                    }
+                    else if (p.type == PT::FLOAT) {
+                        fprintf(file, "Prop %s Float %.7g\n", p.key.c_str(), get<PW::FloatType>(p.valueWrapper).value);
+                    }
+                    else if (p.type == PT::INT) {
+                        fprintf(file, "Prop %s Int %d\n", p.key.c_str(), get<PW::IntType>(p.valueWrapper).value);
+                    }
+                }
+                fputs("\n", file);
+            }
+            void areaLight(const string& name, const AreaLight& a) {
+                if (block != "Light") begin("Light");
+                fprintf(file, "Area %s\n", name.c_str());
+                vec("IRV", a.radiance);
+                vec("P", a.position);
+                vec("U", a.u);
+                vec("V", a.v);
+                fputs("\n", file);
+            }
+            void beginModel(const string& name, const Vec3& translation) {
+                begin("Model");
+                fprintf(file, "Model %s\n", name.c_str());
+                vec("Translation", translation);
+                fputs("\n", file);
+            }
+            void sphere(const Sphere& s) {
+                fprintf(file, "Sphere s%zu %s\n", nodeCount++, mtlNames[s.material.index()].c_str());
+                vec("N", s.direction);
+                vec("P", s.position);
+                fprintf(file, "R %.7g\n", s.radius);
+            }
+            void triangle(const Triangle& t) {
+                fprintf(file, "Triangle t%zu %s\n", nodeCount++, mtlNames[t.material.index()].c_str());
+                vec("V1", t.v[0]);
+                vec("V2", t.v[1]);
+                vec("V3", t.v[2]);
+                vec("N", t.normal);
+            }
+            void endModel() {
+                end();
+            }
+        };
+
+        // ɫ͵ƣShaderCreatorеͱһһӦ
+        const char* SHADER_TYPE_NAMES[] = {
+            "Lambertian", "Metal", "Dielectric", "Textured", "Marble", "Disney"
+        };
+        constexpr unsigned int SHADER_TYPE_NUMS = 6;
+
+        vector<string> materialNames(const GeneratorOptions& options) {
+            vector<string> names;
+            unsigned int n = options.materials == 0 ? 1 : options.materials;
+            for (unsigned int i = 0; i < n; i++) {
+                unsigned int type = options.mixedMaterials ? i % SHADER_TYPE_NUMS : 0;
+                names.push_back("M" + to_string(i) + "_" + SHADER_TYPE_NAMES[type]);
+            }
+            return names;
+        }
+    }
+
+    template<typename Sink>
+    void SceneGenerator::emit(Sink& sink) const {
+        using PW = Property::Wrapper;
+        const float e = options.extent;
+        auto names = materialNames(options);
+        const uint32_t mtlNums = uint32_t(names.size());
+
+        // ʣShaderCreatorֵ֧
+        Random mr{options.seed, STREAM_MATERIAL};
+        for (uint32_t i = 0; i < mtlNums; i++) {
+            Material m;
+            m.type = options.mixedMaterials ? i % SHADER_TYPE_NUMS : 0;
+            switch (m.type)
+            {
+            case 0:
+                m.registerProperty("diffuseColor", PW::RGBType{mr.color(0.2f, 0.9f)});
+                break;
+            case 1:
+                m.registerProperty("albedo", PW::RGBType{mr.color(0.5f, 0.95f)});
+                m.registerProperty("roughness", PW::FloatType{mr.range(0.f, 0.5f)});
+                break;
+            case 2:
+                m.registerProperty("refractiveIndex", PW::FloatType{mr.range(1.3f, 1.8f)});
+                m.registerProperty("attenuation", PW::RGBType{mr.color(0.85f, 1.f)});
+                break;
+            case 3:
+                m.registerProperty("diffuseColor", PW::RGBType{mr.color(0.2f, 0.9f)});
+                break;
+            case 5:
+                m.registerProperty("baseColor", PW::RGBType{mr.color(0.2f, 0.9f)});
+                m.registerProperty("metallic", PW::FloatType{mr.uniform()});
+                m.registerProperty("roughness", PW::FloatType{mr.range(0.05f, 0.9f)});
+                break;
+            default:
+                break;
+            }
+            sink.material(names[i], m);
+        }
+
+        // Դڳųܷ⹦޹
+        Random lr{options.seed, STREAM_LIGHT};
+        size_t lightNums = options.areaLights;
+        size_t lightsPerRow = size_t(ceil(sqrt(double(lightNums))));
+        float lightCell = 2.f*e/float(lightsPerRow == 0 ? 1 : lightsPerRow);
+        float lightSize = lightCell*0.5f;
+        for (size_t i = 0; i < lightNums; i++) {
+            AreaLight a;
+            float cx = -e + lightCell*(float(i % lightsPerRow) + 0.5f);
+            float cz = -e + lightCell*(float(i / lightsPerRow) + 0.5f);
+            a.u = {lightSize, 0, 0};
+            a.v = {0, 0, lightSize};    // u x v 
+            a.position = Vec3{cx, e*1.1f, cz} - 0.5f*(a.u + a.v);
+            a.radiance = Vec3{16.f*lr.range(0.8f, 1.2f)};
+            sink.areaLight("L" + to_string(i), a);
+        }
+
+        // 
+        if (options.spheres > 0) {
+            Random sr{options.seed, STREAM_SPHERE};
+            float baseRadius = e/float(cbrt(double(options.spheres)));
+            sink.beginModel("Spheres", {0, 0, 0});
+            for (size_t i = 0; i < options.spheres; i++) {
+                Sphere s;
+                s.position = {sr.range(-e, e), sr.range(-e, e), sr.range(-e, e)};
+                s.radius = baseRadius*sr.range(0.15f, 0.5f);
+                s.material = Handle(sr.below(mtlNums));
+                sink.sphere(s);
+            }
+            sink.endModel();
+        }
+
+        // ϸƽ䵽
+        if (options.meshes > 0 && options.meshTriangles > 0) {
+            Random gr{options.seed, STREAM_MESH};
+            for (size_t i = 0; i < options.meshes; i++) {
+                size_t count = options.meshTriangles/options.meshes
+                    + (i < options.meshTriangles % options.meshes ? 1 : 0);
+                Vec3 center{gr.range(-e, e)*0.8f, gr.range(-e, e)*0.8f, gr.range(-e, e)*0.8f};
+                float radius = e*gr.range(0.05f, 0.2f);
+                Handle mtl = Handle(gr.below(mtlNums));
+                sink.beginModel("Mesh" + to_string(i), center);
+                tessellateSphere(radius, count, gr.range(0.f, 2.f*GEN_PI), [&](Triangle& t) {
+                    t.material = mtl;
+                    sink.triangle(t);
+                });
+                sink.endModel();
+            }
+        }
+
+        // θ߶ȳڳײ
+        if (options.terrainTriangles > 0) {
+            Random tr{options.seed, STREAM_TERRAIN};
+            size_t n = size_t(ceil(sqrt(double(options.terrainTriangles)/2.0)));
+            float cell = 2.f*e/float(n);
+            float f1 = tr.range(1.f, 3.f), f2 = tr.range(2.f, 5.f);
+            auto height = [&](size_t i, size_t j) {
+                float x = float(i)/float(n), z = float(j)/float(n);
+                return e*0.05f*(sin(2.f*GEN_PI*f1*x)*cos(2.f*GEN_PI*f2*z) + 0.5f*sin(2.f*GEN_PI*(f1 + f2)*(x + z)));
+            };
+            auto point = [&](size_t i, size_t j) -> Vec3 {
+                return {-e + cell*float(i), height(i, j), -e + cell*float(j)};
+            };
+            Handle mtl = Handle(0);
+            size_t emitted = 0;
+            sink.beginModel("Terrain", {0, -e, 0});
+            for (size_t i = 0; i < n && emitted < options.terrainTriangles; i++) {
+                for (size_t j = 0; j < n && emitted < options.terrainTriangles; j++) {
+                    Triangle t;
+                    t.material = mtl;
+                    t.v[0] = point(i, j); t.v[1] = point(i, j + 1); t.v[2] = point(i + 1, j);
+                    computeNormal(t);
+                    sink.triangle(t);
+                    if (++emitted >= options.terrainTriangles) break;
+                    t.v[0] = point(i + 1, j); t.v[1] = point(i, j + 1); t.v[2] = point(i + 1, j + 1);
+                    computeNormal(t);
+                    sink.triangle(t);
+                    ++emitted;
+                }
+            }
+            sink.endModel();
+        }
+
+        // ʵͬһԭͰƽƸƣÿʵһModel
+        size_t instances = size_t(options.gridX)*options.gridY*options.gridZ;
+        if (instances > 0 && options.instanceTriangles > 0) {
+            unsigned int maxDim = max(options.gridX, max(options.gridY, options.gridZ));
+            float cell = 2.f*e/float(maxDim);
+            vector<Triangle> prototype;
+            tessellateSphere(cell/3.f, options.instanceTriangles, 0.f, [&](Triangle& t) {
+                prototype.push_back(t);
+            });
+            for (unsigned int x = 0; x < options.gridX; x++) {
+                for (unsigned int y = 0; y < options.gridY; y++) {
+                    for (unsigned int z = 0; z < options.gridZ; z++) {
+                        Vec3 center = Vec3{-e} + cell*Vec3{x + 0.5f, y + 0.5f, z + 0.5f};
+                        Handle mtl = Handle((x + y + z) % mtlNums);
+                        sink.beginModel("Instance_" + to_string(x) + "_" + to_string(y) + "_" + to_string(z), center);
+                        for (auto t : prototype) {
+                            t.material = mtl;
+                            sink.triangle(t);
+                        }
+                        sink.endModel();
+                    }
+                }
+            }
+        }
+    }
+
+    SharedScene SceneGenerator::generate() const {
+        auto spScene = make_shared<Scene>();
+        auto& scene = *spScene;
+        size_t instanceTris = size_t(options.gridX)*options.gridY*options.gridZ*options.instanceTriangles;
+        scene.sphereBuffer.reserve(options.spheres);
+        scene.triangleBuffer.reserve(options.meshTriangles + options.terrainTriangles + instanceTris);
+        scene.nodes.reserve(options.primitiveCount());
+        scene.areaLightBuffer.reserve(options.areaLights);
+
+        SceneSink sink{scene};
+        emit(sink);
+
+        scene.camera = suggestCamera();
+        scene.ambient.type = Ambient::Type::CONSTANT;
+        scene.ambient.constant = {0, 0, 0};
+        return spScene;
+    }
+
+    bool SceneGenerator::writeScn(const string& path) {
+        FILE* file = fopen(path.c_str(), "w");
+        if (file == nullptr) {
+            lastErrorInfo = "Failed to open " + path + " for writing.";
+            return false;
+        }
+        // ļдʱʹýϴĻ
+        vector<char> buffer(1 << 20);
+        setvbuf(file, buffer.data(), _IOFBF, buffer.size());
+        fprintf(file, "# Generated by SceneGenerator, seed %u, %zu primitives\n\n",
+            options.seed, options.primitiveCount());
+
+        auto names = materialNames(options);
+        ScnSink sink{file, names, 0, {}};
+        emit(sink);
+        sink.end();
+
+        bool ok = ferror(file) == 0;
+        fclose(file);
+        if (!ok) lastErrorInfo = "Failed to write " + path + ".";
+        return ok;
+    }
+
+    Camera SceneGenerator::suggestCamera() const {
+        const float e = options.extent;
+        Camera c;
+        c.position = {0.f, e*0.3f, -e*3.2f};
+        c.lookAt = {0.f, 0.f, 0.f};
+        c.up = {0.f, 1.f, 0.f};
+        c.fov = 40.f;
+        c.aspect = 1.f;
+        return c;
+    }
+} // namespace NRenderer
@@ -0,0 +1,504 @@
+#include "scene/ScnParser.hpp"
+#include "server/MappedFile.hpp"
+
+#include <map>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <string_view>
+#include <limits>
+#include <cmath>
+#include <cstdlib>
+
+// SCNıʵ
+// ļӳڴ󵥱нṹΪ Begin Material/Model/Light ... End
+// ʷԭstringstream>>ȡΪһ
+
+namespace NRenderer
+{
+    namespace
+    {
+        inline bool isSpace(char c) {
+            return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f';
+        }
+
+        inline bool isDigit(char c) {
+            return c >= '0' && c <= '9';
+        }
+
+        // һıĴʷ
+        // stringstreamֵͬȡʧʱõ0Ҹ֮ȡʧ
+        class LineTokenizer
+        {
+        private:
+            const char* p;
+            const char* end;
+            bool failed;
+
+            void skipSpace() {
+                while (p < end && isSpace(*p)) p++;
+            }
+        public:
+            LineTokenizer(const char* begin, const char* end)
+                : p                 (begin)
+                , end               (end)
+                , failed            (false)
+            {}
+
+            // ȡһԿհ׷ָĴʣûʱؿ
+            string_view token() {
+                if (failed) return {};
+                skipSpace();
+                const char* begin = p;
+                while (p < end && !isSpace(*p)) p++;
+                return { begin, size_t(p - begin) };
+            }
+
+            // ȡһֵ
+            // Ϊ룺ǰ'+'inf/nanָΪʧܣ
+            // ʱõֵ߽ʧܣ޷ʱ޷
+            template<typename T>
+            T number() {
+                if (failed) return T(0);
+                skipSpace();
+                const char* begin = p;
+                bool negative = false;
+                if (begin < end && (*begin == '+' || *begin == '-')) {
+                    negative = *begin == '-';
+                    begin++;
+                }
+                if (begin >= end || !(isDigit(*begin) || (is_floating_point_v<T> && *begin == '.'))) {
+                    failed = true;
+                    return T(0);
+                }
+                // зͬһ𽻸from_charsСֵľֵ
+                const char* first = (negative && !is_unsigned_v<T>) ? begin - 1 : begin;
+                T value{};
+                auto [ptr, ec] = from_chars(first, end, value);
+                if (ec == errc::invalid_argument) {
+                    failed = true;
+                    return T(0);
+                }
+                if constexpr (is_floating_point_v<T>) {
+                    if (ptr < end && (*ptr == 'e' || *ptr == 'E') && find_if(begin, ptr, [](char c) { return c == 'e' || c == 'E'; }) == ptr) {
+                        failed = true;
+                        return T(0);
+                    }
+                    if (ec == errc::result_out_of_range) {
+                        // õ0ǹõֵ߽
+                        value = strtof(string(first, ptr).c_str(), nullptr);
+                        if (isinf(value)) {
+                            failed = true;
+                            value = value > 0 ? numeric_limits<T>::max() : numeric_limits<T>::lowest();
+                        }
+                    }
+                }
+                else if (ec == errc::result_out_of_range) {
+                    failed = true;
+                    return (negative && !is_unsigned_v<T>) ? numeric_limits<T>::min() : numeric_limits<T>::max();
+                }
+                p = ptr;
+                if constexpr (is_unsigned_v<T>) {
+                    if (negative) value = T(0) - value;
+                }
+                return value;
+            }
+
+            Vec3 readVec3() {
+                float f1 = number<float>();
+                float f2 = number<float>();
+                float f3 = number<float>();
+                return { f1, f2, f3 };
+            }
+
+            // ǷѾβӦstringstreameof
+            bool atEnd() const {
+                return p >= end;
+            }
+        };
+
+        // жһеĵһǷΪkeywordԤͳͼԪ
+        inline bool firstTokenIs(const char* p, const char* end, string_view keyword) {
+            while (p < end && (*p == ' ' || *p == '\t')) p++;
+            if (size_t(end - p) < keyword.size() || memcmp(p, keyword.data(), keyword.size()) != 0) return false;
+            p += keyword.size();
+            return p == end || isSpace(*p);
+        }
+
+        // ǰڵĿ
+        enum class CurrBlock
+        {
+            NONE, MATERIAL, MODEL, LIGHT
+        };
+
+        // ǰڶĽڵ
+        enum class CurrNode
+        {
+            NONE, SPHERE, TRIANGLE, PLANE
+        };
+
+        // ǰڶĹԴ
+        enum class CurrLight
+        {
+            NONE, POINT, AREA, DIRECTIONAL, SPOT
+        };
+
+        // ״̬ÿδһ
+        class ScnReader
+        {
+        private:
+            StagedScene& staged;
+            Scene& scene;
+            string& lastErrorInfo;
+            map<string, size_t, less<>> mtlMap;     // Ƶ±ӳ
+            CurrBlock currBlock;
+            bool hasMaterial;       // ǰʿǷѾMaterial
+            CurrNode currNode;
+            CurrLight currLight;
+
+            bool syntaxError() {
+                lastErrorInfo = "Syntax Error!";
+                return false;
+            }
+
+            bool parseMtl(string_view token, LineTokenizer& line);
+            bool parseMdl(string_view token, LineTokenizer& line);
+            bool parseLgt(string_view token, LineTokenizer& line);
+        public:
+            ScnReader(StagedScene& staged, string& lastErrorInfo)
+                : staged            (staged)
+                , scene             (staged.scene)
+                , lastErrorInfo     (lastErrorInfo)
+                , mtlMap            ()
+                , currBlock         (CurrBlock::NONE)
+                , hasMaterial       (false)
+                , currNode          (CurrNode::NONE)
+                , currLight         (CurrLight::NONE)
+            {}
+
+            // һУʱôϢfalse
+            bool parseLine(LineTokenizer& line) {
+                auto token = line.token();
+                if (token.empty() || token[0] == '#') return true;
+                switch (currBlock)
+                {
+                case CurrBlock::MATERIAL:
+                    return parseMtl(token, line);
+                case CurrBlock::MODEL:
+                    return parseMdl(token, line);
+                case CurrBlock::LIGHT:
+                    return parseLgt(token, line);
+                default:
+                    break;
+                }
+                if (token != "Begin") return syntaxError();
+                token = line.token();
+                if (token == "Material") {
+                    currBlock = CurrBlock::MATERIAL;
+                    hasMaterial = false;
+                }
+                else if (token == "Model") {
+                    currBlock = CurrBlock::MODEL;
+                    currNode = CurrNode::NONE;
+                }
+                else if (token == "Light") {
+                    currBlock = CurrBlock::LIGHT;
+                    currLight = CurrLight::NONE;
+                }
+                else {
+                    return syntaxError();
+                }
+                return true;
+            }
+        };
+
+        bool ScnReader::parseMtl(string_view token, LineTokenizer& line) {
+            if (token == "Material") {
+                string name{line.token()};
+                if (mtlMap.find(name) != mtlMap.end()) {
+                    lastErrorInfo = "Duplicated Material Key:" + name;
+                    return false;
+                }
+                mtlMap[name] = scene.materials.size();
+                unsigned int type = 0;
+                if (!line.atEnd())
+                    type = line.number<unsigned int>();
+                scene.materials.emplace_back();
+                scene.materials.back().type = type;
+                staged.materialNames.push_back(move(name));
+                hasMaterial = true;
+            }
+            else if (token == "Prop") {
+                if (!hasMaterial) return syntaxError();
+                using PW = Property::Wrapper;
+                auto& material = scene.materials.back();
+                string key{line.token()};
+                auto type = line.token();
+                if (type == "Int") {
+                    material.registerProperty(key, PW::IntType{line.number<int>()});
+                }
+                else if (type == "Float") {
+                    material.registerProperty(key, PW::FloatType{line.number<float>()});
+                }
+                else if (type == "Vec3") {
+                    material.registerProperty(key, PW::Vec3Type{line.readVec3()});
+                }
+                else if (type == "Vec4") {
+                    Vec3 v = line.readVec3();
+                    material.registerProperty(key, PW::Vec4Type{Vec4{v, line.number<float>()}});
+                }
+                else if (type == "RGB") {
+                    material.registerProperty(key, PW::RGBType{line.readVec3()});
+                }
+                else if (type == "RGBA") {
+                    Vec3 v = line.readVec3();
+                    material.registerProperty(key, PW::RGBAType{Vec4{v, line.number<float>()}});
+                }
+            }
+            else if (token == "End") {
+                currBlock = CurrBlock::NONE;
+            }
+            else {
+                return syntaxError();
+            }
+            return true;
+        }
+
+        bool ScnReader::parseMdl(string_view token, LineTokenizer& line) {
+            // ڵǰģӽڵ㣬زǷЧ
+            auto addNode = [&](Node::Type type, size_t entity, Handle& material) {
+                auto name = line.token();
+                auto mtl = mtlMap.find(line.token());
+                if (mtl == mtlMap.end()) {
+                    lastErrorInfo = string("Invalid material name.");
+                    return false;
+                }
+                material = Handle(Index(mtl->second));
+                staged.nodeNames.emplace_back(name);
+                Node node{};
+                node.type = type;
+                node.entity = Index(entity);
+                node.model = Index(scene.models.size() - 1);
+                scene.models.back().nodes.push_back(Index(scene.nodes.size()));
+                scene.nodes.push_back(node);
+                return true;
+            };
+
+            if (token == "Model") {
+                staged.modelNames.emplace_back(line.token());
+                scene.models.emplace_back();
+                currNode = CurrNode::NONE;
+                return true;
+            }
+            else if (token == "End") {
+                currBlock = CurrBlock::NONE;
+                return true;
+            }
+
+            // 䶼λĳģ֮
+            if (scene.models.empty()) return syntaxError();
+            if (token == "Translation") {
+                scene.models.back().translation = line.readVec3();
+            }
+            else if (token == "Scale") {
+                scene.models.back().scale = line.readVec3();
+            }
+            else if (token == "Sphere") {
+                scene.sphereBuffer.emplace_back();
+                if (!addNode(Node::Type::SPHERE, scene.sphereBuffer.size() - 1, scene.sphereBuffer.back().material))
+                    return false;
+                currNode = CurrNode::SPHERE;
+            }
+            else if (token == "Triangle") {
+                scene.triangleBuffer.emplace_back();
+                if (!addNode(Node::Type::TRIANGLE, scene.triangleBuffer.size() - 1, scene.triangleBuffer.back().material))
+                    return false;
+                currNode = CurrNode::TRIANGLE;
+            }
+            else if (token == "Plane") {
+                scene.planeBuffer.emplace_back();
+                if (!addNode(Node::Type::PLANE, scene.planeBuffer.size() - 1, scene.planeBuffer.back().material))
+                    return false;
+                currNode = CurrNode::PLANE;
+            }
+            else if (token == "R" && currNode == CurrNode::SPHERE) {
+                scene.sphereBuffer.back().radius = line.number<float>();
+            }
+            else if (token == "N" && currNode != CurrNode::NONE) {
+                Vec3 n = line.readVec3();
+                if (currNode == CurrNode::SPHERE) scene.sphereBuffer.back().direction = n;
+                else if (currNode == CurrNode::TRIANGLE) scene.triangleBuffer.back().normal = n;
+                else scene.planeBuffer.back().normal = n;
+            }
+            else if ((token == "V1" || token == "V2" || token == "V3") && currNode == CurrNode::TRIANGLE) {
+                scene.triangleBuffer.back().v[token[1] - '1'] = line.readVec3();
+            }
+            else if (token == "P" && (currNode == CurrNode::SPHERE || currNode == CurrNode::PLANE)) {
+                Vec3 p = line.readVec3();
+                if (currNode == CurrNode::SPHERE) scene.sphereBuffer.back().position = p;
+                else scene.planeBuffer.back().position = p;
+            }
+            else if (token == "U" && currNode == CurrNode::PLANE) {
+                scene.planeBuffer.back().u = line.readVec3();
+            }
+            else if (token == "V" && currNode == CurrNode::PLANE) {
+                scene.planeBuffer.back().v = line.readVec3();
+            }
+            else {
+                return syntaxError();
+            }
+            return true;
+        }
+
+        bool ScnReader::parseLgt(string_view token, LineTokenizer& line) {
+            // ӹԴentityΪӦԴе±
+            auto addLight = [&](Light::Type type, size_t entity) {
+                staged.lightNames.emplace_back(line.token());
+                Light light{type};
+                light.entity = Index(entity);
+                scene.lights.push_back(light);
+            };
+
+            if (token == "Point") {
+                addLight(Light::Type::POINT, scene.pointLightBuffer.size());
+                scene.pointLightBuffer.emplace_back();
+                currLight = CurrLight::POINT;
+            }
+            else if (token == "Spot") {
+                addLight(Light::Type::SPOT, scene.spotLightBuffer.size());
+                scene.spotLightBuffer.emplace_back();
+                currLight = CurrLight::SPOT;
+            }
+            else if (token == "Directional") {
+                addLight(Light::Type::DIRECTIONAL, scene.directionalLightBuffer.size());
+                scene.directionalLightBuffer.emplace_back();
+                currLight = CurrLight::DIRECTIONAL;
+            }
+            else if (token == "Area") {
+                addLight(Light::Type::AREA, scene.areaLightBuffer.size());
+                scene.areaLightBuffer.emplace_back();
+                currLight = CurrLight::AREA;
+            }
+            else if (token == "IRV" && currLight != CurrLight::NONE) {
+                Vec3 v = line.readVec3();
+                if (currLight == CurrLight::POINT) scene.pointLightBuffer.back().intensity = v;
+                else if (currLight == CurrLight::AREA) scene.areaLightBuffer.back().radiance = v;
+                else if (currLight == CurrLight::DIRECTIONAL) scene.directionalLightBuffer.back().irradiance = v;
+                else scene.spotLightBuffer.back().intensity = v;
+            }
+            else if (token == "P" && currLight != CurrLight::NONE) {
+                Vec3 pos = line.readVec3();
+                if (currLight == CurrLight::POINT) scene.pointLightBuffer.back().position = pos;
+                else if (currLight == CurrLight::AREA) scene.areaLightBuffer.back().position = pos;
+                else if (currLight == CurrLight::SPOT) scene.spotLightBuffer.back().position = pos;
+            }
+            else if (token == "D" && currLight != CurrLight::NONE) {
+                Vec3 dir = line.readVec3();
+                if (currLight == CurrLight::DIRECTIONAL) scene.directionalLightBuffer.back().direction = dir;
+                else if (currLight == CurrLight::SPOT) scene.spotLightBuffer.back().direction = dir;
+            }
+            else if (token == "HotSpot" && currLight == CurrLight::SPOT) {
+                scene.spotLightBuffer.back().hotSpot = line.number<float>();
+            }
+            else if (token == "Fallout" && currLight == CurrLight::SPOT) {
+                scene.spotLightBuffer.back().fallout = line.number<float>();
+            }
+            else if (token == "U" && currLight == CurrLight::AREA) {
+                scene.areaLightBuffer.back().u = line.readVec3();
+            }
+            else if (token == "V" && currLight == CurrLight::AREA) {
+                scene.areaLightBuffer.back().v = line.readVec3();
+            }
+            else if (token == "End") {
+                currBlock = CurrBlock::NONE;
+            }
+            else {
+                return syntaxError();
+            }
+            return true;
+        }
+    }
+
+    bool ScnParser::stageBuffer(const char* data, size_t size, StagedScene& staged) {
+        lastErrorInfo = "";
+        const char* end = data + size;
+        auto nextLine = [end](const char* p) {
+            auto eol = (const char*)memchr(p, '\n', size_t(end - p));
+            return eol == nullptr ? end : eol;
+        };
+
+        // ͳͼԪԤͼԪʱ
+        size_t spheres = 0, triangles = 0, planes = 0;
+        for (const char* p = data; p < end; ) {
+            const char* eol = nextLine(p);
+            if (firstTokenIs(p, eol, "Sphere")) spheres++;
+            else if (firstTokenIs(p, eol, "Triangle")) triangles++;
+            else if (firstTokenIs(p, eol, "Plane")) planes++;
+            p = eol + 1;
+        }
+        auto& scene = staged.scene;
+        scene.sphereBuffer.reserve(scene.sphereBuffer.size() + spheres);
+        scene.triangleBuffer.reserve(scene.triangleBuffer.size() + triangles);
+        scene.planeBuffer.reserve(scene.planeBuffer.size() + planes);
+        scene.nodes.reserve(scene.nodes.size() + spheres + triangles + planes);
+        staged.nodeNames.reserve(staged.nodeNames.size() + spheres + triangles + planes);
+
+        ScnReader reader{staged, lastErrorInfo};
+        size_t readLines = 0;
+        for (const char* p = data; p < end; ) {
+            // ÿһһνȲȡ
+            if (progress != nullptr && (++readLines & 0xFFF) == 0) {
+                if (progress->isCancelled()) {
+                    lastErrorInfo = "Import cancelled.";
+                    return false;
+                }
+                progress->report(float(p - data)/float(size));
+            }
+            const char* eol = nextLine(p);
+            LineTokenizer line{p, eol};
+            if (!reader.parseLine(line)) return false;
+            p = eol + 1;
+        }
+        if (progress != nullptr) progress->report(1.f);
+        return true;
+    }
+
+    bool ScnParser::stage(istream& in, StagedScene& staged, ImportProgress* progress) {
+        this->progress = progress;
+        stringstream ss{};
+        ss<<in.rdbuf();
+        const string text = ss.str();
+        return stageBuffer(text.data(), text.size(), staged);
+    }
+
+    bool ScnParser::stageFile(const string& path, StagedScene& staged, ImportProgress* progress) {
+        this->progress = progress;
+        MappedFile file{};
+        if (!file.open(path)) {
+            lastErrorInfo = "File does not exist!";
+            return false;
+        }
+        return stageBuffer(file.data(), file.getSize(), staged);
+    }
+
+    SharedScene ScnParser::parse(istream& in) {
+        StagedScene staged;
+        if (!stage(in, staged)) return nullptr;
+        return make_shared<Scene>(std::move(staged.scene));
+    }
+
+    SharedScene ScnParser::parseText(const string& text) {
+        StagedScene staged;
+        progress = nullptr;
+        if (!stageBuffer(text.data(), text.size(), staged)) return nullptr;
+        return make_shared<Scene>(std::move(staged.scene));
+    }
+
+    SharedScene ScnParser::parseFile(const string& path) {
+        StagedScene staged;
+        if (!stageFile(path, staged)) return nullptr;
+        return make_shared<Scene>(std::move(staged.scene));
+    }
+} // namespace NRenderer
@@ -0,0 +1,118 @@
+#include "server/AccumulationBuffer.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <filesystem>
+
+namespace NRenderer
+{
+    namespace
+    {
+        // ļʽ8ֽڱʶߣuint32Ϊɫ͡ƽͣÿ3floatuint32
+        // ݰֽСˣ洢
+        const char ACC_MAGIC[8] = { 'N', 'R', 'A', 'C', 'C', '0', '0', '1' };
+        constexpr size_t ACC_HEADER_SIZE = sizeof(ACC_MAGIC) + 2*sizeof(uint32_t);
+        constexpr size_t ACC_PIXEL_SIZE = 2*sizeof(Vec3) + sizeof(uint32_t);
+    }
+
+    Vec3 AccumulationBuffer::mean(unsigned int row, unsigned int col) const {
+        size_t i = size_t(row)*width + col;
+        if (counts[i] == 0) return Vec3{0.f};
+        return sums[i]/float(counts[i]);
+    }
+
+    Vec3 AccumulationBuffer::variance(unsigned int row, unsigned int col) const {
+        size_t i = size_t(row)*width + col;
+        float n = float(counts[i]);
+        if (counts[i] < 2) return Vec3{0.f};
+        Vec3 m = sums[i]/n;
+        //  = (ƽ - n*ֵ^2)/(n - 1)ʹС0
+        Vec3 s = (squareSums[i] - n*m*m)/(n - 1.f);
+        return glm::max(s, Vec3{0.f})/n;
+    }
+
+    bool AccumulationBuffer::merge(const AccumulationBuffer& other) {
+        if (other.width != width || other.height != height) return false;
+        for (size_t i = 0; i < counts.size(); i++) {
+            sums[i] += other.sums[i];
+            squareSums[i] += other.squareSums[i];
+            counts[i] += other.counts[i];
+        }
+        return true;
+    }
+
+    vector<RGBA> AccumulationBuffer::resolve() const {
+        vector<RGBA> pixels(counts.size());
+        for (unsigned int i = 0; i < height; i++) {
+            for (unsigned int j = 0; j < width; j++) {
+                pixels[size_t(i)*width + j] = { glm::sqrt(mean(i, j)), 1 };
+            }
+        }
+        return pixels;
+    }
+
+    bool AccumulationBuffer::write(const string& path) const {
+        FILE* file = fopen(path.c_str(), "wb");
+        if (file == nullptr) return false;
+        uint32_t size[2] = { width, height };
+        fwrite(ACC_MAGIC, 1, sizeof(ACC_MAGIC), file);
+        fwrite(size, sizeof(uint32_t), 2, file);
+        fwrite(sums.data(), sizeof(Vec3), sums.size(), file);
+        fwrite(squareSums.data(), sizeof(Vec3), squareSums.size(), file);
+        fwrite(counts.data(), sizeof(uint32_t), counts.size(), file);
+        bool ok = ferror(file) == 0;
+        fclose(file);
+        return ok;
+    }
+
+    bool AccumulationBuffer::read(const string& path) {
+        error_code ec;
+        uintmax_t fileSize = filesystem::file_size(path, ec);
+        if (ec) return false;
+        FILE* file = fopen(path.c_str(), "rb");
+        if (file == nullptr) return false;
+        char magic[sizeof(ACC_MAGIC)] = {};
+        uint32_t size[2] = {};
+        bool ok = fread(magic, 1, sizeof(magic), file) == sizeof(magic)
+            && memcmp(magic, ACC_MAGIC, sizeof(magic)) == 0
+            && fread(size, sizeof(uint32_t), 2, file) == 2;
+        // ǰļСУͷеĿߣضϻ𻵵ļᵼ¾޴ķ
+        if (ok) {
+            uintmax_t pixels = uintmax_t(size[0])*size[1];
+            ok = fileSize >= ACC_HEADER_SIZE
+                && pixels <= (fileSize - ACC_HEADER_SIZE)/ACC_PIXEL_SIZE
+                && pixels*ACC_PIXEL_SIZE == fileSize - ACC_HEADER_SIZE;
+        }
+        AccumulationBuffer buffer{};
+        if (ok) {
+            buffer = AccumulationBuffer{size[0], size[1]};
+            size_t n = buffer.counts.size();
+            ok = fread(buffer.sums.data(), sizeof(Vec3), n, file) == n
+                && fread(buffer.squareSums.data(), sizeof(Vec3), n, file) == n
+                && fread(buffer.counts.data(), sizeof(uint32_t), n, file) == n;
+        }
+        fclose(file);
+        if (ok) *this = move(buffer);
+        return ok;
+    }
+
+    bool AccumulationBuffer::writeVariancePfm(const string& path) const {
+        FILE* file = fopen(path.c_str(), "wb");
+        if (file == nullptr) return false;
+        // ıӱʾСֽ
+        fprintf(file, "Pf\n%u %u\n-1.0\n", width, height);
+        // PFMµϵ˳洢ɨ
+        vector<float> row(width);
+        for (unsigned int i = 0; i < height; i++) {
+            for (unsigned int j = 0; j < width; j++) {
+                Vec3 v = variance(height - i - 1, j);
+                row[j] = (v.x + v.y + v.z)/3.f;
+            }
+            fwrite(row.data(), sizeof(float), width, file);
+        }
+        bool ok = ferror(file) == 0;
+        fclose(file);
+        return ok;
+    }
+} // namespace NRenderer
@@ -0,0 +1,68 @@
+#include "server/CostMap.hpp"
+
+#include <cstdio>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+
+namespace NRenderer
+{
+    float CostMap::max() const {
+        float m = 0.f;
+        for (auto c : costs) m = std::max(m, c);
+        return m;
+    }
+
+    float CostMap::mean() const {
+        if (costs.empty()) return 0.f;
+        double sum = 0.0;
+        for (auto c : costs) sum += c;
+        return float(sum / double(costs.size()));
+    }
+
+    bool CostMap::writePfm(const string& path) const {
+        FILE* file = fopen(path.c_str(), "wb");
+        if (file == nullptr) return false;
+        // ıӱʾСֽ
+        fprintf(file, "Pf\n%u %u\n-1.0\n", width, height);
+        // PFMµϵ˳洢ɨ
+        for (unsigned int i = 0; i < height; i++) {
+            fwrite(&costs[size_t(height - i - 1)*width], sizeof(float), width, file);
+        }
+        bool ok = ferror(file) == 0;
+        fclose(file);
+        return ok;
+    }
+
+    namespace
+    {
+        // [0, 1]ӳΪ----αɫ
+        void falseColor(float t, uint8_t rgb[3]) {
+            t = std::clamp(t, 0.f, 1.f);
+            float r = std::clamp(std::min(4.f*t - 1.5f, -4.f*t + 4.5f), 0.f, 1.f);
+            float g = std::clamp(std::min(4.f*t - 0.5f, -4.f*t + 3.5f), 0.f, 1.f);
+            float b = std::clamp(std::min(4.f*t + 0.5f, -4.f*t + 2.5f), 0.f, 1.f);
+            rgb[0] = uint8_t(r*255.f + 0.5f);
+            rgb[1] = uint8_t(g*255.f + 0.5f);
+            rgb[2] = uint8_t(b*255.f + 0.5f);
+        }
+    }
+
+    bool CostMap::writeFalseColor(const string& path) const {
+        FILE* file = fopen(path.c_str(), "wb");
+        if (file == nullptr) return false;
+        fprintf(file, "P6\n%u %u\n255\n", width, height);
+        float m = max();
+        float scale = m > 0.f ? 1.f/m : 0.f;
+        vector<uint8_t> row(size_t(width)*3);
+        for (unsigned int i = 0; i < height; i++) {
+            for (unsigned int j = 0; j < width; j++) {
+                falseColor(at(i, j)*scale, &row[size_t(j)*3]);
+            }
+            fwrite(row.data(), 1, row.size(), file);
+        }
+        bool ok = ferror(file) == 0;
+        fclose(file);
+        return ok;
+    }
+} // namespace NRenderer
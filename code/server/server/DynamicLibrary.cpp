@@ -0,0 +1,56 @@
+#include "server/DynamicLibrary.hpp"
+
+#ifdef _WIN32
+    #include <Windows.h>
+#else
+    #include <dlfcn.h>
+#endif
+
+namespace NRenderer
+{
+    DynamicLibrary::DynamicLibrary()
+        : handle            (nullptr)
+        , path              ()
+        , lastErrorInfo     ()
+    {}
+
+    DynamicLibrary::~DynamicLibrary() {
+        close();
+    }
+
+    bool DynamicLibrary::open(const string& path) {
+        close();
+        this->path = path;
+#ifdef _WIN32
+        handle = (void*)::LoadLibraryA(path.c_str());
+        if (handle == nullptr) {
+            lastErrorInfo = "LoadLibrary failed with error " + to_string(::GetLastError());
+        }
+#else
+        handle = ::dlopen(path.c_str(), RTLD_NOW);
+        if (handle == nullptr) {
+            const char* err = ::dlerror();
+            lastErrorInfo = err != nullptr ? err : "dlopen failed";
+        }
+#endif
+        return handle != nullptr;
+    }
+
+    void DynamicLibrary::close() {
+        if (handle == nullptr) return;
+#ifdef _WIN32
+        ::FreeLibrary((HMODULE)handle);
+#else
+        ::dlclose(handle);
+#endif
+        handle = nullptr;
+    }
+
+    string DynamicLibrary::extension() {
+#ifdef _WIN32
+        return ".dll";
+#else
+        return ".so";
+#endif
+    }
+} // namespace NRenderer
@@ -0,0 +1,55 @@
+#include "server/InstrumentedMutex.hpp"
+
+#include <map>
+#include <memory>
+
+namespace NRenderer
+{
+    namespace
+    {
+        // ע󲻻ᱻͷţɰȫسڳ
+        struct LockRegistry
+        {
+            mutex mtx;
+            map<string, unique_ptr<LockCounter>> counters;
+        };
+
+        LockRegistry& registry() {
+            static LockRegistry r{};
+            return r;
+        }
+    }
+
+    LockCounter& getLockCounter(const string& name) {
+        auto& r = registry();
+        lock_guard<mutex> lock{r.mtx};
+        auto& c = r.counters[name];
+        if (c == nullptr) c = make_unique<LockCounter>();
+        return *c;
+    }
+
+    vector<LockStatistics> getLockStatistics() {
+        auto& r = registry();
+        lock_guard<mutex> lock{r.mtx};
+        vector<LockStatistics> result;
+        for (auto& [name, c] : r.counters) {
+            LockStatistics s;
+            s.name = name;
+            s.acquisitions = c->acquisitions.load(memory_order_relaxed);
+            s.contended = c->contended.load(memory_order_relaxed);
+            s.waitSeconds = double(c->waitNanoseconds.load(memory_order_relaxed)) * 1e-9;
+            result.push_back(s);
+        }
+        return result;
+    }
+
+    void resetLockStatistics() {
+        auto& r = registry();
+        lock_guard<mutex> lock{r.mtx};
+        for (auto& [name, c] : r.counters) {
+            c->acquisitions = 0;
+            c->contended = 0;
+            c->waitNanoseconds = 0;
+        }
+    }
+} // namespace NRenderer
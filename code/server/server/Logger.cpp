@@ -4,7 +4,7 @@ namespace NRenderer
 {
     Logger::Logger()
         : msgs      ()
-        , mtx     ()
+        , mtx     ("Logger")
     {
         msgs.reserve(100);
     }
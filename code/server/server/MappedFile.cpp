@@ -0,0 +1,90 @@
+#include "server/MappedFile.hpp"
+
+#ifdef _WIN32
+    #include <Windows.h>
+#else
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+namespace NRenderer
+{
+    MappedFile::MappedFile()
+        : address           (nullptr)
+        , size              (0)
+        , file              (nullptr)
+        , mapping           (nullptr)
+        , opened            (false)
+    {}
+
+    MappedFile::~MappedFile() {
+        close();
+    }
+
+    bool MappedFile::open(const string& path) {
+        close();
+#ifdef _WIN32
+        HANDLE h = ::CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+            FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+        if (h == INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER fileSize;
+        if (!::GetFileSizeEx(h, &fileSize)) {
+            ::CloseHandle(h);
+            return false;
+        }
+        file = h;
+        size = size_t(fileSize.QuadPart);
+        if (size > 0) {
+            mapping = ::CreateFileMappingA(h, NULL, PAGE_READONLY, 0, 0, NULL);
+            if (mapping == NULL) {
+                close();
+                return false;
+            }
+            address = (const char*)::MapViewOfFile((HANDLE)mapping, FILE_MAP_READ, 0, 0, 0);
+            if (address == nullptr) {
+                close();
+                return false;
+            }
+        }
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+            ::close(fd);
+            return false;
+        }
+        size = size_t(st.st_size);
+        if (size > 0) {
+            void* p = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p == MAP_FAILED) {
+                ::close(fd);
+                size = 0;
+                return false;
+            }
+            ::madvise(p, size, MADV_SEQUENTIAL);
+            address = (const char*)p;
+        }
+        ::close(fd);
+#endif
+        opened = true;
+        return true;
+    }
+
+    void MappedFile::close() {
+#ifdef _WIN32
+        if (address != nullptr) ::UnmapViewOfFile(address);
+        if (mapping != nullptr) ::CloseHandle((HANDLE)mapping);
+        if (file != nullptr) ::CloseHandle((HANDLE)file);
+        mapping = nullptr;
+        file = nullptr;
+#else
+        if (address != nullptr) ::munmap((void*)address, size);
+#endif
+        address = nullptr;
+        size = 0;
+        opened = false;
+    }
+} // namespace NRenderer
@@ -8,7 +8,8 @@ namespace NRenderer
         : width             (500)
         , height            (500)
         , updated           (false)
-        , mtx               ()
+        , mtx               ("Screen")
+        , mirror            ()
     {
         pixels = new RGBA[height * width];
         for (int i=0; i<height; i++) {
@@ -16,6 +17,22 @@ namespace NRenderer
                 pixels[i*width+j] = {0, 0, 0, 1};
             }
         }
+        // ͨڴ澵񣬱޽Ⱦũ
+        if (auto name = getenv("NR_SCREEN_MIRROR")) {
+            enableMirror(name);
+        }
+    }
+    bool Screen::enableMirror(const string& name) {
+        lock_guard<InstrumentedMutex> lock{mtx};
+        auto m = make_unique<SharedFrameBuffer>();
+        if (!m->create(name, width, height)) return false;
+        if (pixels != nullptr) m->publish(pixels, width, height);
+        mirror = std::move(m);
+        return true;
+    }
+    void Screen::disableMirror() {
+        lock_guard<InstrumentedMutex> lock{mtx};
+        mirror.reset();
     }
     bool Screen::isUpdated() const {
         return updated;
@@ -51,6 +68,16 @@ namespace NRenderer
         mtx.unlock();
         return pixels;
     }
+    bool Screen::copyPixels(vector<RGBA>& out, unsigned int& width, unsigned int& height) const {
+        lock_guard<InstrumentedMutex> lock{mtx};
+        bool wasUpdated = updated;
+        updated = false;
+        width = this->width;
+        height = this->height;
+        if (pixels == nullptr) out.clear();
+        else out.assign(pixels, pixels + size_t(width)*height);
+        return wasUpdated;
+    }
     void Screen::set(RGBA* pixels, int width, int height) {
         mtx.lock();
         updated = true;
@@ -62,6 +89,7 @@ namespace NRenderer
         for (int i=0; i<width*height; i++) {
             this->pixels[i] = clamp(pixels[i]);
         }
+        if (mirror) mirror->publish(this->pixels, width, height);
         mtx.unlock();
     }
 } // namespace NRenderer
@@ -0,0 +1,264 @@
+#include "server/SharedFrameBuffer.hpp"
+
+#include <cstring>
+#include <new>
+#include <thread>
+
+#ifdef _WIN32
+    #include <Windows.h>
+#else
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+namespace NRenderer
+{
+    namespace
+    {
+        // POSIXҪڴ'/'ͷWindowsʹûỰڵռ
+        string systemName(const string& name) {
+#ifdef _WIN32
+            return "Local\\" + name;
+#else
+            return "/" + name;
+#endif
+        }
+
+        size_t segmentSize(size_t pixels) {
+            return sizeof(SharedFrameHeader) + pixels*sizeof(RGBA);
+        }
+    }
+
+    SharedMemory::SharedMemory()
+        : name              ()
+        , address           (nullptr)
+        , size              (0)
+        , handle            (nullptr)
+        , owner             (false)
+    {}
+
+    SharedMemory::~SharedMemory() {
+        close();
+    }
+
+    bool SharedMemory::create(const string& name, size_t size) {
+        close();
+        this->name = systemName(name);
+#ifdef _WIN32
+        handle = ::CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE,
+            DWORD(uint64_t(size) >> 32), DWORD(size & 0xFFFFFFFF), this->name.c_str());
+        if (handle == NULL) return false;
+        address = ::MapViewOfFile((HANDLE)handle, FILE_MAP_ALL_ACCESS, 0, 0, size);
+        if (address == nullptr) {
+            ::CloseHandle((HANDLE)handle);
+            handle = nullptr;
+            return false;
+        }
+#else
+        // ɾͬľɶ󣬱ȡ򿪵ߴ粻Ķ
+        ::shm_unlink(this->name.c_str());
+        int fd = ::shm_open(this->name.c_str(), O_CREAT | O_RDWR, 0644);
+        if (fd < 0) return false;
+        if (::ftruncate(fd, off_t(size)) != 0) {
+            ::close(fd);
+            ::shm_unlink(this->name.c_str());
+            return false;
+        }
+        void* p = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) {
+            ::shm_unlink(this->name.c_str());
+            return false;
+        }
+        address = p;
+#endif
+        this->size = size;
+        owner = true;
+        return true;
+    }
+
+    bool SharedMemory::open(const string& name) {
+        close();
+        this->name = systemName(name);
+#ifdef _WIN32
+        handle = ::OpenFileMappingA(FILE_MAP_READ, FALSE, this->name.c_str());
+        if (handle == NULL) return false;
+        address = ::MapViewOfFile((HANDLE)handle, FILE_MAP_READ, 0, 0, 0);
+        if (address == nullptr) {
+            ::CloseHandle((HANDLE)handle);
+            handle = nullptr;
+            return false;
+        }
+        MEMORY_BASIC_INFORMATION info;
+        ::VirtualQuery(address, &info, sizeof(info));
+        size = info.RegionSize;
+#else
+        int fd = ::shm_open(this->name.c_str(), O_RDONLY, 0);
+        if (fd < 0) return false;
+        struct stat st;
+        if (::fstat(fd, &st) != 0 || size_t(st.st_size) < sizeof(SharedFrameHeader)) {
+            ::close(fd);
+            return false;
+        }
+        void* p = ::mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) return false;
+        address = p;
+        size = size_t(st.st_size);
+#endif
+        owner = false;
+        return true;
+    }
+
+    void SharedMemory::close() {
+        if (address == nullptr) return;
+#ifdef _WIN32
+        ::UnmapViewOfFile(address);
+        ::CloseHandle((HANDLE)handle);
+        handle = nullptr;
+#else
+        ::munmap(address, size);
+        if (owner) ::shm_unlink(name.c_str());
+#endif
+        address = nullptr;
+        size = 0;
+        owner = false;
+    }
+
+    SharedFrameBuffer::SharedFrameBuffer()
+        : name              ()
+        , memory            ()
+        , frameCount        (0)
+    {}
+
+    SharedFrameBuffer::~SharedFrameBuffer() {
+        close();
+    }
+
+    SharedFrameHeader* SharedFrameBuffer::header() const {
+        return static_cast<SharedFrameHeader*>(memory.data());
+    }
+
+    bool SharedFrameBuffer::allocate(size_t pixels) {
+        // ֪ͨӳɶεĶȡ´
+        if (memory.isOpen()) {
+            header()->retired.store(1, memory_order_release);
+            memory.close();
+        }
+        if (!memory.create(name, segmentSize(pixels))) return false;
+        auto h = new (memory.data()) SharedFrameHeader{};
+        h->magic = SharedFrameHeader::MAGIC;
+        h->version = SharedFrameHeader::VERSION;
+        h->format = SharedFrameHeader::RGBA32F;
+        h->capacity = uint32_t(pixels);
+        h->retired.store(0, memory_order_relaxed);
+        h->sequence.store(0, memory_order_relaxed);
+        h->width = 0;
+        h->height = 0;
+        h->frameCount = frameCount;
+        return true;
+    }
+
+    bool SharedFrameBuffer::create(const string& name, unsigned int width, unsigned int height) {
+        close();
+        this->name = name;
+        frameCount = 0;
+        return allocate(size_t(width)*height);
+    }
+
+    void SharedFrameBuffer::close() {
+        if (memory.isOpen()) {
+            header()->retired.store(1, memory_order_release);
+        }
+        memory.close();
+    }
+
+    void SharedFrameBuffer::publish(const RGBA* pixels, unsigned int width, unsigned int height) {
+        if (!memory.isOpen()) return;
+        size_t n = size_t(width)*height;
+        if (n > header()->capacity && !allocate(n)) return;
+        auto h = header();
+        auto dst = reinterpret_cast<RGBA*>(reinterpret_cast<char*>(h) + sizeof(SharedFrameHeader));
+
+        // ˳д룺Ϊ -> д -> Ϊż
+        uint32_t seq = h->sequence.load(memory_order_relaxed);
+        h->sequence.store(seq + 1, memory_order_relaxed);
+        atomic_thread_fence(memory_order_release);
+        h->width = width;
+        h->height = height;
+        h->frameCount = ++frameCount;
+        memcpy(dst, pixels, n*sizeof(RGBA));
+        h->sequence.store(seq + 2, memory_order_release);
+    }
+
+    SharedFrameHeader* SharedFrameReader::header() const {
+        return static_cast<SharedFrameHeader*>(memory.data());
+    }
+
+    bool SharedFrameReader::open(const string& name) {
+        this->name = name;
+        if (!memory.open(name)) return false;
+        auto h = header();
+        if (h->magic != SharedFrameHeader::MAGIC || h->version != SharedFrameHeader::VERSION
+            || memory.getSize() < segmentSize(h->capacity)) {
+            memory.close();
+            return false;
+        }
+        return true;
+    }
+
+    void SharedFrameReader::close() {
+        memory.close();
+    }
+
+    bool SharedFrameReader::isRetired() const {
+        return !memory.isOpen() || header()->retired.load(memory_order_acquire) != 0;
+    }
+
+    uint32_t SharedFrameReader::beginRead() const {
+        uint32_t seq = header()->sequence.load(memory_order_acquire);
+        while (seq & 1) {
+            this_thread::yield();
+            seq = header()->sequence.load(memory_order_acquire);
+        }
+        return seq;
+    }
+
+    bool SharedFrameReader::validate(uint32_t sequence) const {
+        atomic_thread_fence(memory_order_acquire);
+        return header()->sequence.load(memory_order_relaxed) == sequence;
+    }
+
+    unsigned int SharedFrameReader::getWidth() const {
+        return header()->width;
+    }
+
+    unsigned int SharedFrameReader::getHeight() const {
+        return header()->height;
+    }
+
+    uint64_t SharedFrameReader::getFrameCount() const {
+        return header()->frameCount;
+    }
+
+    const RGBA* SharedFrameReader::data() const {
+        return reinterpret_cast<const RGBA*>(reinterpret_cast<const char*>(header()) + sizeof(SharedFrameHeader));
+    }
+
+    bool SharedFrameReader::read(vector<RGBA>& pixels, unsigned int& width, unsigned int& height, uint64_t& frame) {
+        if (isRetired() && !open(name)) return false;
+        while (true) {
+            auto seq = beginRead();
+            width = getWidth();
+            height = getHeight();
+            frame = getFrameCount();
+            size_t n = size_t(width)*height;
+            if (n > header()->capacity) continue;
+            pixels.resize(n);
+            memcpy(pixels.data(), data(), n*sizeof(RGBA));
+            if (validate(seq)) return true;
+        }
+    }
+} // namespace NRenderer
@@ -0,0 +1,54 @@
+#include "server/Statistics.hpp"
+
+namespace NRenderer
+{
+    Statistics::Statistics()
+        : lastRender        ()
+        , renderCount       (0)
+        , progress          (0.f)
+        , mtx               ()
+    {}
+
+    void Statistics::reportRender(const RenderStatistics& stats) {
+        lock_guard<mutex> lock{mtx};
+        lastRender = stats;
+        renderCount++;
+        progress = 1.f;
+    }
+
+    void Statistics::reportProgress(float progress) {
+        lock_guard<mutex> lock{mtx};
+        this->progress = progress;
+    }
+
+    float Statistics::getProgress() const {
+        lock_guard<mutex> lock{mtx};
+        return progress;
+    }
+
+    RenderStatistics Statistics::getLastRender() const {
+        lock_guard<mutex> lock{mtx};
+        return lastRender;
+    }
+
+    unsigned int Statistics::getRenderCount() const {
+        lock_guard<mutex> lock{mtx};
+        return renderCount;
+    }
+
+    bool Statistics::lockStatsEnabled() const {
+#ifdef NR_LOCK_STATS
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    vector<LockStatistics> Statistics::getLockStatistics() const {
+        return NRenderer::getLockStatistics();
+    }
+
+    void Statistics::resetLockStatistics() {
+        NRenderer::resetLockStatistics();
+    }
+} // namespace NRenderer
@@ -0,0 +1,74 @@
+#include "server/TaskGraph.hpp"
+
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <exception>
+#include <algorithm>
+
+namespace NRenderer
+{
+    auto TaskGraph::add(function<void()> work, initializer_list<TaskId> after) -> TaskId {
+        return add(move(work), vector<TaskId>(after));
+    }
+
+    auto TaskGraph::add(function<void()> work, const vector<TaskId>& after) -> TaskId {
+        TaskId id = tasks.size();
+        tasks.push_back({ move(work), {}, unsigned(after.size()) });
+        for (auto a : after) tasks[a].successors.push_back(id);
+        return id;
+    }
+
+    void TaskGraph::run(unsigned int threads) {
+        if (tasks.empty()) return;
+        if (threads == 0) threads = max(1u, thread::hardware_concurrency());
+
+        mutex mtx;
+        condition_variable cv;
+        vector<TaskId> ready;
+        vector<unsigned int> remaining(tasks.size());
+        size_t unfinished = tasks.size();   // δɵ񣬳ٿʼҲΪ
+        exception_ptr error = nullptr;
+        for (TaskId i = 0; i < tasks.size(); i++) {
+            remaining[i] = tasks[i].dependencies;
+            if (remaining[i] == 0) ready.push_back(i);
+        }
+
+        auto worker = [&]() {
+            unique_lock<mutex> lock{mtx};
+            while (true) {
+                cv.wait(lock, [&]() { return !ready.empty() || unfinished == 0; });
+                if (unfinished == 0) break;
+                TaskId id = ready.back();
+                ready.pop_back();
+                if (error == nullptr) {
+                    lock.unlock();
+                    exception_ptr caught = nullptr;
+                    try {
+                        tasks[id].work();
+                    }
+                    catch (...) {
+                        caught = current_exception();
+                    }
+                    lock.lock();
+                    if (caught != nullptr && error == nullptr) error = caught;
+                }
+                // ԰ϵͷţִУ֤unfinishedܹ
+                for (auto s : tasks[id].successors) {
+                    if (--remaining[s] == 0) ready.push_back(s);
+                }
+                unfinished--;
+                cv.notify_all();
+            }
+        };
+
+        // ߳ʱֻ߳յ
+        unsigned int helpers = unsigned(min<size_t>(threads, tasks.size())) - 1;
+        vector<thread> pool;
+        pool.reserve(helpers);
+        for (unsigned int i = 0; i < helpers; i++) pool.emplace_back(worker);
+        worker();
+        for (auto& t : pool) t.join();
+        if (error != nullptr) rethrow_exception(error);
+    }
+} // namespace NRenderer
@@ -0,0 +1,55 @@
+#include "server/TemporalHistory.hpp"
+
+#include <cmath>
+
+namespace NRenderer
+{
+    TemporalHistory::TemporalHistory(unsigned int width, unsigned int height, uint64_t key, unsigned int frame, const View& view)
+        : width             (width)
+        , height            (height)
+        , key               (key)
+        , frame             (frame)
+        , view              (view)
+        , toView            (glm::inverse(Mat3x3{ view.lowerLeft - view.origin, view.horizontal, view.vertical }))
+        , texels            (size_t(width)*height)
+    {}
+
+    auto TemporalHistory::reproject(const Vec3& position, const Vec3& normal) const -> Texel {
+        Texel result{};
+        if (texels.empty()) return result;
+        //  = k*(lowerLeft - origin) + k*s*horizontal + k*t*vertical
+        Vec3 projected = toView*(position - view.origin);
+        if (projected.x <= 0.f) return result;      // λһ֡ĺ
+        float x = projected.y/projected.x*float(width) - 0.5f;
+        float y = projected.z/projected.x*float(height) - 0.5f;
+        if (!(x > -1.f && x < float(width) && y > -1.f && y < float(height))) return result;
+
+        const int x0 = int(floor(x));
+        const int y0 = int(floor(y));
+        const float fx = x - float(x0);
+        const float fy = y - float(y0);
+        const float tolerance = DEPTH_TOLERANCE*glm::length(position - view.origin);
+        float total = 0.f;
+        for (int dy = 0; dy < 2; dy++) {
+            for (int dx = 0; dx < 2; dx++) {
+                int col = x0 + dx;
+                int row = y0 + dy;
+                if (col < 0 || row < 0 || col >= int(width) || row >= int(height)) continue;
+                const Texel& texel = at(row, col);
+                if (texel.weight <= 0.f) continue;
+                if (glm::dot(texel.normal, normal) < NORMAL_TOLERANCE) continue;
+                if (abs(glm::dot(position - texel.position, texel.normal)) > tolerance) continue;
+                float b = (dx ? fx : 1.f - fx)*(dy ? fy : 1.f - fy);
+                if (b <= 0.f) continue;
+                result.radiance += b*texel.radiance;
+                result.weight += b*texel.weight;
+                total += b;
+            }
+        }
+        if (total <= 0.f) return Texel{};
+        result.radiance /= total;
+        result.position = position;
+        result.normal = normal;
+        return result;
+    }
+} // namespace NRenderer
@@ -0,0 +1,180 @@
+#include "server/TileStream.hpp"
+
+#include <algorithm>
+
+namespace NRenderer
+{
+    namespace
+    {
+        void putU16(vector<uint8_t>& out, uint16_t v) {
+            out.push_back(uint8_t(v));
+            out.push_back(uint8_t(v >> 8));
+        }
+        void putU32(vector<uint8_t>& out, uint32_t v) {
+            for (int i = 0; i < 4; i++) out.push_back(uint8_t(v >> (8*i)));
+        }
+        void patchU32(vector<uint8_t>& out, size_t at, uint32_t v) {
+            for (int i = 0; i < 4; i++) out[at + i] = uint8_t(v >> (8*i));
+        }
+
+        // ߽С˶ȡ
+        struct Reader
+        {
+            const uint8_t* data;
+            size_t size;
+            size_t pos = 0;
+            bool u16(uint16_t& v) {
+                if (size - pos < 2) return false;
+                v = uint16_t(data[pos] | (data[pos + 1] << 8));
+                pos += 2;
+                return true;
+            }
+            bool u32(uint32_t& v) {
+                if (size - pos < 4) return false;
+                v = 0;
+                for (int i = 0; i < 4; i++) v |= uint32_t(data[pos + i]) << (8*i);
+                pos += 4;
+                return true;
+            }
+        };
+
+        // PackBitsѹ
+        // ֽn0~127֮ʱn+1ԭֽڣ-127~-1֮ʱһֽظ1-n
+        void packBits(const uint8_t* src, size_t size, vector<uint8_t>& out) {
+            size_t i = 0;
+            while (i < size) {
+                size_t run = 1;
+                while (i + run < size && run < 128 && src[i + run] == src[i]) run++;
+                if (run >= 3) {
+                    out.push_back(uint8_t(int8_t(1 - int(run))));
+                    out.push_back(src[i]);
+                    i += run;
+                    continue;
+                }
+                // ԭֱֳȲС3ظ
+                size_t begin = i;
+                while (i < size && i - begin < 128) {
+                    if (i + 2 < size && src[i] == src[i + 1] && src[i] == src[i + 2]) break;
+                    i++;
+                }
+                out.push_back(uint8_t(i - begin - 1));
+                out.insert(out.end(), src + begin, src + i);
+            }
+        }
+
+        // PackBitsѹȱǡΪsize
+        bool unpackBits(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t size) {
+            size_t i = 0, o = 0;
+            while (i < srcSize) {
+                int n = int8_t(src[i++]);
+                if (n >= 0) {
+                    size_t count = size_t(n) + 1;
+                    if (srcSize - i < count || size - o < count) return false;
+                    copy(src + i, src + i + count, dst + o);
+                    i += count;
+                    o += count;
+                }
+                else if (n != -128) {
+                    size_t count = size_t(1 - n);
+                    if (i >= srcSize || size - o < count) return false;
+                    fill(dst + o, dst + o + count, src[i++]);
+                    o += count;
+                }
+            }
+            return o == size;
+        }
+    }
+
+    TileEncoder::TileEncoder()
+        : width             (0)
+        , height            (0)
+        , sent              ()
+        , delta             ()
+    {}
+
+    vector<uint8_t> TileEncoder::encode(const RGBA* pixels, unsigned int width, unsigned int height, unsigned int& changedTiles) {
+        if (width != this->width || height != this->height) {
+            this->width = width;
+            this->height = height;
+            sent.assign(size_t(width)*height*4, 0);
+        }
+        vector<uint8_t> out;
+        putU32(out, width);
+        putU32(out, height);
+        putU32(out, 0);
+        changedTiles = 0;
+
+        const unsigned int tilesX = (width + FRAME_TILE_SIZE - 1)/FRAME_TILE_SIZE;
+        const unsigned int tilesY = (height + FRAME_TILE_SIZE - 1)/FRAME_TILE_SIZE;
+        for (unsigned int ty = 0; ty < tilesY; ty++) {
+            for (unsigned int tx = 0; tx < tilesX; tx++) {
+                unsigned int x0 = tx*FRAME_TILE_SIZE, y0 = ty*FRAME_TILE_SIZE;
+                unsigned int x1 = min(x0 + FRAME_TILE_SIZE, width), y1 = min(y0 + FRAME_TILE_SIZE, height);
+                delta.clear();
+                bool changed = false;
+                for (unsigned int y = y0; y < y1; y++) {
+                    for (unsigned int x = x0; x < x1; x++) {
+                        size_t idx = size_t(y)*width + x;
+                        auto c = RGBA2RGBAi(pixels[idx]);
+                        uint8_t* old = &sent[idx*4];
+                        for (int k = 0; k < 4; k++) {
+                            uint8_t d = uint8_t(c[k] - old[k]);
+                            changed |= d != 0;
+                            delta.push_back(d);
+                            old[k] = c[k];
+                        }
+                    }
+                }
+                if (!changed) continue;
+                putU16(out, uint16_t(tx));
+                putU16(out, uint16_t(ty));
+                size_t sizeAt = out.size();
+                putU32(out, 0);
+                packBits(delta.data(), delta.size(), out);
+                patchU32(out, sizeAt, uint32_t(out.size() - sizeAt - 4));
+                changedTiles++;
+            }
+        }
+        patchU32(out, 8, changedTiles);
+        return out;
+    }
+
+    TileDecoder::TileDecoder()
+        : width             (0)
+        , height            (0)
+        , frame             ()
+    {}
+
+    bool TileDecoder::apply(const uint8_t* data, size_t size) {
+        Reader r{data, size};
+        uint32_t w, h, count;
+        if (!r.u32(w) || !r.u32(h) || !r.u32(count)) return false;
+        if (w != width || h != height) {
+            width = w;
+            height = h;
+            frame.assign(size_t(w)*h*4, 0);
+        }
+        const unsigned int tilesX = (width + FRAME_TILE_SIZE - 1)/FRAME_TILE_SIZE;
+        const unsigned int tilesY = (height + FRAME_TILE_SIZE - 1)/FRAME_TILE_SIZE;
+        vector<uint8_t> tile;
+        for (uint32_t t = 0; t < count; t++) {
+            uint16_t tx, ty;
+            uint32_t bytes;
+            if (!r.u16(tx) || !r.u16(ty) || !r.u32(bytes)) return false;
+            if (tx >= tilesX || ty >= tilesY || size - r.pos < bytes) return false;
+            unsigned int x0 = tx*FRAME_TILE_SIZE, y0 = ty*FRAME_TILE_SIZE;
+            unsigned int x1 = min(x0 + FRAME_TILE_SIZE, width), y1 = min(y0 + FRAME_TILE_SIZE, height);
+            tile.resize(size_t(x1 - x0)*(y1 - y0)*4);
+            if (!unpackBits(data + r.pos, bytes, tile.data(), tile.size())) return false;
+            r.pos += bytes;
+            const uint8_t* d = tile.data();
+            for (unsigned int y = y0; y < y1; y++) {
+                uint8_t* row = &frame[(size_t(y)*width + x0)*4];
+                for (size_t k = 0; k < size_t(x1 - x0)*4; k++) {
+                    row[k] = uint8_t(row[k] + *d++);
+                }
+            }
+        }
+        return r.pos == size;
+    }
+} // namespace NRenderer
@@ -0,0 +1,72 @@
+#include "gtest/gtest.h"
+#include "server/AccumulationBuffer.hpp"
+
+#include <cstdio>
+#include <cmath>
+#include <filesystem>
+
+using namespace NRenderer;
+
+TEST(AccumulationBufferTest, MergeMatchesSingleRender) {
+    // ͬһص4ֱۻϲӦһۻȫͬ
+    const Vec3 samples[4] = { {0.1f, 0.2f, 0.3f}, {0.5f, 0.4f, 0.3f}, {0.9f, 0.0f, 0.2f}, {0.3f, 0.6f, 0.1f} };
+    AccumulationBuffer whole{2, 1}, first{2, 1}, second{2, 1};
+    for (int k = 0; k < 4; k++) {
+        whole.add(0, 1, samples[k], samples[k]*samples[k], 1);
+        (k < 2 ? first : second).add(0, 1, samples[k], samples[k]*samples[k], 1);
+    }
+    ASSERT_TRUE(first.merge(second));
+    EXPECT_EQ(first.count(0, 1), 4u);
+    EXPECT_EQ(first.count(0, 0), 0u);
+    for (int c = 0; c < 3; c++) {
+        EXPECT_FLOAT_EQ(first.mean(0, 1)[c], whole.mean(0, 1)[c]);
+        EXPECT_NEAR(first.variance(0, 1)[c], whole.variance(0, 1)[c], 1e-6f);
+    }
+    // ûвΪɫ
+    auto pixels = first.resolve();
+    EXPECT_FLOAT_EQ(pixels[0].r, 0.f);
+    EXPECT_FLOAT_EQ(pixels[1].g, std::sqrt(whole.mean(0, 1).y));
+
+    AccumulationBuffer other{1, 2};
+    EXPECT_FALSE(first.merge(other));
+}
+
+TEST(AccumulationBufferTest, FileRoundTrip) {
+    AccumulationBuffer buffer{3, 2};
+    buffer.add(1, 2, {1.f, 2.f, 3.f}, {1.f, 4.f, 9.f}, 2);
+    ASSERT_TRUE(buffer.write("accumulation_test.nracc"));
+
+    AccumulationBuffer loaded{};
+    ASSERT_TRUE(loaded.read("accumulation_test.nracc"));
+    EXPECT_EQ(loaded.getWidth(), 3u);
+    EXPECT_EQ(loaded.getHeight(), 2u);
+    EXPECT_EQ(loaded.count(1, 2), 2u);
+    EXPECT_FLOAT_EQ(loaded.mean(1, 2).z, 1.5f);
+    remove("accumulation_test.nracc");
+
+    EXPECT_FALSE(loaded.read("accumulation_test.nracc"));
+    EXPECT_EQ(loaded.getWidth(), 3u);
+}
+
+TEST(AccumulationBufferTest, RejectsCorruptHeader) {
+    AccumulationBuffer buffer{3, 2};
+    buffer.add(0, 0, {1.f, 1.f, 1.f}, {1.f, 1.f, 1.f}, 1);
+    ASSERT_TRUE(buffer.write("accumulation_corrupt.nracc"));
+
+    // ͷƵĳߴԶļݣȡӦڷǰʧ
+    FILE* file = fopen("accumulation_corrupt.nracc", "r+b");
+    ASSERT_NE(file, nullptr);
+    const uint32_t size[2] = { 0xFFFFu, 0xFFFFu };
+    fseek(file, 8, SEEK_SET);
+    fwrite(size, sizeof(uint32_t), 2, file);
+    fclose(file);
+    AccumulationBuffer loaded{};
+    EXPECT_FALSE(loaded.read("accumulation_corrupt.nracc"));
+
+    // ضϵļ
+    ASSERT_TRUE(buffer.write("accumulation_corrupt.nracc"));
+    auto fileSize = std::filesystem::file_size("accumulation_corrupt.nracc");
+    std::filesystem::resize_file("accumulation_corrupt.nracc", fileSize - 4);
+    EXPECT_FALSE(loaded.read("accumulation_corrupt.nracc"));
+    remove("accumulation_corrupt.nracc");
+}
@@ -0,0 +1,85 @@
+#include "gtest/gtest.h"
+#include "scene/BakedIrradiance.hpp"
+
+#include <cstdio>
+#include <filesystem>
+
+using namespace NRenderer;
+
+TEST(BakedIrradianceTest, LookupInterpolates) {
+    BakedIrradiance baked{42, 1, 1, 1, 2};
+    // Σ㴦ȡֵĴȡƽ
+    Triangle t{};
+    t.v1 = {0, 0, 0};
+    t.v2 = {1, 0, 0};
+    t.v3 = {0, 1, 0};
+    baked.triangles = { Vec3{3.f}, Vec3{6.f}, Vec3{9.f} };
+    EXPECT_NEAR(baked.triangle(0, t, t.v2).x, 6.f, 1e-5f);
+    EXPECT_NEAR(baked.triangle(0, t, (t.v1 + t.v2 + t.v3)/3.f).y, 6.f, 1e-5f);
+
+    // 壺ȡӦֵб򰴷ƽȨ
+    baked.spheres = { Vec3{1.f}, Vec3{2.f}, Vec3{3.f}, Vec3{4.f}, Vec3{5.f}, Vec3{6.f} };
+    EXPECT_FLOAT_EQ(baked.sphere(0, {0, -1, 0}).x, 4.f);
+    Vec3 n = glm::normalize(Vec3{-1, 0, 1});
+    EXPECT_NEAR(baked.sphere(0, n).x, 0.5f*2.f + 0.5f*5.f, 1e-5f);
+
+    // ƽ棺texelȡtexelֵͼԵ֮ȡԵֵ
+    Plane p{};
+    p.position = {0, 0, 0};
+    p.u = {2, 0, 0};
+    p.v = {0, 0, 2};
+    p.normal = {0, 1, 0};
+    baked.planes = { Vec3{0.f}, Vec3{1.f}, Vec3{2.f}, Vec3{3.f} };
+    EXPECT_FLOAT_EQ(baked.plane(0, p, {1.5f, 0, 0.5f}).x, 1.f);
+    EXPECT_FLOAT_EQ(baked.plane(0, p, {1.f, 0, 1.f}).x, 1.5f);
+    EXPECT_FLOAT_EQ(baked.plane(0, p, {2.f, 0, 2.f}).x, 3.f);
+}
+
+TEST(BakedIrradianceTest, FileRoundTripAndStore) {
+    auto baked = std::make_shared<BakedIrradiance>(7, 2, 1, 1, 4);
+    baked->spheres[5] = {1.f, 2.f, 3.f};
+    baked->planes[baked->planeTexel(0, 3, 2)] = {4.f, 5.f, 6.f};
+    ASSERT_TRUE(baked->write("irradiance_test.nrbake"));
+
+    BakedIrradiance loaded{};
+    ASSERT_TRUE(loaded.read("irradiance_test.nrbake"));
+    EXPECT_EQ(loaded.key, 7u);
+    EXPECT_EQ(loaded.planeResolution, 4u);
+    EXPECT_EQ(loaded.triangles.size(), 6u);
+    EXPECT_FLOAT_EQ(loaded.spheres[5].z, 3.f);
+    EXPECT_FLOAT_EQ(loaded.planes[loaded.planeTexel(0, 3, 2)].y, 5.f);
+    remove("irradiance_test.nrbake");
+    EXPECT_FALSE(loaded.read("irradiance_test.nrbake"));
+    EXPECT_EQ(loaded.key, 7u);
+
+    // º決ĽֻҪһΣļָĽҪ
+    IrradianceStore store{};
+    store.publish(baked);
+    EXPECT_EQ(store.takeUnsaved(), baked);
+    EXPECT_EQ(store.takeUnsaved(), nullptr);
+    EXPECT_EQ(store.get(), baked);
+    store.restore(baked);
+    EXPECT_EQ(store.takeUnsaved(), nullptr);
+}
+
+TEST(BakedIrradianceTest, RejectsCorruptHeader) {
+    BakedIrradiance baked{3, 2, 1, 1, 4};
+    ASSERT_TRUE(baked.write("irradiance_corrupt.nrbake"));
+
+    // ͷƵԶļݣȡӦڷǰʧ
+    FILE* file = fopen("irradiance_corrupt.nrbake", "r+b");
+    ASSERT_NE(file, nullptr);
+    const uint32_t counts[4] = { 0xFFFFFFFFu, 1, 1, 0xFFFFu };
+    fseek(file, 16, SEEK_SET);
+    fwrite(counts, sizeof(uint32_t), 4, file);
+    fclose(file);
+    BakedIrradiance loaded{};
+    EXPECT_FALSE(loaded.read("irradiance_corrupt.nrbake"));
+
+    // ضϵļ
+    ASSERT_TRUE(baked.write("irradiance_corrupt.nrbake"));
+    auto fileSize = std::filesystem::file_size("irradiance_corrupt.nrbake");
+    std::filesystem::resize_file("irradiance_corrupt.nrbake", fileSize - 12);
+    EXPECT_FALSE(loaded.read("irradiance_corrupt.nrbake"));
+    remove("irradiance_corrupt.nrbake");
+}
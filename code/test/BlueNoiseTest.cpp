@@ -0,0 +1,94 @@
+#include "gtest/gtest.h"
+#include "samplers/BlueNoise.hpp"
+
+#include <cmath>
+#include <random>
+#include <set>
+#include <utility>
+
+using namespace SimplePathTracer;
+
+namespace
+{
+    const double PI = 3.14159265358979323846;
+
+    // ڵλϻ֪ıϵĽԾ⻬Ϊ0.21 + 0
+    double integrand(double u, double v) {
+        return (u < 0.3 && v < 0.7 ? 1.0 : 0.0) + std::sin(2.0*PI*u)*std::cos(4.0*PI*v);
+    }
+}
+
+// ԶͼƽSIZE*SIZEʱͬĽ
+TEST(BlueNoiseTest, HighSppMatchesRandom) {
+    const unsigned int samples = 1u << 16;
+    const double exact = 0.21;
+    auto& stream = SampleStream::current();
+    stream.enable(true);
+    double blueNoise = 0.0;
+    std::set<std::pair<float, float>> distinct;
+    for (unsigned int k = 0; k < samples; k++) {
+        stream.beginSample(5, 9, k);
+        float u, v;
+        ASSERT_TRUE(stream.next2(u, v));
+        EXPECT_GE(u, 0.f);
+        EXPECT_LT(u, 1.f);
+        blueNoise += integrand(u, v);
+        if (k < 3*BlueNoiseMask::SIZE*BlueNoiseMask::SIZE) distinct.insert({u, v});
+    }
+    stream.enable(false);
+    blueNoise /= samples;
+
+    std::mt19937 rng{11};
+    std::uniform_real_distribution<double> uniform{0.0, 1.0};
+    double random = 0.0;
+    for (unsigned int k = 0; k < samples; k++) {
+        double u = uniform(rng);
+        random += integrand(u, uniform(rng));
+    }
+    random /= samples;
+
+    // Ƶı׼ԼΪ0.7/NӦΧ
+    double tolerance = 4.0*0.7/std::sqrt(double(samples));
+    EXPECT_NEAR(random, exact, tolerance);
+    EXPECT_NEAR(blueNoise, exact, tolerance);
+    // ƽظȡֵӦظ
+    EXPECT_GT(distinct.size(), size_t(2*BlueNoiseMask::SIZE*BlueNoiseMask::SIZE));
+}
+
+// ͼڸƵƵֵռԶСڰڵƵƵռı
+TEST(BlueNoiseTest, MaskLowFrequencyEnergy) {
+    const int n = BlueNoiseMask::SIZE;
+    const int radius = n/8;
+    auto& mask = BlueNoiseMask::instance();
+    double mean = 0.0;
+    for (int y = 0; y < n; y++) {
+        for (int x = 0; x < n; x++) mean += mask.at(x, y);
+    }
+    mean /= n*n;
+    double total = 0.0;
+    for (int y = 0; y < n; y++) {
+        for (int x = 0; x < n; x++) total += (mask.at(x, y) - mean)*(mask.at(x, y) - mean);
+    }
+    // ParsevalȫƵ֮Ϊ n*n*total
+    double low = 0.0;
+    int lowBins = 0;
+    for (int fy = -radius; fy <= radius; fy++) {
+        for (int fx = -radius; fx <= radius; fx++) {
+            if ((fx == 0 && fy == 0) || fx*fx + fy*fy > radius*radius) continue;
+            lowBins++;
+            double re = 0.0, im = 0.0;
+            for (int y = 0; y < n; y++) {
+                for (int x = 0; x < n; x++) {
+                    double phase = -2.0*PI*double(fx*x + fy*y)/n;
+                    double value = mask.at(x, y) - mean;
+                    re += value*std::cos(phase);
+                    im += value*std::sin(phase);
+                }
+            }
+            low += re*re + im*im;
+        }
+    }
+    double lowFraction = low/(double(n)*n*total);
+    double whiteFraction = double(lowBins)/(double(n)*n);
+    EXPECT_LT(lowFraction, 0.2*whiteFraction);
+}
@@ -0,0 +1,95 @@
+#include "gtest/gtest.h"
+#include "SimplePathTracer.hpp"
+#include "scene/ScnParser.hpp"
+#include "server/Server.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <vector>
+
+using namespace SimplePathTracer;
+
+namespace
+{
+    // 桢ԴÿصĹǷмǷڵͬ
+    const char* HEATMAP_SCENE = R"(
+Begin Material
+Material White
+Prop diffuseColor RGB 0.8 0.8 0.8
+End
+
+Begin Model
+Model Ground
+Translation 0 0 0
+Plane Floor White
+N 0 1 0
+P -2 0 -2
+U 4 0 0
+V 0 0 4
+Sphere Ball White
+N 0 0 1
+P 0 0.8 0
+R 0.5
+End
+
+Begin Light
+Area Top
+IRV 4 4 4
+P -0.5 3 -0.5
+U 1 0 0
+V 0 0 1
+End
+)";
+
+    // ȡͨPFMʧʱؿ
+    std::vector<float> readPfm(const string& path, unsigned int& width, unsigned int& height) {
+        std::ifstream in{path, std::ios::binary};
+        string magic;
+        float scale = 0.f;
+        in>>magic>>width>>height>>scale;
+        in.get();
+        if (!in || magic != "Pf") return {};
+        std::vector<float> values(size_t(width)*height);
+        in.read(reinterpret_cast<char*>(values.data()), values.size()*sizeof(float));
+        if (!in) return {};
+        return values;
+    }
+}
+
+// ͼصĹ֮ӦȾͳеĹдRenderOption::heatmapOutputָ·
+TEST(HeatmapTest, RayCountsSumToTotal) {
+    ScnParser parser;
+    auto scene = parser.parseText(HEATMAP_SCENE);
+    ASSERT_NE(scene, nullptr) << parser.getErrorInfo();
+    scene->camera.position = Vec3{0, 3, -3};
+    scene->camera.lookAt = Vec3{0, 0, 0};
+    auto& ro = scene->renderOption;
+    ro.width = 24;
+    ro.height = 16;
+    ro.depth = 2;
+    ro.samplesPerPixel = 8;
+    ro.threads = 3;
+    ro.sampleSeed = 5;
+    ro.heatmap = RenderOption::Heatmap::RAYS;
+    ro.heatmapOutput = "heatmap_test_rays";
+
+    SimplePathTracerRenderer renderer{scene};
+    renderer.release(renderer.render());
+    uint64_t total = getServer().statistics.getLastRender().rays;
+
+    unsigned int width = 0, height = 0;
+    auto counts = readPfm("heatmap_test_rays.pfm", width, height);
+    std::ifstream falseColor{"heatmap_test_rays.ppm"};
+    EXPECT_TRUE(falseColor.good());
+    falseColor.close();
+    remove("heatmap_test_rays.pfm");
+    remove("heatmap_test_rays.ppm");
+    ASSERT_EQ(counts.size(), size_t(24*16));
+    EXPECT_EQ(width, 24u);
+    EXPECT_EQ(height, 16u);
+
+    double sum = 0.0;
+    for (float c : counts) sum += c;
+    EXPECT_GT(total, uint64_t(24*16*8));
+    EXPECT_EQ(uint64_t(sum), total);
+}
@@ -0,0 +1,47 @@
+#include "gtest/gtest.h"
+#include "server/InstrumentedMutex.hpp"
+
+#include <thread>
+#include <vector>
+
+using namespace NRenderer;
+
+TEST(InstrumentedMutexTest, MutualExclusion) {
+    InstrumentedMutex m{"Test.MutualExclusion"};
+    int counter = 0;
+    vector<thread> threads;
+    for (int i = 0; i < 4; i++) {
+        threads.emplace_back([&]() {
+            for (int k = 0; k < 10000; k++) {
+                lock_guard<InstrumentedMutex> lock{m};
+                counter++;
+            }
+        });
+    }
+    for (auto& t : threads) t.join();
+    EXPECT_EQ(counter, 40000);
+}
+
+#ifdef NR_LOCK_STATS
+TEST(InstrumentedMutexTest, Counting) {
+    InstrumentedMutex a{"Test.Counting"};
+    InstrumentedMutex b{"Test.Counting"};
+    for (int i = 0; i < 3; i++) {
+        a.lock();
+        a.unlock();
+    }
+    // ͬͬһ
+    EXPECT_TRUE(b.try_lock());
+    b.unlock();
+
+    bool found = false;
+    for (auto& s : getLockStatistics()) {
+        if (s.name == "Test.Counting") {
+            found = true;
+            EXPECT_EQ(s.acquisitions, 4);
+            EXPECT_EQ(s.contended, 0);
+        }
+    }
+    EXPECT_TRUE(found);
+}
+#endif
@@ -0,0 +1,126 @@
+#include "gtest/gtest.h"
+#include "scene/IrradianceVolume.hpp"
+
+#include <cmath>
+
+using namespace NRenderer;
+
+namespace
+{
+    // Ͻƾȷֲķ쳲㼯
+    Vec3 fibonacci(unsigned int i, unsigned int n) {
+        float z = 1.f - (float(i) + 0.5f)*2.f/float(n);
+        float r = std::sqrt(std::max(0.f, 1.f - z*z));
+        float phi = float(i)*2.39996323f;
+        return { r*std::cos(phi), r*std::sin(phi), z };
+    }
+
+    // radianceͶӰõгϵ
+    template<typename F>
+    void project(Vec3* coefficients, F radiance) {
+        constexpr unsigned int N = IrradianceVolume::SH_COEFFICIENTS;
+        const unsigned int count = 4096;
+        float basis[N];
+        for (unsigned int i = 0; i < N; i++) coefficients[i] = Vec3{0.f};
+        for (unsigned int i = 0; i < count; i++) {
+            Vec3 d = fibonacci(i, count);
+            IrradianceVolume::shBasis(d, basis);
+            for (unsigned int k = 0; k < N; k++) coefficients[k] += radiance(d)*basis[k]*(4.f*3.14159265f/float(count));
+        }
+    }
+
+    Scene makeScene(const Vec3& spherePosition) {
+        Scene scene{};
+        Model model{};
+        Sphere s{};
+        s.position = spherePosition;
+        s.radius = 1.f;
+        scene.sphereBuffer.push_back(s);
+        Plane p{};
+        p.normal = { 0, 1, 0 };
+        p.position = { -10, 0, -10 };
+        p.u = { 20, 0, 0 };
+        p.v = { 0, 0, 20 };
+        scene.planeBuffer.push_back(p);
+        for (Index i = 0; i < 2; i++) {
+            Node node{};
+            node.type = i == 0 ? Node::Type::SPHERE : Node::Type::PLANE;
+            node.entity = 0;
+            node.model = 0;
+            model.nodes.push_back(i);
+            scene.nodes.push_back(node);
+        }
+        scene.models.push_back(model);
+        return scene;
+    }
+}
+
+TEST(IrradianceVolumeTest, ShIrradianceOfKnownRadiance) {
+    constexpr unsigned int N = IrradianceVolume::SH_COEFFICIENTS;
+    Vec3 sh[N];
+    // Ϊ1ʱⷨߵķնΪ
+    project(sh, [](const Vec3&) { return Vec3{1.f}; });
+    for (Vec3 n : { Vec3{0, 1, 0}, Vec3{1, 0, 0}, glm::normalize(Vec3{1, -2, 3}) }) {
+        EXPECT_NEAR(IrradianceVolume::shIrradiance(sh, n).x, 3.14159265f, 1e-2f);
+    }
+    // ֻϰйʱϵķնΪУΪ0гĽضڼٷֵ
+    project(sh, [](const Vec3& d) { return Vec3{d.z > 0.f ? 1.f : 0.f}; });
+    EXPECT_NEAR(IrradianceVolume::shIrradiance(sh, {0, 0, 1}).x, 3.14159265f, 0.1f);
+    EXPECT_NEAR(IrradianceVolume::shIrradiance(sh, {0, 0, -1}).x, 0.f, 0.1f);
+    EXPECT_NEAR(IrradianceVolume::shIrradiance(sh, {1, 0, 0}).x, 3.14159265f/2.f, 0.1f);
+}
+
+TEST(IrradianceVolumeTest, InterpolationSkipsInvalidProbes) {
+    constexpr unsigned int N = IrradianceVolume::SH_COEFFICIENTS;
+    IrradianceVolume volume{1, 2, 16, {0, 0, 0}, {4, 1, 1}, 4};
+    ASSERT_EQ(volume.counts, glm::uvec3(4, 1, 1));
+    EXPECT_FLOAT_EQ(volume.position(volume.probe(1, 0, 0)).x, 1.5f);
+    // ̽ķΪ̽x
+    for (size_t p = 0; p < volume.size(); p++) {
+        float x = volume.position(p).x;
+        project(&volume.coefficients[p*N], [x](const Vec3&) { return Vec3{x}; });
+    }
+    Vec3 up{0, 1, 0};
+    // ֮̽ĵ㰴Բֵĵȡ̽
+    EXPECT_NEAR(volume.irradiance({1.0f, 0.5f, 0.5f}, up).x, 1.0f*3.14159265f, 1e-2f);
+    EXPECT_NEAR(volume.irradiance({-5.f, 0.5f, 0.5f}, up).x, 0.5f*3.14159265f, 1e-2f);
+    // Ч̽벻ֵ
+    volume.valid[volume.probe(1, 0, 0)] = 0;
+    EXPECT_NEAR(volume.irradiance({1.0f, 0.5f, 0.5f}, up).x, 0.5f*3.14159265f, 1e-2f);
+    // λڱ汳̽ȨغС
+    volume.valid[volume.probe(1, 0, 0)] = 1;
+    Vec3 e = volume.irradiance({1.0f, 0.5f, 0.5f}, {1, 0, 0});
+    EXPECT_GT(e.x, 1.4f*3.14159265f);
+}
+
+TEST(IrradianceVolumeTest, ChangedBoundsCoverOldAndNewGeometry) {
+    auto before = PreparedSceneCache::prepare(makeScene({0, 2, 0}));
+    auto after = PreparedSceneCache::prepare(makeScene({5, 2, 0}));
+    Vec3 min, max;
+    ASSERT_TRUE(IrradianceVolume::changedBounds(*before, *before, min, max));
+    EXPECT_GT(min.x, max.x);
+    ASSERT_TRUE(IrradianceVolume::changedBounds(*before, *after, min, max));
+    EXPECT_FLOAT_EQ(min.x, -1.f);
+    EXPECT_FLOAT_EQ(max.x, 6.f);
+    EXPECT_FLOAT_EQ(min.y, 1.f);
+
+    IrradianceVolume volume{after->key, 0, 16, after->bvh.nodes[0].min, after->bvh.nodes[0].max, 8};
+    auto near = volume.probesNear(min, max, 1.f);
+    EXPECT_GT(near.size(), 0u);
+    EXPECT_LT(near.size(), volume.size());
+    for (size_t p : near) {
+        Vec3 q = volume.position(p);
+        EXPECT_TRUE(q.x >= -2.f && q.x <= 7.f && q.y >= 0.f && q.y <= 4.f && q.z >= -2.f && q.z <= 2.f);
+    }
+
+    // ͼԪͬʱ޷Ƚ
+    Scene larger = makeScene({0, 2, 0});
+    larger.sphereBuffer.push_back(larger.sphereBuffer[0]);
+    Node node{};
+    node.type = Node::Type::SPHERE;
+    node.entity = 1;
+    node.model = 0;
+    larger.models[0].nodes.push_back(Index(larger.nodes.size()));
+    larger.nodes.push_back(node);
+    EXPECT_FALSE(IrradianceVolume::changedBounds(*before, *PreparedSceneCache::prepare(larger), min, max));
+}
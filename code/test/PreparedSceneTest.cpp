@@ -0,0 +1,371 @@
+#include "gtest/gtest.h"
+#include "scene/PreparedScene.hpp"
+
+#include <cmath>
+#include <random>
+#include <limits>
+#include <thread>
+
+using namespace NRenderer;
+
+namespace
+{
+    // һģµһƽ
+    Scene makeScene(const Vec3& translation) {
+        Scene scene{};
+        Model model{};
+        model.translation = translation;
+        std::mt19937 rng{7};
+        std::uniform_real_distribution<float> pos{-10.f, 10.f};
+        for (Index i = 0; i < 50; i++) {
+            Sphere s{};
+            s.position = { pos(rng), pos(rng), pos(rng) };
+            s.radius = 0.5f;
+            scene.sphereBuffer.push_back(s);
+            Node node{};
+            node.type = Node::Type::SPHERE;
+            node.entity = i;
+            node.model = 0;
+            model.nodes.push_back(Index(scene.nodes.size()));
+            scene.nodes.push_back(node);
+        }
+        Plane p{};
+        p.normal = { 0, 1, 0 };
+        p.position = { -20, -12, -20 };
+        p.u = { 40, 0, 0 };
+        p.v = { 0, 0, 40 };
+        scene.planeBuffer.push_back(p);
+        Node node{};
+        node.type = Node::Type::PLANE;
+        node.entity = 0;
+        node.model = 0;
+        model.nodes.push_back(Index(scene.nodes.size()));
+        scene.nodes.push_back(node);
+        scene.models.push_back(model);
+        return scene;
+    }
+
+    float hitSphere(const Vec3& o, const Vec3& d, const Sphere& s, float tMin, float tMax) {
+        Vec3 oc = o - s.position;
+        float b = glm::dot(oc, d);
+        float c = glm::dot(oc, oc) - s.radius*s.radius;
+        float disc = b*b - c;
+        if (disc < 0) return tMax;
+        float t = -b - std::sqrt(disc);
+        return (t > tMin && t < tMax) ? t : tMax;
+    }
+
+    float hitPlane(const Vec3& o, const Vec3& d, const Plane& p, float tMin, float tMax) {
+        float denom = glm::dot(p.normal, d);
+        if (std::abs(denom) < 1e-6f) return tMax;
+        float t = glm::dot(p.position - o, p.normal)/denom;
+        if (t <= tMin || t >= tMax) return tMax;
+        Vec3 local = o + t*d - p.position;
+        float a = glm::dot(local, p.u)/glm::dot(p.u, p.u);
+        float b = glm::dot(local, p.v)/glm::dot(p.v, p.v);
+        return (a >= 0 && a <= 1 && b >= 0 && b <= 1) ? t : tMax;
+    }
+}
+
+TEST(PreparedSceneTest, CacheKeyedByGeometry) {
+    PreparedSceneCache cache{};
+    Scene scene = makeScene({1, 2, 3});
+    auto first = cache.acquire(scene);
+    // ʡȲӰ켸ε޸л
+    scene.camera.position = {5, 5, 5};
+    auto second = cache.acquire(scene);
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(cache.getHits(), 1u);
+    EXPECT_EQ(cache.getMisses(), 1u);
+    // Ԥλ꣬ԭ޸
+    EXPECT_FLOAT_EQ(first->spheres[0].position.x, scene.sphereBuffer[0].position.x + 1.f);
+
+    Scene moved = makeScene({1, 2, 4});
+    EXPECT_NE(PreparedSceneCache::hashGeometry(moved), PreparedSceneCache::hashGeometry(scene));
+    auto third = cache.acquire(moved);
+    EXPECT_NE(third, first);
+    EXPECT_EQ(cache.getMisses(), 2u);
+}
+
+TEST(PreparedSceneTest, BvhMatchesBruteForce) {
+    auto prepared = PreparedSceneCache::prepare(makeScene({0.5f, 0, 0}));
+    std::mt19937 rng{11};
+    std::uniform_real_distribution<float> dir{-1.f, 1.f};
+    const Vec3 origin{0, 0, 25};
+    const float inf = std::numeric_limits<float>::infinity();
+    for (int k = 0; k < 1000; k++) {
+        Vec3 d = glm::normalize(Vec3{ dir(rng), dir(rng), dir(rng) - 1.f });
+        float expected = inf;
+        for (auto& s : prepared->spheres) expected = hitSphere(origin, d, s, 1e-4f, expected);
+        for (auto& p : prepared->planes) expected = hitPlane(origin, d, p, 1e-4f, expected);
+
+        float actual = inf;
+        prepared->bvh.traverse(origin, d, 1e-4f, inf, [&](const PrimitiveRef& prim, float closest) {
+            if (prim.type == PrimitiveRef::Type::SPHERE) actual = hitSphere(origin, d, prepared->spheres[prim.index], 1e-4f, closest);
+            else actual = hitPlane(origin, d, prepared->planes[prim.index], 1e-4f, closest);
+            return actual;
+        });
+        EXPECT_EQ(actual, expected);
+    }
+}
+
+TEST(PreparedSceneTest, PacketOcclusionMatchesSingleRays) {
+    auto prepared = PreparedSceneCache::prepare(makeScene({0.5f, 0, 0}));
+    std::mt19937 rng{17};
+    std::uniform_real_distribution<float> dir{-1.f, 1.f};
+    std::uniform_real_distribution<float> dist{1.f, 40.f};
+    const Vec3 origin{0, 0, 25};
+    const float inf = std::numeric_limits<float>::infinity();
+    auto hit = [&](const PrimitiveRef& prim, const Vec3& d, float tMax) {
+        if (prim.type == PrimitiveRef::Type::SPHERE) return hitSphere(origin, d, prepared->spheres[prim.index], 1e-4f, tMax);
+        return hitPlane(origin, d, prepared->planes[prim.index], 1e-4f, tMax);
+    };
+    for (int k = 0; k < 250; k++) {
+        RayPacket4 packet{};
+        bool expected[RayPacket4::SIZE];
+        for (int lane = 0; lane < RayPacket4::SIZE; lane++) {
+            Vec3 d = glm::normalize(Vec3{ dir(rng), dir(rng), dir(rng) - 1.f });
+            float tMax = dist(rng);
+            // żһߣδԵĹ߲Ӱ
+            expected[lane] = false;
+            if (k % 5 == 0 && lane == k % RayPacket4::SIZE) continue;
+            packet.set(lane, origin, d, 1e-4f, tMax);
+            float closest = inf;
+            prepared->bvh.traverse(origin, d, 1e-4f, inf, [&](const PrimitiveRef& prim, float c) {
+                closest = hit(prim, d, c);
+                return closest;
+            });
+            expected[lane] = closest >= tMax;
+        }
+        prepared->bvh.occluded4(packet, [&](const PrimitiveRef& prim, int lane) {
+            return hit(prim, packet.directions[lane], packet.tMax[lane]) < packet.tMax[lane];
+        });
+        for (int lane = 0; lane < RayPacket4::SIZE; lane++) {
+            EXPECT_EQ(packet.isActive(lane), expected[lane]);
+        }
+    }
+}
+
+TEST(PreparedSceneTest, IncrementalRefit) {
+    PreparedSceneCache cache{};
+    Scene scene = makeScene({0.5f, 0, 0});
+    auto base = cache.acquire(scene);
+
+    // ¼޸ķΧڵ޸ģBVHṹ
+    scene.changes.clear();
+    scene.sphereBuffer[3].position += Vec3{4, -3, 2};
+    scene.sphereBuffer[7].radius = 2.f;
+    scene.changes.spheres = { 3, 7 };
+    auto refitted = cache.acquire(scene);
+    EXPECT_EQ(cache.getRefits(), 1u);
+    EXPECT_EQ(refitted->key, PreparedSceneCache::hashGeometry(scene));
+    EXPECT_EQ(refitted->bvh.primitives.size(), base->bvh.primitives.size());
+
+    std::mt19937 rng{23};
+    std::uniform_real_distribution<float> dir{-1.f, 1.f};
+    const Vec3 origin{0, 0, 25};
+    const float inf = std::numeric_limits<float>::infinity();
+    for (int k = 0; k < 1000; k++) {
+        Vec3 d = glm::normalize(Vec3{ dir(rng), dir(rng), dir(rng) - 1.f });
+        float expected = inf;
+        for (auto& s : refitted->spheres) expected = hitSphere(origin, d, s, 1e-4f, expected);
+        for (auto& p : refitted->planes) expected = hitPlane(origin, d, p, 1e-4f, expected);
+
+        float actual = inf;
+        refitted->bvh.traverse(origin, d, 1e-4f, inf, [&](const PrimitiveRef& prim, float closest) {
+            if (prim.type == PrimitiveRef::Type::SPHERE) actual = hitSphere(origin, d, refitted->spheres[prim.index], 1e-4f, closest);
+            else actual = hitPlane(origin, d, refitted->planes[prim.index], 1e-4f, closest);
+            return actual;
+        });
+        EXPECT_EQ(actual, expected);
+    }
+
+    // δ¼޸ı
+    scene.sphereBuffer[9].position.x += 1.f;
+    cache.acquire(scene);
+    EXPECT_EQ(cache.getRefits(), 1u);
+    EXPECT_EQ(cache.getMisses(), 3u);
+}
+
+TEST(PreparedSceneTest, LazyBuildMatchesBruteForce) {
+    auto prepared = std::make_shared<PreparedScene>(*PreparedSceneCache::prepare(makeScene({0.5f, 0, 0})));
+    // 51ͼԪֻϲڵ㣬8ͼԪӳٹ
+    prepared->bvh.build(prepared->spheres, prepared->triangles, prepared->planes, 8);
+    ASSERT_TRUE(prepared->bvh.isLazy());
+    EXPECT_EQ(prepared->bvh.builtSubtrees(), 0u);
+    EXPECT_TRUE(prepared->bvh.primitives.empty());
+
+    // ߳ͬʱͬһÿֻһҽһ
+    const Vec3 origin{0, 0, 25};
+    const float inf = std::numeric_limits<float>::infinity();
+    std::vector<int> mismatches(4, 0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&, t]() {
+            std::mt19937 rng{29};
+            std::uniform_real_distribution<float> dir{-1.f, 1.f};
+            for (int k = 0; k < 1000; k++) {
+                Vec3 d = glm::normalize(Vec3{ dir(rng), dir(rng), dir(rng) - 1.f });
+                float expected = inf;
+                for (auto& s : prepared->spheres) expected = hitSphere(origin, d, s, 1e-4f, expected);
+                for (auto& p : prepared->planes) expected = hitPlane(origin, d, p, 1e-4f, expected);
+
+                float actual = inf;
+                prepared->bvh.traverse(origin, d, 1e-4f, inf, [&](const PrimitiveRef& prim, float closest) {
+                    if (prim.type == PrimitiveRef::Type::SPHERE) actual = hitSphere(origin, d, prepared->spheres[prim.index], 1e-4f, closest);
+                    else actual = hitPlane(origin, d, prepared->planes[prim.index], 1e-4f, closest);
+                    return actual;
+                });
+                if (actual != expected) mismatches[t]++;
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    for (int m : mismatches) EXPECT_EQ(m, 0);
+    EXPECT_GT(prepared->bvh.builtSubtrees(), 0u);
+    EXPECT_LE(prepared->bvh.builtSubtrees(), prepared->bvh.subtrees.size());
+}
+
+TEST(PreparedSceneTest, ParallelBuildMatchesSerial) {
+    std::vector<Sphere> spheres;
+    std::mt19937 rng{31};
+    std::uniform_real_distribution<float> pos{-50.f, 50.f};
+    for (int i = 0; i < 10000; i++) {
+        Sphere s{};
+        s.position = { pos(rng), pos(rng), pos(rng) };
+        s.radius = 0.5f;
+        spheres.push_back(s);
+    }
+    SceneBvh serial{}, parallel{};
+    serial.build(spheres, {}, {});
+    parallel.build(spheres, {}, {}, 0, 4);
+    EXPECT_FALSE(parallel.isLazy());
+    ASSERT_EQ(parallel.nodes.size(), serial.nodes.size());
+    ASSERT_EQ(parallel.primitives.size(), serial.primitives.size());
+    for (size_t i = 0; i < serial.nodes.size(); i++) {
+        EXPECT_EQ(parallel.nodes[i].min, serial.nodes[i].min);
+        EXPECT_EQ(parallel.nodes[i].max, serial.nodes[i].max);
+        EXPECT_EQ(parallel.nodes[i].offset, serial.nodes[i].offset);
+        EXPECT_EQ(parallel.nodes[i].count, serial.nodes[i].count);
+        EXPECT_EQ(parallel.nodes[i].axis, serial.nodes[i].axis);
+    }
+    for (size_t i = 0; i < serial.primitives.size(); i++) {
+        EXPECT_EQ(parallel.primitives[i].index, serial.primitives[i].index);
+    }
+}
+
+TEST(PreparedSceneTest, GridMatchesBruteForce) {
+    Scene scene = makeScene({0.5f, 0, 0});
+    scene.renderOption.accelerator = RenderOption::Accelerator::GRID;
+    auto prepared = PreparedSceneCache::prepare(scene);
+    ASSERT_EQ(prepared->accelerator, RenderOption::Accelerator::GRID);
+    EXPECT_FALSE(prepared->grid.subgrids.empty());
+    std::mt19937 rng{37};
+    std::uniform_real_distribution<float> dir{-1.f, 1.f};
+    std::uniform_real_distribution<float> pos{-30.f, 30.f};
+    const float inf = std::numeric_limits<float>::infinity();
+    auto hit = [&](const PrimitiveRef& prim, const Vec3& o, const Vec3& d, float tMax) {
+        if (prim.type == PrimitiveRef::Type::SPHERE) return hitSphere(o, d, prepared->spheres[prim.index], 1e-4f, tMax);
+        return hitPlane(o, d, prepared->planes[prim.index], 1e-4f, tMax);
+    };
+    for (int k = 0; k < 2000; k++) {
+        // ⶼУֹ᷽
+        Vec3 origin{ pos(rng), pos(rng), pos(rng) };
+        Vec3 d{ dir(rng), dir(rng), dir(rng) };
+        if (k % 7 == 0) d[k % 3] = 0.f;
+        d = glm::normalize(d);
+        float expected = inf;
+        for (auto& s : prepared->spheres) expected = hitSphere(origin, d, s, 1e-4f, expected);
+        for (auto& p : prepared->planes) expected = hitPlane(origin, d, p, 1e-4f, expected);
+
+        float actual = inf;
+        prepared->traverse(origin, d, 1e-4f, inf, [&](const PrimitiveRef& prim, float closest) {
+            actual = hit(prim, origin, d, closest);
+            return actual;
+        });
+        EXPECT_EQ(actual, expected);
+
+        RayPacket4 packet{};
+        float tMax = expected == inf ? 10.f : expected*(k % 2 == 0 ? 0.5f : 1.5f);
+        packet.set(k % RayPacket4::SIZE, origin, d, 1e-4f, tMax);
+        prepared->occluded4(packet, [&](const PrimitiveRef& prim, int lane) {
+            return hit(prim, packet.origins[lane], packet.directions[lane], packet.tMax[lane]) < packet.tMax[lane];
+        });
+        EXPECT_EQ(packet.isActive(k % RayPacket4::SIZE), expected >= tMax);
+    }
+}
+
+TEST(PreparedSceneTest, GridChosenForUniformDistributions) {
+    std::vector<Sphere> uniform, clustered;
+    std::mt19937 rng{41};
+    std::uniform_real_distribution<float> pos{-50.f, 50.f};
+    for (int i = 0; i < 10000; i++) {
+        Sphere s{};
+        s.position = { pos(rng), pos(rng), pos(rng) };
+        s.radius = 0.5f;
+        uniform.push_back(s);
+        // 󲿷弯ںСڣɢ
+        if (i >= 100) s.position *= 0.01f;
+        clustered.push_back(s);
+    }
+    SceneGrid serial{}, parallel{}, rejected{};
+    EXPECT_TRUE(serial.build(uniform, {}, {}, 1, true));
+    EXPECT_TRUE(parallel.build(uniform, {}, {}, 4, true));
+    EXPECT_FALSE(rejected.build(clustered, {}, {}, 4, true));
+    EXPECT_TRUE(rejected.empty());
+
+    // й뵥̹߳Ľͬ
+    EXPECT_EQ(parallel.resolution, serial.resolution);
+    ASSERT_EQ(parallel.cells.size(), serial.cells.size());
+    ASSERT_EQ(parallel.primitives.size(), serial.primitives.size());
+    for (size_t i = 0; i < serial.cells.size(); i++) {
+        EXPECT_EQ(parallel.cells[i].offset, serial.cells[i].offset);
+        EXPECT_EQ(parallel.cells[i].count, serial.cells[i].count);
+    }
+    for (size_t i = 0; i < serial.primitives.size(); i++) {
+        EXPECT_EQ(parallel.primitives[i].index, serial.primitives[i].index);
+    }
+}
+
+TEST(PreparedSceneTest, GridCountingSortMatchesSerial) {
+    // λϣԷΪΣοԽԪ
+    std::vector<Sphere> spheres;
+    std::vector<Triangle> triangles;
+    std::mt19937 rng{43};
+    std::uniform_real_distribution<float> pos{-40.f, 40.f};
+    std::uniform_real_distribution<float> edge{-3.f, 3.f};
+    for (int i = 0; i < 30000; i++) {
+        Sphere s{};
+        s.position = { pos(rng), pos(rng), pos(rng) };
+        s.radius = i % 50 == 0 ? 4.f : 0.3f;
+        spheres.push_back(s);
+    }
+    for (int i = 0; i < 20000; i++) {
+        Triangle t{};
+        t.v1 = { pos(rng), pos(rng), pos(rng) };
+        t.v2 = t.v1 + Vec3{ edge(rng), edge(rng), edge(rng) };
+        t.v3 = t.v1 + Vec3{ edge(rng), edge(rng), edge(rng) };
+        triangles.push_back(t);
+    }
+    SceneGrid serial{};
+    ASSERT_TRUE(serial.build(spheres, triangles, {}, 1, false));
+    for (unsigned int threads : { 3u, 7u, 32u }) {
+        SceneGrid parallel{};
+        ASSERT_TRUE(parallel.build(spheres, triangles, {}, threads, false));
+        EXPECT_EQ(parallel.resolution, serial.resolution);
+        ASSERT_EQ(parallel.cells.size(), serial.cells.size());
+        ASSERT_EQ(parallel.subgrids.size(), serial.subgrids.size());
+        ASSERT_EQ(parallel.primitives.size(), serial.primitives.size());
+        size_t mismatches = 0;
+        for (size_t i = 0; i < serial.cells.size(); i++) {
+            if (parallel.cells[i].offset != serial.cells[i].offset || parallel.cells[i].count != serial.cells[i].count) mismatches++;
+        }
+        for (size_t i = 0; i < serial.subgrids.size(); i++) {
+            if (parallel.subgrids[i].firstCell != serial.subgrids[i].firstCell) mismatches++;
+        }
+        for (size_t i = 0; i < serial.primitives.size(); i++) {
+            if (parallel.primitives[i].type != serial.primitives[i].type || parallel.primitives[i].index != serial.primitives[i].index) mismatches++;
+        }
+        EXPECT_EQ(mismatches, 0u) << threads << " threads";
+    }
+}
@@ -0,0 +1,127 @@
+#include "gtest/gtest.h"
+#include "scene/RayQuery.hpp"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace NRenderer;
+
+namespace
+{
+    // һ
+    SharedPreparedScene makeScene() {
+        Scene scene{};
+        Model model{};
+        std::mt19937 rng{11};
+        std::uniform_real_distribution<float> pos{-10.f, 10.f};
+        for (Index i = 0; i < 200; i++) {
+            Sphere s{};
+            s.position = { pos(rng), pos(rng), pos(rng) };
+            s.radius = 0.4f;
+            scene.sphereBuffer.push_back(s);
+            Node node{};
+            node.type = Node::Type::SPHERE;
+            node.entity = i;
+            node.model = 0;
+            model.nodes.push_back(Index(scene.nodes.size()));
+            scene.nodes.push_back(node);
+        }
+        Plane p{};
+        p.normal = { 0, 1, 0 };
+        p.position = { -20, -12, -20 };
+        p.u = { 40, 0, 0 };
+        p.v = { 0, 0, 40 };
+        scene.planeBuffer.push_back(p);
+        Node node{};
+        node.type = Node::Type::PLANE;
+        node.entity = 0;
+        node.model = 0;
+        model.nodes.push_back(Index(scene.nodes.size()));
+        scene.nodes.push_back(node);
+        scene.models.push_back(model);
+        return PreparedSceneCache::prepare(scene);
+    }
+
+    std::vector<RayIn> makeRays(size_t count, float tMax) {
+        std::mt19937 rng{3};
+        std::uniform_real_distribution<float> dir{-1.f, 1.f};
+        std::vector<RayIn> rays(count);
+        for (auto& ray : rays) {
+            ray.origin = { 0, 15, 0 };
+            ray.direction = glm::normalize(Vec3{ dir(rng), -1.f, dir(rng) });
+            ray.tMin = 0.01f;
+            ray.tMax = tMax;
+        }
+        return rays;
+    }
+
+    // ͼԪཻΪ
+    float bruteForce(const PreparedScene& scene, const RayIn& ray) {
+        float closest = ray.tMax;
+        for (auto& s : scene.spheres) {
+            Vec3 oc = ray.origin - s.position;
+            float b = glm::dot(oc, ray.direction);
+            float c = glm::dot(oc, oc) - s.radius*s.radius;
+            float disc = b*b - c;
+            if (disc <= 0) continue;
+            float t = -b - std::sqrt(disc);
+            if (t > ray.tMin && t < closest) closest = t;
+        }
+        for (auto& p : scene.planes) {
+            float t = (glm::dot(p.position, p.normal) - glm::dot(p.normal, ray.origin))/glm::dot(ray.direction, p.normal);
+            Vec3 local = ray.origin + t*ray.direction - p.position;
+            float a = glm::dot(local, p.u)/glm::dot(p.u, p.u);
+            float b = glm::dot(local, p.v)/glm::dot(p.v, p.v);
+            if (a >= 0 && a <= 1 && b >= 0 && b <= 1 && t > ray.tMin && t < closest) closest = t;
+        }
+        return closest;
+    }
+}
+
+TEST(RayQueryTest, BatchMatchesBruteForce) {
+    auto prepared = makeScene();
+    auto rays = makeRays(1000, std::numeric_limits<float>::infinity());
+    std::vector<HitOut> hits(rays.size());
+    RayQuery::intersect(*prepared, rays, hits);
+    size_t hitCount = 0;
+    for (size_t i = 0; i < rays.size(); i++) {
+        float expected = bruteForce(*prepared, rays[i]);
+        ASSERT_EQ(hits[i].hit(), expected != rays[i].tMax) << i;
+        if (!hits[i].hit()) continue;
+        hitCount++;
+        EXPECT_NEAR(hits[i].t, expected, 1e-3f) << i;
+        EXPECT_NEAR(glm::length(hits[i].normal), 1.f, 1e-3f);
+        EXPECT_NEAR(glm::length(hits[i].position - (rays[i].origin + hits[i].t*rays[i].direction)), 0.f, 1e-3f);
+    }
+    EXPECT_GT(hitCount, 0u);
+}
+
+TEST(RayQueryTest, OcclusionMatchesIntersect) {
+    auto prepared = makeScene();
+    // ޵tMaxʹһֹڵǰ
+    auto rays = makeRays(1001, 20.f);
+    std::vector<HitOut> hits(rays.size());
+    std::vector<uint8_t> blocked(rays.size());
+    RayQuery::intersect(*prepared, rays, hits);
+    RayQuery::occluded(*prepared, rays, blocked);
+    for (size_t i = 0; i < rays.size(); i++) {
+        EXPECT_EQ(blocked[i] != 0, hits[i].hit()) << i;
+    }
+}
+
+TEST(RayQueryTest, ParallelBatchMatchesSerial) {
+    auto prepared = makeScene();
+    auto rays = makeRays(RayQuery::PARALLEL_BATCH_SIZE*3 + 5, 20.f);
+    std::vector<HitOut> serial(rays.size()), parallel(rays.size());
+    std::vector<uint8_t> serialBlocked(rays.size()), parallelBlocked(rays.size());
+    RayQuery::intersect(*prepared, rays, serial);
+    RayQuery::intersect(*prepared, rays, parallel, 4);
+    RayQuery::occluded(*prepared, rays, serialBlocked);
+    RayQuery::occluded(*prepared, rays, parallelBlocked, 4);
+    for (size_t i = 0; i < rays.size(); i++) {
+        ASSERT_EQ(serial[i].t, parallel[i].t) << i;
+        ASSERT_EQ(serial[i].primitive.index, parallel[i].primitive.index) << i;
+        ASSERT_EQ(serialBlocked[i], parallelBlocked[i]) << i;
+    }
+}
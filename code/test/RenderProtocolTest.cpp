@@ -0,0 +1,51 @@
+#include "gtest/gtest.h"
+#include "RenderProtocol.hpp"
+
+#include <cstdio>
+
+using namespace NRenderer;
+
+namespace
+{
+    // ڱ׽ϽһĶ˵㣬client󣬷صserverreceiveJob
+    LocalSocket connectPair(const string& path, LocalSocket& client) {
+        LocalSocket listener;
+        if (!listener.listen(path) || !client.connect(path)) return LocalSocket{};
+        auto server = listener.accept();
+        std::remove(path.c_str());
+        return server;
+    }
+}
+
+// ճգʱڴ沢Э
+TEST(RenderProtocolTest, InlineSceneLimit) {
+    const string path = "nr_protocol_test.sock";
+    {
+        LocalSocket client;
+        auto server = connectPair(path, client);
+        ASSERT_TRUE(server.valid());
+        RenderJob job;
+        job.inlineScene = true;
+        job.sceneText = "Begin\nEnd\n";
+        ASSERT_TRUE(sendJob(client, job));
+        string line;
+        ASSERT_TRUE(server.recvLine(line));
+        ASSERT_EQ(line, "Job");
+        RenderJob received;
+        string error;
+        EXPECT_TRUE(receiveJob(server, received, error));
+        EXPECT_TRUE(received.inlineScene);
+        EXPECT_EQ(received.sceneText, job.sceneText);
+    }
+    {
+        LocalSocket client;
+        auto server = connectPair(path, client);
+        ASSERT_TRUE(server.valid());
+        ASSERT_TRUE(client.sendLine("Inline " + to_string(MAX_INLINE_SCENE_BYTES + 1)));
+        RenderJob received;
+        string error;
+        EXPECT_FALSE(receiveJob(server, received, error));
+        EXPECT_NE(error.find("too large"), string::npos);
+        EXPECT_TRUE(received.sceneText.empty());
+    }
+}
@@ -0,0 +1,84 @@
+#include "gtest/gtest.h"
+#include "scene/SceneGenerator.hpp"
+#include "scene/ScnParser.hpp"
+
+#include <cstdio>
+
+using namespace NRenderer;
+
+namespace
+{
+    void expectNear(const Vec3& a, const Vec3& b) {
+        EXPECT_NEAR(a.x, b.x, 1e-3f);
+        EXPECT_NEAR(a.y, b.y, 1e-3f);
+        EXPECT_NEAR(a.z, b.z, 1e-3f);
+    }
+}
+
+// д.scnScnParserӦֱɵĳһ
+// ͼԪԴ֣ǿлʱBegin/End
+TEST(SceneGeneratorTest, ScnRoundTrip) {
+    GeneratorOptions options;
+    options.spheres = 50;
+    options.meshes = 2;
+    options.meshTriangles = 120;
+    options.terrainTriangles = 64;
+    options.areaLights = 3;
+    options.gridX = 2;
+    options.gridY = 1;
+    options.gridZ = 2;
+    options.instanceTriangles = 20;
+    SceneGenerator generator{options};
+    auto expected = generator.generate();
+    ASSERT_TRUE(generator.writeScn("scene_generator_test.scn")) << generator.getErrorInfo();
+
+    ScnParser parser;
+    auto parsed = parser.parseFile("scene_generator_test.scn");
+    remove("scene_generator_test.scn");
+    ASSERT_NE(parsed, nullptr) << parser.getErrorInfo();
+
+    ASSERT_EQ(parsed->materials.size(), expected->materials.size());
+    for (size_t i = 0; i < expected->materials.size(); i++) {
+        EXPECT_EQ(parsed->materials[i].type, expected->materials[i].type);
+        EXPECT_EQ(parsed->materials[i].properties.size(), expected->materials[i].properties.size());
+    }
+
+    ASSERT_EQ(parsed->models.size(), expected->models.size());
+    for (size_t i = 0; i < expected->models.size(); i++) {
+        expectNear(parsed->models[i].translation, expected->models[i].translation);
+        EXPECT_EQ(parsed->models[i].nodes, expected->models[i].nodes);
+    }
+    ASSERT_EQ(parsed->nodes.size(), expected->nodes.size());
+    for (size_t i = 0; i < expected->nodes.size(); i++) {
+        EXPECT_EQ(parsed->nodes[i].type, expected->nodes[i].type);
+        EXPECT_EQ(parsed->nodes[i].entity, expected->nodes[i].entity);
+        EXPECT_EQ(parsed->nodes[i].model, expected->nodes[i].model);
+    }
+
+    ASSERT_EQ(parsed->sphereBuffer.size(), expected->sphereBuffer.size());
+    for (size_t i = 0; i < expected->sphereBuffer.size(); i++) {
+        auto& a = parsed->sphereBuffer[i];
+        auto& b = expected->sphereBuffer[i];
+        expectNear(a.position, b.position);
+        EXPECT_NEAR(a.radius, b.radius, 1e-3f);
+        EXPECT_EQ(a.material.index(), b.material.index());
+    }
+    ASSERT_EQ(parsed->triangleBuffer.size(), expected->triangleBuffer.size());
+    for (size_t i = 0; i < expected->triangleBuffer.size(); i++) {
+        auto& a = parsed->triangleBuffer[i];
+        auto& b = expected->triangleBuffer[i];
+        for (int k = 0; k < 3; k++) expectNear(a.v[k], b.v[k]);
+        EXPECT_EQ(a.material.index(), b.material.index());
+    }
+
+    ASSERT_EQ(parsed->lights.size(), expected->lights.size());
+    ASSERT_EQ(parsed->areaLightBuffer.size(), expected->areaLightBuffer.size());
+    for (size_t i = 0; i < expected->areaLightBuffer.size(); i++) {
+        auto& a = parsed->areaLightBuffer[i];
+        auto& b = expected->areaLightBuffer[i];
+        expectNear(a.radiance, b.radiance);
+        expectNear(a.position, b.position);
+        expectNear(a.u, b.u);
+        expectNear(a.v, b.v);
+    }
+}
@@ -0,0 +1,134 @@
+#include "gtest/gtest.h"
+#include "shaders/ShaderCreator.hpp"
+
+#include <cmath>
+#include <random>
+
+using namespace SimplePathTracer;
+using PW = Property::Wrapper;
+
+namespace
+{
+    const int SAMPLES = 200000;
+    const Vec3 NORMAL{0, 0, 1};
+
+    // 뷨߳thetaǵķ䣬ߴϷָԭ
+    Ray incoming(float theta) {
+        return Ray{Vec3{0, 0, 1}, Vec3{std::sin(theta), 0, -std::cos(theta)}};
+    }
+
+    // ɫ¯ȴΪ1ʱʲƵķȣtraceͬ·Ȩ attenuation|cos|/pdf
+    double bsdfFurnace(const Shader& shader, float theta) {
+        Ray ray = incoming(theta);
+        double sum = 0.0;
+        for (int i = 0; i < SAMPLES; i++) {
+            auto scattered = shader.shade(ray, Vec3{0}, NORMAL);
+            if (!(scattered.pdf > 0.f)) continue;
+            float cosTheta = std::abs(glm::dot(NORMAL, scattered.ray.direction));
+            sum += (scattered.attenuation * cosTheta / scattered.pdf).x;
+        }
+        return sum/SAMPLES;
+    }
+
+    // ͬһɫ¯¹Դ·ĹƣevaluateDirectLightingڰϾȲĻ
+    double lightFurnace(const Shader& shader, float theta) {
+        Ray ray = incoming(theta);
+        AreaLight light{};
+        light.radiance = Vec3{1};
+        std::mt19937 rng{7};
+        std::uniform_real_distribution<float> uniform{0.f, 1.f};
+        double sum = 0.0;
+        for (int i = 0; i < SAMPLES; i++) {
+            float z = uniform(rng), phi = 2*PI*uniform(rng), r = std::sqrt(1 - z*z);
+            Vec3 wi{r*std::cos(phi), r*std::sin(phi), z};
+            sum += shader.evaluateDirectLighting(ray, Vec3{0}, NORMAL, light, wi, 1.f).x*2*PI;
+        }
+        return sum/SAMPLES;
+    }
+
+    SharedShader makeShader(Material& material) {
+        static vector<Texture> textures;
+        return ShaderCreator{}.create(material, textures);
+    }
+}
+
+// 䣺Ϊ1LambertianֹƶӦ1
+TEST(ShaderEnergyTest, DiffuseLobe) {
+    Material lambertian;
+    lambertian.type = 0;
+    lambertian.registerProperty("diffuseColor", PW::RGBType{RGB{1}});
+    auto shader = makeShader(lambertian);
+    EXPECT_TRUE(shader->lobes().sampleLights());
+    for (float theta : {0.f, 1.f, 1.4f}) {
+        EXPECT_NEAR(bsdfFurnace(*shader, theta), 1.0, 0.02);
+        EXPECT_NEAR(lightFurnace(*shader, theta), 1.0, 0.02);
+    }
+}
+
+// delta꣺·ȨǡΪalbedo沨겻ԹԴ
+TEST(ShaderEnergyTest, DeltaLobes) {
+    Material mirror;
+    mirror.type = 1;
+    mirror.registerProperty("albedo", PW::RGBType{RGB{1}});
+    mirror.registerProperty("roughness", PW::FloatType{0.f});
+    auto metal = makeShader(mirror);
+    EXPECT_FALSE(metal->lobes().sampleLights());
+
+    Material glass;
+    glass.type = 2;
+    auto dielectric = makeShader(glass);
+    EXPECT_FALSE(dielectric->lobes().sampleLights());
+
+    for (float theta : {0.f, 1.f, 1.4f}) {
+        EXPECT_NEAR(bsdfFurnace(*metal, theta), 1.0, 1e-3);
+        // 벣ʱȳ(1/1.5)^21
+        double transmitted = bsdfFurnace(*dielectric, theta);
+        EXPECT_LE(transmitted, 1.0 + 1e-3);
+        EXPECT_GE(transmitted, 1.0/(1.5*1.5) - 1e-3);
+    }
+}
+
+// 󲨰꣺۴ֲڶȶԹԴʲԴֹһ£1
+TEST(ShaderEnergyTest, GlossyLobes) {
+    vector<Material> materials;
+    for (float roughness : {0.02f, 0.2f, 1.f}) {
+        Material metal;
+        metal.type = 1;
+        metal.registerProperty("albedo", PW::RGBType{RGB{1}});
+        metal.registerProperty("roughness", PW::FloatType{roughness});
+        materials.push_back(metal);
+    }
+    for (float roughness : {0.3f, 1.f}) {
+        Material disney;
+        disney.type = 5;
+        disney.registerProperty("baseColor", PW::RGBType{RGB{1}});
+        disney.registerProperty("metallic", PW::FloatType{1.f});
+        disney.registerProperty("roughness", PW::FloatType{roughness});
+        materials.push_back(disney);
+    }
+    for (auto& material : materials) {
+        auto shader = makeShader(material);
+        EXPECT_TRUE(shader->lobes().sampleLights());
+        for (float theta : {0.f, 1.f, 1.4f}) {
+            double bsdf = bsdfFurnace(*shader, theta);
+            EXPECT_LE(bsdf, 1.0 + 0.02);
+            EXPECT_NEAR(bsdf, lightFurnace(*shader, theta), 0.03);
+        }
+    }
+}
+
+// Disneyǽ+󲨰꣩BurleyǸ΢ƫҪ󲻳10%
+TEST(ShaderEnergyTest, DiffuseAndGlossyLobes) {
+    Material disney;
+    disney.type = 5;
+    disney.registerProperty("baseColor", PW::RGBType{RGB{1}});
+    disney.registerProperty("metallic", PW::FloatType{0.f});
+    disney.registerProperty("roughness", PW::FloatType{0.5f});
+    auto shader = makeShader(disney);
+    EXPECT_TRUE(shader->lobes().sampleLights());
+    for (float theta : {0.f, 1.f}) {
+        double bsdf = bsdfFurnace(*shader, theta);
+        EXPECT_LE(bsdf, 1.1);
+        EXPECT_NEAR(bsdf, lightFurnace(*shader, theta), 0.03);
+    }
+}
@@ -0,0 +1,99 @@
+#include "gtest/gtest.h"
+#include "server/SharedFrameBuffer.hpp"
+
+#include <vector>
+#include <thread>
+#include <atomic>
+
+using namespace NRenderer;
+
+namespace
+{
+    const char* NAME = "nrenderer_shared_frame_test";
+
+    vector<RGBA> uniformFrame(unsigned int w, unsigned int h, float v) {
+        return vector<RGBA>(size_t(w)*h, RGBA{v, v, v, 1.f});
+    }
+}
+
+TEST(SharedFrameBufferTest, WriteReadRetire) {
+    SharedFrameBuffer writer;
+    ASSERT_TRUE(writer.create(NAME, 4, 4));
+    SharedFrameReader reader;
+    ASSERT_TRUE(reader.open(NAME));
+
+    auto frame = uniformFrame(4, 4, 0.25f);
+    frame[5] = {1.f, 0.f, 0.f, 1.f};
+    writer.publish(frame.data(), 4, 4);
+
+    vector<RGBA> pixels;
+    unsigned int w = 0, h = 0;
+    uint64_t count = 0;
+    ASSERT_TRUE(reader.read(pixels, w, h, count));
+    EXPECT_EQ(w, 4u);
+    EXPECT_EQ(h, 4u);
+    EXPECT_EQ(count, 1u);
+    ASSERT_EQ(pixels.size(), frame.size());
+    EXPECT_EQ(pixels[5], frame[5]);
+    EXPECT_EQ(pixels[0], frame[0]);
+
+    // ֮֡ǰĶȡЧ
+    auto seq = reader.beginRead();
+    EXPECT_TRUE(reader.validate(seq));
+    writer.publish(frame.data(), 2, 2);
+    EXPECT_FALSE(reader.validate(seq));
+    EXPECT_FALSE(reader.isRetired());
+
+    // ʱдؽڴΣɶαΪȡȡʱԶ´
+    auto large = uniformFrame(8, 8, 0.5f);
+    writer.publish(large.data(), 8, 8);
+    EXPECT_TRUE(reader.isRetired());
+    ASSERT_TRUE(reader.read(pixels, w, h, count));
+    EXPECT_FALSE(reader.isRetired());
+    EXPECT_EQ(w, 8u);
+    EXPECT_EQ(h, 8u);
+    EXPECT_EQ(count, 3u);
+    EXPECT_EQ(pixels.back(), large.back());
+
+    // д˹رպȡĶαȡ޷ٴ
+    writer.close();
+    EXPECT_TRUE(reader.isRetired());
+    EXPECT_FALSE(reader.read(pixels, w, h, count));
+}
+
+TEST(SharedFrameBufferTest, ConcurrentReadsAreConsistent) {
+    const unsigned int w = 64, h = 64, frames = 300;
+    SharedFrameBuffer writer;
+    ASSERT_TRUE(writer.create(NAME, w, h));
+    SharedFrameReader reader;
+    ASSERT_TRUE(reader.open(NAME));
+
+    // ÿһ֡ض֡ţ֡˵˳ʧЧ
+    atomic<bool> done{false};
+    thread t([&]() {
+        for (unsigned int k = 1; k <= frames; k++) {
+            auto frame = uniformFrame(w, h, float(k));
+            writer.publish(frame.data(), w, h);
+        }
+        done = true;
+    });
+    vector<RGBA> pixels;
+    unsigned int rw = 0, rh = 0;
+    uint64_t count = 0;
+    bool consistent = true;
+    while (!done && consistent) {
+        ASSERT_TRUE(reader.read(pixels, rw, rh, count));
+        if (count == 0) continue;
+        for (auto& p : pixels) {
+            if (p.x != float(count)) {
+                consistent = false;
+                break;
+            }
+        }
+    }
+    t.join();
+    EXPECT_TRUE(consistent);
+    ASSERT_TRUE(reader.read(pixels, rw, rh, count));
+    EXPECT_EQ(count, frames);
+    EXPECT_EQ(pixels.front().x, float(frames));
+}
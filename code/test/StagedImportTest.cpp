@@ -0,0 +1,160 @@
+#include "gtest/gtest.h"
+#include "scene/ScnParser.hpp"
+#include "scene/ObjParser.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <limits>
+
+using namespace NRenderer;
+
+namespace
+{
+    void writeFile(const string& path, const string& text) {
+        ofstream file(path, ios::binary);
+        file<<text;
+    }
+
+    const char* SCN_TEXT =
+        "Begin Material\n"
+        "Material red 0\n"
+        "Prop diffuseColor RGB 1 0 0\n"
+        "\n"
+        "Material blue 0\n"
+        "Prop diffuseColor RGB 0 0 1\n"
+        "End\n"
+        "\n"
+        "Begin Model\n"
+        "Model box\n"
+        "Translation 0 0 0\n"
+        "Sphere ball blue\n"
+        "P 0 0 0\n"
+        "N 0 1 0\n"
+        "R 1\n"
+        "End\n"
+        "\n"
+        "Begin Light\n"
+        "Area top\n"
+        "IRV 1 1 1\n"
+        "P 0 5 0\n"
+        "U 1 0 0\n"
+        "V 0 0 1\n"
+        "End\n";
+}
+
+TEST(StagedImportTest, StagesScn) {
+    ScnParser parser;
+    StagedScene staged;
+    stringstream ss{SCN_TEXT};
+    ASSERT_TRUE(parser.stage(ss, staged)) << parser.getErrorInfo();
+    ASSERT_EQ(staged.materialNames.size(), 2u);
+    EXPECT_EQ(staged.materialNames[1], "blue");
+    ASSERT_EQ(staged.modelNames.size(), 1u);
+    ASSERT_EQ(staged.nodeNames.size(), 1u);
+    EXPECT_EQ(staged.nodeNames[0], "ball");
+    ASSERT_EQ(staged.lightNames.size(), 1u);
+    EXPECT_EQ(staged.lightNames[0], "top");
+    ASSERT_EQ(staged.scene.sphereBuffer.size(), 1u);
+    EXPECT_EQ(staged.scene.sphereBuffer[0].material.index(), 1u);
+}
+
+TEST(StagedImportTest, StagesObjWithMaterials) {
+    writeFile("staged_import_test.mtl",
+        "newmtl first\n"
+        "Kd 1 0 0\n"
+        "newmtl second\n"
+        "Kd 0 1 0\n"
+        "map_Kd wood.png\n");
+    writeFile("staged_import_test.obj",
+        "mtllib staged_import_test.mtl\n"
+        "v 0 0 0\nv 1 0 0\nv 0 1 0\nv 1 1 0\n"
+        "vn 0 0 1\n"
+        "o quad\n"
+        "usemtl second\n"
+        "f 1//1 2//1 3//1\n"
+        "f 2//1 4//1 3//1\n");
+
+    ObjParser parser;
+    StagedScene staged;
+    ImportProgress progress;
+    ASSERT_TRUE(parser.stageFile("staged_import_test.obj", staged, &progress)) << parser.getErrorInfo();
+    EXPECT_FLOAT_EQ(progress.get(), 1.f);
+
+    ASSERT_EQ(staged.materialNames.size(), 2u);
+    ASSERT_EQ(staged.texturePaths.size(), 1u);
+    EXPECT_EQ(staged.textureNames[0], "wood.png");
+    ASSERT_EQ(staged.modelNames.size(), 1u);
+    EXPECT_EQ(staged.modelNames[0], "staged_import_test.obj");
+    ASSERT_EQ(staged.nodeNames.size(), 1u);
+    EXPECT_EQ(staged.nodeNames[0], "quad");
+
+    ASSERT_EQ(staged.scene.meshBuffer.size(), 1u);
+    auto& mesh = staged.scene.meshBuffer[0];
+    // ±ָusemtlõĲ
+    EXPECT_EQ(mesh.material.index(), 1u);
+    EXPECT_EQ(mesh.positions.size(), 4u);
+    EXPECT_EQ(mesh.normals.size(), 1u);
+    EXPECT_EQ(mesh.positionIndices.size(), 6u);
+
+    remove("staged_import_test.obj");
+    remove("staged_import_test.mtl");
+}
+
+TEST(StagedImportTest, RejectsBadObj) {
+    writeFile("staged_import_bad.obj", "v 0 0 0\nv 1 0 0\nf 1 2 3\n");
+    ObjParser parser;
+    StagedScene staged;
+    EXPECT_FALSE(parser.stageFile("staged_import_bad.obj", staged));
+    remove("staged_import_bad.obj");
+}
+
+TEST(StagedImportTest, Cancel) {
+    // 㹻У֤лȡ
+    string text = "Begin Model\nModel big\nTranslation 0 0 0\n";
+    for (int i = 0; i < 20000; i++) text += "# padding\n";
+    text += "End\n";
+    ScnParser parser;
+    StagedScene staged;
+    ImportProgress progress;
+    progress.cancel();
+    stringstream ss{text};
+    EXPECT_FALSE(parser.stage(ss, staged, &progress));
+    EXPECT_EQ(parser.getErrorInfo(), "Import cancelled.");
+}
+
+TEST(StagedImportTest, ScnNumbersMatchStreamExtraction) {
+    // ֵȡԭ>>ȡһ£ȡʧܵõ0Ҹֵ֮Ϊ0
+    string text =
+        "Begin Material\r\n"
+        "Material m -1\r\n"
+        "Prop a Vec3 +1.5 .25 -2e1\r\n"
+        "Prop b Vec3 1e 2 3\r\n"
+        "Prop c Vec3 4 inf 5\r\n"
+        "Prop d Int 7.9\r\n"
+        "End\r\n"
+        "Begin Model\r\n"
+        "Model box\r\n"
+        "Sphere ball m\r\n"
+        "R 1e40\r\n";
+    writeFile("staged_import_numbers.scn", text);
+    ScnParser parser;
+    StagedScene staged;
+    ASSERT_TRUE(parser.stageFile("staged_import_numbers.scn", staged)) << parser.getErrorInfo();
+    remove("staged_import_numbers.scn");
+
+    auto& material = staged.scene.materials[0];
+    EXPECT_EQ(material.type, 0xFFFFFFFFu);
+    EXPECT_EQ(material.getProperty<Property::Wrapper::Vec3Type>("a")->value, Vec3(1.5f, 0.25f, -20.f));
+    EXPECT_EQ(material.getProperty<Property::Wrapper::Vec3Type>("b")->value, Vec3(0.f));
+    EXPECT_EQ(material.getProperty<Property::Wrapper::Vec3Type>("c")->value, Vec3(4.f, 0.f, 0.f));
+    EXPECT_EQ(material.getProperty<Property::Wrapper::IntType>("d")->value, 7);
+    EXPECT_EQ(staged.scene.sphereBuffer[0].radius, numeric_limits<float>::max());
+
+    // ȡʱϢ
+    StagedScene fromStream;
+    stringstream ss{text + "Plane floor x\n"};
+    EXPECT_FALSE(parser.stage(ss, fromStream));
+    EXPECT_EQ(parser.getErrorInfo(), "Invalid material name.");
+}
@@ -0,0 +1,37 @@
+#include "gtest/gtest.h"
+#include "server/TaskGraph.hpp"
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+using namespace NRenderer;
+
+TEST(TaskGraphTest, RunsTasksAfterDependencies) {
+    // a -> b, a -> c, (b, c) -> dһ黥
+    std::atomic<int> clock{0};
+    int a = -1, b = -1, c = -1, d = -1;
+    std::vector<int> independent(32, -1);
+    TaskGraph graph{};
+    auto ta = graph.add([&]() { a = clock++; });
+    auto tb = graph.add([&]() { b = clock++; }, { ta });
+    auto tc = graph.add([&]() { c = clock++; }, { ta });
+    graph.add([&]() { d = clock++; }, { tb, tc });
+    for (auto& v : independent) graph.add([&]() { v = clock++; });
+    graph.run(4);
+    EXPECT_LT(a, b);
+    EXPECT_LT(a, c);
+    EXPECT_LT(b, d);
+    EXPECT_LT(c, d);
+    for (int v : independent) EXPECT_GE(v, 0);
+    EXPECT_EQ(clock.load(), 36);
+}
+
+TEST(TaskGraphTest, RethrowsAndSkipsDependents) {
+    bool dependentRan = false;
+    TaskGraph graph{};
+    auto failing = graph.add([]() { throw std::runtime_error("failed"); });
+    graph.add([&]() { dependentRan = true; }, { failing });
+    EXPECT_THROW(graph.run(2), std::runtime_error);
+    EXPECT_FALSE(dependentRan);
+}
@@ -0,0 +1,63 @@
+#include "gtest/gtest.h"
+#include "server/TemporalHistory.hpp"
+
+using namespace NRenderer;
+
+namespace
+{
+    // λ(0, 0, 10)-z4x4صʷ¼z = 0ƽϸĵ״ཻ
+    TemporalHistory makeHistory() {
+        TemporalHistory::View view{ {0, 0, 10}, {-1, -1, 9}, {2, 0, 0}, {0, 2, 0} };
+        TemporalHistory history{4, 4, 42, 0, view};
+        for (unsigned int row = 0; row < 4; row++) {
+            for (unsigned int col = 0; col < 4; col++) {
+                float s = (float(col) + 0.5f)/4.f;
+                float t = (float(row) + 0.5f)/4.f;
+                TemporalHistory::Texel texel{};
+                texel.radiance = { float(col), float(row), 0 };
+                texel.weight = 8.f;
+                texel.position = { 10.f*(2.f*s - 1.f), 10.f*(2.f*t - 1.f), 0 };
+                texel.normal = { 0, 0, 1 };
+                history.set(row, col, texel);
+            }
+        }
+        return history;
+    }
+
+    // z = 0ƽͶӰһ(s, t)ĵ
+    Vec3 onPlane(float s, float t) {
+        return { 10.f*(2.f*s - 1.f), 10.f*(2.f*t - 1.f), 0 };
+    }
+}
+
+TEST(TemporalHistoryTest, ReprojectInterpolatesMatchingTexels) {
+    auto history = makeHistory();
+    // ĵõصʷ
+    auto center = history.reproject(onPlane(2.5f/4.f, 1.5f/4.f), {0, 0, 1});
+    EXPECT_FLOAT_EQ(center.weight, 8.f);
+    EXPECT_FLOAT_EQ(center.radiance.x, 2.f);
+    EXPECT_FLOAT_EQ(center.radiance.y, 1.f);
+    // ֮䰴˫Բֵ
+    auto between = history.reproject(onPlane(0.5f, 1.5f/4.f), {0, 0, 1});
+    EXPECT_FLOAT_EQ(between.weight, 8.f);
+    EXPECT_FLOAT_EQ(between.radiance.x, 1.5f);
+    // ͼԵֻвؿãЧ֮С
+    auto edge = history.reproject(onPlane(0.f, 1.5f/4.f), {0, 0, 1});
+    EXPECT_FLOAT_EQ(edge.weight, 4.f);
+    EXPECT_FLOAT_EQ(edge.radiance.x, 0.f);
+}
+
+TEST(TemporalHistoryTest, RejectsMismatchedSurfaces) {
+    auto history = makeHistory();
+    const Vec3 p = onPlane(2.5f/4.f, 1.5f/4.f);
+    // ߲һ
+    EXPECT_EQ(history.reproject(p, {0, 1, 0}).weight, 0.f);
+    // ͶӰͬһص뿪ʷ棨ڵ
+    const Vec3 origin{0, 0, 10};
+    EXPECT_EQ(history.reproject(origin + 0.9f*(p - origin), {0, 0, 1}).weight, 0.f);
+    // λһ֡󷽻Ұ
+    EXPECT_EQ(history.reproject({0, 0, 20}, {0, 0, 1}).weight, 0.f);
+    EXPECT_EQ(history.reproject(onPlane(2.f, 0.5f), {0, 0, 1}).weight, 0.f);
+    // յʷ
+    EXPECT_EQ(TemporalHistory{}.reproject(p, {0, 0, 1}).weight, 0.f);
+}
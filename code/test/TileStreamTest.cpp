@@ -0,0 +1,60 @@
+#include "gtest/gtest.h"
+#include "server/TileStream.hpp"
+
+#include <vector>
+
+using namespace NRenderer;
+
+namespace
+{
+    void expectSameFrame(const TileDecoder& decoder, const vector<RGBA>& pixels) {
+        auto& frame = decoder.getFrame();
+        ASSERT_EQ(frame.size(), pixels.size()*4);
+        for (size_t i = 0; i < pixels.size(); i++) {
+            auto c = RGBA2RGBAi(pixels[i]);
+            for (int k = 0; k < 4; k++) {
+                ASSERT_EQ(frame[i*4 + k], c[k]);
+            }
+        }
+    }
+}
+
+TEST(TileStreamTest, RoundTrip) {
+    // ߴ粻ǿСǱԵ
+    const unsigned int w = 37, h = 21;
+    vector<RGBA> pixels(w*h);
+    for (unsigned int i = 0; i < w*h; i++) {
+        pixels[i] = {float(i % 7)/7.f, float(i % 13)/13.f, 0.5f, 1.f};
+    }
+    TileEncoder encoder;
+    TileDecoder decoder;
+    unsigned int tiles = 0;
+    auto data = encoder.encode(pixels.data(), w, h, tiles);
+    EXPECT_EQ(tiles, 6u);
+    ASSERT_TRUE(decoder.apply(data.data(), data.size()));
+    EXPECT_EQ(decoder.getWidth(), w);
+    EXPECT_EQ(decoder.getHeight(), h);
+    expectSameFrame(decoder, pixels);
+
+    // ֻ޸һʱֻһ
+    pixels[20*w + 36] = {1.f, 0.f, 0.f, 1.f};
+    data = encoder.encode(pixels.data(), w, h, tiles);
+    EXPECT_EQ(tiles, 1u);
+    ASSERT_TRUE(decoder.apply(data.data(), data.size()));
+    expectSameFrame(decoder, pixels);
+
+    // ûб仯ʱ
+    data = encoder.encode(pixels.data(), w, h, tiles);
+    EXPECT_EQ(tiles, 0u);
+    ASSERT_TRUE(decoder.apply(data.data(), data.size()));
+    expectSameFrame(decoder, pixels);
+}
+
+TEST(TileStreamTest, RejectsTruncatedData) {
+    vector<RGBA> pixels(16*16, RGBA{0.25f, 0.5f, 0.75f, 1.f});
+    TileEncoder encoder;
+    unsigned int tiles = 0;
+    auto data = encoder.encode(pixels.data(), 16, 16, tiles);
+    TileDecoder decoder;
+    EXPECT_FALSE(decoder.apply(data.data(), data.size() - 1));
+}
@@ -0,0 +1,83 @@
+#include "gtest/gtest.h"
+#include "SimplePathTracer.hpp"
+#include "scene/ScnParser.hpp"
+#include "server/Server.hpp"
+
+#include <utility>
+
+using namespace SimplePathTracer;
+
+namespace
+{
+    // ϷһԴϷȫڵӰȫɼ
+    const char* OCCLUDED_SCENE = R"(
+Begin Material
+Material White
+Prop diffuseColor RGB 0.8 0.8 0.8
+End
+
+Begin Model
+Model Ground
+Translation 0 0 0
+Plane Floor White
+N 0 1 0
+P -2 0 -2
+U 4 0 0
+V 0 0 4
+End
+
+Begin Model
+Model Occluder
+Translation 0 0.8 0
+Sphere Ball White
+N 0 0 1
+P 0 0 0
+R 0.5
+End
+
+Begin Light
+Area Top
+IRV 4 4 4
+P -0.5 3 -0.5
+U 1 0 0
+V 0 0 1
+End
+)";
+
+    // ׷Ϊ0ֻйԴֱӹգҪԿɼԻ汾
+    // ȾصƽֵֵgammaУ׷ٵĹ
+    pair<double, uint64_t> renderMean(bool visibilityCache) {
+        ScnParser parser;
+        auto scene = parser.parseText(OCCLUDED_SCENE);
+        EXPECT_NE(scene, nullptr) << parser.getErrorInfo();
+        if (scene == nullptr) return { 0.0, 0 };
+        scene->camera.position = Vec3{0, 3, -3};
+        scene->camera.lookAt = Vec3{0, 0, 0};
+        scene->renderOption.width = 32;
+        scene->renderOption.height = 32;
+        scene->renderOption.depth = 0;
+        scene->renderOption.samplesPerPixel = 128;
+        scene->renderOption.threads = 2;
+        scene->renderOption.sampleSeed = 17;
+        scene->renderOption.visibilityCache = visibilityCache;
+        scene->renderOption.countRays = true;
+
+        SimplePathTracerRenderer renderer{scene};
+        auto result = renderer.render();
+        auto [pixels, width, height] = result;
+        double sum = 0.0;
+        for (unsigned int i = 0; i < width*height; i++) sum += pixels[i].r*pixels[i].r;
+        renderer.release(result);
+        return { sum/(width*height), getServer().statistics.getLastRender().rays };
+    }
+}
+
+// ɼԻֻȷӰ߲ʼȨͼƽֵӦ벻ʹûʱһ
+TEST(VisibilityCacheTest, CachedMatchesUncached) {
+    auto [uncached, uncachedRays] = renderMean(false);
+    auto [cached, cachedRays] = renderMean(true);
+    ASSERT_GT(uncached, 0.0);
+    EXPECT_NEAR(cached, uncached, 0.01*uncached);
+    // 󲿷ȫɼȫڵӦ൱һӰ
+    EXPECT_LT(cachedRays, uncachedRays);
+}